@@ -8,81 +8,564 @@
 # Descripción general:
 # ---------------------------------------------------------------
 # Script en Perl que automatiza la ejecución de los programas de multiplicación
-# de matrices implementados en C (Fork, Pthreads, OpenMP, Filas OpenMP).
+# de matrices implementados en C (Fork, Pthreads, OpenMP, Filas OpenMP,
+# Strassen, SUMMA y CSR disperso) y resume estadísticamente los tiempos
+# medidos.
 #
-# Su función principal es:
-#   - Ejecutar cada versión del algoritmo con distintos tamaños de matriz (N)
-#     y números de hilos/procesos (P).
-#   - Repetir cada prueba varias veces (por defecto 30) para obtener datos estables.
-#   - Guardar los tiempos medidos en archivos de salida con extensión `.dat`.
+# Para cada versión, variante del kernel, tipo de páginas, tamaño N y número
+# de hilos P:
+#   - Descarta algunas ejecuciones de calentamiento (caches, páginas, CPU
+#     en frecuencia estable).
+#   - Repite la medición de forma adaptativa: al menos --reps-min veces y
+#     hasta que el intervalo de confianza del 95 % de la media tenga un
+#     semiancho menor que --precision (relativo), con un máximo de --reps-max.
+#   - Calcula mediana, p95, media, desviación estándar, IC95, mínimo y
+#     máximo; y, respecto a P=1, speedup (mediana P=1 / mediana P) y
+#     eficiencia (speedup / P).
+#   - Con la variante tuberia (--pipeline), muestra además el ancho de banda
+#     logrado frente al pico STREAM (una ejecución extra con -v).
+#   - Con --densidades, repite el barrido para cada densidad de A
+#     (--density): los motores densos multiplican A con sus ceros y
+#     Dispersa la comprime a CSR.
 #
-# Archivos generados:
-#   Fork.dat, Posix.dat, OpenMP.dat, FilasOpenMP.dat
+# El barrido de hilos por defecto se adapta al equipo: 1, 2, 4, ... hasta el
+# número de núcleos en línea (incluido).
+#
+# Archivos generados (en resultados/):
+#   resultados.csv   Una fila por (entorno, versión, variante, N, P) con el
+#                    esquema descrito en README.md.
+#   resultados.json  Los mismos datos más la descripción del entorno.
+#   muestras.csv     Cada medición individual (para repetir el análisis).
+#
+# Con --importar se leen los archivos históricos "Entorno-Versión.csv"
+# (Linux-*.csv, WSL-*.csv: líneas "N P tiempo") y se resumen con el mismo
+# esquema, de modo que todos los datos quedan en un único archivo.
 #
 # Requisitos:
 #   - Ejecutables compilados previamente con el Makefile.
 #   - Permisos de ejecución en este script:  chmod +x lanzador.pl
 #
 # Ejecución:
-#   ./lanzador.pl
+#   ./lanzador.pl                                  (barrido completo)
+#   ./lanzador.pl --tamanos 100,400 --motores Posix,OpenMP --variantes micro
+#   ./lanzador.pl --tamanos 1200,2400 --paginas normal,thp --precarga
+#   ./lanzador.pl --tamanos 1024,4096 --forma 32x4096 --variantes micro
+#   ./lanzador.pl --tamanos 1024,2048 --tipos f64,f32,i8 --variantes micro
+#   ./lanzador.pl --tamanos 600,1200,2400 --motores OpenMP,Strassen --variantes micro --corte 512
+#   ./lanzador.pl --tamanos 1200,2400 --motores Fork,Summa --hilos 1,4,9 --variantes micro
+#   ./lanzador.pl --tamanos 1200 --motores OpenMP --repartos estatico,dinamico,guiado,dinamico:4
+#   ./lanzador.pl --tamanos 4,8,16,100 --lote 10000 --variantes micro
+#   ./lanzador.pl --tamanos 1024,2048 --motores OpenMP,FilasOpenMP --variantes micro,tuberia
+#   ./lanzador.pl --tamanos 2048 --motores OpenMP,Dispersa --variantes micro --densidades 0.01,0.05,0.2,1
+#   ./lanzador.pl --importar Linux-*.csv WSL-*.csv
+#   ./lanzador.pl --ayuda
 #
 ##########################################################################################
 
 use strict;
 use warnings;
+use Getopt::Long;
+use JSON::PP;
+use Sys::Hostname;
 
 # Configuración general -------------------------------------------------------
 
-# Número de repeticiones por experimento
-my $reps = 30;
+# Ejecuciones de calentamiento descartadas antes de medir
+my $calentamiento = 2;
+
+# Repeticiones mínimas y máximas por experimento
+my $reps_min = 5;
+my $reps_max = 30;
+
+# Semiancho relativo aceptado para el IC95 de la media (0.02 = ±2 %)
+my $precision = 0.02;
 
 # Tamaños de matriz a evaluar
 my @sizes = (100, 200, 400, 600, 1200, 2400);
 
-# Números de hilos o procesos
-my @threads = (1, 2, 4);
+# Números de hilos o procesos (vacío → según los núcleos del equipo)
+my @threads = ();
 
 # Ejecutables (deben existir en el mismo directorio)
 my %executables = (
-    "Fork"	   => "./mmClasicaFork",
+    "Fork"         => "./mmClasicaFork",
     "Posix"        => "./mmClasicaPosix",
-    "OpenMP"	   => "./mmClasicaOpenMP",
-    "FilasOpenMP"  => "./mmFilasOpenMP"	
+    "OpenMP"       => "./mmClasicaOpenMP",
+    "FilasOpenMP"  => "./mmFilasOpenMP",
+    "Strassen"     => "./mmStrassenOpenMP",
+    "Summa"        => "./mmSummaProcesos",
+    "Dispersa"     => "./mmDispersaOpenMP"
 );
 
+# Variantes del kernel: nombre => opciones adicionales
+my %variantes = (
+    "clasico"   => "",
+    "bloques"   => "-b auto",
+    "micro"     => "-k auto",
+    "tuberia"   => "--pipeline"
+);
+
+# Tipos de páginas de las matrices (--pages, mmMemoria.c): nombre => opciones.
+# Una variante con páginas distintas de las normales se etiqueta
+# "variante+paginas" (p. ej. "clasico+thp"), con su propio speedup.
+my %paginas = (
+    "normal"    => "",
+    "thp"       => "--pages thp",
+    "hugetlb"   => "--pages hugetlb"
+);
+my @lista_paginas = ("normal");
+
+# Precarga de páginas antes de medir (--prefault)
+my $precarga = 0;
+# Producto general "MxK" (--shape): cada N es el número de columnas de C
+my $forma;
+# Tipos de elemento (--type); vacío = double con los kernels de siempre
+my @lista_tipos = ("");
+# Corte de la recursión de Strassen (--cutoff); solo se pasa a ese motor y
+# la etiqueta lleva "+cN" (sin valor, el corte por defecto del programa)
+my $corte;
+# Repartos (-s) de las versiones Posix y OpenMP; "tipo:n" = trozos de n
+# (filas en Posix, teselas en OpenMP). Vacío = el reparto por defecto; los
+# demás se etiquetan "variante+tipo" (p. ej. "clasico+dinamico4")
+my @lista_repartos = ("");
+# Lote de productos N×N independientes (--batch); la etiqueta lleva "+loteB"
+# y el tiempo es el del lote completo
+my $lote;
+# Densidades de A (--density); vacío = A densa. La etiqueta lleva "+dD" y,
+# con --perfil, el perfil de densidad por filas (uniforme o creciente)
+my @lista_densidades = ("");
+my $perfil;
+
 # Directorio de salida
 my $out_dir = "resultados";
-mkdir $out_dir unless -d $out_dir;
 
+# Etiqueta del entorno (por defecto Linux o WSL, detectado)
+my $entorno;
+
+# Archivos históricos a importar en lugar de ejecutar
+my $importar = 0;
+
+my ($op_tamanos, $op_hilos, $op_motores, $op_variantes, $op_paginas, $op_tipos, $op_repartos,
+    $op_densidades, $ayuda);
+
+GetOptions(
+    "tamanos=s"       => \$op_tamanos,
+    "hilos=s"         => \$op_hilos,
+    "motores=s"       => \$op_motores,
+    "variantes=s"     => \$op_variantes,
+    "paginas=s"       => \$op_paginas,
+    "precarga"        => \$precarga,
+    "forma=s"         => \$forma,
+    "tipos=s"         => \$op_tipos,
+    "corte=i"         => \$corte,
+    "repartos=s"      => \$op_repartos,
+    "lote=i"          => \$lote,
+    "densidades=s"    => \$op_densidades,
+    "perfil=s"        => \$perfil,
+    "reps-min=i"      => \$reps_min,
+    "reps-max=i"      => \$reps_max,
+    "precision=f"     => \$precision,
+    "calentamiento=i" => \$calentamiento,
+    "salida=s"        => \$out_dir,
+    "entorno=s"       => \$entorno,
+    "importar"        => \$importar,
+    "ayuda"           => \$ayuda,
+) or uso(1);
+uso(0) if $ayuda;
+
+@sizes   = split(/,/, $op_tamanos) if defined $op_tamanos;
+@threads = split(/,/, $op_hilos)   if defined $op_hilos;
+$reps_max = $reps_min if $reps_max < $reps_min;
+
+my @motores = defined $op_motores ? split(/,/, $op_motores) : sort keys %executables;
+my @lista_variantes = defined $op_variantes ? split(/,/, $op_variantes) : sort keys %variantes;
+@lista_paginas = split(/,/, $op_paginas) if defined $op_paginas;
+@lista_tipos = split(/,/, $op_tipos) if defined $op_tipos;
+@lista_repartos = split(/,/, $op_repartos) if defined $op_repartos;
+@lista_densidades = split(/,/, $op_densidades) if defined $op_densidades;
+
+foreach my $m (@motores) {
+    die "Versión desconocida: $m\n" unless exists $executables{$m};
+}
+foreach my $v (@lista_variantes) {
+    die "Variante desconocida: $v\n" unless exists $variantes{$v};
+}
+foreach my $g (@lista_paginas) {
+    die "Tipo de páginas desconocido: $g\n" unless exists $paginas{$g};
+}
+die "Forma inválida: $forma (se espera MxK)\n" if defined $forma && $forma !~ /^\d+x\d+$/;
+foreach my $t (@lista_tipos) {
+    die "Tipo desconocido: $t (f64, f32, i16 o i8)\n" unless $t =~ /^(|f64|f32|i16|i8)$/;
+}
+die "--tipos no se combina con --forma\n" if defined $op_tipos && defined $forma;
+die "--lote debe ser positivo y no se combina con --forma ni --tipos\n"
+    if defined $lote && ($lote <= 0 || defined $forma || defined $op_tipos);
+foreach my $d (@lista_densidades) {
+    die "Densidad inválida: $d (se espera 0 < d <= 1)\n"
+        unless $d eq "" || ($d =~ /^(\d+\.?\d*|\.\d+)(e-?\d+)?$/i && $d > 0 && $d <= 1);
+}
+die "Perfil desconocido: $perfil (uniforme o creciente)\n"
+    if defined $perfil && $perfil !~ /^(uniforme|creciente)$/;
+die "--perfil requiere --densidades\n" if defined $perfil && !defined $op_densidades;
+die "--densidades no se combina con --forma, --tipos ni --lote\n"
+    if defined $op_densidades && (defined $forma || defined $op_tipos || defined $lote);
+foreach my $r (@lista_repartos) {
+    die "Reparto desconocido: $r (estatico, dinamico, guiado o robo, con :n opcional)\n"
+        unless $r =~ /^(|(estatico|dinamico|guiado|robo)(:\d+)?)$/;
+}
+
+# Funciones auxiliares --------------------------------------------------------
+
+sub uso {
+    my ($codigo) = @_;
+    print <<"FIN";
+Uso: ./lanzador.pl [opciones]
+  --tamanos 100,200,...    tamaños N (por defecto @{[join(',', @sizes)]})
+  --hilos 1,2,4            valores de P (por defecto 1, 2, 4, ... hasta los núcleos)
+  --motores Fork,Posix     versiones a ejecutar (@{[join(',', sort keys %executables)]})
+  --variantes clasico,...  variantes del kernel (@{[join(',', sort keys %variantes)]})
+  --paginas normal,thp     páginas de las matrices (@{[join(',', sort keys %paginas)]})
+  --precarga               toca las páginas antes de medir (--prefault)
+  --forma MxK              producto general A M×K · B K×N con N de --tamanos (--shape)
+  --tipos f64,f32,i16,i8   tipos de elemento (--type); la etiqueta lleva +tipo
+  --corte N                (Strassen) corte de la recursión (--cutoff); etiqueta +cN
+  --repartos estatico,dinamico:4   (Posix, OpenMP) repartos -s; etiqueta +reparto
+  --lote B                 lote de B productos N×N por ejecución (--batch); etiqueta +loteB
+  --densidades 0.01,0.1    densidades de A (--density); etiqueta +dD
+  --perfil creciente       perfil de densidad por filas (uniforme o creciente)
+  --reps-min R, --reps-max R   repeticiones mínimas/máximas ($reps_min/$reps_max)
+  --precision E            semiancho relativo del IC95 para detenerse ($precision)
+  --calentamiento W        ejecuciones descartadas antes de medir ($calentamiento)
+  --salida DIR             directorio de salida ($out_dir)
+  --entorno NOMBRE         etiqueta del entorno (por defecto Linux o WSL)
+  --importar ARCHIVOS...   resume archivos históricos Entorno-Versión.csv
+FIN
+    exit($codigo);
+}
+
+# Número de núcleos en línea
+sub nucleos {
+    my $n = `getconf _NPROCESSORS_ONLN 2>/dev/null`;
+    return $1 + 0 if defined $n && $n =~ /^\s*(\d+)/ && $1 > 0;
+
+    my $c = 0;
+    if (open(my $fh, '<', '/proc/cpuinfo')) {
+        while (<$fh>) { $c++ if /^processor\s*:/; }
+        close($fh);
+    }
+    return $c > 0 ? $c : 1;
+}
+
+# 1, 2, 4, ... menores que el número de núcleos, y el número de núcleos
+sub barrido_hilos {
+    my ($c) = @_;
+    my @p;
+    for (my $p = 1; $p < $c; $p *= 2) { push @p, $p; }
+    push @p, $c;
+    return @p;
+}
+
+# Linux o WSL según /proc/version
+sub detecta_entorno {
+    if (open(my $fh, '<', '/proc/version')) {
+        my $v = <$fh> // "";
+        close($fh);
+        return "WSL" if $v =~ /microsoft/i;
+    }
+    return $^O eq "linux" ? "Linux" : $^O;
+}
+
+# Modelo de CPU según /proc/cpuinfo
+sub modelo_cpu {
+    if (open(my $fh, '<', '/proc/cpuinfo')) {
+        while (<$fh>) {
+            if (/^model name\s*:\s*(.*)$/) { close($fh); return $1; }
+        }
+        close($fh);
+    }
+    return "";
+}
+
+# Cuantil q (0..1) de una lista ordenada, con interpolación lineal
+sub cuantil {
+    my ($q, @x) = @_;
+    return undef unless @x;
+    my $pos = $q * (@x - 1);
+    my $i = int($pos);
+    return $x[$i] if $i >= $#x;
+    return $x[$i] + ($pos - $i) * ($x[$i + 1] - $x[$i]);
+}
+
+# Valor crítico t de Student bilateral al 95 % con `gl` grados de libertad
+sub t95 {
+    my ($gl) = @_;
+    my @t = (0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+             2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+             2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042);
+    return $gl <= 0 ? 0 : ($gl <= 30 ? $t[$gl] : 1.96);
+}
+
+# Resumen estadístico de una lista de tiempos
+sub estadisticas {
+    my @x = sort { $a <=> $b } @_;
+    my $n = @x;
+    my %e = (n => $n);
+    return \%e if $n == 0;
+
+    my $suma = 0;
+    $suma += $_ foreach @x;
+    my $media = $suma / $n;
+    my $var = 0;
+    $var += ($_ - $media) ** 2 foreach @x;
+    my $desv = $n > 1 ? sqrt($var / ($n - 1)) : 0;
+
+    $e{media}     = $media;
+    $e{desviacion} = $desv;
+    $e{ic95}      = $n > 1 ? t95($n - 1) * $desv / sqrt($n) : 0;
+    $e{mediana}   = cuantil(0.5, @x);
+    $e{p95}       = cuantil(0.95, @x);
+    $e{min}       = $x[0];
+    $e{max}       = $x[-1];
+    return \%e;
+}
+
+# Ejecuta un programa y devuelve los números de la primera línea de su salida
+sub ejecuta {
+    my ($cmd) = @_;
+    my $salida = `$cmd 2>/dev/null`;
+    return () if $? != 0 || !defined $salida;
+    my ($linea) = grep { /\S/ } split(/\n/, $salida);
+    return () unless defined $linea;
+    return grep { /^-?[\d.]+(e[-+]?\d+)?$/i } split(' ', $linea);
+}
+
+# Mide un experimento: calentamiento y repeticiones adaptativas
+sub mide {
+    my ($cmd) = @_;
+    my (@tiempos, @extra);
+
+    ejecuta($cmd) for 1 .. $calentamiento;
+
+    while (@tiempos < $reps_max) {
+        my @v = ejecuta($cmd);
+        if (!@v) {
+            warn "  Falló: $cmd\n";
+            last;
+        }
+        push @tiempos, $v[0];
+        push @extra, $v[1] if @v > 1;
+
+        if (@tiempos >= $reps_min) {
+            my $e = estadisticas(@tiempos);
+            last if $e->{media} > 0 && $e->{ic95} / $e->{media} <= $precision;
+        }
+    }
+    return (\@tiempos, \@extra);
+}
+
+# Registro de resultados ------------------------------------------------------
+
+my @filas;      # una entrada por experimento
+my @muestras;   # una entrada por medición
+
+my @campos = qw(entorno maquina cpu nucleos motor variante opciones N P repeticiones
+                calentamiento mediana_us p95_us media_us desviacion_us ic95_us
+                min_us max_us speedup eficiencia extra_mediana_us);
+
+sub registra {
+    my ($env, $motor, $variante, $opciones, $n, $p, $tiempos, $extra, $cal) = @_;
+    my $e = estadisticas(@$tiempos);
+    return if $e->{n} == 0;
+
+    my %f = (
+        entorno => $env->{entorno}, maquina => $env->{maquina}, cpu => $env->{cpu},
+        nucleos => $env->{nucleos}, motor => $motor, variante => $variante,
+        opciones => $opciones, N => $n + 0, P => $p + 0,
+        repeticiones => $e->{n}, calentamiento => $cal,
+        mediana_us => $e->{mediana}, p95_us => $e->{p95}, media_us => $e->{media},
+        desviacion_us => $e->{desviacion}, ic95_us => $e->{ic95},
+        min_us => $e->{min}, max_us => $e->{max},
+        speedup => undef, eficiencia => undef,
+        extra_mediana_us => @$extra ? estadisticas(@$extra)->{mediana} : undef,
+    );
+    push @filas, \%f;
+
+    for my $i (0 .. $#$tiempos) {
+        push @muestras, [$env->{entorno}, $motor, $variante, $n, $p, $i + 1,
+                         $tiempos->[$i], $i <= $#$extra ? $extra->[$i] : ""];
+    }
+}
+
+# Speedup y eficiencia de cada fila respecto a P=1 del mismo grupo
+sub calcula_speedup {
+    my %base;
+    foreach my $f (@filas) {
+        next unless $f->{P} == 1;
+        $base{join("|", @$f{qw(entorno motor variante N)})} = $f->{mediana_us};
+    }
+    foreach my $f (@filas) {
+        my $b = $base{join("|", @$f{qw(entorno motor variante N)})};
+        next unless defined $b && $f->{mediana_us} > 0;
+        $f->{speedup}    = $b / $f->{mediana_us};
+        $f->{eficiencia} = $f->{speedup} / $f->{P};
+    }
+}
+
+sub escribe_resultados {
+    my ($env) = @_;
+    mkdir $out_dir unless -d $out_dir;
+
+    my $csv = "$out_dir/resultados.csv";
+    open(my $fh, '>', $csv) or die "No se pudo crear $csv: $!";
+    print $fh join(",", @campos), "\n";
+    foreach my $f (@filas) {
+        print $fh join(",", map {
+            my $v = $f->{$_};
+            !defined $v ? "" :
+            /^(entorno|maquina|cpu|motor|variante|opciones)$/ ? "\"$v\"" :
+            /_us$/ ? sprintf("%.1f", $v) :
+            /^(speedup|eficiencia)$/ ? sprintf("%.4f", $v) : $v
+        } @campos), "\n";
+    }
+    close($fh);
+
+    my $json = "$out_dir/resultados.json";
+    open($fh, '>', $json) or die "No se pudo crear $json: $!";
+    print $fh JSON::PP->new->utf8(0)->pretty->canonical->encode({
+        esquema    => 1,
+        entorno    => $env,
+        parametros => { calentamiento => $calentamiento, reps_min => $reps_min,
+                        reps_max => $reps_max, precision => $precision },
+        campos     => \@campos,
+        resultados => \@filas,
+    });
+    close($fh);
+
+    my $mue = "$out_dir/muestras.csv";
+    open($fh, '>', $mue) or die "No se pudo crear $mue: $!";
+    print $fh "entorno,motor,variante,N,P,repeticion,tiempo_us,extra_us\n";
+    print $fh join(",", @$_), "\n" foreach @muestras;
+    close($fh);
+
+    print "Archivos generados: $csv, $json, $mue\n";
+}
+
+# Importación de archivos históricos ------------------------------------------
+
+if ($importar) {
+    die "Indique los archivos a importar (p. ej. Linux-*.csv WSL-*.csv)\n" unless @ARGV;
+
+    foreach my $archivo (@ARGV) {
+        my ($env_nombre, $motor) = $archivo =~ m{([^/-]+)-([^/]+)\.(?:csv|dat)$}
+            or die "Nombre no reconocido (se espera Entorno-Versión.csv): $archivo\n";
+        my %env = (entorno => $env_nombre, maquina => "", cpu => "", nucleos => undef);
+        my (%t, @orden);
+
+        open(my $fh, '<', $archivo) or die "No se pudo leer $archivo: $!";
+        while (<$fh>) {
+            next if /^\s*(#|$)/;
+            my ($n, $p, $tiempo) = split;
+            next unless defined $tiempo && $tiempo =~ /\d/;   # líneas sin medición
+            my $k = "$n $p";
+            push @orden, $k unless exists $t{$k};
+            push @{$t{$k}}, $tiempo;
+        }
+        close($fh);
+
+        foreach my $k (@orden) {
+            my ($n, $p) = split(' ', $k);
+            registra(\%env, $motor, "clasico", "", $n, $p, $t{$k}, [], 0);
+        }
+        print "Importado: $archivo (" . scalar(@orden) . " combinaciones N, P)\n";
+    }
+
+    calcula_speedup();
+    escribe_resultados({ entorno => "importado" });
+    exit(0);
+}
 
 # Bucle principal de experimentos --------------------------------------------
+
+my $nucleos = nucleos();
+@threads = barrido_hilos($nucleos) unless @threads;
+
+my %env = (
+    entorno => $entorno // detecta_entorno(),
+    maquina => hostname(),
+    cpu     => modelo_cpu(),
+    nucleos => $nucleos,
+    nucleo_so => (split(' ', `uname -r 2>/dev/null` // ""))[0] // "",
+);
+
 print "\n=== INICIO DE EJECUCIONES AUTOMATIZADAS ===\n";
+print "Entorno: $env{entorno}, $env{cpu}, $nucleos núcleos; P = @threads\n";
 
-foreach my $exe (keys %executables) {
-    my $program = $executables{$exe};
-    my $outfile = "$out_dir/$exe.dat";
+# Combinaciones motor × variante × páginas × tipo × reparto × densidad, en
+# ese orden (el último factor varía más rápido)
+my @combinaciones = ([]);
+foreach my $lista (\@motores, \@lista_variantes, \@lista_paginas, \@lista_tipos,
+                   \@lista_repartos, \@lista_densidades) {
+    @combinaciones = map { my $c = $_; map { [@$c, $_] } @$lista } @combinaciones;
+}
 
-    open(my $fh, '>', $outfile) or die "No se pudo crear $outfile: $!";
+foreach my $combinacion (@combinaciones) {
+    my ($exe, $variante, $pag, $tipo, $rep, $dens) = @$combinacion;
+    my $program = $executables{$exe};
+    my $strassen = ($exe eq "Strassen");
+    # Strassen, SUMMA y Dispersa solo multiplican una matriz cuadrada de double
+    next if ($strassen || $exe eq "Summa" || $exe eq "Dispersa")
+            && (defined $forma || length $tipo || defined $lote);
+    # Dispersa tiene solo su kernel CSR (-k elige la variante SIMD): se mide
+    # una vez, con la variante micro
+    next if $exe eq "Dispersa" && $variante ne "micro";
+    # La tubería es un modo del micro-kernel de double
+    next if $variante eq "tuberia" && (length $tipo || defined $lote);
+    # -s solo cambia el reparto de Pthreads y de OpenMP clásica
+    next if length $rep && $exe ne "Posix" && $exe ne "OpenMP";
+    (my $s = $rep) =~ s/:/,/;
+    my $flags   = join(" ", grep { length } $variantes{$variante}, $paginas{$pag},
+                       $precarga ? "--prefault" : (), defined $forma ? "--shape $forma" : (),
+                       length $tipo ? "--type $tipo" : (),
+                       $strassen && defined $corte ? "--cutoff $corte" : (),
+                       length $rep ? "-s $s" : (), defined $lote ? "--batch $lote" : (),
+                       length $dens ? "--density $dens" . (defined $perfil ? ",$perfil" : "") : ());
+    my $etiqueta = ($pag eq "normal") ? $variante : "$variante+$pag";
+    $etiqueta .= "+$forma" if defined $forma;
+    $etiqueta .= "+$tipo" if length $tipo;
+    $etiqueta .= "+c$corte" if $strassen && defined $corte;
+    (my $r = $rep) =~ s/://;
+    $etiqueta .= "+$r" if length $rep;
+    $etiqueta .= "+lote$lote" if defined $lote;
+    $etiqueta .= "+d$dens" if length $dens;
+    $etiqueta .= "+$perfil" if length $dens && defined $perfil;
 
-    print $fh "# Resultados de ejecución para $exe\n";
-    print $fh "# Formato: N P Tiempo(µs)\n\n";
+    unless (-x $program) {
+        warn "No existe $program; compile con make\n";
+        next;
+    }
 
     foreach my $n (@sizes) {
         foreach my $p (@threads) {
-            print "Ejecutando $exe con N=$n y P=$p ...\n";
-            for (my $i = 1; $i <= $reps; $i++) {
-                my $cmd = "$program $n $p";
-                my $output = `$cmd`;
-                chomp($output);
-                print $fh "$n $p $output\n";
+            my ($t, $x) = mide("$program $n $p $flags");
+            registra(\%env, $exe, $etiqueta, $flags, $n, $p, $t, $x, $calentamiento);
+            my $f = $filas[-1];
+            printf("%-12s %-8s N=%-5d P=%-3d reps=%-3d mediana=%10.0f µs  ±%.1f %%\n",
+                   $exe, $etiqueta, $n, $p, $f->{repeticiones}, $f->{mediana_us},
+                   $f->{media_us} > 0 ? 100 * $f->{ic95_us} / $f->{media_us} : 0)
+                if @$t;
+            # Con la tubería, una ejecución más con -v para comparar el ancho
+            # de banda logrado con el pico STREAM del equipo
+            if ($variante eq "tuberia" && @$t) {
+                my ($ancho) = grep { /^# ancho de banda \(tubería\)/ } `$program $n $p $flags -v 2>&1 >/dev/null`;
+                print "             $ancho" if defined $ancho;
             }
         }
-        print "-------------------------------------------\n";
     }
-
-    close($fh);
-    print "Archivo generado: $outfile\n";
+    print "-------------------------------------------\n";
 }
 
+calcula_speedup();
+escribe_resultados(\%env);
+
 print "\n=== FIN DE TODAS LAS EJECUCIONES ===\n";
 print "Los resultados están almacenados en la carpeta '$out_dir/'.\n";
@@ -0,0 +1,438 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * Descripción general:
+ * ---------------------------------------------------------------
+ * Binario único `mm`: enlaza los siete motores (Fork, Pthreads, OpenMP
+ * clásica, OpenMP por filas, Strassen con tareas OpenMP, SUMMA con
+ * procesos y sockets y CSR disperso con OpenMP) detrás de la interfaz de
+ * mmMotor.h y recorre
+ * en un solo proceso el barrido N × P × motor sobre las mismas matrices.
+ *
+ * Los ejecutables separados pagan en cada lanzamiento el `exec`, la reserva
+ * y los fallos de página de A, B y C, y su inicialización. Aquí la región
+ * de las tres matrices se reserva una sola vez para el mayor N, en memoria
+ * compartida (los hijos del motor Fork escriben C en ella) y con las
+ * páginas de `--pages` (mmMemoria.c); para cada N se inicializan A y B y se
+ * toca C antes de medir, de modo que ningún fallo de página cae dentro del
+ * tiempo de un motor.
+ *
+ * Uso:
+ *   ./mm <N[,N...]> <P[,P...]> [--engine fork,posix,openmp,filas,strassen,summa,dispersa|todos]
+ *        [-r R] [--batch B] [--density d] [opciones comunes, ver mmComun.c]
+ *
+ * Salida (stdout): una línea de encabezado que empieza con '#' y una línea
+ * por configuración con el motor, N, P y la media, mínima y máxima de las R
+ * multiplicaciones (µs); la columna `trans` es la transposición media de B
+ * del motor `filas` (0 en los demás). Con `--counters` se añaden las
+ * columnas de mmContadores.c. Con `--verify` se comprueba C tras cada
+ * configuración y el programa termina con código 1 si alguna falla.
+ *
+ * Con `--shape MxK` (o `--pad`) cada N de la lista es el número de columnas
+ * del producto general C (M×N) = A (M×K) · B (K×N) de mmForma.c, con M y K
+ * fijas; la primera línea de comentario indica la forma.
+ *
+ * Con `--type f64,f32,i16,i8` (mmTipo.c) el barrido recorre además los
+ * tipos de elemento, con las mismas N, P y motores: cada línea lleva el
+ * tipo tras el motor y una última columna con el rendimiento en GFLOP/s
+ * (GOP/s en enteros) calculado con la media. Cada tipo ocupa el principio
+ * de la zona de cada matriz en la región reservada para double.
+ *
+ * Con `--batch B` (mmLote.c) cada configuración multiplica un lote de B
+ * productos N×N independientes y los tiempos son los del lote completo;
+ * la última columna es el rendimiento del lote en GFLOP/s. La región se
+ * reserva para B productos del mayor N.
+ *
+ * Con `--density d[,perfil]` (mmDispersa.c) A tiene una fracción d de no
+ * ceros: los motores densos la multiplican con sus ceros y `dispersa` la
+ * comprime a CSR en su primera multiplicación, fuera del tiempo medido.
+ * Con `-v` cada configuración muestra los GFLOP/s útiles (2·nnz·N).
+ *
+ * Los motores `strassen` (mmStrassenOpenMP.c), `summa`
+ * (mmSummaProcesos.c) y `dispersa` (mmDispersaOpenMP.c) solo multiplican
+ * una matriz cuadrada de double: con
+ * `--shape`, `--pad`, `--type` o `--batch` la lista "todos" los omite y
+ * pedirlos con `--engine` es un error. Strassen reserva su arena en
+ * `iniciar()`, así que el tiempo medido no incluye esa reserva; SUMMA crea
+ * allí sus sockets y sus procesos escriben C en la región compartida.
+ *
+ * Con `-a` los motores fijan sus hilos, pero A y C quedan ubicadas por el
+ * primer toque de la inicialización común, no por los hilos de cada motor.
+ * Los hilos de OpenMP y los del pool de Pthreads coexisten en el proceso;
+ * entre motores los de OpenMP quedan dormidos tras su espera activa
+ * (OMP_WAIT_POLICY / GOMP_SPINCOUNT), que puede afectar a la primera
+ * medición del motor siguiente con `-r` pequeño.
+ *
+ * ---------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <omp.h>
+#include "mmComun.h"
+#include "mmReparto.h"
+#include "mmAleatorio.h"
+#include "mmVerifica.h"
+#include "mmTiempo.h"
+#include "mmContadores.h"
+#include "mmMemoria.h"
+#include "mmForma.h"
+#include "mmTipo.h"
+#include "mmLote.h"
+#include "mmDispersa.h"
+#include "mmMotor.h"
+
+/* Máximo de valores en las listas de N y de P */
+#define MM_MAX_LISTA 32
+
+/* Motores disponibles, en el orden en que se ejecutan con "todos" */
+static const struct motor *const motores[] = { &motorFork, &motorPosix, &motorOpenMP, &motorFilas,
+                                                &motorStrassen, &motorSumma, &motorDispersa };
+#define MM_MOTORES ((int) (sizeof(motores) / sizeof(motores[0])))
+
+/*-----------------------------------------------------------------------------
+ * leeLista — Interpreta una lista de enteros positivos separados por comas.
+ *
+ * Parámetros:
+ *  - texto: lista ("600,1200,2400").
+ *  - valores: destino, con capacidad para MM_MAX_LISTA valores.
+ *
+ * Retorna el número de valores leídos, o -1 si alguno no es un entero
+ * positivo o la lista es demasiado larga.
+ *---------------------------------------------------------------------------*/
+static int leeLista(const char *texto, int *valores) {
+	int n = 0;
+	const char *p = texto;
+	char *fin;
+
+	while (*p != '\0') {
+		long v = strtol(p, &fin, 10);
+		if (fin == p || v <= 0 || v > INT_MAX || n == MM_MAX_LISTA || (*fin != ',' && *fin != '\0'))
+			return -1;
+		valores[n++] = (int) v;
+		p = (*fin == ',') ? fin + 1 : fin;
+	}
+	return n;
+}
+
+/*-----------------------------------------------------------------------------
+ * eligeMotores — Traduce `--engine` a la lista de motores a ejecutar.
+ *
+ * Parámetros:
+ *  - op: opciones; con `--shape`, `--pad`, `--type` o `--batch` "todos"
+ *        omite los motores que no los admiten (campo `general`).
+ *  - elegidos: destino, con capacidad para MM_MOTORES motores.
+ *
+ * Retorna el número de motores elegidos, o -1 si algún nombre no existe o
+ * no admite las opciones pedidas.
+ *---------------------------------------------------------------------------*/
+static int eligeMotores(const struct opciones *op, const struct motor **elegidos) {
+	const char *texto = op->motores;
+	int general = formaGeneral(op) || op->tipos != NULL || op->lote > 0;
+	char copia[128], *nombre, *resto;
+	int n = 0;
+
+	if (texto == NULL || strcmp(texto, "todos") == 0) {
+		for (int m = 0; m < MM_MOTORES; m++)
+			if (motores[m]->general || !general)
+				elegidos[n++] = motores[m];
+		return n;
+	}
+
+	snprintf(copia, sizeof(copia), "%s", texto);
+	for (nombre = strtok_r(copia, ",", &resto); nombre != NULL; nombre = strtok_r(NULL, ",", &resto)) {
+		int m = 0;
+		while (m < MM_MOTORES && strcmp(nombre, motores[m]->nombre) != 0)
+			m++;
+		if (m == MM_MOTORES || n == MM_MOTORES) {
+			fprintf(stderr, "Motor '%s' desconocido (fork, posix, openmp, filas, strassen, summa, dispersa o todos)\n", nombre);
+			return -1;
+		}
+		if (general && !motores[m]->general) {
+			fprintf(stderr, "El motor %s no admite --shape, --pad, --type ni --batch\n", nombre);
+			return -1;
+		}
+		elegidos[n++] = motores[m];
+	}
+	return n;
+}
+
+/*-----------------------------------------------------------------------------
+ * preparaMatrices — Inicializa A y B para la dimensión N y toca C.
+ *
+ * Descripción:
+ *  Los hilos de OpenMP llenan franjas de filas con el generador por contador
+ *  (mmAleatorio.c), así que A y B son idénticas a las de los ejecutables
+ *  separados con la misma semilla. C se pone a cero para que sus páginas
+ *  existan antes de la primera medición. El producto general se inicializa
+ *  en serie con `iniForma()`, como en los ejecutables separados. Con
+ *  `--type` las matrices se llenan con elementos del tipo en curso, con
+ *  `--batch` se reparten entre los hilos los productos del lote y con
+ *  `--density` A se llena con `iniDispersaFilas()`.
+ *---------------------------------------------------------------------------*/
+static void preparaMatrices(const struct opciones *op, double *mA, double *mB, double *mC, int N) {
+	int tam = franjaFilas(op);
+
+	if (op->lote > 0) {
+		#pragma omp parallel
+		{
+			int ini, fin;
+
+			rangoEstatico(op->lote, omp_get_num_threads(), omp_get_thread_num(), &ini, &fin);
+			iniLote(mA, mB, N, ini, fin, op->semilla);
+			memset(mC + (size_t) ini * N * N, 0, (size_t) (fin - ini) * N * N * sizeof(double));
+		}
+		return;
+	}
+
+	if (op->tipo != MM_TIPO_NINGUNO) {
+		size_t bytesC = bytesResultado(op->tipo);
+
+		#pragma omp parallel for schedule(static)
+		for (int ii = 0; ii < N; ii += tam) {
+			int iF = (ii + tam < N) ? ii + tam : N;
+			iniTipoFilas(op->tipo, mA, mB, N, ii, iF, op->semilla);
+			memset((char *) mC + (size_t) ii * N * bytesC, 0, (size_t) (iF - ii) * N * bytesC);
+		}
+		return;
+	}
+
+	if (formaGeneral(op)) {
+		struct forma f;
+
+		formaDe(op, &f);
+		iniForma(&f, mA, mB, mC, op->semilla);
+		return;
+	}
+
+	#pragma omp parallel for schedule(static)
+	for (int ii = 0; ii < N; ii += tam) {
+		int iF = (ii + tam < N) ? ii + tam : N;
+		if (op->densidad > 0.0)
+			iniDispersaFilas(mA, mB, N, ii, iF, op->densidad, op->perfilDensidad, op->semilla);
+		else
+			iniMatrixFilas(mA, mB, N, ii, iF, op->semilla);
+		memset(mC + (size_t) ii * N, 0, (size_t) (iF - ii) * N * sizeof(double));
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * ejecutaMotor — Mide una configuración (motor, N, P) y escribe su línea.
+ *
+ * Parámetros:
+ *  - mt: motor a ejecutar.
+ *  - op: opciones con N y P de la configuración.
+ *  - mA, mB, mC: matrices ya preparadas para N (con la forma de
+ *                `formaDe()` si se pidió `--shape`).
+ *
+ * Descripción:
+ *  Inicia el motor, ejecuta las R multiplicaciones (`-r`, 1 por defecto) y
+ *  lo termina. Con `--verify` borra C antes y la comprueba después; con
+ *  `--timing` escribe en stderr las fases y los trabajadores de la
+ *  configuración; con `--type` la línea lleva el tipo y su rendimiento, y
+ *  con `--batch` el rendimiento del lote; con `--density` y `-v`, el
+ *  rendimiento útil.
+ *  Retorna 1 si la verificación falla y 0 en otro caso.
+ *---------------------------------------------------------------------------*/
+static int ejecutaMotor(const struct motor *mt, const struct opciones *op,
+                        const double *mA, const double *mB, double *mC) {
+	int N = op->N;
+	int reps = (op->repeticiones > 0) ? op->repeticiones : 1;
+	struct medicion tiempos;
+	struct contadores contadores;
+	struct forma f;
+
+	formaDe(op, &f);
+	double flops = (op->lote > 0) ? flopsForma(&f) * op->lote : flopsForma(&f);
+
+	/* Con --density los motores densos hacen los 2·N³ FLOP, pero el motor
+	 * dispersa solo los 2·nnz·N útiles */
+	size_t nnz = (op->densidad > 0.0) ? cuentaNoCeros(mA, (size_t) N * N) : 0;
+	if (mt == &motorDispersa && op->densidad > 0.0)
+		flops = 2.0 * (double) nnz * N;
+
+	if (iniMedicion(&tiempos, op->P) != 0) {
+		perror("Error al reservar las marcas de tiempo");
+		exit(1);
+	}
+	if (op->contadores) {
+		if (iniContadores(&contadores, op->P) != 0) {
+			perror("Error al reservar los contadores");
+			exit(1);
+		}
+		tiempos.cont = &contadores;
+	}
+
+	/* C viene de la configuración anterior: se borra para que `--verify` no
+	 * dé por buena una C que este motor no escribió */
+	if (op->verifica && op->lote > 0)
+		memset(mC, 0, (size_t) op->lote * N * N * sizeof(double));
+	else if (op->verifica)
+		memset(mC, 0, (size_t) f.M * f.ldc * (op->tipo != MM_TIPO_NINGUNO ? bytesResultado(op->tipo) : sizeof(double)));
+
+	if (mt->iniciar(op, &tiempos) != 0) {
+		fprintf(stderr, "Error al iniciar el motor %s con P=%d\n", mt->nombre, op->P);
+		exit(1);
+	}
+
+	double suma = 0.0, minimo = 0.0, maximo = 0.0;
+	for (int r = 0; r < reps; r++) {
+		double t = mt->multiplicar(op, mA, mB, mC);
+
+		suma += t;
+		if (r == 0 || t < minimo) minimo = t;
+		if (r == 0 || t > maximo) maximo = t;
+	}
+	mt->terminar(op);
+
+	const struct fase *trans = &tiempos.fase[MM_FASE_TRANSPOSICION];
+	printf("%-8s ", mt->nombre);
+	if (op->tipos != NULL)
+		printf("%-4s ", nombreTipo(op->tipo));
+	printf("%6d %3d %9.0f %9.0f %9.0f %9.0f ", N, op->P, suma / reps, minimo, maximo,
+	       trans->veces > 0 ? trans->total / trans->veces : 0.0);
+	if (op->tipos != NULL || op->lote > 0)
+		printf("%8.2f ", suma > 0.0 ? flops * reps / (suma * 1e3) : 0.0);
+	if (op->contadores)
+		columnasContadores(&contadores, flops * reps, suma, stdout);
+	printf("\n");
+	fflush(stdout);
+
+	int fallo = 0;
+	if (op->verifica && op->lote > 0)
+		fallo = verificaLote(mA, mB, mC, N, op->lote, (size_t) N * N, op->semilla, stderr);
+	else if (op->verifica && op->tipo != MM_TIPO_NINGUNO)
+		fallo = verificaTipo(op->tipo, mA, mB, mC, N, op->semilla, stderr);
+	else if (op->verifica)
+		fallo = verificaForma(&f, mA, mB, mC, op->semilla, stderr);
+
+	if (op->informe && op->lote > 0)
+		informeLote(op, suma, reps, stderr);
+	else if (op->informe && op->tipo != MM_TIPO_NINGUNO)
+		informeTipo(op->tipo, N, suma, reps, stderr);
+	else if (op->informe && formaGeneral(op)) {
+		struct particion plan;
+
+		planifica(&plan, &f, op->P);
+		informeParticion(&plan, stderr);
+		informeForma(&f, suma, reps, stderr);
+	} else if (op->informe && op->densidad > 0.0)
+		informeDispersa(op, nnz, suma, reps, stderr);
+	else if (op->informe)
+		informeHuella(N, trans->veces > 0 ? 4 : 3, suma, reps, stderr);
+	escribeMedicion(&tiempos, op->formatoTiempo, mt->nombre, N, stderr);
+	if (op->contadores) {
+		informeContadores(&contadores, op->informe, stderr);
+		liberaContadores(&contadores);
+	}
+	finMedicion(&tiempos);
+	return fallo;
+}
+
+/*-----------------------------------------------------------------------------
+ * main — Función principal del binario único.
+ *
+ * Descripción:
+ *  1. Lee las opciones comunes, las listas de N y P y los motores.
+ *  2. Reserva una sola región compartida para A, B y C del mayor N.
+ *  3. Para cada N (y cada tipo de `--type`) prepara las matrices (fuera de
+ *     toda medición) y ejecuta cada motor con cada P.
+ *  4. Termina con código 1 si alguna verificación falló.
+ *---------------------------------------------------------------------------*/
+int main(int argc, char *argv[]) {
+	struct opciones op;
+	int listaN[MM_MAX_LISTA], listaP[MM_MAX_LISTA], listaTipos[MM_MAX_TIPOS] = { MM_TIPO_NINGUNO };
+	const struct motor *elegidos[MM_MOTORES];
+
+	leerOpciones(argc, argv, "./mm", &op);
+
+	int nN = leeLista(op.listaN, listaN);
+	int nP = leeLista(op.listaP, listaP);
+	if (nN < 0 || nP < 0) {
+		fprintf(stderr, "N y P deben ser enteros positivos separados por comas (máx. %d)\n", MM_MAX_LISTA);
+		exit(1);
+	}
+	int nTipos = (op.tipos != NULL) ? leeTipos(op.tipos, listaTipos) : 1;
+	int nMotores = eligeMotores(&op, elegidos);
+	if (nMotores < 0)
+		exit(1);
+	if (op.privada) {
+		fprintf(stderr, "-p no aplica a mm: las matrices están siempre en memoria compartida\n");
+		exit(1);
+	}
+	if (op.archivos[0] != NULL) {
+		fprintf(stderr, "--files y --budget son de los programas separados: mm recorre listas de N "
+		        "sobre matrices en memoria\n");
+		exit(1);
+	}
+
+	int maxN = 0;
+	for (int i = 0; i < nN; i++)
+		if (listaN[i] > maxN) maxN = listaN[i];
+
+	/* La forma del mayor N es la de mayor huella (M y K no dependen de N) */
+	struct forma f;
+
+	op.N = maxN;
+	formaDe(&op, &f);
+	if (op.lote > 0 ? compruebaLote(maxN, op.lote, stderr) != 0
+	    : formaGeneral(&op) ? compruebaForma(&f, stderr) != 0 : compruebaHuella(maxN, 3, stderr) != 0)
+		exit(1);
+	for (int t = 0; t < nTipos; t++)
+		if (listaTipos[t] != MM_TIPO_NINGUNO && compruebaTipo(listaTipos[t], maxN, stderr) != 0)
+			exit(1);
+
+	size_t elems = (op.lote > 0) ? 3 * elemsLote(maxN, op.lote) : huellaForma(&f) / sizeof(double);
+	double *region = reservaMatriz(elems, op.paginas, 1, op.precarga);
+	if (region == NULL) {
+		perror("Error al reservar memoria para las matrices");
+		exit(1);
+	}
+
+	int fallo = 0;
+	if (formaGeneral(&op))
+		printf("# forma: M=%d K=%d relleno=%d (C M×N = A M×K · B K×N)\n", f.M, f.K, op.relleno);
+	if (op.lote > 0)
+		printf("# lote: %d productos N×N por configuración\n", op.lote);
+	if (op.densidad > 0.0)
+		printf("# densidad de A: %g (%s)\n", op.densidad, nombrePerfil(op.perfilDensidad));
+	if (op.tipos != NULL)
+		printf("# motor    tipo      N   P  media_us    min_us    max_us  trans_us   gop_s\n");
+	else if (op.lote > 0)
+		printf("# motor        N   P  media_us    min_us    max_us  trans_us  gflop_s\n");
+	else
+		printf("# motor        N   P  media_us    min_us    max_us  trans_us\n");
+	for (int i = 0; i < nN; i++) {
+		int N = listaN[i];
+
+		op.N = N;
+		formaDe(&op, &f);
+
+		double *matA = region;
+		double *matB = matA + elemsAlineados((size_t) f.M * f.lda);
+		double *matC = matB + elemsAlineados((size_t) f.K * f.ldb);
+
+		if (op.lote > 0) {
+			matB = matA + elemsLote(N, op.lote);
+			matC = matB + elemsLote(N, op.lote);
+		}
+
+		for (int t = 0; t < nTipos; t++) {
+			op.tipo = listaTipos[t];
+			preparaMatrices(&op, matA, matB, matC, N);
+
+			for (int m = 0; m < nMotores; m++)
+				for (int j = 0; j < nP; j++) {
+					op.P = listaP[j];
+					fallo |= ejecutaMotor(elegidos[m], &op, matA, matB, matC);
+				}
+		}
+	}
+
+	if (op.informe)
+		informeMemoria("A|B|C", region, stderr);
+	liberaMatriz(region, elems, op.paginas);
+	return fallo;
+}
@@ -0,0 +1,282 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * Descripción general:
+ * ---------------------------------------------------------------
+ * Afinidad de hilos y ubicación NUMA.
+ *
+ * Las versiones originales no fijan los hilos y reservan A, B y C con
+ * `calloc` desde el hilo principal, que además las inicializa: con la
+ * política de primer toque de Linux todas las páginas quedan en el nodo
+ * del hilo principal y, en equipos de dos sockets, los hilos del otro nodo
+ * leen todo por la interconexión. Este módulo:
+ *  1. Arma un plan hilo → CPU (compacto o disperso entre nodos) a partir de
+ *     las CPUs permitidas al proceso y de /sys/devices/system/cpu/cpuN/nodeM.
+ *  2. Fija cada hilo con `pthread_setaffinity_np()` (equivalente a
+ *     OMP_PLACES=cores con OMP_PROC_BIND=close/spread).
+ *  3. Ofrece `tocaFilas()` y `tocaTesela()` para que cada hilo escriba
+ *     primero sus franjas (o teselas) de A y C antes de la inicialización. `calloc` de bloques grandes
+ *     entrega páginas nuevas de `mmap` que aún no existen físicamente, así
+ *     que la página queda en el nodo del hilo que la toca primero.
+ *  4. Opcionalmente crea una réplica de B por nodo, copiada por el primer
+ *     hilo de ese nodo (que por primer toque la ubica localmente).
+ *
+ * No depende de libnuma: en equipos de un solo nodo todo se degrada a una
+ * única réplica y a la simple fijación de hilos.
+ *
+ * ---------------------------------------------------------------
+ */
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "mmAfinidad.h"
+
+/* Nodo NUMA del hilo que llama; lo fija `fijaHiloActual()` */
+static __thread int nodoHilo = 0;
+
+/* CPUs permitidas al proceso antes de fijar hilos; las restaura
+ * `sueltaHiloActual()` */
+static cpu_set_t permitidasOriginal;
+static int hayOriginal = 0;
+
+/*-----------------------------------------------------------------------------
+ * afinidadPorNombre — Traduce el argumento de `-a` a una política.
+ *
+ * Retorna -1 si el nombre no corresponde a ninguna política.
+ *---------------------------------------------------------------------------*/
+int afinidadPorNombre(const char *nombre) {
+	if (strcmp(nombre, "compacto") == 0) return MM_AFIN_COMPACTA;
+	if (strcmp(nombre, "disperso") == 0) return MM_AFIN_DISPERSA;
+	return -1;
+}
+
+/*-----------------------------------------------------------------------------
+ * nodoDeCPU — Nodo NUMA de una CPU según sysfs (0 si no hay información).
+ *---------------------------------------------------------------------------*/
+static int nodoDeCPU(int cpu) {
+	char ruta[96];
+
+	for (int n = 0; n < 1024; n++) {
+		snprintf(ruta, sizeof(ruta), "/sys/devices/system/cpu/cpu%d/node%d", cpu, n);
+		if (access(ruta, F_OK) == 0)
+			return n;
+	}
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * iniAfinidad — Arma el plan de CPUs y nodos para `nH` hilos.
+ *
+ * Descripción:
+ *  Se parte de las CPUs permitidas al proceso (`sched_getaffinity`), de modo
+ *  que se respetan taskset/cgroups. Con la política compacta el hilo i va a
+ *  la i-ésima CPU permitida; con la dispersa las CPUs se ordenan tomando una
+ *  de cada nodo por turnos. Si hay más hilos que CPUs el plan da la vuelta.
+ *  Retorna 0 si todo fue bien y -1 si falla la reserva de memoria.
+ *---------------------------------------------------------------------------*/
+int iniAfinidad(struct afinidad *af, int politica, int nH) {
+	cpu_set_t permitidas;
+	int nCPU = 0, *lista, *nodoLista, *orden;
+
+	memset(af, 0, sizeof(*af));
+	af->politica = politica;
+	af->nH = nH;
+	af->cpu = calloc(nH, sizeof(int));
+	af->nodo = calloc(nH, sizeof(int));
+	af->cpuReal = calloc(nH, sizeof(int));
+	lista = calloc(CPU_SETSIZE, sizeof(int));
+	nodoLista = calloc(CPU_SETSIZE, sizeof(int));
+	orden = calloc(CPU_SETSIZE, sizeof(int));
+	if (!af->cpu || !af->nodo || !af->cpuReal || !lista || !nodoLista || !orden)
+		return -1;
+
+	sched_getaffinity(0, sizeof(permitidas), &permitidas);
+	if (!hayOriginal) {
+		permitidasOriginal = permitidas;
+		hayOriginal = 1;
+	}
+	for (int c = 0; c < CPU_SETSIZE; c++)
+		if (CPU_ISSET(c, &permitidas)) {
+			lista[nCPU] = c;
+			nodoLista[nCPU] = nodoDeCPU(c);
+			if (nodoLista[nCPU] + 1 > af->nNodos)
+				af->nNodos = nodoLista[nCPU] + 1;
+			nCPU++;
+		}
+
+	if (politica == MM_AFIN_DISPERSA) {
+		/* una CPU de cada nodo por turnos: nodo 0, nodo 1, ..., nodo 0, ... */
+		int usados = 0;
+		char *tomada = calloc(nCPU, 1);
+		while (usados < nCPU)
+			for (int n = 0; n < af->nNodos; n++)
+				for (int i = 0; i < nCPU; i++)
+					if (!tomada[i] && nodoLista[i] == n) {
+						tomada[i] = 1;
+						orden[usados++] = i;
+						break;
+					}
+		free(tomada);
+	} else {
+		for (int i = 0; i < nCPU; i++)
+			orden[i] = i;
+	}
+
+	for (int h = 0; h < nH; h++) {
+		int i = orden[h % nCPU];
+		af->cpu[h] = lista[i];
+		af->nodo[h] = nodoLista[i];
+		af->cpuReal[h] = -1;
+	}
+
+	af->replica = calloc(af->nNodos, sizeof(double *));
+	free(lista);
+	free(nodoLista);
+	free(orden);
+	return (af->replica != NULL) ? 0 : -1;
+}
+
+/*-----------------------------------------------------------------------------
+ * fijaHiloActual — Fija el hilo que llama a la CPU planificada para `idH`.
+ *
+ * Descripción:
+ *  Registra además el nodo del hilo (para `matrizLocal()`) y la CPU en la
+ *  que efectivamente se ejecuta, que luego muestra `informeAfinidad()`.
+ *  Retorna el código de `pthread_setaffinity_np()` (0 si tuvo éxito).
+ *---------------------------------------------------------------------------*/
+int fijaHiloActual(struct afinidad *af, int idH) {
+	cpu_set_t conjunto;
+	int rc;
+
+	CPU_ZERO(&conjunto);
+	CPU_SET(af->cpu[idH], &conjunto);
+	rc = pthread_setaffinity_np(pthread_self(), sizeof(conjunto), &conjunto);
+
+	nodoHilo = af->nodo[idH];
+	af->cpuReal[idH] = sched_getcpu();
+	return rc;
+}
+
+/*-----------------------------------------------------------------------------
+ * sueltaHiloActual — Deshace `fijaHiloActual()` en el hilo que llama.
+ *
+ * Descripción:
+ *  Devuelve al hilo las CPUs que tenía el proceso en el primer
+ *  `iniAfinidad()` y lo asocia de nuevo al nodo 0. Lo usa el binario único
+ *  `mm`, que ejecuta varios motores en el mismo proceso y no debe heredar
+ *  la fijación de uno al siguiente (los hijos de Fork, por ejemplo).
+ *---------------------------------------------------------------------------*/
+void sueltaHiloActual(void) {
+	nodoHilo = 0;
+	if (hayOriginal)
+		pthread_setaffinity_np(pthread_self(), sizeof(permitidasOriginal), &permitidasOriginal);
+}
+
+/*-----------------------------------------------------------------------------
+ * tocaFilas — Primer toque de las filas [filaI, filaF) de una matriz D×D.
+ *
+ * Descripción:
+ *  Escribe ceros sobre el rango; si las páginas aún no existían, el kernel
+ *  las crea en el nodo NUMA del hilo que llama.
+ *---------------------------------------------------------------------------*/
+void tocaFilas(double *m, int D, int filaI, int filaF) {
+	if (filaF > filaI)
+		memset(m + (size_t) filaI * D, 0, (size_t) (filaF - filaI) * D * sizeof(double));
+}
+
+/*-----------------------------------------------------------------------------
+ * tocaTesela — Primer toque de la tesela [filaI, filaF) × [colI, colF) de
+ * una matriz D×D.
+ *
+ * Descripción:
+ *  Como `tocaFilas()`, fila a fila de la tesela. La ubicación es por
+ *  página: una página compartida por teselas de hilos distintos queda en
+ *  el nodo del primero que la toca.
+ *---------------------------------------------------------------------------*/
+void tocaTesela(double *m, int D, int filaI, int filaF, int colI, int colF) {
+	if (colF <= colI)
+		return;
+	for (int i = filaI; i < filaF; i++)
+		memset(m + (size_t) i * D + colI, 0, (size_t) (colF - colI) * sizeof(double));
+}
+
+/*-----------------------------------------------------------------------------
+ * reservaReplicas — Reserva (sin tocar) una réplica de B por nodo NUMA.
+ *
+ * Descripción:
+ *  Las réplicas se reservan con `mmap` anónimo, sin escribirlas, para que
+ *  `copiaReplica()` las ubique por primer toque. Retorna -1 si falla.
+ *---------------------------------------------------------------------------*/
+int reservaReplicas(struct afinidad *af, const double *mB, size_t elems) {
+	af->original = mB;
+	af->elems = elems;
+
+	for (int n = 0; n < af->nNodos; n++) {
+		void *r = mmap(NULL, elems * sizeof(double), PROT_READ | PROT_WRITE,
+		               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (r == MAP_FAILED)
+			return -1;
+		af->replica[n] = (double *) r;
+	}
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * copiaReplica — Copia B a la réplica de su nodo si `idH` es el primer hilo
+ * de ese nodo.
+ *
+ * Descripción:
+ *  Debe llamarse desde cada hilo ya fijado, después de que B tenga sus
+ *  valores definitivos. Los demás hilos del nodo no hacen nada.
+ *---------------------------------------------------------------------------*/
+void copiaReplica(struct afinidad *af, int idH) {
+	int n = af->nodo[idH];
+
+	if (af->replica == NULL || af->replica[n] == NULL)
+		return;
+	for (int h = 0; h < idH; h++)
+		if (af->nodo[h] == n)
+			return;
+	memcpy(af->replica[n], af->original, af->elems * sizeof(double));
+}
+
+/*-----------------------------------------------------------------------------
+ * matrizLocal — Réplica de `m` en el nodo del hilo que llama.
+ *
+ * Retorna `m` si no hay réplicas o si `m` no es la matriz replicada.
+ *---------------------------------------------------------------------------*/
+const double *matrizLocal(const struct afinidad *af, const double *m) {
+	if (af == NULL || af->replica == NULL || m != af->original || af->replica[nodoHilo] == NULL)
+		return m;
+	return af->replica[nodoHilo];
+}
+
+/*-----------------------------------------------------------------------------
+ * informeAfinidad — Muestra el plan hilo → CPU → nodo y la CPU observada.
+ *---------------------------------------------------------------------------*/
+void informeAfinidad(const struct afinidad *af, FILE *f) {
+	fprintf(f, "# afinidad: %s, %d nodo(s) NUMA, réplicas de B: %s\n",
+	        af->politica == MM_AFIN_DISPERSA ? "disperso" : "compacto", af->nNodos,
+	        af->original ? "sí" : "no");
+	fprintf(f, "# hilo cpu nodo cpu_observada\n");
+	for (int h = 0; h < af->nH; h++)
+		fprintf(f, "%d %d %d %d\n", h, af->cpu[h], af->nodo[h], af->cpuReal[h]);
+}
+
+/*-----------------------------------------------------------------------------
+ * finAfinidad — Libera el plan y las réplicas.
+ *---------------------------------------------------------------------------*/
+void finAfinidad(struct afinidad *af) {
+	for (int n = 0; af->replica && n < af->nNodos; n++)
+		if (af->replica[n])
+			munmap(af->replica[n], af->elems * sizeof(double));
+	free(af->replica);
+	free(af->cpu);
+	free(af->nodo);
+	free(af->cpuReal);
+}
@@ -0,0 +1,59 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * mmAfinidad.h — Afinidad de hilos y ubicación NUMA de las matrices para las
+ * versiones con hilos (Pthreads, OpenMP clásica y OpenMP por filas).
+ *
+ * Con `-a` cada hilo se fija a una CPU, toca primero (first touch) sus
+ * franjas de A y C para que el kernel las ubique en su nodo, y opcionalmente
+ * trabaja con una réplica de B propia de su nodo NUMA.
+ */
+
+#ifndef MM_AFINIDAD_H
+#define MM_AFINIDAD_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+#define MM_AFIN_NINGUNA   0
+#define MM_AFIN_COMPACTA  1   /* hilos consecutivos en CPUs consecutivas    */
+#define MM_AFIN_DISPERSA  2   /* hilos repartidos por turnos entre nodos    */
+
+/*-----------------------------------------------------------------------------
+ * Plan de afinidad:
+ *  - politica: MM_AFIN_*.
+ *  - nH: número de hilos.
+ *  - cpu, nodo: CPU asignada a cada hilo y su nodo NUMA.
+ *  - cpuReal: CPU en la que se observó cada hilo tras fijarse (sched_getcpu).
+ *  - nNodos: número de nodos NUMA del equipo.
+ *  - original, replica, elems: B y sus copias por nodo (replica[n] = NULL si
+ *    no se replica).
+ *---------------------------------------------------------------------------*/
+struct afinidad {
+	int politica;
+	int nH;
+	int *cpu;
+	int *nodo;
+	int *cpuReal;
+	int nNodos;
+	const double *original;
+	double **replica;
+	size_t elems;
+};
+
+int afinidadPorNombre(const char *nombre);
+
+int iniAfinidad(struct afinidad *af, int politica, int nH);
+int fijaHiloActual(struct afinidad *af, int idH);
+void sueltaHiloActual(void);
+void tocaFilas(double *m, int D, int filaI, int filaF);
+void tocaTesela(double *m, int D, int filaI, int filaF, int colI, int colF);
+
+int reservaReplicas(struct afinidad *af, const double *mB, size_t elems);
+void copiaReplica(struct afinidad *af, int idH);
+const double *matrizLocal(const struct afinidad *af, const double *m);
+
+void informeAfinidad(const struct afinidad *af, FILE *f);
+void finAfinidad(struct afinidad *af);
+
+#endif
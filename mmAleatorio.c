@@ -0,0 +1,149 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * Descripción general:
+ * ---------------------------------------------------------------
+ * Generador pseudoaleatorio basado en contador para inicializar matrices.
+ *
+ * Las versiones originales llenaban A y B en serie con `rand()`, sembrado con
+ * `srand(time(NULL))` (la versión Pthreads ni siquiera lo sembraba). `rand()`
+ * tiene estado global, de modo que no se puede paralelizar, y dos ejecuciones
+ * nunca multiplican las mismas matrices, lo que impide comparar resultados.
+ *
+ * Aquí el elemento i se obtiene aplicando la función de mezcla de SplitMix64
+ * a `semilla + (i + 1)·φ` (φ = 0x9E3779B97F4A7C15). La función es una
+ * biyección de 64 bits con buena avalancha, por lo que contadores
+ * consecutivos producen valores independientes a efectos prácticos, sin
+ * estado compartido: cada hilo llena su franja sin coordinarse con los demás.
+ *
+ * A y B usan semillas derivadas distintas de la semilla del usuario.
+ *
+ * ---------------------------------------------------------------
+ */
+
+#include <math.h>
+#include "mmAleatorio.h"
+
+#define MM_PHI  0x9E3779B97F4A7C15ULL
+
+/*-----------------------------------------------------------------------------
+ * mezcla — Función de finalización de SplitMix64.
+ *---------------------------------------------------------------------------*/
+static inline uint64_t mezcla(uint64_t z) {
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+/*-----------------------------------------------------------------------------
+ * aleatorioEn — Valor uniforme en [0, 1) para la posición `contador`.
+ *
+ * Descripción:
+ *  Se toman los 53 bits altos de la mezcla, que es la precisión de un double.
+ *---------------------------------------------------------------------------*/
+double aleatorioEn(uint64_t semilla, uint64_t contador) {
+	return (double) (mezcla(semilla + (contador + 1) * MM_PHI) >> 11) * 0x1.0p-53;
+}
+
+/*-----------------------------------------------------------------------------
+ * semillaMatriz — Semilla derivada de la del usuario para una matriz
+ * (`cual` = 0xA para A, 0xB para B), la misma que usa `iniMatrixFilas()`;
+ * permite llenar matrices de otros tipos (mmTipo.c) con la misma serie.
+ *---------------------------------------------------------------------------*/
+uint64_t semillaMatriz(uint64_t semilla, uint64_t cual) {
+	return mezcla(semilla ^ cual);
+}
+
+/*-----------------------------------------------------------------------------
+ * llenaAleatorio — Llena m[ini .. fin) con valores uniformes en [lo, hi).
+ *
+ * Descripción:
+ *  El elemento m[i] depende solo de `semilla` e `i`, así que el rango puede
+ *  ser cualquier trozo de la matriz y llenarse desde cualquier hilo.
+ *---------------------------------------------------------------------------*/
+void llenaAleatorio(double *m, size_t ini, size_t fin, uint64_t semilla, double lo, double hi) {
+	for (size_t i = ini; i < fin; i++)
+		m[i] = lo + aleatorioEn(semilla, i) * (hi - lo);
+}
+
+/*-----------------------------------------------------------------------------
+ * iniMatrixFilas — Inicializa las filas [filaI, filaF) de A y B.
+ *
+ * Parámetros:
+ *  - mA, mB: matrices D×D.
+ *  - D: dimensión.
+ *  - filaI, filaF: rango de filas a llenar.
+ *  - semilla: semilla del usuario (`--seed`).
+ *
+ * Descripción:
+ *  A recibe valores en [MM_A_MIN, MM_A_MAX) y B en [MM_B_MIN, MM_B_MAX),
+ *  los rangos que documentaban las versiones originales.
+ *---------------------------------------------------------------------------*/
+void iniMatrixFilas(double *mA, double *mB, int D, int filaI, int filaF, uint64_t semilla) {
+	size_t ini = (size_t) filaI * D, fin = (size_t) filaF * D;
+
+	llenaAleatorio(mA, ini, fin, semillaMatriz(semilla, 0xA), MM_A_MIN, MM_A_MAX);
+	llenaAleatorio(mB, ini, fin, semillaMatriz(semilla, 0xB), MM_B_MIN, MM_B_MAX);
+}
+
+/*-----------------------------------------------------------------------------
+ * iniMatrixTesela — Inicializa la tesela [filaI, filaF) × [colI, colF) de
+ * A y de B.
+ *
+ * Descripción:
+ *  Los mismos valores que `iniMatrixFilas()`, para los programas que
+ *  inicializan (y ubican por primer toque) con el reparto 2-D de la
+ *  multiplicación.
+ *---------------------------------------------------------------------------*/
+void iniMatrixTesela(double *mA, double *mB, int D, int filaI, int filaF, int colI, int colF,
+                     uint64_t semilla) {
+	uint64_t sA = semillaMatriz(semilla, 0xA), sB = semillaMatriz(semilla, 0xB);
+
+	for (int i = filaI; i < filaF; i++) {
+		size_t ini = (size_t) i * D + colI, fin = (size_t) i * D + colF;
+
+		llenaAleatorio(mA, ini, fin, sA, MM_A_MIN, MM_A_MAX);
+		llenaAleatorio(mB, ini, fin, sB, MM_B_MIN, MM_B_MAX);
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * llenaFilas — Llena las filas [filaI, filaF) de una matriz con salto `ld`.
+ *
+ * Parámetros:
+ *  - m: matriz por filas de `cols` columnas útiles y salto `ld` ≥ cols.
+ *  - semilla, lo, hi: igual que en `llenaAleatorio()`.
+ *
+ * Descripción:
+ *  El elemento (i, j) recibe el valor de la posición lógica i·cols + j, de
+ *  modo que el contenido no depende del relleno: con ld = cols coincide con
+ *  `llenaAleatorio()`. El relleno [cols, ld) de cada fila se llena con NaN,
+ *  así que un kernel que lea fuera de la fila contamina C y `--verify` lo
+ *  detecta.
+ *---------------------------------------------------------------------------*/
+void llenaFilas(double *m, int cols, int ld, int filaI, int filaF, uint64_t semilla, double lo, double hi) {
+	for (int i = filaI; i < filaF; i++) {
+		double *fila = m + (size_t) i * ld;
+		uint64_t base = (uint64_t) i * cols;
+
+		for (int j = 0; j < cols; j++)
+			fila[j] = lo + aleatorioEn(semilla, base + j) * (hi - lo);
+		for (int j = cols; j < ld; j++)
+			fila[j] = NAN;
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * iniFormaFilas — Inicializa las filas [filaI, filaF) de A (M×K) y B (K×N)
+ * del producto general (`--shape`, ver mmForma.h).
+ *
+ * Descripción:
+ *  Cada matriz llena solo las filas del rango que tiene (A hasta M, B hasta
+ *  K). Con M = N = K y sin relleno el resultado es idéntico al de
+ *  `iniMatrixFilas()`.
+ *---------------------------------------------------------------------------*/
+void iniFormaFilas(double *mA, double *mB, int M, int N, int K, int lda, int ldb,
+                   int filaI, int filaF, uint64_t semilla) {
+	llenaFilas(mA, K, lda, filaI, (filaF < M) ? filaF : M, semillaMatriz(semilla, 0xA), MM_A_MIN, MM_A_MAX);
+	llenaFilas(mB, N, ldb, filaI, (filaF < K) ? filaF : K, semillaMatriz(semilla, 0xB), MM_B_MIN, MM_B_MAX);
+}
@@ -0,0 +1,37 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * mmAleatorio.h — Inicialización reproducible y paralelizable de A y B con
+ * un generador basado en contador (SplitMix64).
+ *
+ * El valor de cada elemento depende solo de la semilla y de su posición, no
+ * del orden en que se calcula: cualquier reparto de filas entre hilos o
+ * procesos produce matrices idénticas bit a bit en todas las versiones.
+ */
+
+#ifndef MM_ALEATORIO_H
+#define MM_ALEATORIO_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Semilla usada cuando no se indica --seed */
+#define MM_SEMILLA_DEFECTO  20251110ULL
+
+/* Rangos de los valores generados: A en [1, 5), B en [5, 9) */
+#define MM_A_MIN  1.0
+#define MM_A_MAX  5.0
+#define MM_B_MIN  5.0
+#define MM_B_MAX  9.0
+
+double aleatorioEn(uint64_t semilla, uint64_t contador);
+uint64_t semillaMatriz(uint64_t semilla, uint64_t cual);
+void llenaAleatorio(double *m, size_t ini, size_t fin, uint64_t semilla, double lo, double hi);
+void iniMatrixFilas(double *mA, double *mB, int D, int filaI, int filaF, uint64_t semilla);
+void iniMatrixTesela(double *mA, double *mB, int D, int filaI, int filaF, int colI, int colF,
+                     uint64_t semilla);
+void llenaFilas(double *m, int cols, int ld, int filaI, int filaF, uint64_t semilla, double lo, double hi);
+void iniFormaFilas(double *mA, double *mB, int M, int N, int K, int lda, int ldb,
+                   int filaI, int filaF, uint64_t semilla);
+
+#endif
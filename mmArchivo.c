@@ -0,0 +1,453 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * Descripción general:
+ * ---------------------------------------------------------------
+ * Matrices en archivos binarios proyectados en memoria (`--files A,B,C`).
+ *
+ * Formato: una cabecera (`struct cabeceraArchivo`) con la forma, el tipo de
+ * elemento, la disposición y el salto entre filas, y los datos desde el
+ * byte MM_ARCHIVO_DATOS. Que los datos empiecen en una página propia permite
+ * proyectar el archivo completo con `mmap` y usar `base + datos` como la
+ * matriz, alineada y sin copias; el salto de fila del archivo es el `lda`,
+ * `ldb` o `ldc` del producto (`--pad`). Solo se multiplican archivos f64
+ * por filas; los demás tipos y la disposición por columnas se reconocen y
+ * se rechazan con un mensaje claro.
+ *
+ * `ejecutaArchivo()` es el `main()` común de la ruta con archivos:
+ *  - A y B se abren si existen (su forma debe coincidir con la de N,
+ *    `--shape` y `--pad`) y si no se crean y se llenan con el generador de
+ *    mmAleatorio.c, de modo que la misma semilla da las mismas matrices
+ *    que en memoria. C se crea siempre de nuevo.
+ *  - Sin `--budget` el motor multiplica directamente sobre las
+ *    proyecciones (con `--prefault`, MAP_POPULATE las lee antes de medir);
+ *    los archivos deben caber en memoria.
+ *  - Con `--budget` el producto se recorre por paneles (mmExterno.c) y
+ *    los archivos pueden ser mayores que la memoria.
+ * Al generar una entrada se descartan de la proyección las filas ya
+ * escritas (MADV_DONTNEED, que en una proyección compartida de archivo no
+ * pierde datos), para que generar un archivo grande no ocupe su tamaño en
+ * memoria residente.
+ *
+ * ---------------------------------------------------------------
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "mmArchivo.h"
+#include "mmExterno.h"
+#include "mmForma.h"
+#include "mmTipo.h"
+#include "mmAleatorio.h"
+#include "mmVerifica.h"
+#include "mmTiempo.h"
+#include "mmContadores.h"
+#include "mmMemoria.h"
+#include "mmMotor.h"
+
+/* Bytes que se generan antes de descartar las filas escritas */
+#define MM_ARCHIVO_TROZO  (64UL * 1024 * 1024)
+
+/*-----------------------------------------------------------------------------
+ * leeArchivos — Interpreta el argumento de `--files` ("A,B,C").
+ *
+ * Descripción:
+ *  Separa las tres rutas en el propio texto (cambia las comas por '\0').
+ *  Retorna 0 si hay exactamente tres rutas no vacías; -1 en otro caso.
+ *---------------------------------------------------------------------------*/
+int leeArchivos(char *texto, const char *rutas[3]) {
+	char *p = texto;
+
+	for (int i = 0; i < 3; i++) {
+		char *coma = strchr(p, ',');
+
+		if ((i < 2) != (coma != NULL))
+			return -1;
+		if (coma != NULL)
+			*coma = '\0';
+		if (*p == '\0')
+			return -1;
+		rutas[i] = p;
+		p = coma + 1;
+	}
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * proyecta — Proyecta el archivo abierto en m->fd completo.
+ *
+ * Descripción:
+ *  Siempre MAP_SHARED: lo escrito en C llega al archivo y lo ven los hijos
+ *  de la versión Fork. Con `precarga`, MAP_POPULATE lee todas las páginas
+ *  antes de retornar. Deja `datos` apuntando al primer elemento.
+ *---------------------------------------------------------------------------*/
+static int proyecta(struct matrizArchivo *m, int escritura, int precarga, size_t datos) {
+	int prot = PROT_READ | (escritura ? PROT_WRITE : 0);
+	void *base = mmap(NULL, m->bytes, prot, MAP_SHARED | (precarga ? MAP_POPULATE : 0), m->fd, 0);
+
+	if (base == MAP_FAILED)
+		return -1;
+	m->base = base;
+	m->datos = (double *) (m->base + datos);
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * abreArchivo — Abre y proyecta una matriz existente.
+ *
+ * Parámetros:
+ *  - m: matriz a llenar.
+ *  - ruta: archivo.
+ *  - escritura: 1 → proyección de lectura y escritura.
+ *  - precarga: 1 → lee todas las páginas al proyectar (`--prefault`).
+ *  - f: destino de los mensajes de error.
+ *
+ * Descripción:
+ *  Valida la cabecera (identificación, versión, tipo f64, disposición por
+ *  filas, salto y tamaño del archivo) y retorna 0; -1 con el motivo en `f`
+ *  si el archivo no es una matriz que se pueda multiplicar.
+ *---------------------------------------------------------------------------*/
+int abreArchivo(struct matrizArchivo *m, const char *ruta, int escritura, int precarga, FILE *f) {
+	struct cabeceraArchivo cab;
+	struct stat st;
+
+	memset(m, 0, sizeof(*m));
+	m->ruta = ruta;
+	m->fd = open(ruta, escritura ? O_RDWR : O_RDONLY);
+	if (m->fd < 0 || fstat(m->fd, &st) != 0) {
+		fprintf(f, "%s: %s\n", ruta, strerror(errno));
+		goto error;
+	}
+	if (pread(m->fd, &cab, sizeof(cab), 0) != (ssize_t) sizeof(cab)
+	    || memcmp(cab.magia, MM_ARCHIVO_MAGIA, sizeof(cab.magia)) != 0) {
+		fprintf(f, "%s: no es un archivo de matriz (falta la cabecera %s)\n", ruta, MM_ARCHIVO_MAGIA);
+		goto error;
+	}
+	if (cab.version != MM_ARCHIVO_VERSION) {
+		fprintf(f, "%s: versión %u del formato; se esperaba %d\n", ruta, cab.version, MM_ARCHIVO_VERSION);
+		goto error;
+	}
+	if (cab.disposicion != MM_DISPOSICION_FILAS) {
+		fprintf(f, "%s: solo se multiplican matrices guardadas por filas\n", ruta);
+		goto error;
+	}
+	if (cab.tipo != MM_TIPO_F64 || cab.bytesElem != sizeof(double)) {
+		fprintf(f, "%s: elementos %s de %u bytes; solo se multiplican archivos f64\n", ruta,
+		        cab.tipo <= MM_TIPO_I8 ? nombreTipo((int) cab.tipo) : "desconocidos", cab.bytesElem);
+		goto error;
+	}
+	if (cab.filas == 0 || cab.cols == 0 || cab.filas > INT_MAX || cab.ld > INT_MAX || cab.ld < cab.cols
+	    || cab.datos < sizeof(cab) || cab.datos % MM_ALINEACION != 0
+	    || (uint64_t) st.st_size < cab.datos
+	    || ((uint64_t) st.st_size - cab.datos) / sizeof(double) / cab.ld < cab.filas) {
+		fprintf(f, "%s: cabecera incoherente con el tamaño del archivo (%llu×%llu, ld %llu, %lld bytes)\n",
+		        ruta, (unsigned long long) cab.filas, (unsigned long long) cab.cols,
+		        (unsigned long long) cab.ld, (long long) st.st_size);
+		goto error;
+	}
+
+	m->filas = (int) cab.filas;
+	m->cols = (int) cab.cols;
+	m->ld = (int) cab.ld;
+	m->bytes = (size_t) st.st_size;
+	if (proyecta(m, escritura, precarga, cab.datos) != 0) {
+		fprintf(f, "%s: mmap: %s\n", ruta, strerror(errno));
+		goto error;
+	}
+	return 0;
+
+error:
+	if (m->fd >= 0)
+		close(m->fd);
+	m->fd = -1;
+	return -1;
+}
+
+/*-----------------------------------------------------------------------------
+ * creaArchivo — Crea (o vacía) un archivo de filas×cols con salto `ld` y lo
+ * proyecta para lectura y escritura.
+ *
+ * Descripción:
+ *  Escribe la cabecera y fija el tamaño con `ftruncate()`: los datos quedan
+ *  en cero sin escribirlos (el archivo es disperso hasta que se llena).
+ *  Retorna 0; -1 con el motivo en `f`.
+ *---------------------------------------------------------------------------*/
+int creaArchivo(struct matrizArchivo *m, const char *ruta, int filas, int cols, int ld, int precarga,
+                FILE *f) {
+	struct cabeceraArchivo cab;
+
+	memset(m, 0, sizeof(*m));
+	memset(&cab, 0, sizeof(cab));
+	memcpy(cab.magia, MM_ARCHIVO_MAGIA, sizeof(cab.magia));
+	cab.version = MM_ARCHIVO_VERSION;
+	cab.tipo = MM_TIPO_F64;
+	cab.disposicion = MM_DISPOSICION_FILAS;
+	cab.bytesElem = sizeof(double);
+	cab.filas = (uint64_t) filas;
+	cab.cols = (uint64_t) cols;
+	cab.ld = (uint64_t) ld;
+	cab.datos = MM_ARCHIVO_DATOS;
+
+	m->ruta = ruta;
+	m->filas = filas;
+	m->cols = cols;
+	m->ld = ld;
+	m->bytes = MM_ARCHIVO_DATOS + (size_t) filas * ld * sizeof(double);
+	m->fd = open(ruta, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (m->fd < 0 || ftruncate(m->fd, (off_t) m->bytes) != 0
+	    || pwrite(m->fd, &cab, sizeof(cab), 0) != (ssize_t) sizeof(cab)) {
+		fprintf(f, "%s: %s\n", ruta, strerror(errno));
+		goto error;
+	}
+	if (proyecta(m, 1, precarga, MM_ARCHIVO_DATOS) != 0) {
+		fprintf(f, "%s: mmap: %s\n", ruta, strerror(errno));
+		goto error;
+	}
+	return 0;
+
+error:
+	if (m->fd >= 0)
+		close(m->fd);
+	m->fd = -1;
+	return -1;
+}
+
+/*-----------------------------------------------------------------------------
+ * generaArchivo — Llena la matriz de un archivo recién creado.
+ *
+ * Descripción:
+ *  Mismos valores que `llenaFilas()` en memoria. Cada MM_ARCHIVO_TROZO
+ *  bytes inicia la escritura de las filas generadas y las descarta de la
+ *  proyección; el contenido queda en la cache de páginas y en el archivo.
+ *---------------------------------------------------------------------------*/
+void generaArchivo(struct matrizArchivo *m, uint64_t semilla, double lo, double hi) {
+	size_t filasTrozo = MM_ARCHIVO_TROZO / ((size_t) m->ld * sizeof(double));
+
+	if (filasTrozo == 0)
+		filasTrozo = 1;
+	for (size_t i = 0; i < (size_t) m->filas; i += filasTrozo) {
+		size_t iF = (i + filasTrozo < (size_t) m->filas) ? i + filasTrozo : (size_t) m->filas;
+
+		llenaFilas(m->datos, m->cols, m->ld, (int) i, (int) iF, semilla, lo, hi);
+		sync_file_range(m->fd, (off_t) ((char *) (m->datos + i * m->ld) - m->base),
+		                (off_t) ((iF - i) * m->ld * sizeof(double)), SYNC_FILE_RANGE_WRITE);
+		aconsejaFilas(m, i, iF, 0, (size_t) m->cols, MADV_DONTNEED);
+	}
+	m->generada = 1;
+}
+
+/*-----------------------------------------------------------------------------
+ * cierraArchivo — Deshace la proyección y cierra el archivo.
+ *---------------------------------------------------------------------------*/
+void cierraArchivo(struct matrizArchivo *m) {
+	if (m->base != NULL)
+		munmap(m->base, m->bytes);
+	if (m->fd >= 0)
+		close(m->fd);
+	m->base = NULL;
+	m->datos = NULL;
+	m->fd = -1;
+}
+
+/*-----------------------------------------------------------------------------
+ * aconsejaFilas — `madvise()` sobre el bloque [filaI, filaF) × [colI, colF).
+ *
+ * Descripción:
+ *  Con las filas completas es un solo rango; si no, un rango por fila. Los
+ *  extremos se redondean a páginas, así que el consejo puede alcanzar
+ *  elementos vecinos: MADV_WILLNEED solo adelanta lecturas y, como las
+ *  proyecciones son compartidas, MADV_DONTNEED solo obliga a volver a
+ *  leerlos de la cache de páginas, sin perder nada.
+ *---------------------------------------------------------------------------*/
+void aconsejaFilas(const struct matrizArchivo *m, size_t filaI, size_t filaF, size_t colI, size_t colF,
+                   int consejo) {
+	size_t pagina = (size_t) sysconf(_SC_PAGESIZE);
+	size_t ld = (size_t) m->ld;
+	int completas = (colI == 0 && colF >= (size_t) m->cols);
+
+	for (size_t i = filaI; i < filaF; i = completas ? filaF : i + 1) {
+		char *ini = (char *) (m->datos + i * ld + colI);
+		char *fin = (char *) (m->datos + ((completas ? filaF : i + 1) - 1) * ld + colF);
+		uintptr_t a = (uintptr_t) ini & ~(uintptr_t) (pagina - 1);
+		uintptr_t b = ((uintptr_t) fin + pagina - 1) & ~(uintptr_t) (pagina - 1);
+
+		madvise((void *) a, b - a, consejo);
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * preparaEntrada — Abre la entrada `ruta` si existe o la crea.
+ *
+ * Descripción:
+ *  Un archivo existente debe tener exactamente la forma y el salto que
+ *  pide la línea de comandos; un archivo con otra forma es casi siempre un
+ *  error de uso, y multiplicarlo daría un producto distinto del pedido.
+ *  Retorna 1 si la creó (hay que llenarla) y 0 si ya existía; termina el
+ *  programa si la entrada no sirve.
+ *---------------------------------------------------------------------------*/
+static int preparaEntrada(struct matrizArchivo *m, const char *ruta, int filas, int cols, int ld,
+                          int precarga) {
+	if (access(ruta, F_OK) != 0) {
+		if (creaArchivo(m, ruta, filas, cols, ld, 0, stderr) != 0)
+			exit(1);
+		return 1;
+	}
+	if (abreArchivo(m, ruta, 0, precarga, stderr) != 0)
+		exit(1);
+	if (m->filas != filas || m->cols != cols || m->ld != ld) {
+		fprintf(stderr, "%s: es %d×%d con salto %d y el producto pide %d×%d con salto %d\n",
+		        ruta, m->filas, m->cols, m->ld, filas, cols, ld);
+		exit(1);
+	}
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * informeArchivo — Muestra el origen y la residencia de una matriz.
+ *---------------------------------------------------------------------------*/
+static void informeArchivo(const char *nombre, const struct matrizArchivo *m, int salida, FILE *f) {
+	fprintf(f, "# %s: %s, %d×%d (salto %d), %.1f MiB, %s\n", nombre, m->ruta, m->filas, m->cols, m->ld,
+	        m->bytes / 1048576.0, salida ? "escrita" : m->generada ? "generada" : "leída");
+	informeMemoria(nombre, m->datos, f);
+}
+
+/*-----------------------------------------------------------------------------
+ * ejecutaArchivo — Programa independiente de la ruta con archivos.
+ *
+ * Parámetros:
+ *  - op: opciones (op->archivos con las rutas de A, B y C).
+ *  - mt: motor que multiplica.
+ *  - compartida: 1 → buffers de los paneles en memoria compartida (Fork).
+ *  - programa: nombre para `--timing`.
+ *
+ * Descripción:
+ *  Como `ejecutaForma()`, pero A, B y C son las proyecciones de los
+ *  archivos y la fase de inicialización genera las entradas que no
+ *  existían. Con `--budget` el motor se prepara para la forma de un panel
+ *  y cada multiplicación recorre los archivos con `multiplicaExterno()`;
+ *  el tiempo incluye entonces la lectura y la escritura de los archivos.
+ *  Retorna el código de salida (1 si `--verify` encontró un error).
+ *---------------------------------------------------------------------------*/
+int ejecutaArchivo(const struct opciones *op, const struct motor *mt, int compartida, const char *programa) {
+	struct forma f;
+	struct matrizArchivo mA, mB, mC;
+	struct planExterno plan;
+	struct estadExterno estad;
+	struct opciones sub;
+	struct medicion tiempos;
+	struct contadores contadores;
+	int reps = (op->repeticiones > 0) ? op->repeticiones : 1;
+	int externo = (op->presupuesto > 0);
+
+	formaDe(op, &f);
+	if (huellaForma(&f) == SIZE_MAX) {
+		fprintf(stderr, "M=%d N=%d K=%d: las matrices no caben en el espacio de direcciones\n",
+		        f.M, f.N, f.K);
+		exit(1);
+	}
+	if (!externo && compruebaForma(&f, stderr) != 0) {
+		fprintf(stderr, "Use --budget <MiB> para recorrer los archivos por paneles\n");
+		exit(1);
+	}
+	if (externo && !mt->general) {
+		fprintf(stderr, "El motor %s no admite --budget\n", mt->nombre);
+		exit(1);
+	}
+	if (externo && planificaExterno(&plan, &f, op->presupuesto, stderr) != 0)
+		exit(1);
+
+	/* Fuera de memoria no se precarga: leer los archivos completos es
+	 * justo lo que el presupuesto evita */
+	int precarga = op->precarga && !externo;
+	int nuevaA = preparaEntrada(&mA, op->archivos[0], f.M, f.K, f.lda, precarga);
+	int nuevaB = preparaEntrada(&mB, op->archivos[1], f.K, f.N, f.ldb, precarga);
+	if (creaArchivo(&mC, op->archivos[2], f.M, f.N, f.ldc, precarga, stderr) != 0)
+		exit(1);
+
+	if (iniMedicion(&tiempos, op->P) != 0) {
+		perror("Error al reservar las marcas de tiempo");
+		exit(1);
+	}
+	if (op->contadores) {
+		if (iniContadores(&contadores, op->P) != 0) {
+			perror("Error al reservar los contadores");
+			exit(1);
+		}
+		tiempos.cont = &contadores;
+	}
+
+	inicioFase(&tiempos, MM_FASE_INICIALIZACION);
+	if (nuevaA)
+		generaArchivo(&mA, semillaMatriz(op->semilla, 0xA), MM_A_MIN, MM_A_MAX);
+	if (nuevaB)
+		generaArchivo(&mB, semillaMatriz(op->semilla, 0xB), MM_B_MIN, MM_B_MAX);
+	finFase(&tiempos, MM_FASE_INICIALIZACION);
+
+	if (externo) {
+		if (iniExterno(&plan, compartida, op->paginas) != 0) {
+			perror("Error al reservar los buffers de paneles");
+			exit(1);
+		}
+		opcionesPanel(op, &plan, &sub);
+		memset(&estad, 0, sizeof(estad));
+	}
+	if (mt->iniciar(externo ? &sub : op, &tiempos) != 0) {
+		perror("Error al iniciar el motor");
+		exit(1);
+	}
+
+	double suma = 0.0, minimo = 0.0, maximo = 0.0;
+	for (int r = 0; r < reps; r++) {
+		double t = externo ? multiplicaExterno(&sub, mt, &plan, &mA, &mB, &mC, &estad)
+		                   : mt->multiplicar(op, mA.datos, mB.datos, mC.datos);
+
+		suma += t;
+		if (r == 0 || t < minimo) minimo = t;
+		if (r == 0 || t > maximo) maximo = t;
+	}
+	mt->terminar(externo ? &sub : op);
+
+	const struct fase *trans = &tiempos.fase[MM_FASE_TRANSPOSICION];
+	if (op->repeticiones > 0)
+		printf("%9.0f %9.0f %9.0f ", suma / reps, minimo, maximo);
+	else
+		printf("%9.0f ", suma);
+	if (trans->veces > 0)
+		printf("%9.0f ", trans->total / trans->veces);
+	if (op->contadores)
+		columnasContadores(&contadores, flopsForma(&f) * reps, suma, stdout);
+	printf("\n");
+	fflush(stdout);
+
+	if (op->informe) {
+		informeForma(&f, suma, reps, stderr);
+		if (externo)
+			informeExterno(&plan, &estad, op->presupuesto, suma, reps, stderr);
+		informeArchivo("A", &mA, 0, stderr);
+		informeArchivo("B", &mB, 0, stderr);
+		informeArchivo("C", &mC, 1, stderr);
+	}
+
+	int fallo = op->verifica ? verificaForma(&f, mA.datos, mB.datos, mC.datos, op->semilla, stderr) : 0;
+
+	escribeMedicion(&tiempos, op->formatoTiempo, programa, f.N, stderr);
+	if (op->contadores) {
+		informeContadores(&contadores, op->informe, stderr);
+		liberaContadores(&contadores);
+	}
+	finMedicion(&tiempos);
+	if (externo)
+		finExterno(&plan);
+	cierraArchivo(&mA);
+	cierraArchivo(&mB);
+	cierraArchivo(&mC);
+	return fallo;
+}
@@ -0,0 +1,93 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * mmArchivo.h — Matrices en archivos binarios proyectados con `mmap`
+ * (`--files A,B,C`).
+ *
+ * Cada archivo empieza con una cabecera que lo describe (forma, tipo de
+ * elemento y disposición) y guarda los datos a partir de la primera página,
+ * de modo que la proyección del archivo se usa directamente como matriz.
+ * Las entradas que no existen se generan con el mismo generador que las
+ * matrices en memoria, y C se escribe siempre en su archivo. Con
+ * `--budget` el producto no carga los archivos completos sino que los
+ * recorre por paneles (mmExterno.c).
+ */
+
+#ifndef MM_ARCHIVO_H
+#define MM_ARCHIVO_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "mmComun.h"
+
+struct motor;
+struct forma;
+
+/* Identificación y versión del formato */
+#define MM_ARCHIVO_MAGIA    "MMTALLER"
+#define MM_ARCHIVO_VERSION  1
+
+/* Bytes reservados a la cabecera: los datos empiezan en la segunda página */
+#define MM_ARCHIVO_DATOS    4096
+
+/* Disposición de los elementos en el archivo */
+#define MM_DISPOSICION_FILAS     0   /* por filas, con salto `ld`          */
+#define MM_DISPOSICION_COLUMNAS  1   /* por columnas (solo se reconoce)    */
+
+/*-----------------------------------------------------------------------------
+ * Cabecera del archivo (en el orden de bytes del equipo):
+ *  - magia: MM_ARCHIVO_MAGIA, sin el '\0' final.
+ *  - version: MM_ARCHIVO_VERSION.
+ *  - tipo: tipo de elemento (MM_TIPO_*, ver mmTipo.h).
+ *  - disposicion: MM_DISPOSICION_*.
+ *  - bytesElem: bytes de cada elemento (comprueba que `tipo` se entiende
+ *               igual al escribir y al leer).
+ *  - filas, cols: forma de la matriz.
+ *  - ld: salto entre filas consecutivas, en elementos (≥ cols).
+ *  - datos: desplazamiento de los datos desde el inicio del archivo.
+ *---------------------------------------------------------------------------*/
+struct cabeceraArchivo {
+	char magia[8];
+	uint32_t version;
+	uint32_t tipo;
+	uint32_t disposicion;
+	uint32_t bytesElem;
+	uint64_t filas;
+	uint64_t cols;
+	uint64_t ld;
+	uint64_t datos;
+};
+
+/*-----------------------------------------------------------------------------
+ * Matriz proyectada desde un archivo:
+ *  - ruta: nombre del archivo.
+ *  - fd: descriptor abierto (-1 si está cerrada).
+ *  - base, bytes: proyección del archivo completo.
+ *  - datos: primer elemento (base + cabecera.datos).
+ *  - filas, cols, ld: forma, copiada de la cabecera.
+ *  - generada: 1 si el programa creó y llenó el archivo en esta ejecución.
+ *---------------------------------------------------------------------------*/
+struct matrizArchivo {
+	const char *ruta;
+	int fd;
+	char *base;
+	size_t bytes;
+	double *datos;
+	int filas, cols, ld;
+	int generada;
+};
+
+int leeArchivos(char *texto, const char *rutas[3]);
+
+int abreArchivo(struct matrizArchivo *m, const char *ruta, int escritura, int precarga, FILE *f);
+int creaArchivo(struct matrizArchivo *m, const char *ruta, int filas, int cols, int ld, int precarga,
+                FILE *f);
+void generaArchivo(struct matrizArchivo *m, uint64_t semilla, double lo, double hi);
+void cierraArchivo(struct matrizArchivo *m);
+void aconsejaFilas(const struct matrizArchivo *m, size_t filaI, size_t filaF, size_t colI, size_t colF,
+                   int consejo);
+
+int ejecutaArchivo(const struct opciones *op, const struct motor *mt, int compartida, const char *programa);
+
+#endif
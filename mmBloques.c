@@ -0,0 +1,305 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * Descripción general:
+ * ---------------------------------------------------------------
+ * Kernel de multiplicación de matrices por bloques (cache blocking).
+ *
+ * El bucle clásico i-j-k recorre B por columnas y, para N=1200 o N=2400,
+ * el conjunto de trabajo supera ampliamente la cache L2: cada elemento de B
+ * se trae de memoria principal una vez por fila de A. Aquí el espacio de
+ * iteración se divide en bloques de `tam`×`tam` de modo que:
+ *  - Un bloque de B (tam×tam) permanece en L2 mientras se reutiliza para
+ *    todas las filas del bloque de A.
+ *  - El bucle interno recorre una fila de B y una fila de C de forma
+ *    contigua (orden i-k-j), cuyo segmento de `tam` elementos cabe en L1 y
+ *    que el compilador puede vectorizar.
+ *
+ * Estructura:
+ *  - `tamBloqueAuto()`: elige el tamaño de bloque a partir de sysfs.
+ *  - `multiMatrixBloques()`: C = A·B para un bloque de filas×columnas de C
+ *    (B por filas).
+ *  - `multiMatrixBloquesTrans()`: lo mismo cuando se dispone de la
+ *    transpuesta de B (versión por filas).
+ *  - `transMatrixBloques()`: construye Bᵀ a partir de B por bloques.
+ *  - `multiForma*()` / `transFormaBloques()`: las mismas operaciones para
+ *    matrices rectangulares con salto de fila (leading dimension) propio;
+ *    las versiones D×D son su caso cuadrado.
+ *
+ * ---------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "mmBloques.h"
+
+/*-----------------------------------------------------------------------------
+ * leeCache — Lee el tamaño (en bytes) de un nivel de cache de datos.
+ *
+ * Parámetros:
+ *  - nivel: 1 para L1, 2 para L2, ...
+ *
+ * Descripción:
+ *  Recorre /sys/devices/system/cpu/cpu0/cache/index*, busca la entrada con el
+ *  nivel indicado y tipo "Data" o "Unified", e interpreta su tamaño ("48K",
+ *  "2048K", "30M"). Retorna 0 si la información no está disponible.
+ *---------------------------------------------------------------------------*/
+static long leeCache(int nivel) {
+	char ruta[128], tipo[32], tamano[32];
+
+	for (int idx = 0; idx < 16; idx++) {
+		int lvl = 0;
+		FILE *f;
+
+		snprintf(ruta, sizeof(ruta), "/sys/devices/system/cpu/cpu0/cache/index%d/level", idx);
+		if ((f = fopen(ruta, "r")) == NULL)
+			break;
+		if (fscanf(f, "%d", &lvl) != 1) lvl = 0;
+		fclose(f);
+		if (lvl != nivel)
+			continue;
+
+		snprintf(ruta, sizeof(ruta), "/sys/devices/system/cpu/cpu0/cache/index%d/type", idx);
+		if ((f = fopen(ruta, "r")) == NULL)
+			continue;
+		if (fscanf(f, "%31s", tipo) != 1) tipo[0] = '\0';
+		fclose(f);
+		if (strcmp(tipo, "Data") != 0 && strcmp(tipo, "Unified") != 0)
+			continue;
+
+		snprintf(ruta, sizeof(ruta), "/sys/devices/system/cpu/cpu0/cache/index%d/size", idx);
+		if ((f = fopen(ruta, "r")) == NULL)
+			continue;
+		if (fscanf(f, "%31s", tamano) != 1) tamano[0] = '\0';
+		fclose(f);
+
+		char *fin;
+		long valor = strtol(tamano, &fin, 10);
+		if (*fin == 'K') valor *= 1024L;
+		else if (*fin == 'M') valor *= 1024L * 1024L;
+		return valor;
+	}
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * tamBloqueAuto — Tamaño de bloque por defecto según la cache del equipo.
+ *
+ * Descripción:
+ *  Se busca el mayor `tam` (múltiplo de 16) tal que tres bloques tam×tam de
+ *  doubles (A, B y C) ocupen como máximo la mitad de L2, dejando espacio a
+ *  otros datos y al prefetcher. Se comprueba además que la fila de B y la de
+ *  C recorridas en el bucle interno (2·tam doubles) quepan en L1. El
+ *  resultado se limita a [16, 512]; sin datos de sysfs se usa
+ *  MM_BLOQUE_DEFECTO.
+ *---------------------------------------------------------------------------*/
+int tamBloqueAuto(void) {
+	long l1 = leeCache(1);
+	long l2 = leeCache(2);
+
+	if (l2 <= 0)
+		return MM_BLOQUE_DEFECTO;
+
+	int tam = (int) sqrt((double) l2 / 2.0 / (3.0 * sizeof(double)));
+	tam -= tam % 16;
+
+	while (l1 > 0 && tam > 16 && 2L * tam * (long) sizeof(double) > l1 / 2)
+		tam -= 16;
+
+	if (tam < 16)  tam = 16;
+	if (tam > 512) tam = 512;
+	return tam;
+}
+
+/*-----------------------------------------------------------------------------
+ * limpiaBloque — Pone a cero el bloque [filaI, filaF) × [colI, colF) de C.
+ *---------------------------------------------------------------------------*/
+static void limpiaBloque(double *mC, int ldc, int filaI, int filaF, int colI, int colF) {
+	if (colI == 0 && colF == ldc) {
+		memset(mC + (size_t) filaI * ldc, 0, (size_t) (filaF - filaI) * ldc * sizeof(double));
+		return;
+	}
+	for (int i = filaI; i < filaF; i++)
+		memset(mC + (size_t) i * ldc + colI, 0, (size_t) (colF - colI) * sizeof(double));
+}
+
+/*-----------------------------------------------------------------------------
+ * multiFormaBloques — Multiplicación por bloques de una región de C con
+ * dimensiones y saltos generales.
+ *
+ * Parámetros:
+ *  - mA: matriz A (filas de C) × K por filas, con salto `lda`.
+ *  - mB: matriz B K × (columnas de C) por filas, con salto `ldb`.
+ *  - mC: matriz resultado con salto `ldc`; solo se escribe la región
+ *        indicada.
+ *  - K: dimensión común (columnas de A, filas de B).
+ *  - filaI, filaF: rango de filas de C a calcular.
+ *  - colI, colF: rango de columnas de C a calcular.
+ *  - tam: tamaño de bloque (ver `tamBloqueAuto()`).
+ *
+ * Descripción:
+ *  La región se pone a cero y se acumulan los productos bloque a bloque en
+ *  orden (ii, kk, jj) → (i, k, j). El resultado es el mismo que el del
+ *  kernel clásico, salvo el orden de redondeo de las sumas. Para un rango
+ *  de k basta con desplazar mA (columnas) y mB (filas) y reducir K.
+ *---------------------------------------------------------------------------*/
+void multiFormaBloques(const double *mA, int lda, const double *mB, int ldb, double *mC, int ldc,
+                       int K, int filaI, int filaF, int colI, int colF, int tam) {
+	if (filaF <= filaI || colF <= colI)
+		return;
+
+	limpiaBloque(mC, ldc, filaI, filaF, colI, colF);
+
+	for (int ii = filaI, iF; ii < filaF; ii = iF) {
+		iF = ii + ((tam < filaF - ii) ? tam : filaF - ii);
+
+		for (int kk = 0, kF; kk < K; kk = kF) {
+			kF = kk + ((tam < K - kk) ? tam : K - kk);
+
+			for (int jj = colI, jF; jj < colF; jj = jF) {
+				jF = jj + ((tam < colF - jj) ? tam : colF - jj);
+
+				for (int i = ii; i < iF; i++) {
+					double *restrict pC = mC + (size_t) i * ldc;
+					const double *pA = mA + (size_t) i * lda;
+
+					for (int k = kk; k < kF; k++) {
+						double a = pA[k];
+						const double *restrict pB = mB + (size_t) k * ldb;
+
+						for (int j = jj; j < jF; j++)
+							pC[j] += a * pB[j];
+					}
+				}
+			}
+		}
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * multiMatrixBloques — Multiplicación por bloques de una región de C.
+ *
+ * Parámetros:
+ *  - mA, mB: matrices de entrada D×D (por filas).
+ *  - mC: matriz resultado; solo se escribe la región indicada.
+ *  - D: dimensión de las matrices.
+ *  - filaI, filaF: rango de filas de C a calcular.
+ *  - colI, colF: rango de columnas de C a calcular (0, D → filas completas).
+ *  - tam: tamaño de bloque (ver `tamBloqueAuto()`).
+ *
+ * Descripción:
+ *  Caso cuadrado de `multiFormaBloques()`.
+ *---------------------------------------------------------------------------*/
+void multiMatrixBloques(const double *mA, const double *mB, double *mC, int D,
+                        int filaI, int filaF, int colI, int colF, int tam) {
+	multiFormaBloques(mA, D, mB, D, mC, D, D, filaI, filaF, colI, colF, tam);
+}
+
+/*-----------------------------------------------------------------------------
+ * multiFormaBloquesTrans — Multiplicación por bloques con B transpuesta y
+ * dimensiones y saltos generales.
+ *
+ * Parámetros:
+ *  - mA: matriz A por filas, con salto `lda`.
+ *  - mBt: transpuesta de B (columnas de C) × K, con salto `ldbt`; la fila j
+ *         de mBt es la columna j de B.
+ *  - mC, ldc, K, filaI, filaF, colI, colF, tam: igual que en
+ *    `multiFormaBloques()`.
+ *
+ * Descripción:
+ *  Cada elemento C[i][j] es el producto punto de la fila i de A y la fila j
+ *  de Bᵀ. Se agrupan bloques de filas de A y de Bᵀ para que ambos segmentos
+ *  de longitud `tam` se reutilicen desde cache.
+ *---------------------------------------------------------------------------*/
+void multiFormaBloquesTrans(const double *mA, int lda, const double *mBt, int ldbt, double *mC, int ldc,
+                            int K, int filaI, int filaF, int colI, int colF, int tam) {
+	if (filaF <= filaI || colF <= colI)
+		return;
+
+	limpiaBloque(mC, ldc, filaI, filaF, colI, colF);
+
+	for (int ii = filaI, iF; ii < filaF; ii = iF) {
+		iF = ii + ((tam < filaF - ii) ? tam : filaF - ii);
+
+		for (int jj = colI, jF; jj < colF; jj = jF) {
+			jF = jj + ((tam < colF - jj) ? tam : colF - jj);
+
+			for (int kk = 0, kF; kk < K; kk = kF) {
+				kF = kk + ((tam < K - kk) ? tam : K - kk);
+
+				for (int i = ii; i < iF; i++) {
+					const double *restrict pA = mA + (size_t) i * lda;
+					double *pC = mC + (size_t) i * ldc;
+
+					for (int j = jj; j < jF; j++) {
+						const double *restrict pB = mBt + (size_t) j * ldbt;
+						double Suma = 0.0;
+
+						for (int k = kk; k < kF; k++)
+							Suma += pA[k] * pB[k];
+						pC[j] += Suma;
+					}
+				}
+			}
+		}
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * multiMatrixBloquesTrans — Multiplicación por bloques con B transpuesta.
+ *
+ * Parámetros:
+ *  - mA: matriz A D×D (por filas).
+ *  - mBt: transpuesta de B, es decir, la fila j de mBt es la columna j de B.
+ *  - mC, D, filaI, filaF, colI, colF, tam: igual que en
+ *    `multiMatrixBloques()`.
+ *
+ * Descripción:
+ *  Caso cuadrado de `multiFormaBloquesTrans()`.
+ *---------------------------------------------------------------------------*/
+void multiMatrixBloquesTrans(const double *mA, const double *mBt, double *mC, int D,
+                             int filaI, int filaF, int colI, int colF, int tam) {
+	multiFormaBloquesTrans(mA, D, mBt, D, mC, D, D, filaI, filaF, colI, colF, tam);
+}
+
+/*-----------------------------------------------------------------------------
+ * transFormaBloques — Transpone por bloques un rango de filas de B.
+ *
+ * Parámetros:
+ *  - mB: matriz B por filas, con salto `ldb` y `cols` columnas.
+ *  - mBt: destino con salto `ldbt`; al terminar, mBt[j·ldbt + i] =
+ *         mB[i·ldb + j] para las filas i del rango.
+ *  - filaI, filaF: filas de B a transponer (columnas de mBt a escribir).
+ *  - tam: lado del bloque (ver MM_BLOQUE_TRANS).
+ *
+ * Descripción:
+ *  La transposición ingenua lee B por filas pero escribe Bᵀ con salto ldbt,
+ *  lo que falla en cache y en TLB para matrices grandes. Recorriendo bloques
+ *  tam×tam, tanto el bloque leído como el escrito permanecen en L1. Rangos
+ *  de filas disjuntos escriben columnas disjuntas de mBt, así que varios
+ *  hilos pueden transponer a la vez sin sincronización.
+ *---------------------------------------------------------------------------*/
+void transFormaBloques(const double *mB, int ldb, double *mBt, int ldbt, int cols,
+                       int filaI, int filaF, int tam) {
+	for (int ii = filaI, iF; ii < filaF; ii = iF) {
+		iF = ii + ((tam < filaF - ii) ? tam : filaF - ii);
+
+		for (int jj = 0, jF; jj < cols; jj = jF) {
+			jF = jj + ((tam < cols - jj) ? tam : cols - jj);
+
+			for (int i = ii; i < iF; i++)
+				for (int j = jj; j < jF; j++)
+					mBt[(size_t) j * ldbt + i] = mB[(size_t) i * ldb + j];
+		}
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * transMatrixBloques — Transpone por bloques un rango de filas de B D×D
+ * (caso cuadrado de `transFormaBloques()`).
+ *---------------------------------------------------------------------------*/
+void transMatrixBloques(const double *mB, double *mBt, int D, int filaI, int filaF, int tam) {
+	transFormaBloques(mB, D, mBt, D, D, filaI, filaF, tam);
+}
@@ -0,0 +1,43 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * mmBloques.h — Kernel de multiplicación por bloques (tiling) compartido por
+ * las versiones densas (Fork, Pthreads, OpenMP clásica y por filas,
+ * Strassen y SUMMA); la versión dispersa usa su kernel CSR.
+ *
+ * Las matrices se almacenan por filas en formato lineal: cuadradas D×D en
+ * las funciones `*Matrix*` y con dimensiones y saltos de fila (lda, ldb,
+ * ldc) generales en las `*Forma*` (`--shape`, ver mmForma.h). Cada función calcula únicamente el bloque de filas [filaI, filaF) y columnas
+ * [colI, colF) de C, de modo que el programa que la llama decide cómo
+ * repartir filas (o teselas 2-D) entre procesos o hilos.
+ */
+
+#ifndef MM_BLOQUES_H
+#define MM_BLOQUES_H
+
+/* Tamaño de bloque usado cuando no se puede consultar la cache en sysfs */
+#define MM_BLOQUE_DEFECTO 64
+
+/* Bloque de la transposición: dos bloques de 32×32 doubles (16 KiB) en L1 */
+#define MM_BLOQUE_TRANS   32
+
+int tamBloqueAuto(void);
+
+void multiMatrixBloques(const double *mA, const double *mB, double *mC, int D,
+                        int filaI, int filaF, int colI, int colF, int tam);
+
+void multiMatrixBloquesTrans(const double *mA, const double *mBt, double *mC, int D,
+                             int filaI, int filaF, int colI, int colF, int tam);
+
+void transMatrixBloques(const double *mB, double *mBt, int D, int filaI, int filaF, int tam);
+
+void multiFormaBloques(const double *mA, int lda, const double *mB, int ldb, double *mC, int ldc,
+                       int K, int filaI, int filaF, int colI, int colF, int tam);
+
+void multiFormaBloquesTrans(const double *mA, int lda, const double *mBt, int ldbt, double *mC, int ldc,
+                            int K, int filaI, int filaF, int colI, int colF, int tam);
+
+void transFormaBloques(const double *mB, int ldb, double *mBt, int ldbt, int cols,
+                       int filaI, int filaF, int tam);
+
+#endif
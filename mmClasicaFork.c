@@ -12,50 +12,58 @@
  * Cada proceso hijo calcula un subconjunto de filas de la matriz resultado,
  * aprovechando múltiples núcleos del CPU para dividir la carga de trabajo.
  *
+ * Las matrices A, B y C se ubican en una región anónima compartida (`mmap`
+ * con MAP_SHARED), de modo que las filas escritas por cada hijo quedan
+ * visibles para el padre. La opción `-p` conserva el modo original con
+ * memoria privada, en el que cada hijo escribe sobre su copia (copy-on-write)
+ * y el padre nunca recibe el producto; sirve solo como referencia de tiempos.
+ * La región se reserva con mmMemoria.c (`--pages`, `--prefault`).
+ *
  * Estructura general:
- *  - Función `iniMatrix()`: inicializa las matrices A y B con valores aleatorios.
+ *  - Función `iniMatrix()`: inicializa A y B en paralelo y de forma reproducible
+ *    (mmAleatorio.c, opción `--seed`).
  *  - Función `multiMatrix()`: realiza la multiplicación parcial por bloques de filas.
+ *  - Función `hijosForma()`: producto general M×K · K×N (`--shape`, mmForma.c).
+ *  - Función `hijosLote()`: lote de productos pequeños (`--batch`, mmLote.c).
  *  - Función `impMatrix()`: imprime una matriz (solo si es pequeña, N < 9).
- *  - Funciones `InicioMuestra()` y `FinMuestra()`: miden el tiempo de ejecución total.
- *  - `main()`: distribuye el trabajo entre procesos hijos, espera su finalización
- *    y libera memoria al concluir.
+ *  - Tiempos por fase y por hijo con mmTiempo.c (`--timing csv|json`).
+ *  - Funciones `reservaMatrices()` y `liberaMatrices()`: gestionan la memoria
+ *    compartida (o privada) de las tres matrices.
+ *  - `motorFork` (`iniciaFork()`, `multiplicaFork()`, `terminaFork()`): crea
+ *    los hijos, reparte las filas y espera su finalización; es la interfaz
+ *    que usa también el binario único `mm` (ver mmMotor.h).
+ *  - `main()`: reserva e inicializa las matrices, ejecuta el motor y libera
+ *    memoria al concluir (se omite al compilar con -DMM_BINARIO_UNICO).
  *
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
+#include <sys/mman.h>
 #include <sys/wait.h>
-#include <sys/time.h>
-#include <time.h>
+#include "mmComun.h"
+#include "mmBloques.h"
+#include "mmReparto.h"
+#include "mmAleatorio.h"
+#include "mmVerifica.h"
+#include "mmTiempo.h"
+#include "mmMemoria.h"
+#include "mmForma.h"
+#include "mmTipo.h"
+#include "mmLote.h"
+#include "mmDispersa.h"
+#include "mmArchivo.h"
+#include "mmMotor.h"
 
-struct timeval inicio, fin;
+/* Tiempos por fase y por proceso hijo de la ejecución en curso (ver
+ * mmTiempo.h); los entrega `iniciaFork()` */
+static struct medicion *medida;
 
-/*-----------------------------------------------------------------------------
- * InicioMuestra — Inicia el cronómetro de medición de tiempo.
- *
- * Descripción:
- *  Guarda la marca de tiempo actual en la variable global `inicio`
- *  mediante la función `gettimeofday()`.
- *---------------------------------------------------------------------------*/
-void InicioMuestra() {
-	gettimeofday(&inicio, (void *)0);
-}
-
-/*-----------------------------------------------------------------------------
- * FinMuestra — Finaliza la medición y muestra el tiempo total.
- *
- * Descripción:
- *  Calcula el tiempo transcurrido desde `InicioMuestra()` en microsegundos
- *  y lo imprime con formato numérico.
- *---------------------------------------------------------------------------*/
-void FinMuestra() {
-	gettimeofday(&fin, (void *)0);
-	fin.tv_usec -= inicio.tv_usec;
-	fin.tv_sec  -= inicio.tv_sec;
-	double tiempo = (double) (fin.tv_sec * 1000000 + fin.tv_usec);
-	printf("%9.0f \n", tiempo);
-}
+/* Reparto del producto general (`--shape`, ver mmForma.h); las sumas
+ * parciales están en memoria compartida para que el padre las vea */
+static struct particion plan;
 
 /*-----------------------------------------------------------------------------
  * multiMatrix — Multiplicación parcial de matrices.
@@ -72,23 +80,224 @@ void FinMuestra() {
  *  Cada proceso hijo ejecuta esta función sobre un subconjunto de filas.
  *  Calcula los productos parciales y los almacena directamente en `mC`.
  *---------------------------------------------------------------------------*/
-void multiMatrix(double *mA, double *mB, double *mC, int D, int filaI, int filaF) {
-	double Suma, *pA, *pB;
+static void multiMatrix(const double *mA, const double *mB, double *mC, int D, int filaI, int filaF) {
+	double Suma;
+	const double *pA, *pB;
 
 	for (int i = filaI; i < filaF; i++) {
 		for (int j = 0; j < D; j++) {
 			Suma = 0.0;
-			pA = mA + i * D;
+			pA = mA + (size_t) i * D;
 			pB = mB + j;
 
 			for (int k = 0; k < D; k++, pA++, pB += D) {
 				Suma += *pA * *pB;	
 			}
-			mC[i * D + j] = Suma;
+			mC[(size_t) i * D + j] = Suma;
+		}
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * esperaHijos — Espera a `n` procesos hijos.
+ *
+ * Descripción:
+ *  Si alguno termina por una señal o con estado distinto de 0, su parte de
+ *  C no está escrita: se informa y el programa termina con 1 en lugar de
+ *  dar un tiempo por un producto incompleto (como `multiplicaSumma()`).
+ *---------------------------------------------------------------------------*/
+static void esperaHijos(int n) {
+	int fallo = 0;
+
+	for (int i = 0; i < n; i++) {
+		int estado;
+
+		if (wait(&estado) < 0 || !WIFEXITED(estado) || WEXITSTATUS(estado) != 0)
+			fallo = 1;
+	}
+	if (fallo) {
+		fprintf(stderr, "Error: un proceso hijo no terminó correctamente\n");
+		exit(1);
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * hijosForma — Una etapa del producto general con P procesos hijos.
+ *
+ * Parámetros:
+ *  - op: opciones (P y kernel).
+ *  - mA, mB, mC: matrices con los saltos de `plan.f` (C compartida).
+ *  - reduce: 0 → el hijo i calcula el trozo i del plan; 1 → el hijo i suma
+ *            a C las parciales de la franja i.
+ *
+ * Descripción:
+ *  El padre espera a todos los hijos antes de retornar, de modo que la
+ *  reducción empieza cuando todas las sumas parciales están escritas.
+ *---------------------------------------------------------------------------*/
+static void hijosForma(const struct opciones *op, const double *mA, const double *mB, double *mC, int reduce) {
+	for (int i = 0; i < op->P; i++) {
+		pid_t pid = fork();
+
+		if (pid == 0) {
+			if (reduce)
+				reduceFranja(&plan, mC, i);
+			else {
+				inicioTrabajador(medida, i);
+				calculaTrozo(op, &plan, mA, mB, plan.f.ldb, 0, mC, i);
+				finTrabajador(medida, i);
+			}
+			_exit(0);
+		}
+		else if (pid < 0) {
+			perror("Error al crear el proceso con fork");
+			exit(1);
+		}
+	}
+	esperaHijos(op->P);
+}
+
+/*-----------------------------------------------------------------------------
+ * hijosLote — Reparte los productos del lote entre P procesos hijos.
+ *
+ * Descripción:
+ *  El hijo i calcula el rango estático i de productos completos (ver
+ *  `rangoEstatico()`), con sus propios buffers de kernel; el padre espera
+ *  a todos. Se crean P hijos para todo el lote, no P por producto.
+ *---------------------------------------------------------------------------*/
+static void hijosLote(const struct opciones *op, const double *mA, const double *mB, double *mC) {
+	for (int i = 0; i < op->P; i++) {
+		pid_t pid = fork();
+
+		if (pid == 0) {
+			struct trabajoLote t;
+			int ini, fin;
+
+			inicioTrabajador(medida, i);
+			rangoEstatico(op->lote, op->P, i, &ini, &fin);
+			iniTrabajoLote(&t, op);
+			multiLote(&t, mA, mB, mC, (size_t) op->N * op->N, ini, fin);
+			finTrabajoLote(&t);
+			finTrabajador(medida, i);
+			_exit(0);
+		}
+		else if (pid < 0) {
+			perror("Error al crear el proceso con fork");
+			exit(1);
 		}
 	}
+	esperaHijos(op->P);
 }
 
+/*-----------------------------------------------------------------------------
+ * iniciaFork — Prepara el motor Fork (ver mmMotor.h).
+ *
+ * Descripción:
+ *  Los procesos se crean en cada multiplicación, así que solo se guarda la
+ *  medición donde los hijos dejan sus marcas y, con `--shape`, se planifica
+ *  el reparto de la forma. Retorna -1 si falla la reserva del plan.
+ *---------------------------------------------------------------------------*/
+static int iniciaFork(const struct opciones *op, struct medicion *m) {
+	medida = m;
+
+	if (formaGeneral(op)) {
+		struct forma f;
+
+		formaDe(op, &f);
+		if (iniParticion(&plan, &f, op->P, 1, op->paginas) != 0)
+			return -1;
+	}
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * multiplicaFork — Reparte las filas de C entre P procesos hijos.
+ *
+ * Parámetros:
+ *  - op: opciones (N, P y kernel).
+ *  - mA, mB: matrices de entrada.
+ *  - mC: matriz resultado; debe estar en memoria compartida para que el
+ *        padre reciba el producto (con `-p` cada hijo escribe en su copia).
+ *
+ * Descripción:
+ *  Cada hijo calcula un rango de filas de C (`rangoEstatico()`; kernel
+ *  clásico, por bloques o micro-kernel según `-b` y `-k`) y termina; el
+ *  padre espera a todos y termina el programa si alguno falló. Con
+ *  `--shape` cada hijo calcula un trozo del plan de la forma y, si el plan
+ *  divide K, una segunda tanda de hijos suma las parciales; con `--batch`
+ *  cada hijo calcula productos completos del lote. Se retorna el tiempo
+ *  desde el primer `fork()` hasta el último `wait()`, en µs.
+ *---------------------------------------------------------------------------*/
+static double multiplicaFork(const struct opciones *op, const double *mA, const double *mB, double *mC) {
+	int N = op->N;                    // Dimensión de la matriz
+	int num_P = op->P;                // Número de procesos
+
+	fflush(stdout); // evita que los hijos hereden y repitan la salida pendiente
+
+	inicioFase(medida, MM_FASE_MULTIPLICACION); // desde el primer fork hasta el último wait
+
+	if (formaGeneral(op)) {
+		hijosForma(op, mA, mB, mC, 0);
+		if (plan.franjas > 0)
+			hijosForma(op, mA, mB, mC, 1);
+		return finFase(medida, MM_FASE_MULTIPLICACION);
+	}
+	if (op->lote > 0) {
+		hijosLote(op, mA, mB, mC);
+		return finFase(medida, MM_FASE_MULTIPLICACION);
+	}
+
+	for (int i = 0; i < num_P; i++) {
+		pid_t pid = fork();
+		
+		if (pid == 0) { // Proceso hijo
+			int start_row, end_row; // filas asignadas a este proceso
+
+			rangoEstatico(N, num_P, i, &start_row, &end_row);
+
+			inicioTrabajador(medida, i);
+			if (kernelComun(op))
+				multiRango(op, mA, mB, 0, mC, N, start_row, end_row);
+			else
+				multiMatrix(mA, mB, mC, N, start_row, end_row);
+			finTrabajador(medida, i);
+
+			if (N < 9) {
+				printf("\nChild PID %d calculó filas %d a %d:\n", getpid(), start_row, end_row - 1);
+				for (int r = start_row; r < end_row; r++) {
+					for (int c = 0; c < N; c++) {
+						printf(" %.2f ", mC[(size_t) N * r + c]);
+					}
+					printf("\n");
+				}
+			}
+			fflush(stdout);
+			_exit(0); // Finaliza el hijo sin ejecutar los atexit del padre
+		} 
+		else if (pid < 0) {
+			perror("Error al crear el proceso con fork");
+			exit(1);
+		}
+	}
+
+	// Esperar a que todos los hijos terminen
+	esperaHijos(num_P);
+
+	return finFase(medida, MM_FASE_MULTIPLICACION);
+}
+
+/*-----------------------------------------------------------------------------
+ * terminaFork — Libera el plan de la forma (si lo hay).
+ *---------------------------------------------------------------------------*/
+static void terminaFork(const struct opciones *op) {
+	(void) op;
+	finParticion(&plan);
+	medida = NULL;
+}
+
+const struct motor motorFork = { "fork", iniciaFork, multiplicaFork, terminaFork, 1 };
+
+#ifndef MM_BINARIO_UNICO
+
 /*-----------------------------------------------------------------------------
  * impMatrix — Imprime una matriz cuadrada de tamaño D×D.
  *
@@ -100,7 +309,7 @@ void multiMatrix(double *mA, double *mB, double *mC, int D, int filaI, int filaF
  *  Si la matriz es pequeña (D < 9), se imprime en pantalla con formato.
  *  Se usa principalmente con fines de depuración.
  *---------------------------------------------------------------------------*/
-void impMatrix(double *matrix, int D) {
+static void impMatrix(double *matrix, int D) {
 	if (D < 9) {
 		printf("\nImpresión de matriz:\n");
 		for (int i = 0; i < D * D; i++, matrix++) {
@@ -118,17 +327,71 @@ void impMatrix(double *matrix, int D) {
  *  - mA: puntero a la matriz A.
  *  - mB: puntero a la matriz B.
  *  - D:  tamaño de las matrices cuadradas.
+ *  - P:  número de procesos.
+ *  - compartida: 1 si las matrices están en la región compartida.
+ *  - semilla: semilla del generador (`--seed`).
  *
  * Descripción:
- *  Asigna valores aleatorios de punto flotante a las dos matrices:
+ *  Asigna valores aleatorios de punto flotante a las dos matrices con el
+ *  generador por contador de mmAleatorio.c:
  *   - A: valores entre 1.0 y 5.0
  *   - B: valores entre 5.0 y 9.0
+ *  Con memoria compartida, P hijos llenan cada uno su rango de filas, igual
+ *  que en la multiplicación; con `-p` los hijos no podrían devolver lo
+ *  escrito, así que el padre llena todo. El resultado es el mismo en ambos
+ *  casos.
  *---------------------------------------------------------------------------*/
-void iniMatrix(double *mA, double *mB, int D) {
-	for (int i = 0; i < D * D; i++, mA++, mB++) {
-		*mA = (double) rand() / RAND_MAX * (5.0 - 1.0);
-		*mB = (double) rand() / RAND_MAX * (9.0 - 5.0);
+static void iniMatrix(double *mA, double *mB, int D, int P, int compartida, uint64_t semilla) {
+	if (!compartida || P == 1) {
+		iniMatrixFilas(mA, mB, D, 0, D, semilla);
+		return;
+	}
+
+	fflush(stdout);
+	for (int i = 0; i < P; i++) {
+		int ini, fin;
+		pid_t pid = fork();
+
+		if (pid == 0) {
+			rangoEstatico(D, P, i, &ini, &fin);
+			iniMatrixFilas(mA, mB, D, ini, fin, semilla);
+			_exit(0);
+		}
+		else if (pid < 0) {
+			perror("Error al crear el proceso con fork");
+			exit(1);
+		}
 	}
+	esperaHijos(P);
+}
+
+/*-----------------------------------------------------------------------------
+ * reservaMatrices — Reserva en un solo bloque el espacio de A, B y C.
+ *
+ * Parámetros:
+ *  - op: opciones (N, `--pages` y `--prefault`, ver mmMemoria.c).
+ *  - compartida: 1 → región anónima compartida (`mmap` MAP_SHARED),
+ *                0 → memoria privada del proceso (MAP_PRIVATE, como el
+ *                `calloc` original).
+ *
+ * Descripción:
+ *  Devuelve un puntero a tres matrices N×N inicializadas en cero, cada una
+ *  alineada a 64 bytes (ver `elemsAlineados()`): A ocupa el primer tercio,
+ *  B el segundo y C el último. Con memoria compartida los hijos creados por
+ *  `fork()` escriben directamente sobre la misma C que luego lee el padre.
+ *  Retorna NULL si la reserva falla.
+ *---------------------------------------------------------------------------*/
+static double *reservaMatrices(const struct opciones *op, int compartida) {
+	size_t elems = 3 * elemsAlineados((size_t) op->N * op->N);
+
+	return reservaMatriz(elems, op->paginas, compartida, op->precarga);
+}
+
+/*-----------------------------------------------------------------------------
+ * liberaMatrices — Libera el bloque obtenido con `reservaMatrices()`.
+ *---------------------------------------------------------------------------*/
+static void liberaMatrices(double *bloque, const struct opciones *op) {
+	liberaMatriz(bloque, 3 * elemsAlineados((size_t) op->N * op->N), op->paginas);
 }
 
 /*-----------------------------------------------------------------------------
@@ -136,76 +399,115 @@ void iniMatrix(double *mA, double *mB, int D) {
  *
  * Parámetros:
  *  - argc: número de argumentos pasados en la línea de comandos.
- *  - argv: arreglo de argumentos (argv[1] = tamaño, argv[2] = procesos).
+ *  - argv: arreglo de argumentos (tamaño, procesos y opciones de mmComun.c;
+ *          "-p" usa memoria privada, "-b"/"-k" los kernels comunes).
  *
  * Descripción:
- *  1. Valida los parámetros de entrada.
- *  2. Reserva memoria dinámica para matrices A, B y C.
+ *  1. Valida los parámetros de entrada; con `--shape` o `--pad` el producto
+ *     general lo ejecuta `ejecutaForma()` (mmForma.c) con este motor, y con
+ *     `--type` `ejecutaTipo()` (mmTipo.c); con `--files`, `ejecutaArchivo()`
+ *     (mmArchivo.c), y con `--density`, `ejecutaDispersa()` (mmDispersa.c).
+ *  2. Reserva memoria (compartida por defecto) para matrices A, B y C.
  *  3. Inicializa y muestra las matrices (si son pequeñas).
  *  4. Divide el trabajo entre procesos hijos usando `fork()`.
- *  5. Cada hijo calcula un rango de filas de la matriz C.
+ *  5. Cada hijo calcula un rango de filas de la matriz C (kernel clásico, por
+ *     bloques o micro-kernel según las opciones `-b` y `-k`).
  *  6. El proceso padre espera la finalización de todos los hijos.
- *  7. Mide y muestra el tiempo total de ejecución.
+ *  7. Mide y muestra el tiempo total de la multiplicación (con `--timing`,
+ *     además las fases y el intervalo de cada hijo en stderr).
+ *  8. Imprime C desde el padre (si es pequeña) y, con `--verify`, comprueba
+ *     C = A·B fuera del tiempo medido (código de salida 1 si es incorrecta).
  *---------------------------------------------------------------------------*/
 int main(int argc, char *argv[]) {
-	if (argc < 3) {
-		printf("\nUso: ./nom_ejecutable <TamañoMatriz> <NumProcesos>\n");
-		exit(0);
-	}
+	struct opciones op;
+	leerOpciones(argc, argv, "./mmClasicaFork", &op);
 
-	int N = atoi(argv[1]);       // Dimensión de la matriz
-	int num_P = atoi(argv[2]);   // Número de procesos
-	double *matA = (double *) calloc(N * N, sizeof(double));
-	double *matB = (double *) calloc(N * N, sizeof(double));
-	double *matC = (double *) calloc(N * N, sizeof(double));
+	int N = op.N;                // Dimensión de la matriz
+	int num_P = op.P;            // Número de procesos
+	int compartida = !op.privada;
 
-	srand(time(0)); 
+	if (op.verifica && !compartida) {
+		fprintf(stderr, "--verify requiere memoria compartida: con -p el padre no recibe C\n");
+		exit(1);
+	}
 
-	iniMatrix(matA, matB, N);
-	impMatrix(matA, N);
-	impMatrix(matB, N);
+	if (op.archivos[0] != NULL)
+		return ejecutaArchivo(&op, &motorFork, compartida, "mmClasicaFork");
+	if (formaGeneral(&op))
+		return ejecutaForma(&op, &motorFork, compartida, "mmClasicaFork");
+	if (op.tipo != MM_TIPO_NINGUNO)
+		return ejecutaTipo(&op, &motorFork, compartida, "mmClasicaFork");
+	if (op.lote > 0)
+		return ejecutaLote(&op, &motorFork, compartida, "mmClasicaFork");
+	if (op.densidad > 0.0)
+		return ejecutaDispersa(&op, &motorFork, compartida, "mmClasicaFork");
 
-	int rows_per_process = N / num_P; // filas asignadas a cada proceso
+	if (compruebaHuella(N, 3, stderr) != 0)
+		exit(1);
 
-	InicioMuestra(); // Comienza la medición de tiempo total
+	double *region = reservaMatrices(&op, compartida);
+	if (region == NULL) {
+		perror("Error al reservar memoria para las matrices");
+		exit(1);
+	}
+	double *matA = region;
+	double *matB = region + elemsAlineados((size_t) N * N);
+	double *matC = region + 2 * elemsAlineados((size_t) N * N);
 
-	for (int i = 0; i < num_P; i++) {
-		pid_t pid = fork();
-		
-		if (pid == 0) { // Proceso hijo
-			int start_row = i * rows_per_process;
-			int end_row = (i == num_P - 1) ? N : start_row + rows_per_process;
+	struct medicion tiempos;
+	struct contadores contadores;
 
-			multiMatrix(matA, matB, matC, N, start_row, end_row);
+	if (iniMedicion(&tiempos, num_P) != 0) {
+		perror("Error al reservar las marcas de tiempo");
+		exit(1);
+	}
 
-			if (N < 9) {
-				printf("\nChild PID %d calculó filas %d a %d:\n", getpid(), start_row, end_row - 1);
-				for (int r = start_row; r < end_row; r++) {
-					for (int c = 0; c < N; c++) {
-						printf(" %.2f ", matC[N * r + c]);
-					}
-					printf("\n");
-				}
-			}
-			exit(0); // Finaliza el hijo
-		} 
-		else if (pid < 0) {
-			perror("Error al crear el proceso con fork");
+	if (op.contadores) {
+		if (iniContadores(&contadores, num_P) != 0) {
+			perror("Error al reservar los contadores");
 			exit(1);
 		}
+		tiempos.cont = &contadores;
 	}
 
-	// Esperar a que todos los hijos terminen
-	for (int i = 0; i < num_P; i++) {
-		wait(NULL);
+	inicioFase(&tiempos, MM_FASE_INICIALIZACION);
+	iniMatrix(matA, matB, N, num_P, compartida, op.semilla);
+	finFase(&tiempos, MM_FASE_INICIALIZACION);
+	impMatrix(matA, N);
+	impMatrix(matB, N);
+	if (op.informe)
+		informeMemoria("A|B|C", region, stderr);
+
+	if (motorFork.iniciar(&op, &tiempos) != 0) {
+		perror("Error al preparar el reparto de la forma");
+		exit(1);
+	}
+	double tMult = motorFork.multiplicar(&op, matA, matB, matC);
+	motorFork.terminar(&op);
+
+	printf("%9.0f ", tMult);
+	if (op.contadores)
+		columnasContadores(&contadores, 2.0 * N * N * N, tMult, stdout);
+	printf("\n");
+
+	if (compartida)
+		impMatrix(matC, N); // el padre ve el producto escrito por los hijos
+	if (op.informe)
+		informeHuella(N, 3, tMult, 1, stderr);
+
+	int fallo = op.verifica ? verificaProducto(matA, matB, matC, N, op.semilla, stderr) : 0;
+
+	escribeMedicion(&tiempos, op.formatoTiempo, "mmClasicaFork", N, stderr);
+	if (op.contadores) {
+		informeContadores(&contadores, op.informe, stderr);
+		liberaContadores(&contadores);
 	}
-	
-	FinMuestra(); // Finaliza medición y muestra el tiempo
+	finMedicion(&tiempos);
 
 	// Liberar memoria
-	free(matA);
-	free(matB);
-	free(matC);
+	liberaMatrices(region, &op);
 
-	return 0;
+	return fallo;
 }
+
+#endif /* MM_BINARIO_UNICO */
@@ -9,16 +9,30 @@
  * Implementación del algoritmo clásico de multiplicación de matrices
  * utilizando paralelismo con la biblioteca OpenMP.
  *
- * Cada hilo calcula un subconjunto de filas de la matriz resultado `mC`,
- * aprovechando múltiples núcleos del CPU mediante directivas de compilador
- * (`#pragma omp parallel` y `#pragma omp for`).
+ * La matriz resultado `mC` se divide en teselas y `#pragma omp for
+ * collapse(2) schedule(runtime)` las reparte entre los hilos, con la
+ * política de `-s estatico|dinamico|guiado[,n]` (n = teselas por trozo) o,
+ * sin `-s`, la de la variable de entorno OMP_SCHEDULE (estática si no
+ * está definida).
  *
  * Estructura del programa:
- *  - `iniMatrix()`: Inicializa matrices A y B con valores aleatorios.
+ *  - `iniMatrix()`: Inicializa A y B en paralelo (mmAleatorio.c, `--seed`).
  *  - `multiMatrix()`: Multiplica matrices usando paralelismo OpenMP.
+ *  - `multiMatrixPorBloques()`: Variante con los kernels comunes (`-b`, `-k`).
+ *  - `multiMatrixTuberia()`: Micro-kernel con el empaquetado de B en
+ *    tubería y buffers dobles por hilo (`--pipeline`, mmMicro.c).
+ *  - `eligeReparto()`: Política de `schedule(runtime)` (`-s`, OMP_SCHEDULE).
+ *  - `multiMatrixForma()`: Producto general M×K · K×N (`--shape`, mmForma.c).
+ *  - `multiMatrixLote()`: Lote de productos pequeños (`--batch`, mmLote.c).
+ *  - `colocaMatrices()` / `replicaMatriz()`: Afinidad y ubicación NUMA (`-a`).
  *  - `impMatrix()`: Imprime matrices pequeñas (N < 9).
- *  - `InicioMuestra()` / `FinMuestra()`: Miden el tiempo total de ejecución.
- *  - `main()`: Configura el entorno, ejecuta la multiplicación y muestra resultados.
+ *  - Tiempos por fase y por hilo con mmTiempo.c (`--timing csv|json`).
+ *  - `motorOpenMP` (`iniciaOpenMP()`, `multiplicaOpenMP()`,
+ *    `terminaOpenMP()`): configura y fija los hilos y ejecuta cada
+ *    multiplicación; es la interfaz que usa también el binario único `mm`
+ *    (ver mmMotor.h).
+ *  - `main()`: Reserva e inicializa las matrices, ejecuta el motor y muestra
+ *    resultados (se omite al compilar con -DMM_BINARIO_UNICO).
  *
  * ---------------------------------------------------------------
  */
@@ -26,38 +40,411 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#include <sys/time.h>
 #include <omp.h>
+#include "mmComun.h"
+#include "mmBloques.h"
+#include "mmMicro.h"
+#include "mmReparto.h"
+#include "mmAfinidad.h"
+#include "mmAleatorio.h"
+#include "mmVerifica.h"
+#include "mmTiempo.h"
+#include "mmMemoria.h"
+#include "mmForma.h"
+#include "mmTipo.h"
+#include "mmLote.h"
+#include "mmDispersa.h"
+#include "mmArchivo.h"
+#include "mmMotor.h"
 
-struct timeval inicio, fin;
+/* Lado de las teselas de C con el kernel clásico; con los kernels comunes
+ * la tesela es de `franjaFilas()` filas por MM_OMP_COLUMNAS columnas, para
+ * que el empaquetado de B se amortice en muchas filas */
+#define MM_OMP_TESELA    64
+#define MM_OMP_COLUMNAS  512
+
+/* Plan de afinidad y réplicas de B para `-a` (ver mmAfinidad.h) */
+static struct afinidad colocacion;
+static int replicada;   /* 1 → las réplicas de B ya están creadas */
+
+/* Tiempos por fase y por hilo de la ejecución en curso (ver mmTiempo.h); los
+ * entrega `iniciaOpenMP()` */
+static struct medicion *medida;
+
+/* Reparto del producto general (`--shape`, ver mmForma.h) */
+static struct particion plan;
+
+/*-----------------------------------------------------------------------------
+ * altoTesela, anchoTesela — Filas y columnas de las teselas de C que
+ * reparte el `omp for collapse(2)` del kernel elegido; la ubicación y la
+ * inicialización de A, B y C usan las mismas teselas.
+ *---------------------------------------------------------------------------*/
+static int altoTesela(const struct opciones *op) {
+	return kernelComun(op) ? franjaFilas(op) : MM_OMP_TESELA;
+}
+
+static int anchoTesela(const struct opciones *op) {
+	return kernelComun(op) ? MM_OMP_COLUMNAS : MM_OMP_TESELA;
+}
+
+/*-----------------------------------------------------------------------------
+ * multiMatrix — Multiplica matrices usando paralelismo OpenMP.
+ *
+ * Parámetros:
+ *  - mA: puntero a la matriz A.
+ *  - mB: puntero a la matriz B.
+ *  - mC: puntero a la matriz resultado C.
+ *  - D:  dimensión de las matrices cuadradas.
+ *
+ * Descripción:
+ *  Utiliza directivas OpenMP para distribuir el trabajo entre hilos. Cada hilo
+ *  calcula las teselas de MM_OMP_TESELA × MM_OMP_TESELA de `mC` que le
+ *  asigna el reparto. La multiplicación se realiza utilizando el algoritmo
+ *  clásico O(n³) en formato lineal, con el mismo orden de sumas que antes.
+ *
+ * Notas:
+ *  - `collapse(2)` reparte el espacio 2-D de teselas (filas × columnas), de
+ *    modo que con N pequeño hay trabajo para más hilos que filas de teselas.
+ *  - `schedule(runtime)` toma la política fijada por `eligeReparto()`.
+ *  - `Suma`, `pA` y `pB` se declaran dentro del bucle y son privadas de
+ *    cada hilo. Antes se declaraban fuera de la región paralela y eran
+ *    compartidas: una condición de carrera que podía corromper C.
+ *---------------------------------------------------------------------------*/
+static void multiMatrix(const double *mA, const double *mB, double *mC, int D) {
+	int teselas = (D + MM_OMP_TESELA - 1) / MM_OMP_TESELA;
+
+	#pragma omp parallel
+	{
+		const double *mBl = matrizLocal(&colocacion, mB);
+
+		inicioTrabajador(medida, omp_get_thread_num());
+		#pragma omp for collapse(2) schedule(runtime) nowait
+		for (int ti = 0; ti < teselas; ti++) {
+			for (int tj = 0; tj < teselas; tj++) {
+				int iI = ti * MM_OMP_TESELA, iF = (iI + MM_OMP_TESELA < D) ? iI + MM_OMP_TESELA : D;
+				int jI = tj * MM_OMP_TESELA, jF = (jI + MM_OMP_TESELA < D) ? jI + MM_OMP_TESELA : D;
+
+				for (int i = iI; i < iF; i++) {
+					for (int j = jI; j < jF; j++) {
+						const double *pA = mA + (size_t) i * D;
+						const double *pB = mBl + j;
+						double Suma = 0.0;
+
+						for (int k = 0; k < D; k++, pA++, pB += D) {
+							Suma += *pA * *pB;
+						}
+						mC[(size_t) i * D + j] = Suma;
+					}
+				}
+			}
+		}
+		finTrabajador(medida, omp_get_thread_num());
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * multiMatrixPorBloques — Versión de `multiMatrix()` con los kernels comunes.
+ *
+ * Parámetros:
+ *  - op: opciones del programa (`-b` kernel por bloques, `-k` micro-kernel).
+ *  - mA, mB, mC, D: igual que en `multiMatrix()`.
+ *
+ * Descripción:
+ *  Reparte entre los hilos, con `collapse(2)` y la política de
+ *  `eligeReparto()`, teselas de C con tantas filas como el bloque del kernel
+ *  elegido y MM_OMP_COLUMNAS columnas; cada tesela se calcula con
+ *  `multiTeselaComunEn()` de mmComun.c, con los buffers de empaquetado que
+ *  cada hilo reserva una vez al entrar en la región paralela.
+ *---------------------------------------------------------------------------*/
+static void multiMatrixPorBloques(const struct opciones *op, const double *mA, const double *mB,
+                                  double *mC, int D) {
+	int tam = franjaFilas(op);
+	int franjas = (D + tam - 1) / tam;
+	int columnas = (D + MM_OMP_COLUMNAS - 1) / MM_OMP_COLUMNAS;
+
+	#pragma omp parallel
+	{
+		const double *mBl = matrizLocal(&colocacion, mB);
+		size_t elems = elemsTrabajoComun(op, MM_OMP_COLUMNAS);
+		double *trabajo = (elems > 0) ? aligned_alloc(64, sizeof(double) * elems) : NULL;
+
+		if (elems > 0 && trabajo == NULL) {
+			perror("Error al reservar los buffers de empaquetado");
+			exit(1);
+		}
+
+		inicioTrabajador(medida, omp_get_thread_num());
+		#pragma omp for collapse(2) schedule(runtime) nowait
+		for (int ti = 0; ti < franjas; ti++) {
+			for (int tj = 0; tj < columnas; tj++) {
+				int iI = ti * tam, iF = (iI + tam < D) ? iI + tam : D;
+				int jI = tj * MM_OMP_COLUMNAS, jF = (jI + MM_OMP_COLUMNAS < D) ? jI + MM_OMP_COLUMNAS : D;
+
+				multiTeselaComunEn(op, mA, mBl, 0, mC, D, iI, iF, jI, jF, trabajo);
+			}
+		}
+		finTrabajador(medida, omp_get_thread_num());
+		free(trabajo);
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * multiMatrixTuberia — `multiMatrixPorBloques()` con el micro-kernel en
+ * tubería (`--pipeline`).
+ *
+ * Descripción:
+ *  Mismas teselas y mismo reparto, pero cada hilo reserva una sola vez, al
+ *  entrar en la región paralela, su bloque de A y sus dos paneles de B
+ *  (`elemsTuberia()`) y los reutiliza en todas sus teselas: mientras
+ *  multiplica un panel de B empaqueta el siguiente en el otro buffer (ver
+ *  `multiFormaTuberiaEn()`).
+ *---------------------------------------------------------------------------*/
+static void multiMatrixTuberia(const struct opciones *op, const double *mA, const double *mB,
+                               double *mC, int D) {
+	int tam = franjaFilas(op);
+	int franjas = (D + tam - 1) / tam;
+	int columnas = (D + MM_OMP_COLUMNAS - 1) / MM_OMP_COLUMNAS;
+
+	#pragma omp parallel
+	{
+		const double *mBl = matrizLocal(&colocacion, mB);
+		double *trabajo = aligned_alloc(64, sizeof(double) * elemsTuberia(MM_OMP_COLUMNAS));
+
+		if (trabajo == NULL) {
+			perror("Error al reservar los buffers de la tubería");
+			exit(1);
+		}
+
+		inicioTrabajador(medida, omp_get_thread_num());
+		#pragma omp for collapse(2) schedule(runtime) nowait
+		for (int ti = 0; ti < franjas; ti++) {
+			for (int tj = 0; tj < columnas; tj++) {
+				int iI = ti * tam, iF = (iI + tam < D) ? iI + tam : D;
+				int jI = tj * MM_OMP_COLUMNAS, jF = (jI + MM_OMP_COLUMNAS < D) ? jI + MM_OMP_COLUMNAS : D;
+
+				multiFormaTuberiaEn(mA, D, mBl, D, 0, mC, D, D, iI, iF, jI, jF, op->kernel, trabajo);
+			}
+		}
+		finTrabajador(medida, omp_get_thread_num());
+		free(trabajo);
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * multiMatrixForma — Producto general C (M×N) = A (M×K) · B (K×N).
+ *
+ * Parámetros:
+ *  - op: opciones del programa (kernel).
+ *  - mA, mB, mC: matrices con los saltos de `plan.f`.
+ *
+ * Descripción:
+ *  El hilo t calcula el trozo t de `plan` (filas, columnas o rango de K
+ *  según la forma, ver mmForma.c). Si el plan divide K, tras la barrera
+ *  implícita del primer `omp for` los hilos suman las parciales a C.
+ *---------------------------------------------------------------------------*/
+static void multiMatrixForma(const struct opciones *op, const double *mA, const double *mB, double *mC) {
+	#pragma omp parallel
+	{
+		const double *mBl = matrizLocal(&colocacion, mB);
+
+		inicioTrabajador(medida, omp_get_thread_num());
+		#pragma omp for schedule(static)
+		for (int t = 0; t < plan.trozos; t++)
+			calculaTrozo(op, &plan, mA, mBl, plan.f.ldb, 0, mC, t);
+		#pragma omp for schedule(static) nowait
+		for (int r = 0; r < plan.franjas; r++)
+			reduceFranja(&plan, mC, r);
+		finTrabajador(medida, omp_get_thread_num());
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * multiMatrixLote — Lote de productos pequeños e independientes.
+ *
+ * Descripción:
+ *  Una sola región paralela para todo el lote: el `omp for` reparte
+ *  productos completos con la política de `eligeReparto()` y cada hilo los
+ *  calcula con su propio trabajo de lote (kernel directo o buffers del
+ *  micro-kernel, ver mmLote.c).
+ *---------------------------------------------------------------------------*/
+static void multiMatrixLote(const struct opciones *op, const double *mA, const double *mB, double *mC) {
+	size_t paso = (size_t) op->N * op->N;
+
+	#pragma omp parallel
+	{
+		struct trabajoLote t;
+
+		inicioTrabajador(medida, omp_get_thread_num());
+		iniTrabajoLote(&t, op);
+		#pragma omp for schedule(runtime) nowait
+		for (int b = 0; b < op->lote; b++)
+			multiLote(&t, mA, mB, mC, paso, b, b + 1);
+		finTrabajoLote(&t);
+		finTrabajador(medida, omp_get_thread_num());
+	}
+}
 
 /*-----------------------------------------------------------------------------
- * InicioMuestra — Inicia el cronómetro de medición del rendimiento.
+ * replicaMatriz — Crea una réplica de B en cada nodo NUMA (`-a <pol>,replica`).
  *
  * Descripción:
- *  Registra el instante inicial utilizando `gettimeofday()` para calcular
- *  el tiempo total del bloque de ejecución.
+ *  El primer hilo de cada nodo copia los `elems` elementos de la matriz a la
+ *  réplica de su nodo; los kernels obtienen luego la copia local con
+ *  `matrizLocal()`.
  *---------------------------------------------------------------------------*/
-void InicioMuestra() {
-	gettimeofday(&inicio, (void *)0);
+static void replicaMatriz(const double *m, size_t elems) {
+	if (reservaReplicas(&colocacion, m, elems) != 0) {
+		perror("Error al reservar las réplicas");
+		exit(1);
+	}
+
+	#pragma omp parallel
+	copiaReplica(&colocacion, omp_get_thread_num());
 }
 
 /*-----------------------------------------------------------------------------
- * FinMuestra — Finaliza la medición y muestra el tiempo total.
+ * eligeReparto — Fija la política de `schedule(runtime)` de los kernels;
+ * `repartoDeEntorno()` indica si se deja la de OMP_SCHEDULE.
  *
  * Descripción:
- *  Calcula la diferencia entre los valores almacenados en `inicio` y `fin`
- *  en microsegundos, e imprime el resultado en pantalla.
+ *  `-s estatico|dinamico|guiado[,n]` se traduce a `omp_set_schedule()` con
+ *  trozos de n teselas (0 → el trozo por defecto de OpenMP: bloques iguales
+ *  en el estático, una tesela en los otros). `-s robo` no tiene colas por
+ *  hilo en OpenMP y se aproxima con el dinámico. Sin `-s` (o con `-s
+ *  estatico` sin trozo) se respeta OMP_SCHEDULE si está definida; si no,
+ *  el reparto es estático, como el `omp for` original.
+ *---------------------------------------------------------------------------*/
+static int repartoDeEntorno(const struct opciones *op) {
+	return op->reparto == MM_REPARTO_ESTATICO && op->trozo == 0 && getenv("OMP_SCHEDULE") != NULL;
+}
+
+static void eligeReparto(const struct opciones *op) {
+	if (repartoDeEntorno(op))
+		return;
+
+	omp_sched_t tipo = omp_sched_dynamic;
+	if (op->reparto == MM_REPARTO_ESTATICO)
+		tipo = omp_sched_static;
+	else if (op->reparto == MM_REPARTO_GUIADO)
+		tipo = omp_sched_guided;
+	omp_set_schedule(tipo, (op->lote > 0 && tipo != omp_sched_static) ? trozoLote(op) : op->trozo);
+}
+
+/*-----------------------------------------------------------------------------
+ * informeReparto — Muestra en stderr el reparto efectivo (`-v`).
  *---------------------------------------------------------------------------*/
-void FinMuestra() {
-	gettimeofday(&fin, (void *)0);
-	fin.tv_usec -= inicio.tv_usec;
-	fin.tv_sec  -= inicio.tv_sec;
-	double tiempo = (double)(fin.tv_sec * 1000000 + fin.tv_usec);
-	printf("%9.0f \n", tiempo);
+static void informeReparto(const struct opciones *op, FILE *f) {
+	static const char *nombres[] = { "", "estatico", "dinamico", "guiado", "auto" };
+	omp_sched_t tipo;
+	int trozo;
+
+	omp_get_schedule(&tipo, &trozo);
+	tipo &= ~omp_sched_monotonic;
+	if (op->lote > 0) {
+		fprintf(f, "Reparto OpenMP: schedule(%s, %d) sobre los %d productos del lote%s\n",
+		        (tipo >= omp_sched_static && tipo <= omp_sched_auto) ? nombres[tipo] : "?", trozo,
+		        op->lote, repartoDeEntorno(op) ? ", de OMP_SCHEDULE" : "");
+		return;
+	}
+	fprintf(f, "Reparto OpenMP: schedule(%s, %d) sobre teselas de %d×%d (collapse(2))%s\n",
+	        (tipo >= omp_sched_static && tipo <= omp_sched_auto) ? nombres[tipo] : "?", trozo,
+	        altoTesela(op), anchoTesela(op), repartoDeEntorno(op) ? ", de OMP_SCHEDULE" : "");
+	if (op->afinidad != MM_AFIN_NINGUNA && tipo != omp_sched_static)
+		fprintf(f, "Aviso: con un reparto no estático las teselas no caen en el hilo que las ubicó por "
+		        "primer toque; la ubicación NUMA de A y C es aproximada\n");
 }
 
+/*-----------------------------------------------------------------------------
+ * iniciaOpenMP — Prepara el motor OpenMP clásico (ver mmMotor.h).
+ *
+ * Descripción:
+ *  Configura el número de hilos con `omp_set_num_threads()` y, con `-a`,
+ *  arma el plan de afinidad y fija cada hilo del equipo a su CPU
+ *  (equivalente a OMP_PLACES con OMP_PROC_BIND); los hilos de OpenMP
+ *  persisten entre regiones paralelas, así que la fijación se conserva.
+ *  Fija la política de reparto de las teselas (`eligeReparto()`). Con
+ *  `--shape` planifica además el reparto de la forma. Retorna -1 si falla
+ *  alguna reserva.
+ *---------------------------------------------------------------------------*/
+static int iniciaOpenMP(const struct opciones *op, struct medicion *m) {
+	medida = m;
+	replicada = 0;
+	omp_set_num_threads(op->P);
+	eligeReparto(op);
+	if (op->informe && !formaGeneral(op))
+		informeReparto(op, stderr);
+
+	if (formaGeneral(op)) {
+		struct forma f;
+
+		formaDe(op, &f);
+		if (iniParticion(&plan, &f, op->P, 0, op->paginas) != 0)
+			return -1;
+	}
+
+	if (op->afinidad != MM_AFIN_NINGUNA) {
+		if (iniAfinidad(&colocacion, op->afinidad, op->P) != 0)
+			return -1;
+
+		#pragma omp parallel
+		fijaHiloActual(&colocacion, omp_get_thread_num());
+	}
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * multiplicaOpenMP — Una multiplicación C = A·B con el equipo de hilos.
+ *
+ * Descripción:
+ *  En la primera llamada con `-a <pol>,replica` se replica B (fuera del
+ *  tiempo medido). Con `--shape` se sigue el plan de la forma y con
+ *  `--batch` se reparten los productos del lote; si no, con `--pipeline` el
+ *  micro-kernel en tubería, con `-b` o `-k` los kernels comunes y sin ellos
+ *  el kernel clásico.
+ *  Retorna el tiempo de la multiplicación en µs.
+ *---------------------------------------------------------------------------*/
+static double multiplicaOpenMP(const struct opciones *op, const double *mA, const double *mB, double *mC) {
+	int general = formaGeneral(op);
+
+	if (op->afinidad != MM_AFIN_NINGUNA && op->replicaB && !replicada) {
+		replicaMatriz(mB, general ? (size_t) plan.f.K * plan.f.ldb : (size_t) op->N * op->N);
+		replicada = 1;
+	}
+
+	inicioFase(medida, MM_FASE_MULTIPLICACION);
+	if (general)
+		multiMatrixForma(op, mA, mB, mC);
+	else if (op->lote > 0)
+		multiMatrixLote(op, mA, mB, mC);
+	else if (op->tuberia)
+		multiMatrixTuberia(op, mA, mB, mC, op->N);
+	else if (kernelComun(op))
+		multiMatrixPorBloques(op, mA, mB, mC, op->N);
+	else
+		multiMatrix(mA, mB, mC, op->N);
+	return finFase(medida, MM_FASE_MULTIPLICACION);
+}
+
+/*-----------------------------------------------------------------------------
+ * terminaOpenMP — Suelta los hilos fijados y libera el plan de afinidad y el
+ * de la forma.
+ *---------------------------------------------------------------------------*/
+static void terminaOpenMP(const struct opciones *op) {
+	finParticion(&plan);
+	if (op->afinidad != MM_AFIN_NINGUNA) {
+		#pragma omp parallel
+		sueltaHiloActual();
+
+		finAfinidad(&colocacion);
+		memset(&colocacion, 0, sizeof(colocacion));
+	}
+	medida = NULL;
+}
+
+const struct motor motorOpenMP = { "openmp", iniciaOpenMP, multiplicaOpenMP, terminaOpenMP, 1 };
+
+#ifndef MM_BINARIO_UNICO
+
 /*-----------------------------------------------------------------------------
  * impMatrix — Imprime una matriz cuadrada si el tamaño es pequeño (N < 9).
  *
@@ -69,7 +456,7 @@ void FinMuestra() {
  *  Muestra los elementos en formato flotante con dos decimales. Se utiliza
  *  principalmente para depuración o verificación de resultados.
  *---------------------------------------------------------------------------*/
-void impMatrix(double *matrix, int D) {
+static void impMatrix(double *matrix, int D) {
 	if (D < 9) {
 		printf("\n");
 		for (int i = 0; i < D * D; i++) {
@@ -84,61 +471,90 @@ void impMatrix(double *matrix, int D) {
  * iniMatrix — Inicializa matrices A y B con valores aleatorios.
  *
  * Parámetros:
+ *  - op: opciones del programa (semilla y franja de filas).
  *  - m1: puntero a la matriz A.
  *  - m2: puntero a la matriz B.
  *  - D:  dimensión de las matrices cuadradas.
  *
  * Descripción:
- *  Genera valores flotantes pseudoaleatorios:
+ *  Los hilos llenan teselas en paralelo con el generador por contador de
+ *  mmAleatorio.c (semilla `--seed`):
  *   - A: valores entre 1.0 y 5.0
- *   - B: valores entre 2.0 y 9.0
+ *   - B: valores entre 5.0 y 9.0
+ *  Las teselas y el reparto (`collapse(2) schedule(runtime)`, fijado por
+ *  `eligeReparto()`) son los de la multiplicación: con el reparto estático
+ *  cada hilo llena las teselas que después calculará. Con dinámico o
+ *  guiado la asignación cambia de una región a otra y la coincidencia es
+ *  solo aproximada.
  *---------------------------------------------------------------------------*/
-void iniMatrix(double *m1, double *m2, int D) {
-	for (int i = 0; i < D * D; i++, m1++, m2++) {
-		*m1 = (double)rand() / RAND_MAX * (5.0 - 1.0);
-		*m2 = (double)rand() / RAND_MAX * (9.0 - 2.0);
+static void iniMatrix(const struct opciones *op, double *m1, double *m2, int D) {
+	int alto = altoTesela(op), ancho = anchoTesela(op);
+	int franjas = (D + alto - 1) / alto;
+	int columnas = (D + ancho - 1) / ancho;
+
+	#pragma omp parallel for collapse(2) schedule(runtime)
+	for (int ti = 0; ti < franjas; ti++) {
+		for (int tj = 0; tj < columnas; tj++) {
+			int iI = ti * alto, iF = (iI + alto < D) ? iI + alto : D;
+			int jI = tj * ancho, jF = (jI + ancho < D) ? jI + ancho : D;
+
+			iniMatrixTesela(m1, m2, D, iI, iF, jI, jF, op->semilla);
+		}
 	}
 }
 
 /*-----------------------------------------------------------------------------
- * multiMatrix — Multiplica matrices usando paralelismo OpenMP.
+ * colocaMatrices — Ubica A y C por primer toque.
  *
  * Parámetros:
- *  - mA: puntero a la matriz A.
- *  - mB: puntero a la matriz B.
- *  - mC: puntero a la matriz resultado C.
- *  - D:  dimensión de las matrices cuadradas.
+ *  - op: opciones del programa (definen las teselas y el reparto).
+ *  - mA, mC: matrices aún sin inicializar.
+ *  - D: dimensión de las matrices.
  *
  * Descripción:
- *  Utiliza directivas OpenMP para distribuir el trabajo entre hilos. Cada hilo
- *  calcula las filas correspondientes de `mC`. La multiplicación se realiza
- *  utilizando el algoritmo clásico O(n³) en formato lineal.
+ *  Con los hilos ya fijados por `iniciaOpenMP()`, cada uno escribe primero
+ *  sus teselas de A y C con el mismo `collapse(2) schedule(runtime)` de la
+ *  multiplicación, para que esas páginas queden en su nodo NUMA; `iniMatrix()`
+ *  las llena luego con el mismo reparto.
  *
- * Notas:
- *  - La directiva `#pragma omp for` distribuye el bucle externo de `i`.
- *  - Cada hilo tiene su propia variable local `Suma`, evitando condiciones de carrera.
+ *  La ubicación es exacta (a nivel de página) solo con el reparto estático,
+ *  que asigna las mismas teselas a los mismos hilos en cada región. Con
+ *  `-s dinamico|guiado` la asignación cambia entre regiones y la ubicación
+ *  es aproximada (`-v` lo avisa). Una franja de filas de A la leen todas
+ *  las teselas de esa franja, así que queda repartida entre sus dueños.
  *---------------------------------------------------------------------------*/
-void multiMatrix(double *mA, double *mB, double *mC, int D) {
-	double Suma, *pA, *pB;
+static void colocaMatrices(const struct opciones *op, double *mA, double *mC, int D) {
+	int alto = altoTesela(op), ancho = anchoTesela(op);
+	int franjas = (D + alto - 1) / alto;
+	int columnas = (D + ancho - 1) / ancho;
 
-	#pragma omp parallel
-	{
-		#pragma omp for
-		for (int i = 0; i < D; i++) {
-			for (int j = 0; j < D; j++) {
-				pA = mA + i * D;
-				pB = mB + j;
-				Suma = 0.0;
-
-				for (int k = 0; k < D; k++, pA++, pB += D) {
-					Suma += *pA * *pB;
-				}
-				mC[i * D + j] = Suma;
-			}
+	#pragma omp parallel for collapse(2) schedule(runtime)
+	for (int ti = 0; ti < franjas; ti++) {
+		for (int tj = 0; tj < columnas; tj++) {
+			int iI = ti * alto, iF = (iI + alto < D) ? iI + alto : D;
+			int jI = tj * ancho, jF = (jI + ancho < D) ? jI + ancho : D;
+
+			tocaTesela(mA, D, iI, iF, jI, jF);
+			tocaTesela(mC, D, iI, iF, jI, jF);
 		}
 	}
 }
 
+/*-----------------------------------------------------------------------------
+ * traficoTuberia — Tráfico con memoria de `multiMatrixTuberia()`: la suma
+ * de `traficoMicro()` sobre las teselas.
+ *---------------------------------------------------------------------------*/
+static double traficoTuberia(const struct opciones *op, int D) {
+	int tam = franjaFilas(op);
+	double bytes = 0.0;
+
+	for (int iI = 0; iI < D; iI += tam)
+		for (int jI = 0; jI < D; jI += MM_OMP_COLUMNAS)
+			bytes += traficoMicro((iI + tam < D) ? tam : D - iI,
+			                      (jI + MM_OMP_COLUMNAS < D) ? MM_OMP_COLUMNAS : D - jI, D);
+	return bytes;
+}
+
 /*-----------------------------------------------------------------------------
  * main — Función principal del programa.
  *
@@ -147,42 +563,114 @@ void multiMatrix(double *mA, double *mB, double *mC, int D) {
  *  - argv: arreglo de cadenas con los argumentos.
  *
  * Descripción:
- *  1. Valida la cantidad de parámetros.
+ *  1. Valida los parámetros y las opciones (ver mmComun.c); con `--shape` o
+ *     `--pad` el producto general lo ejecuta `ejecutaForma()` (mmForma.c)
+ *     con este motor, con `--type` `ejecutaTipo()` (mmTipo.c), con
+ *     `--files` `ejecutaArchivo()` (mmArchivo.c) y con `--density`
+ *     `ejecutaDispersa()` (mmDispersa.c).
  *  2. Reserva memoria para matrices A, B y C.
- *  3. Inicializa matrices con valores aleatorios.
- *  4. Configura el número de hilos con `omp_set_num_threads()`.
- *  5. Realiza la multiplicación y mide el tiempo total.
- *  6. Libera la memoria al finalizar.
+ *  3. Prepara el motor (`iniciaOpenMP()`): número de hilos y, con `-a`,
+ *     fijación de hilos; luego ubica A y C por primer toque.
+ *  4. Inicializa matrices con valores aleatorios.
+ *  5. Realiza la multiplicación (que replica B con `-a <pol>,replica`) y
+ *     mide el tiempo total.
+ *  6. Con `--verify`, comprueba C = A·B fuera del tiempo medido.
+ *  7. Libera la memoria al finalizar.
  *---------------------------------------------------------------------------*/
 int main(int argc, char *argv[]) {
-	if (argc < 3) {
-		printf("\nUso: ./clasicaOpenMP <TamañoMatriz> <NumHilos>\n\n");
-		exit(0);
+	struct opciones op;
+	leerOpciones(argc, argv, "./clasicaOpenMP", &op);
+	if (op.archivos[0] != NULL)
+		return ejecutaArchivo(&op, &motorOpenMP, 0, "mmClasicaOpenMP");
+	if (formaGeneral(&op))
+		return ejecutaForma(&op, &motorOpenMP, 0, "mmClasicaOpenMP");
+	if (op.tipo != MM_TIPO_NINGUNO)
+		return ejecutaTipo(&op, &motorOpenMP, 0, "mmClasicaOpenMP");
+	if (op.lote > 0)
+		return ejecutaLote(&op, &motorOpenMP, 0, "mmClasicaOpenMP");
+	if (op.densidad > 0.0)
+		return ejecutaDispersa(&op, &motorOpenMP, 0, "mmClasicaOpenMP");
+
+	int N = op.N;
+	int TH = op.P;
+
+	if (compruebaHuella(N, 3, stderr) != 0)
+		exit(1);
+
+	/* Con -a la ubicación de A y C la hace el primer toque de cada hilo */
+	int precarga = op.precarga && op.afinidad == MM_AFIN_NINGUNA;
+	double *matrixA = reservaMatriz((size_t) N * N, op.paginas, 0, precarga);
+	double *matrixB = reservaMatriz((size_t) N * N, op.paginas, 0, op.precarga);
+	double *matrixC = reservaMatriz((size_t) N * N, op.paginas, 0, precarga);
+	if (matrixA == NULL || matrixB == NULL || matrixC == NULL) {
+		perror("Error al reservar memoria para las matrices");
+		exit(1);
 	}
 
-	int N = atoi(argv[1]);
-	int TH = atoi(argv[2]);
-	double *matrixA = (double *)calloc(N * N, sizeof(double));
-	double *matrixB = (double *)calloc(N * N, sizeof(double));
-	double *matrixC = (double *)calloc(N * N, sizeof(double));
+	struct medicion tiempos;
+	struct contadores contadores;
 
-	srand(time(NULL));
-	omp_set_num_threads(TH);
+	if (iniMedicion(&tiempos, TH) != 0) {
+		perror("Error al reservar las marcas de tiempo");
+		exit(1);
+	}
 
-	iniMatrix(matrixA, matrixB, N);
+	if (op.contadores) {
+		if (iniContadores(&contadores, TH) != 0) {
+			perror("Error al reservar los contadores");
+			exit(1);
+		}
+		tiempos.cont = &contadores;
+	}
+
+	if (motorOpenMP.iniciar(&op, &tiempos) != 0) {
+		perror("Error al preparar la afinidad de hilos");
+		exit(1);
+	}
+	if (op.afinidad != MM_AFIN_NINGUNA)
+		colocaMatrices(&op, matrixA, matrixC, N);
+
+	inicioFase(&tiempos, MM_FASE_INICIALIZACION);
+	iniMatrix(&op, matrixA, matrixB, N);
+	finFase(&tiempos, MM_FASE_INICIALIZACION);
 	impMatrix(matrixA, N);
 	impMatrix(matrixB, N);
 
-	InicioMuestra();
-	multiMatrix(matrixA, matrixB, matrixC, N);
-	FinMuestra();
+	double tMult = motorOpenMP.multiplicar(&op, matrixA, matrixB, matrixC);
+	if (op.afinidad != MM_AFIN_NINGUNA)
+		informeAfinidad(&colocacion, stderr);
+
+	printf("%9.0f ", tMult);
+	if (op.contadores)
+		columnasContadores(&contadores, 2.0 * N * N * N, tMult, stdout);
+	printf("\n");
 
 	impMatrix(matrixC, N);
+	if (op.informe) {
+		informeMemoria("A", matrixA, stderr);
+		informeMemoria("B", matrixB, stderr);
+		informeMemoria("C", matrixC, stderr);
+		informeHuella(N, 3, tMult, 1, stderr);
+		if (op.tuberia)
+			informeAncho("tubería", traficoTuberia(&op, N), tMult, 1, TH, stderr);
+	}
+
+	int fallo = op.verifica ? verificaProducto(matrixA, matrixB, matrixC, N, op.semilla, stderr) : 0;
+
+	motorOpenMP.terminar(&op);
+	escribeMedicion(&tiempos, op.formatoTiempo, "mmClasicaOpenMP", N, stderr);
+	if (op.contadores) {
+		informeContadores(&contadores, op.informe, stderr);
+		liberaContadores(&contadores);
+	}
+	finMedicion(&tiempos);
 
 	/* Liberación de memoria */
-	free(matrixA);
-	free(matrixB);
-	free(matrixC);
+	liberaMatriz(matrixA, (size_t) N * N, op.paginas);
+	liberaMatriz(matrixB, (size_t) N * N, op.paginas);
+	liberaMatriz(matrixC, (size_t) N * N, op.paginas);
 
-	return 0;
+	return fallo;
 }
+
+#endif /* MM_BINARIO_UNICO */
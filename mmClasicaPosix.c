@@ -10,14 +10,37 @@
  * utilizando paralelismo con **hilos POSIX (Pthreads)**.
  *
  * Cada hilo ejecuta una porción del cálculo de la matriz resultado `matrixC`,
- * procesando un conjunto de filas determinado en función de su identificador.
+ * procesando los rangos de filas que le entrega la capa de reparto
+ * (mmReparto.c): estático balanceado, dinámico o guiado según `-s`. Con
+ * `-s robo` C se divide en teselas 2-D y los hilos se roban trabajo entre
+ * sí (mmRobo.c); `-v` muestra teselas, robos y tiempo ocioso por hilo.
+ *
+ * Con `-a` los hilos del pool se fijan a CPUs y tocan primero sus franjas de
+ * A y C antes de la inicialización, para que queden en su nodo NUMA; con
+ * `-a <pol>,replica` cada nodo trabaja con su propia copia de B.
+ *
+ * Los hilos pertenecen a un pool persistente (mmPool.c) que se crea una sola
+ * vez; cada multiplicación solo cruza dos barreras. Con `-r R` se ejecutan R
+ * multiplicaciones seguidas sobre el mismo pool y se informa por separado el
+ * arranque del pool y la latencia por llamada (media, mínima y máxima).
  *
  * Estructura del programa:
- *  - `iniMatrix()`: Inicializa matrices A y B con valores aleatorios.
+ *  - `iniMatrix()`: Tarea del pool que inicializa A y B (mmAleatorio.c).
  *  - `impMatrix()`: Imprime matrices pequeñas (N < 9).
- *  - `multiMatrix()`: Función que ejecuta cada hilo para calcular su bloque.
- *  - `InicioMuestra()` y `FinMuestra()`: Miden el tiempo total en microsegundos.
- *  - `main()`: Configura hilos, crea y sincroniza la ejecución, libera recursos.
+ *  - `multiTesela()`: Calcula una región (filas × columnas) de C.
+ *  - `multiMatrix()`: Función que ejecuta cada hilo; pide rangos al reparto.
+ *  - `multiForma()` / `reduceForma()`: Producto general M×K · K×N
+ *    (`--shape`, mmForma.c).
+ *  - `multiLoteHilo()`: Lote de productos pequeños (`--batch`, mmLote.c);
+ *    el reparto entrega rangos de productos en lugar de filas.
+ *  - `fijaHilo()` / `colocaHilo()` / `replicaHilo()`: Tareas de afinidad y
+ *    ubicación NUMA.
+ *  - Tiempos por fase y por hilo con mmTiempo.c (`--timing csv|json`).
+ *  - `motorPosix` (`iniciaPosix()`, `multiplicaPosix()`, `terminaPosix()`):
+ *    crea el pool, ejecuta cada multiplicación y lo destruye; es la interfaz
+ *    que usa también el binario único `mm` (ver mmMotor.h).
+ *  - `main()`: Reserva e inicializa las matrices, ejecuta el motor y libera
+ *    recursos (se omite al compilar con -DMM_BINARIO_UNICO).
  *
  * ---------------------------------------------------------------
  */
@@ -26,70 +49,375 @@
 #include <pthread.h>
 #include <unistd.h>
 #include <stdlib.h>
-#include <time.h>
-#include <sys/time.h>
+#include <string.h>
+#include "mmComun.h"
+#include "mmBloques.h"
+#include "mmReparto.h"
+#include "mmPool.h"
+#include "mmRobo.h"
+#include "mmAfinidad.h"
+#include "mmAleatorio.h"
+#include "mmVerifica.h"
+#include "mmTiempo.h"
+#include "mmMemoria.h"
+#include "mmForma.h"
+#include "mmTipo.h"
+#include "mmLote.h"
+#include "mmDispersa.h"
+#include "mmArchivo.h"
+#include "mmMotor.h"
 
 /*-----------------------------------------------------------------------------
- * Variables globales:
+ * Variables globales (privadas del módulo):
  *  - Mutex: controla acceso concurrente (aunque aquí no se usa intensivamente)
- *  - Matrices: A, B, C son globales para que todos los hilos puedan acceder.
+ *  - Matrices: A, B, C de la multiplicación en curso, visibles a todos los
+ *    hilos del pool.
+ *  - Reparto: cola de filas compartida por los hilos (ver mmReparto.h).
+ *  - Robo: colas de teselas por hilo para `-s robo` (ver mmRobo.h).
+ *  - Colocación: plan de afinidad y réplicas de B para `-a` (mmAfinidad.h).
+ *  - Medida: marcas por fase y por hilo (mmTiempo.h), la entrega
+ *    `iniciaPosix()`.
+ *  - Pool: hilos persistentes y estado que `iniciaPosix()` prepara una vez
+ *    para todas las multiplicaciones.
+ *  - Plan: reparto del producto general (`--shape`, ver mmForma.h).
+ *  - Trabajo: buffers de empaquetado del micro-kernel, `elemsHilo` doubles
+ *    por hilo, reservados una vez en `iniciaPosix()`.
  *---------------------------------------------------------------------------*/
-pthread_mutex_t MM_mutex;
-double *matrixA, *matrixB, *matrixC;
+static pthread_mutex_t MM_mutex;
+static const double *matrixA, *matrixB;
+static double *matrixC;
+static struct reparto repartoFilas;
+static struct robo roboTeselas;
+static struct afinidad colocacion;
+static struct medicion *medida;
+
+static struct pool grupo;
+static int trozoFilas;    /* filas por trozo del reparto dinámico/guiado */
+static int conRobo;       /* 1 → `-s robo`                               */
+static int replicada;     /* 1 → las réplicas de B ya están creadas       */
+static int general;       /* 1 → producto general (`--shape`, `--pad`)    */
+static struct particion plan;
+static double *trabajoHilos;
+static size_t elemsHilo;
 
 /*-----------------------------------------------------------------------------
  * Estructura de parámetros:
- *  Contiene los datos que cada hilo necesita para su ejecución.
+ *  Contiene los datos que los hilos necesitan para su ejecución; es única y
+ *  compartida (el identificador de cada hilo lo entrega el pool).
  *  - nH: número total de hilos.
- *  - idH: identificador del hilo (0, 1, 2...).
  *  - N: dimensión de las matrices cuadradas.
+ *  - op: opciones del programa (kernel por bloques o micro-kernel).
  *---------------------------------------------------------------------------*/
 struct parametros {
 	int nH;
-	int idH;
 	int N;
+	const struct opciones *op;
 };
 
-struct timeval inicio, fin;
+static struct parametros datos;
 
 /*-----------------------------------------------------------------------------
- * InicioMuestra — Marca el inicio del tiempo de medición.
+ * multiTesela — Calcula la región [filaI, filaF) × [colI, colF) de C.
+ *
+ * Parámetros:
+ *  - mB: matriz B que usa el hilo (global o réplica de su nodo).
+ *  - D: dimensión de las matrices.
+ *  - filaI, filaF: rango de filas.
+ *  - colI, colF: rango de columnas (0, D para filas completas).
+ *  - op: opciones; con `-b` o `-k` la región se calcula con el kernel común
+ *        correspondiente (ver `multiTeselaComunEn()` en mmComun.c).
+ *  - trabajo: buffers de empaquetado del hilo (NULL si el kernel no
+ *             empaqueta).
+ *
+ * Descripción:
+ *  El cálculo sigue el algoritmo clásico O(n³) sobre la región indicada.
  *---------------------------------------------------------------------------*/
-void InicioMuestra() {
-	gettimeofday(&inicio, (void *)0);
+static void multiTesela(const double *mB, int D, int filaI, int filaF, int colI, int colF,
+                        const struct opciones *op, double *trabajo) {
+	const double *pA, *pB;
+	double Suma;
+
+	if (kernelComun(op)) {
+		multiTeselaComunEn(op, matrixA, mB, 0, matrixC, D, filaI, filaF, colI, colF, trabajo);
+		return;
+	}
+
+	for (int i = filaI; i < filaF; i++) {
+		for (int j = colI; j < colF; j++) {
+			pA = matrixA + (size_t) i * D; 
+			pB = mB + j;
+			Suma = 0.0;
+
+			for (int k = 0; k < D; k++, pA++, pB += D) {
+				Suma += *pA * *pB;
+			}
+			matrixC[(size_t) i * D + j] = Suma;
+		}
+	}
 }
 
 /*-----------------------------------------------------------------------------
- * FinMuestra — Marca el fin del tiempo de medición y muestra el resultado.
+ * multiMatrix — Tarea ejecutada por cada hilo del pool en cada multiplicación.
+ *
+ * Parámetros:
+ *  - idH: identificador del hilo (0 .. nH-1), asignado por el pool.
+ *  - variables: puntero genérico (void *) a la `struct parametros` compartida.
+ *
+ * Descripción:
+ *  Cada hilo pide rangos de filas a `repartoFilas` hasta que no queda
+ *  trabajo. Con el reparto estático recibe un único rango balanceado según
+ *  su id (`idH`); con el dinámico o el guiado toma trozos de una cola
+ *  compartida. En todos los casos cada fila se calcula exactamente una vez,
+ *  también cuando N no es divisible por el número de hilos. Con `-s robo`
+ *  el hilo pide teselas a `roboTeselas` en lugar de filas.
  *---------------------------------------------------------------------------*/
-void FinMuestra() {
-	gettimeofday(&fin, (void *)0);
-	fin.tv_usec -= inicio.tv_usec;
-	fin.tv_sec  -= inicio.tv_sec;
-	double tiempo = (double)(fin.tv_sec * 1000000 + fin.tv_usec);
-	printf("%9.0f \n", tiempo);
+static void multiMatrix(int idH, void *variables) {
+	struct parametros *data = (struct parametros *)variables;
+	int turno = 0, filaI, filaF, colI, colF;
+	unsigned semilla = (unsigned) idH + 1;
+	const double *mB = matrizLocal(&colocacion, matrixB);
+	double *trabajo = (trabajoHilos != NULL) ? trabajoHilos + (size_t) idH * elemsHilo : NULL;
+
+	inicioTrabajador(medida, idH);
+	if (data->op->reparto == MM_REPARTO_ROBO) {
+		while (siguienteTesela(&roboTeselas, idH, &semilla, &filaI, &filaF, &colI, &colF))
+			multiTesela(mB, data->N, filaI, filaF, colI, colF, data->op, trabajo);
+	} else {
+		while (siguienteRango(&repartoFilas, idH, &turno, &filaI, &filaF))
+			multiTesela(mB, data->N, filaI, filaF, 0, data->N, data->op, trabajo);
+	}
+	finTrabajador(medida, idH);
+
+	/* Mutex no esencial aquí, pero se incluye como práctica segura */
+	pthread_mutex_lock(&MM_mutex);
+	pthread_mutex_unlock(&MM_mutex);
 }
 
 /*-----------------------------------------------------------------------------
- * iniMatrix — Inicializa matrices A y B con valores aleatorios.
+ * multiForma — Tarea de cada hilo del pool en el producto general: calcula
+ * el trozo `idH` del plan (ver mmForma.c); los hilos sobrantes no tienen
+ * trozo.
+ *---------------------------------------------------------------------------*/
+static void multiForma(int idH, void *variables) {
+	struct parametros *data = (struct parametros *)variables;
+	const double *mB = matrizLocal(&colocacion, matrixB);
+
+	inicioTrabajador(medida, idH);
+	calculaTrozo(data->op, &plan, matrixA, mB, plan.f.ldb, 0, matrixC, idH);
+	finTrabajador(medida, idH);
+}
+
+/*-----------------------------------------------------------------------------
+ * reduceForma — Segunda tarea del producto general cuando el plan divide K:
+ * cada hilo suma a C las parciales de sus franjas.
+ *---------------------------------------------------------------------------*/
+static void reduceForma(int idH, void *variables) {
+	struct parametros *data = (struct parametros *)variables;
+
+	for (int r = idH; r < plan.franjas; r += data->nH)
+		reduceFranja(&plan, matrixC, r);
+}
+
+/*-----------------------------------------------------------------------------
+ * multiLoteHilo — Tarea de cada hilo del pool con `--batch`: pide rangos de
+ * productos a `repartoFilas` (iniciado sobre el lote) y calcula cada
+ * producto completo con sus propios buffers de kernel.
+ *---------------------------------------------------------------------------*/
+static void multiLoteHilo(int idH, void *variables) {
+	struct parametros *data = (struct parametros *)variables;
+	struct trabajoLote t;
+	int turno = 0, ini, fin;
+
+	inicioTrabajador(medida, idH);
+	iniTrabajoLote(&t, data->op);
+	while (siguienteRango(&repartoFilas, idH, &turno, &ini, &fin))
+		multiLote(&t, matrixA, matrixB, matrixC, (size_t) data->N * data->N, ini, fin);
+	finTrabajoLote(&t);
+	finTrabajador(medida, idH);
+}
+
+/*-----------------------------------------------------------------------------
+ * fijaHilo — Tarea de afinidad ejecutada una vez por cada hilo del pool:
+ * fija el hilo a la CPU que le asigna el plan `colocacion`.
+ *---------------------------------------------------------------------------*/
+static void fijaHilo(int idH, void *variables) {
+	(void) variables;
+	fijaHiloActual(&colocacion, idH);
+}
+
+/*-----------------------------------------------------------------------------
+ * sueltaHilo — Tarea inversa de `fijaHilo()` (ver `sueltaHiloActual()`).
+ *---------------------------------------------------------------------------*/
+static void sueltaHilo(int idH, void *variables) {
+	(void) idH;
+	(void) variables;
+	sueltaHiloActual();
+}
+
+/*-----------------------------------------------------------------------------
+ * replicaHilo — Copia B a la réplica de su nodo (solo el primer hilo de cada
+ * nodo lo hace; ver `copiaReplica()`).
+ *---------------------------------------------------------------------------*/
+static void replicaHilo(int idH, void *variables) {
+	(void) variables;
+	copiaReplica(&colocacion, idH);
+}
+
+/*-----------------------------------------------------------------------------
+ * iniciaPosix — Prepara el motor Pthreads (ver mmMotor.h).
  *
- * Parámetros:
- *  - m1: puntero a la matriz A
- *  - m2: puntero a la matriz B
- *  - D:  tamaño de las matrices cuadradas
+ * Descripción:
+ *  Reserva las colas de teselas (`-s robo`) o, con `--shape`, el plan de la
+ *  forma (que sustituye a `-s`; con `--batch`, `-s robo` se reparte como
+ *  el dinámico), crea el pool de op->P hilos (medido como
+ *  fase de arranque) y, con `-a`, arma el plan de afinidad y fija cada hilo
+ *  a su CPU. Con el micro-kernel reserva también los buffers de
+ *  empaquetado de cada hilo, para no reservarlos en cada trozo o tesela.
+ *  Retorna -1 si alguna reserva falla.
+ *---------------------------------------------------------------------------*/
+static int iniciaPosix(const struct opciones *op, struct medicion *m) {
+	int N = op->N;
+	int n_threads = op->P;
+
+	medida = m;
+	datos.nH = n_threads;
+	datos.N = N;
+	datos.op = op;
+	replicada = 0;
+
+	trozoFilas = (op->trozo > 0) ? op->trozo : franjaFilas(op);
+	general = formaGeneral(op);
+	conRobo = (op->reparto == MM_REPARTO_ROBO) && !general && op->lote == 0;
+
+	if (general) {
+		struct forma f;
+
+		formaDe(op, &f);
+		if (iniParticion(&plan, &f, n_threads, 0, op->paginas) != 0)
+			return -1;
+	}
+
+	/* Teselas de al menos 64×64 para que el robo no cueste más que el cálculo */
+	if (conRobo && iniRobo(&roboTeselas, N, n_threads,
+	                       (op->trozo > 0) ? op->trozo : (trozoFilas > 64 ? trozoFilas : 64)) != 0)
+		return -1;
+
+	/* Filas completas o teselas de robo: a lo sumo N columnas */
+	elemsHilo = (!general && op->lote == 0) ? elemsTrabajoComun(op, N) : 0;
+	trabajoHilos = NULL;
+	if (elemsHilo > 0) {
+		trabajoHilos = aligned_alloc(64, sizeof(double) * elemsHilo * n_threads);
+		if (trabajoHilos == NULL)
+			return -1;
+	}
+
+	pthread_mutex_init(&MM_mutex, NULL);
+
+	inicioFase(medida, MM_FASE_ARRANQUE);
+	if (iniPool(&grupo, n_threads) != 0)
+		return -1;
+	finFase(medida, MM_FASE_ARRANQUE);
+
+	if (op->afinidad != MM_AFIN_NINGUNA) {
+		if (iniAfinidad(&colocacion, op->afinidad, n_threads) != 0)
+			return -1;
+		ejecutaPool(&grupo, fijaHilo, NULL);
+	}
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * multiplicaPosix — Una multiplicación C = A·B sobre el pool.
  *
  * Descripción:
- *  Asigna valores flotantes pseudoaleatorios:
- *   - A: valores entre 1.0 y 5.0
- *   - B: valores entre 5.0 y 9.0
+ *  En la primera llamada con `-a <pol>,replica` se crean las réplicas de B
+ *  (fuera del tiempo medido). Luego se reinicia el reparto de filas (o las
+ *  colas de teselas) y el pool ejecuta `multiMatrix()`; con `--shape` el
+ *  pool ejecuta `multiForma()` y, si el plan divide K, `reduceForma()`; con
+ *  `--batch` el reparto es de productos del lote y el pool ejecuta
+ *  `multiLoteHilo()`. Se retorna el tiempo de la llamada en µs.
  *---------------------------------------------------------------------------*/
-void iniMatrix(double *m1, double *m2, int D) { 
-	for (int i = 0; i < D * D; i++, m1++, m2++) {
-		*m1 = (double)rand() / RAND_MAX * (5.0 - 1.0); 
-		*m2 = (double)rand() / RAND_MAX * (9.0 - 5.0); 
-	}	
+static double multiplicaPosix(const struct opciones *op, const double *mA, const double *mB, double *mC) {
+	matrixA = mA;
+	matrixB = mB;
+	matrixC = mC;
+
+	if (op->afinidad != MM_AFIN_NINGUNA && op->replicaB && !replicada) {
+		size_t elemsB = general ? (size_t) plan.f.K * plan.f.ldb : (size_t) op->N * op->N;
+
+		if (reservaReplicas(&colocacion, mB, elemsB) != 0) {
+			perror("Error al reservar las réplicas de B");
+			exit(1);
+		}
+		ejecutaPool(&grupo, replicaHilo, NULL);
+		replicada = 1;
+	}
+
+	inicioFase(medida, MM_FASE_MULTIPLICACION);
+	if (general) {
+		ejecutaPool(&grupo, multiForma, &datos);
+		if (plan.franjas > 0)
+			ejecutaPool(&grupo, reduceForma, &datos);
+		return finFase(medida, MM_FASE_MULTIPLICACION);
+	}
+	if (op->lote > 0) {
+		int tipo = (op->reparto == MM_REPARTO_ROBO) ? MM_REPARTO_DINAMICO : op->reparto;
+
+		iniReparto(&repartoFilas, tipo, op->lote, op->P, trozoLote(op));
+		ejecutaPool(&grupo, multiLoteHilo, &datos);
+		return finFase(medida, MM_FASE_MULTIPLICACION);
+	}
+	if (conRobo)
+		reiniciaRobo(&roboTeselas);
+	else
+		iniReparto(&repartoFilas, op->reparto, op->N, op->P, trozoFilas);
+	ejecutaPool(&grupo, multiMatrix, &datos);
+	return finFase(medida, MM_FASE_MULTIPLICACION);
 }
 
+/*-----------------------------------------------------------------------------
+ * terminaPosix — Muestra el informe de robo (con `-v`), suelta los hilos
+ * fijados y destruye el pool, las colas de teselas y el plan de afinidad.
+ *---------------------------------------------------------------------------*/
+static void terminaPosix(const struct opciones *op) {
+	if (conRobo && op->informe)
+		informeRobo(&roboTeselas, stderr);
+
+	if (op->afinidad != MM_AFIN_NINGUNA) {
+		ejecutaPool(&grupo, sueltaHilo, NULL);
+		finAfinidad(&colocacion);
+	}
+	finPool(&grupo);
+	if (conRobo)
+		finRobo(&roboTeselas);
+	finParticion(&plan);
+	free(trabajoHilos);
+	trabajoHilos = NULL;
+	memset(&colocacion, 0, sizeof(colocacion));
+
+	pthread_mutex_destroy(&MM_mutex);
+	medida = NULL;
+}
+
+const struct motor motorPosix = { "posix", iniciaPosix, multiplicaPosix, terminaPosix, 1 };
+
+#ifndef MM_BINARIO_UNICO
+
+/*-----------------------------------------------------------------------------
+ * Estructura de preparación:
+ *  Datos de las tareas del pool que preparan las matrices antes de medir
+ *  (solo en el programa independiente).
+ *  - nH, N: número de hilos y dimensión.
+ *  - semilla: semilla del generador (`--seed`).
+ *  - mA, mB, mC: matrices a ubicar e inicializar.
+ *---------------------------------------------------------------------------*/
+struct preparacion {
+	int nH;
+	int N;
+	uint64_t semilla;
+	double *mA, *mB, *mC;
+};
+
 /*-----------------------------------------------------------------------------
  * impMatrix — Imprime una matriz cuadrada si el tamaño es pequeño (N < 9).
  *
@@ -97,7 +425,7 @@ void iniMatrix(double *m1, double *m2, int D) {
  *  - matriz: puntero a la matriz lineal
  *  - D: dimensión de la matriz
  *---------------------------------------------------------------------------*/
-void impMatrix(double *matriz, int D) {
+static void impMatrix(double *matriz, int D) {
 	if (D < 9) {
     	for (int i = 0; i < D * D; i++) {
      		if (i % D == 0) printf("\n");
@@ -108,46 +436,44 @@ void impMatrix(double *matriz, int D) {
 }
 
 /*-----------------------------------------------------------------------------
- * multiMatrix — Función ejecutada por cada hilo (cálculo parcial de la matriz).
+ * iniMatrix — Tarea del pool que inicializa A y B con valores aleatorios.
  *
  * Parámetros:
- *  - variables: puntero genérico (void *) con los parámetros del hilo.
+ *  - idH: identificador del hilo en el pool.
+ *  - variables: puntero a la `struct preparacion` compartida.
  *
  * Descripción:
- *  Cada hilo calcula las filas asignadas según su id (`idH`), con base en el
- *  número total de hilos (`nH`). Se utiliza un esquema de reparto de trabajo
- *  por bloques de filas.
- *
- *  El cálculo sigue el algoritmo clásico O(n³), pero dividido entre hilos.
+ *  Cada hilo llena su franja estática de filas con el generador por contador
+ *  de mmAleatorio.c (semilla `--seed`):
+ *   - A: valores entre 1.0 y 5.0
+ *   - B: valores entre 5.0 y 9.0
+ *  Cada valor depende solo de su posición, así que el resultado no depende
+ *  del número de hilos. Es la misma franja que toca `colocaHilo()`.
  *---------------------------------------------------------------------------*/
-void *multiMatrix(void *variables) {
-	struct parametros *data = (struct parametros *)variables;
-	
-	int idH	 = data->idH;
-	int nH	 = data->nH;
-	int D	 = data->N;
-	int filaI = (D / nH) * idH;
-	int filaF = (D / nH) * (idH + 1);
-	double Suma, *pA, *pB;
-
-    for (int i = filaI; i < filaF; i++) {
-        for (int j = 0; j < D; j++) {
-			pA = matrixA + i * D; 
-			pB = matrixB + j;
-			Suma = 0.0;
+static void iniMatrix(int idH, void *variables) {
+	struct preparacion *prep = (struct preparacion *)variables;
+	int filaI, filaF;
 
-            for (int k = 0; k < D; k++, pA++, pB += D) {
-				Suma += *pA * *pB;
-			}
-			matrixC[i * D + j] = Suma;
-		}
-	}
+	rangoEstatico(prep->N, prep->nH, idH, &filaI, &filaF);
+	iniMatrixFilas(prep->mA, prep->mB, prep->N, filaI, filaF, prep->semilla);
+}
 
-	/* Mutex no esencial aquí, pero se incluye como práctica segura */
-	pthread_mutex_lock(&MM_mutex);
-	pthread_mutex_unlock(&MM_mutex);
+/*-----------------------------------------------------------------------------
+ * colocaHilo — Tarea de ubicación ejecutada una vez por cada hilo del pool.
+ *
+ * Descripción:
+ *  Con los hilos ya fijados por `iniciaPosix()`, cada uno escribe primero su
+ *  franja estática de filas de A y C (la misma que le asigna el reparto por
+ *  defecto), de modo que esas páginas se creen en su nodo NUMA antes de que
+ *  `iniMatrix()` las llene.
+ *---------------------------------------------------------------------------*/
+static void colocaHilo(int idH, void *variables) {
+	struct preparacion *prep = (struct preparacion *)variables;
+	int filaI, filaF;
 
-	pthread_exit(NULL);
+	rangoEstatico(prep->N, prep->nH, idH, &filaI, &filaF);
+	tocaFilas(prep->mA, prep->N, filaI, filaF);
+	tocaFilas(prep->mC, prep->N, filaI, filaF);
 }
 
 /*-----------------------------------------------------------------------------
@@ -158,64 +484,131 @@ void *multiMatrix(void *variables) {
  *  - argv: arreglo de argumentos
  *
  * Descripción:
- *  1. Valida argumentos de entrada.
+ *  1. Valida argumentos de entrada; con `--shape` o `--pad` el producto
+ *     general lo ejecuta `ejecutaForma()` (mmForma.c) con este motor, y con
+ *     `--type` `ejecutaTipo()` (mmTipo.c); con `--files`, `ejecutaArchivo()`
+ *     (mmArchivo.c), y con `--density`, `ejecutaDispersa()` (mmDispersa.c).
  *  2. Reserva memoria dinámica para matrices.
- *  3. Inicializa e imprime matrices (si N < 9).
- *  4. Crea hilos POSIX y les asigna rangos de filas.
- *  5. Espera la finalización de todos los hilos (`pthread_join`).
- *  6. Calcula y muestra el tiempo total.
- *  7. Libera la memoria y destruye recursos de hilos.
+ *  3. Prepara el motor (`iniciaPosix()`): crea el pool de hilos POSIX, mide
+ *     su arranque y, con `-a`, fija los hilos.
+ *  4. Con `-a`, ubica A y C por primer toque; luego inicializa A y B en
+ *     paralelo desde el pool e imprime matrices (si N < 9).
+ *  5. Ejecuta una multiplicación (o R con `-r`); la primera crea las
+ *     réplicas de B si se pidieron.
+ *  6. Muestra el tiempo: sin `-r`, arranque + multiplicación en una columna
+ *     (comparable con las mediciones originales); con `-r`, cuatro columnas:
+ *     arranque, media, mínimo y máximo por llamada.
+ *  7. Con `--verify` comprueba C = A·B (fuera del tiempo medido); con `-v` y
+ *     `-s robo`, muestra en stderr las estadísticas de robo, y con
+ *     `--timing`, los tiempos por fase y por hilo.
+ *  8. Libera la memoria y destruye el pool.
  *---------------------------------------------------------------------------*/
 int main(int argc, char *argv[]) {
-	if (argc < 3) {
-		printf("Uso: ./mmClasicaPosix <tamMatriz> <numHilos>\n");
-		exit(0);	
+	struct opciones op;
+	leerOpciones(argc, argv, "./mmClasicaPosix", &op);
+	if (op.archivos[0] != NULL)
+		return ejecutaArchivo(&op, &motorPosix, 0, "mmClasicaPosix");
+	if (formaGeneral(&op))
+		return ejecutaForma(&op, &motorPosix, 0, "mmClasicaPosix");
+	if (op.tipo != MM_TIPO_NINGUNO)
+		return ejecutaTipo(&op, &motorPosix, 0, "mmClasicaPosix");
+	if (op.lote > 0)
+		return ejecutaLote(&op, &motorPosix, 0, "mmClasicaPosix");
+	if (op.densidad > 0.0)
+		return ejecutaDispersa(&op, &motorPosix, 0, "mmClasicaPosix");
+
+	int N = op.N; 
+	int n_threads = op.P; 
+	int reps = (op.repeticiones > 0) ? op.repeticiones : 1;
+
+	if (compruebaHuella(N, 3, stderr) != 0)
+		exit(1);
+
+	struct medicion tiempos;
+	struct contadores contadores;
+
+	/* Con -a la ubicación de A y C la hace el primer toque de cada hilo */
+	int precarga = op.precarga && op.afinidad == MM_AFIN_NINGUNA;
+	double *matA = reservaMatriz((size_t) N * N, op.paginas, 0, precarga);
+	double *matB = reservaMatriz((size_t) N * N, op.paginas, 0, op.precarga);
+	double *matC = reservaMatriz((size_t) N * N, op.paginas, 0, precarga);
+	if (matA == NULL || matB == NULL || matC == NULL) {
+		perror("Error al reservar memoria para las matrices");
+		exit(1);
 	}
+	struct preparacion prep = { n_threads, N, op.semilla, matA, matB, matC };
 
-    int N = atoi(argv[1]); 
-    int n_threads = atoi(argv[2]); 
+	if (iniMedicion(&tiempos, n_threads) != 0) {
+		perror("Error al reservar las marcas de tiempo");
+		exit(1);
+	}
 
-    pthread_t p[n_threads];
-    pthread_attr_t atrMM;
+	if (op.contadores) {
+		if (iniContadores(&contadores, n_threads) != 0) {
+			perror("Error al reservar los contadores");
+			exit(1);
+		}
+		tiempos.cont = &contadores;
+	}
 
-	matrixA = (double *)calloc(N * N, sizeof(double));
-	matrixB = (double *)calloc(N * N, sizeof(double));
-	matrixC = (double *)calloc(N * N, sizeof(double));
+	if (motorPosix.iniciar(&op, &tiempos) != 0) {
+		perror("Error al crear los hilos del pool");
+		exit(1);
+	}
+	double tArranque = tiempos.fase[MM_FASE_ARRANQUE].total;
 
-	iniMatrix(matrixA, matrixB, N);
-	impMatrix(matrixA, N);
-	impMatrix(matrixB, N);
+	if (op.afinidad != MM_AFIN_NINGUNA)
+		ejecutaPool(&grupo, colocaHilo, &prep);
 
-	InicioMuestra();
+	inicioFase(&tiempos, MM_FASE_INICIALIZACION);
+	ejecutaPool(&grupo, iniMatrix, &prep);
+	finFase(&tiempos, MM_FASE_INICIALIZACION);
+	impMatrix(matA, N);
+	impMatrix(matB, N);
 
-	pthread_mutex_init(&MM_mutex, NULL);
-	pthread_attr_init(&atrMM);
-	pthread_attr_setdetachstate(&atrMM, PTHREAD_CREATE_JOINABLE);
+	double tLlamada = 0.0, suma = 0.0, minimo = 0.0, maximo = 0.0;
+	for (int r = 0; r < reps; r++) {
+		tLlamada = motorPosix.multiplicar(&op, matA, matB, matC);
 
-    for (int j = 0; j < n_threads; j++) {
-		struct parametros *datos = (struct parametros *) malloc(sizeof(struct parametros)); 
-		datos->idH = j;
-		datos->nH  = n_threads;
-		datos->N   = N;
+		suma += tLlamada;
+		if (r == 0 || tLlamada < minimo) minimo = tLlamada;
+		if (r == 0 || tLlamada > maximo) maximo = tLlamada;
+	}
+	if (op.afinidad != MM_AFIN_NINGUNA)
+		informeAfinidad(&colocacion, stderr);
 
-        pthread_create(&p[j], &atrMM, multiMatrix, (void *)datos);
+	if (op.repeticiones > 0)
+		printf("%9.0f %9.0f %9.0f %9.0f ", tArranque, suma / reps, minimo, maximo);
+	else
+		printf("%9.0f ", tArranque + tLlamada);
+	if (op.contadores)
+		columnasContadores(&contadores, 2.0 * N * N * N * reps, suma, stdout);
+	printf("\n");
+	
+	impMatrix(matC, N);
+	if (op.informe) {
+		informeMemoria("A", matA, stderr);
+		informeMemoria("B", matB, stderr);
+		informeMemoria("C", matC, stderr);
+		informeHuella(N, 3, suma, reps, stderr);
 	}
 
-    for (int j = 0; j < n_threads; j++)
-        pthread_join(p[j], NULL);
+	int fallo = op.verifica ? verificaProducto(matA, matB, matC, N, op.semilla, stderr) : 0;
 
-	FinMuestra();
-	
-	impMatrix(matrixC, N);
+	motorPosix.terminar(&op);
+	escribeMedicion(&tiempos, op.formatoTiempo, "mmClasicaPosix", N, stderr);
+	if (op.contadores) {
+		informeContadores(&contadores, op.informe, stderr);
+		liberaContadores(&contadores);
+	}
+	finMedicion(&tiempos);
 
 	/* Liberación de Memoria */
-	free(matrixA);
-	free(matrixB);
-	free(matrixC);
+	liberaMatriz(matA, (size_t) N * N, op.paginas);
+	liberaMatriz(matB, (size_t) N * N, op.paginas);
+	liberaMatriz(matC, (size_t) N * N, op.paginas);
 
-	pthread_attr_destroy(&atrMM);
-	pthread_mutex_destroy(&MM_mutex);
-	pthread_exit(NULL);
-
-	return 0;
+	return fallo;
 }
+
+#endif /* MM_BINARIO_UNICO */
@@ -0,0 +1,518 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * Descripción general:
+ * ---------------------------------------------------------------
+ * Lectura de las opciones de línea de comandos compartidas por las versiones
+ * Fork, Pthreads, OpenMP clásica y OpenMP por filas.
+ *
+ * Opciones:
+ *  -b <tam|auto>  Usa el kernel por bloques (mmBloques.c) con bloques de
+ *                 `tam`×`tam`; "auto" lo elige según la cache del equipo.
+ *  -k <kernel>    Usa el micro-kernel empaquetado (mmMicro.c) con la
+ *                 variante indicada: escalar, avx2, avx512 o auto (la mejor
+ *                 soportada según cpuid). Tiene prioridad sobre `-b`.
+ *  -s <tipo>[,n]  (Pthreads) reparto de filas: estatico (balanceado, por
+ *                 defecto), dinamico o guiado; `n` = filas por trozo. Con
+ *                 "robo" se usan teselas n×n con robo de trabajo.
+ *                 (OpenMP clásica) `schedule` de las teselas de C, con `n`
+ *                 teselas por trozo; sin `-s` se respeta OMP_SCHEDULE.
+ *  -r <R>         (Pthreads) R multiplicaciones sobre el mismo pool de
+ *                 hilos; muestra arranque y latencia media/mín/máx.
+ *  -a <pol>[,replica]
+ *                 (hilos) fija cada hilo a una CPU (compacto o disperso
+ *                 entre nodos NUMA), ubica A y C por primer toque desde
+ *                 cada hilo y, con ",replica", copia B en cada nodo.
+ *  -v             Informe adicional en stderr (la salida estándar conserva el
+ *                 formato que lee lanzador.pl).
+ *  -p             (Fork) matrices en memoria privada (modo original).
+ *  --seed <s>     Semilla de A y B (mmAleatorio.c). Con la misma semilla
+ *                 todas las versiones multiplican matrices idénticas.
+ *  --verify       Comprueba C = A·B fuera de la región medida (mmVerifica.c);
+ *                 el programa termina con código 1 si C es incorrecta.
+ *  --timing <fmt> Escribe en stderr los tiempos por fase y por trabajador
+ *                 (mmTiempo.c) en formato csv o json.
+ *  --counters     Cuenta ciclos, instrucciones y fallos de cache/TLB por
+ *                 trabajador (mmContadores.c) y añade GFLOP/s, IPC y fallos
+ *                 por FMA a la salida; con `-v`, el detalle por trabajador.
+ *  --pages <tipo> Páginas de A, B y C (mmMemoria.c): normal (4 KiB, por
+ *                 defecto), thp (páginas grandes transparentes con
+ *                 madvise) o hugetlb (MAP_HUGETLB; si no hay, thp).
+ *  --prefault     Toca todas las páginas de las matrices al reservarlas,
+ *                 antes de inicializar y de medir (con `-a` la ubicación la
+ *                 hace cada hilo y no se precarga A ni C).
+ *  --engine <lista>
+ *                 (mm) motores a ejecutar: fork, posix, openmp, filas,
+ *                 strassen, summa, dispersa separados por comas, o "todos".
+ *                 En el binario único N y P pueden ser también listas
+ *                 separadas por comas.
+ *  --shape <MxK>  Producto general C (M×N) = A (M×K) · B (K×N), con N el
+ *                 primer argumento (mmForma.c); el reparto se adapta a la
+ *                 forma (filas, columnas o dimensión común).
+ *  --pad <e>      Deja `e` elementos extra al final de cada fila de A, B y
+ *                 C (leading dimension mayor que la fila); implica la
+ *                 ruta de forma general aunque M = K = N.
+ *  --type <tipo>  Tipo de elemento (mmTipo.c): f64, f32, i16 o i8 (enteros
+ *                 con acumulación en int32). Todos los motores usan el
+ *                 kernel empaquetado del tipo (`-k` elige la variante); en
+ *                 el binario único admite una lista separada por comas.
+ *  --cutoff <n>   (Strassen) lado máximo de los bloques que se multiplican
+ *                 con el kernel por teselas en lugar de seguir la recursión.
+ *  --batch <B>    Lote de B productos N×N independientes y contiguos
+ *                 (mmLote.c): los motores reparten los productos, no las
+ *                 filas; N = 2, 3, 4, 6, 8, 12, 16 y 24 tienen un kernel
+ *                 directo especializado y `-k` elige la variante SIMD.
+ *  --files <A,B,C>
+ *                 A, B y C en archivos binarios proyectados con mmap
+ *                 (mmArchivo.c); A y B se generan si no existen y deben
+ *                 tener la forma de N, `--shape` y `--pad` si existen.
+ *  --budget <MiB> Con `--files`, producto fuera de memoria (mmExterno.c):
+ *                 recorre los archivos por paneles con buffers dobles que
+ *                 no pasan de MiB y un hilo que precarga el panel siguiente.
+ *  --pipeline     Micro-kernel con el empaquetado de B en tubería
+ *                 (mmMicro.c): el panel siguiente se empaqueta en un
+ *                 segundo buffer, con prefetch, mientras se multiplica el
+ *                 actual. Implica `-k auto` si no se dio `-k`; los motores
+ *                 OpenMP reservan los buffers una vez por hilo.
+ *  --density <d>[,perfil]
+ *                 A dispersa con una fracción d de no ceros (mmDispersa.c),
+ *                 repartidos por igual entre las filas ("uniforme", por
+ *                 defecto) o con densidad creciente con la fila
+ *                 ("creciente"). Los motores densos multiplican la A con
+ *                 ceros; el motor `dispersa` la comprime a CSR.
+ *
+ * ---------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <getopt.h>
+#include "mmComun.h"
+#include "mmBloques.h"
+#include "mmMicro.h"
+#include "mmReparto.h"
+#include "mmAfinidad.h"
+#include "mmAleatorio.h"
+#include "mmTiempo.h"
+#include "mmMemoria.h"
+#include "mmTipo.h"
+#include "mmLote.h"
+#include "mmArchivo.h"
+#include "mmDispersa.h"
+
+/* Opciones largas; `val` es el carácter que devuelve getopt_long() */
+static const struct option opcionesLargas[] = {
+	{"seed",     required_argument, NULL, 'S'},
+	{"verify",   no_argument,       NULL, 'V'},
+	{"timing",   required_argument, NULL, 'T'},
+	{"counters", no_argument,       NULL, 'C'},
+	{"pages",    required_argument, NULL, 'G'},
+	{"prefault", no_argument,       NULL, 'F'},
+	{"engine",   required_argument, NULL, 'E'},
+	{"shape",    required_argument, NULL, 'H'},
+	{"pad",      required_argument, NULL, 'D'},
+	{"type",     required_argument, NULL, 'Y'},
+	{"cutoff",   required_argument, NULL, 'U'},
+	{"batch",    required_argument, NULL, 'L'},
+	{"files",    required_argument, NULL, 'I'},
+	{"budget",   required_argument, NULL, 'W'},
+	{"pipeline", no_argument,       NULL, 'Q'},
+	{"density",  required_argument, NULL, 'O'},
+	{NULL,       0,                 NULL, 0}
+};
+
+/*-----------------------------------------------------------------------------
+ * muestraUso — Imprime la ayuda del programa y termina.
+ *---------------------------------------------------------------------------*/
+static void muestraUso(const char *uso) {
+	printf("\nUso: %s <TamañoMatriz> <NumHilos> [opciones]\n", uso);
+	printf("  -b <tam|auto>  kernel por bloques de tam×tam\n");
+	printf("  -k <kernel>    micro-kernel: escalar, avx2, avx512 o auto\n");
+	printf("  -s <tipo>[,n]  (Pthreads, OpenMP) reparto: estatico, dinamico, guiado o robo\n");
+	printf("  -r <R>         (Pthreads) R llamadas sobre el mismo pool de hilos\n");
+	printf("  -a <pol>[,replica]  (hilos) afinidad: compacto o disperso\n");
+	printf("  -v             informe adicional en stderr\n");
+	printf("  -p             (Fork) memoria privada: el padre no recibe C\n");
+	printf("  --seed <s>     semilla de A y B (por defecto %llu)\n",
+	       (unsigned long long) MM_SEMILLA_DEFECTO);
+	printf("  --verify       comprueba C = A·B al terminar (código 1 si falla)\n");
+	printf("  --timing <fmt> tiempos por fase y por hilo en stderr: csv o json\n");
+	printf("  --counters     añade GFLOP/s, IPC y fallos L1D/LLC/dTLB por FMA\n");
+	printf("  --pages <tipo> páginas de las matrices: normal, thp o hugetlb\n");
+	printf("  --prefault     toca todas las páginas al reservar (fuera del tiempo)\n");
+	printf("  --engine <l>   (mm) motores: fork,posix,openmp,filas,strassen,summa,dispersa o todos;\n");
+	printf("                 N y P admiten listas separadas por comas\n");
+	printf("  --shape <MxK>  producto general: A M×K, B K×N, C M×N (N = TamañoMatriz)\n");
+	printf("  --pad <e>      e elementos de relleno por fila (leading dimension)\n");
+	printf("  --type <t>     tipo de elemento: f64, f32, i16 o i8 (C en int32);\n");
+	printf("                 (mm) lista separada por comas\n");
+	printf("  --cutoff <n>   (Strassen) lado máximo de los bloques base (por defecto %d)\n",
+	       MM_STRASSEN_CORTE);
+	printf("  --batch <B>    lote de B productos N×N independientes\n");
+	printf("  --files <A,B,C> matrices en archivos (A y B se generan si no existen)\n");
+	printf("  --budget <MiB> (con --files) producto fuera de memoria por paneles\n");
+	printf("  --pipeline     micro-kernel con empaquetado de B en tubería (doble buffer)\n");
+	printf("  --density <d>[,perfil]  A dispersa con fracción d de no ceros (uniforme o creciente)\n\n");
+	exit(0);
+}
+
+/*-----------------------------------------------------------------------------
+ * leeDimension — Interpreta N o P (el primer valor si es una lista de `mm`)
+ * y las demás opciones enteras positivas (`-b`, `-r`, trozo de `-s`, ...).
+ *
+ * Descripción:
+ *  A diferencia de `atoi()`, rechaza texto no numérico y valores fuera de
+ *  `int` (un N de 5·10⁹ no debe convertirse en un N pequeño o negativo).
+ *  Retorna -1 si el valor no es un entero positivo representable.
+ *---------------------------------------------------------------------------*/
+static int leeDimension(const char *texto) {
+	char *fin;
+	long v = strtol(texto, &fin, 10);
+
+	if (fin == texto || (*fin != '\0' && *fin != ',') || v <= 0 || v > INT_MAX)
+		return -1;
+	return (int) v;
+}
+
+/*-----------------------------------------------------------------------------
+ * mayorDimension — Mayor dimensión que puede teselarse: el mayor N de la
+ * lista (un solo valor fuera de `mm`), M y K de `--shape` y el lote.
+ *---------------------------------------------------------------------------*/
+static int mayorDimension(const struct opciones *op) {
+	const char *t = op->listaN;
+	int mayor = (op->M > op->K) ? op->M : op->K;
+
+	if (op->lote > mayor)
+		mayor = op->lote;
+	for (;;) {
+		int v = leeDimension(t);
+
+		if (v > mayor)
+			mayor = v;
+		if ((t = strchr(t, ',')) == NULL)
+			break;
+		t++;
+	}
+	return mayor;
+}
+
+/*-----------------------------------------------------------------------------
+ * leeForma — Interpreta el argumento de `--shape` ("MxK").
+ *
+ * Descripción:
+ *  Retorna 0 y deja M y K si ambos son enteros positivos representables;
+ *  -1 en otro caso.
+ *---------------------------------------------------------------------------*/
+static int leeForma(const char *texto, int *M, int *K) {
+	char *fin;
+	long m = strtol(texto, &fin, 10);
+
+	if (fin == texto || *fin != 'x' || m <= 0 || m > INT_MAX)
+		return -1;
+	*M = (int) m;
+	*K = leeDimension(fin + 1);
+	return (*K > 0 && strchr(fin + 1, ',') == NULL) ? 0 : -1;
+}
+
+/*-----------------------------------------------------------------------------
+ * leerOpciones — Interpreta argv y llena la estructura de opciones.
+ *
+ * Parámetros:
+ *  - argc, argv: argumentos recibidos por `main()`.
+ *  - uso: nombre del programa para el mensaje de ayuda.
+ *  - op: estructura a llenar.
+ *
+ * Descripción:
+ *  Procesa las opciones con `getopt_long()` y toma los dos primeros argumentos
+ *  restantes como N y P. Si faltan, o alguno no es un entero positivo, se
+ *  muestra la ayuda y el programa termina, igual que en las versiones
+ *  originales.
+ *---------------------------------------------------------------------------*/
+void leerOpciones(int argc, char *argv[], const char *uso, struct opciones *op) {
+	int c;
+	char *coma, *fin;
+
+	memset(op, 0, sizeof(*op));
+	op->kernel = MM_KERNEL_NINGUNO;
+	op->reparto = MM_REPARTO_ESTATICO;
+	op->semilla = MM_SEMILLA_DEFECTO;
+	op->tipo = MM_TIPO_NINGUNO;
+
+	while ((c = getopt_long(argc, argv, "b:k:s:r:a:vp", opcionesLargas, NULL)) != -1) {
+		switch (c) {
+			case 'b':
+				op->bloque = (strcmp(optarg, "auto") == 0) ? tamBloqueAuto() : leeDimension(optarg);
+				if (op->bloque <= 0 || strchr(optarg, ',') != NULL)
+					muestraUso(uso);
+				break;
+			case 'k':
+				op->kernel = kernelPorNombre(optarg);
+				if (op->kernel == MM_KERNEL_NINGUNO) {
+					fprintf(stderr, "Kernel '%s' no disponible en este CPU (detectado: %s)\n",
+					        optarg, nombreKernel(kernelDetectado()));
+					exit(1);
+				}
+				break;
+			case 's':
+				if ((coma = strchr(optarg, ',')) != NULL) {
+					*coma = '\0';
+					op->trozo = leeDimension(coma + 1);
+					if (op->trozo <= 0 || strchr(coma + 1, ',') != NULL)
+						muestraUso(uso);
+				}
+				op->reparto = repartoPorNombre(optarg);
+				if (op->reparto < 0)
+					muestraUso(uso);
+				break;
+			case 'r':
+				op->repeticiones = leeDimension(optarg);
+				if (op->repeticiones <= 0 || strchr(optarg, ',') != NULL)
+					muestraUso(uso);
+				break;
+			case 'a':
+				if ((coma = strchr(optarg, ',')) != NULL) {
+					*coma = '\0';
+					if (strcmp(coma + 1, "replica") != 0)
+						muestraUso(uso);
+					op->replicaB = 1;
+				}
+				op->afinidad = afinidadPorNombre(optarg);
+				if (op->afinidad < 0)
+					muestraUso(uso);
+				break;
+			case 'v':
+				op->informe = 1;
+				break;
+			case 'p':
+				op->privada = 1;
+				break;
+			case 'S':
+				op->semilla = strtoull(optarg, &fin, 0);
+				if (*optarg == '\0' || *fin != '\0')
+					muestraUso(uso);
+				break;
+			case 'V':
+				op->verifica = 1;
+				break;
+			case 'C':
+				op->contadores = 1;
+				break;
+			case 'G':
+				op->paginas = paginasPorNombre(optarg);
+				if (op->paginas < 0)
+					muestraUso(uso);
+				break;
+			case 'F':
+				op->precarga = 1;
+				break;
+			case 'E':
+				op->motores = optarg;
+				break;
+			case 'H':
+				if (leeForma(optarg, &op->M, &op->K) != 0)
+					muestraUso(uso);
+				break;
+			case 'D':
+				op->relleno = (int) strtol(optarg, &fin, 10);
+				if (*optarg == '\0' || *fin != '\0' || op->relleno < 0 || op->relleno > 4096)
+					muestraUso(uso);
+				break;
+			case 'Y': {
+				int tipos[MM_MAX_TIPOS];
+
+				if (leeTipos(optarg, tipos) < 0)
+					muestraUso(uso);
+				op->tipo = tipos[0];
+				op->tipos = optarg;
+				break;
+			}
+			case 'U':
+				op->corte = leeDimension(optarg);
+				if (op->corte <= 0 || strchr(optarg, ',') != NULL)
+					muestraUso(uso);
+				break;
+			case 'L':
+				op->lote = leeDimension(optarg);
+				if (op->lote <= 0 || strchr(optarg, ',') != NULL)
+					muestraUso(uso);
+				break;
+			case 'I':
+				if (leeArchivos(optarg, op->archivos) != 0)
+					muestraUso(uso);
+				break;
+			case 'W':
+				op->presupuesto = leeDimension(optarg);
+				if (op->presupuesto <= 0 || strchr(optarg, ',') != NULL)
+					muestraUso(uso);
+				break;
+			case 'Q':
+				op->tuberia = 1;
+				break;
+			case 'O':
+				if (densidadPorNombre(optarg, &op->densidad, &op->perfilDensidad) != 0)
+					muestraUso(uso);
+				break;
+			case 'T':
+				op->formatoTiempo = formatoTiempoPorNombre(optarg);
+				if (op->formatoTiempo < 0)
+					muestraUso(uso);
+				break;
+			default:
+				muestraUso(uso);
+		}
+	}
+
+	if (argc - optind < 2)
+		muestraUso(uso);
+
+	op->listaN = argv[optind];
+	op->listaP = argv[optind + 1];
+	op->N = leeDimension(op->listaN);
+	op->P = leeDimension(op->listaP);
+	if (op->N <= 0 || op->P <= 0)
+		muestraUso(uso);
+
+	/* Bloque, trozo y corte mayores que la dimensión que recorren equivalen
+	 * a la dimensión; se recortan aquí para que ningún motor calcule
+	 * `ini + tam` cerca de INT_MAX */
+	int mayor = mayorDimension(op);
+	if (op->bloque > mayor)
+		op->bloque = mayor;
+	if (op->trozo > mayor)
+		op->trozo = mayor;
+	if (op->corte > mayor)
+		op->corte = mayor;
+
+	/* El kernel por tipo trabaja con matrices cuadradas contiguas y copia B
+	 * como bytes del tipo, no como doubles */
+	if (op->tipo != MM_TIPO_NINGUNO && (op->M > 0 || op->K > 0 || op->relleno > 0 || op->replicaB)) {
+		fprintf(stderr, "--type no se combina con --shape, --pad ni -a <pol>,replica\n");
+		exit(1);
+	}
+	/* El lote son matrices cuadradas de double contiguas, y B cambia con
+	 * cada producto */
+	if (op->lote > 0 && (op->M > 0 || op->K > 0 || op->relleno > 0 || op->tipo != MM_TIPO_NINGUNO
+	                     || op->replicaB)) {
+		fprintf(stderr, "--batch no se combina con --shape, --pad, --type ni -a <pol>,replica\n");
+		exit(1);
+	}
+	/* Los archivos guardan matrices de double; fuera de memoria B cambia
+	 * con cada panel y una réplica hecha en la primera llamada no sirve */
+	if (op->archivos[0] != NULL && (op->tipo != MM_TIPO_NINGUNO || op->lote > 0)) {
+		fprintf(stderr, "--files no se combina con --type ni --batch\n");
+		exit(1);
+	}
+	if (op->presupuesto > 0 && (op->archivos[0] == NULL || op->replicaB)) {
+		fprintf(stderr, "--budget requiere --files y no se combina con -a <pol>,replica\n");
+		exit(1);
+	}
+	/* La tubería es un modo del micro-kernel de double */
+	if (op->tuberia && (op->tipo != MM_TIPO_NINGUNO || op->lote > 0)) {
+		fprintf(stderr, "--pipeline no se combina con --type ni --batch\n");
+		exit(1);
+	}
+	/* La A dispersa es cuadrada, de double y se genera en memoria */
+	if (op->densidad > 0.0 && (op->M > 0 || op->K > 0 || op->relleno > 0 || op->tipo != MM_TIPO_NINGUNO
+	                           || op->lote > 0 || op->archivos[0] != NULL)) {
+		fprintf(stderr, "--density no se combina con --shape, --pad, --type, --batch ni --files\n");
+		exit(1);
+	}
+	if (op->tuberia && op->kernel == MM_KERNEL_NINGUNO)
+		op->kernel = kernelDetectado();
+}
+
+/*-----------------------------------------------------------------------------
+ * kernelComun — Indica si se pidió un kernel de mmBloques.c o mmMicro.c.
+ *
+ * Descripción:
+ *  Retorna 0 cuando el programa debe usar su propio kernel clásico. Con
+ *  `--type` siempre se usa el kernel del tipo (mmTipo.c).
+ *---------------------------------------------------------------------------*/
+int kernelComun(const struct opciones *op) {
+	return op->kernel != MM_KERNEL_NINGUNO || op->bloque > 0 || op->tipo != MM_TIPO_NINGUNO;
+}
+
+/*-----------------------------------------------------------------------------
+ * franjaFilas — Número de filas de C que conviene asignar de una vez.
+ *
+ * Descripción:
+ *  Los programas OpenMP reparten franjas de filas entre los hilos; la franja
+ *  coincide con el bloque del kernel elegido (MM_MC para el micro-kernel
+ *  y para el kernel por tipo).
+ *---------------------------------------------------------------------------*/
+int franjaFilas(const struct opciones *op) {
+	if (op->kernel != MM_KERNEL_NINGUNO || op->tipo != MM_TIPO_NINGUNO)
+		return MM_MC;
+	return (op->bloque > 0) ? op->bloque : 1;
+}
+
+/*-----------------------------------------------------------------------------
+ * multiTeselaComun — Calcula la tesela [filaI, filaF) × [colI, colF) de C.
+ *
+ * Parámetros:
+ *  - op: opciones del programa (`--type` tiene prioridad sobre
+ *        `--pipeline`, `--pipeline` sobre `-k` y `-k` sobre `-b`).
+ *  - mA, mB, mC, D: matrices y dimensión; con `--type` contienen elementos
+ *                   del tipo, no doubles (ver `multiTipo()`).
+ *  - bTrans: 1 si `mB` contiene la transpuesta de B.
+ *  - filaI, filaF, colI, colF: región de C a calcular.
+ *---------------------------------------------------------------------------*/
+void multiTeselaComun(const struct opciones *op, const double *mA, const double *mB, int bTrans,
+                      double *mC, int D, int filaI, int filaF, int colI, int colF) {
+	multiTeselaComunEn(op, mA, mB, bTrans, mC, D, filaI, filaF, colI, colF, NULL);
+}
+
+/*-----------------------------------------------------------------------------
+ * elemsTrabajoComun — doubles de buffers de empaquetado que necesita
+ * `multiTeselaComunEn()` para teselas de hasta `cols` columnas; 0 si el
+ * kernel elegido no empaqueta (por bloques) o los gestiona él mismo
+ * (`--type`).
+ *---------------------------------------------------------------------------*/
+size_t elemsTrabajoComun(const struct opciones *op, int cols) {
+	if (op->tipo != MM_TIPO_NINGUNO || op->kernel == MM_KERNEL_NINGUNO)
+		return 0;
+	return op->tuberia ? elemsTuberia(cols) : elemsEmpaquetado(cols);
+}
+
+/*-----------------------------------------------------------------------------
+ * multiTeselaComunEn — `multiTeselaComun()` con los buffers de empaquetado
+ * del llamador.
+ *
+ * Parámetros:
+ *  - trabajo: al menos `elemsTrabajoComun(op, colF - colI)` doubles
+ *             alineados a 64 bytes, de uso exclusivo del hilo; NULL → el
+ *             micro-kernel reserva los suyos en cada llamada.
+ *
+ * Descripción:
+ *  Para los hilos que calculan muchas teselas (pool de Pthreads, regiones
+ *  OpenMP): reservan sus buffers una vez y no en cada tesela, dentro del
+ *  tiempo medido.
+ *---------------------------------------------------------------------------*/
+void multiTeselaComunEn(const struct opciones *op, const double *mA, const double *mB, int bTrans,
+                        double *mC, int D, int filaI, int filaF, int colI, int colF, double *trabajo) {
+	if (op->tipo != MM_TIPO_NINGUNO)
+		multiTipo(op->tipo, mA, mB, bTrans, mC, D, filaI, filaF, colI, colF, op->kernel);
+	else if (op->tuberia && trabajo != NULL)
+		multiFormaTuberiaEn(mA, D, mB, D, bTrans, mC, D, D, filaI, filaF, colI, colF, op->kernel, trabajo);
+	else if (op->tuberia)
+		multiFormaTuberia(mA, D, mB, D, bTrans, mC, D, D, filaI, filaF, colI, colF, op->kernel);
+	else if (op->kernel != MM_KERNEL_NINGUNO && trabajo != NULL)
+		multiFormaMicroEn(mA, D, mB, D, bTrans, mC, D, D, filaI, filaF, colI, colF, op->kernel, trabajo);
+	else if (op->kernel != MM_KERNEL_NINGUNO)
+		multiMatrixMicro(mA, mB, bTrans, mC, D, filaI, filaF, colI, colF, op->kernel);
+	else if (bTrans)
+		multiMatrixBloquesTrans(mA, mB, mC, D, filaI, filaF, colI, colF, op->bloque);
+	else
+		multiMatrixBloques(mA, mB, mC, D, filaI, filaF, colI, colF, op->bloque);
+}
+
+/*-----------------------------------------------------------------------------
+ * multiRango — Calcula las filas completas [filaI, filaF) de C.
+ *---------------------------------------------------------------------------*/
+void multiRango(const struct opciones *op, const double *mA, const double *mB, int bTrans,
+                double *mC, int D, int filaI, int filaF) {
+	multiTeselaComun(op, mA, mB, bTrans, mC, D, filaI, filaF, 0, D);
+}
@@ -0,0 +1,118 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * mmComun.h — Opciones de línea de comandos comunes a las siete versiones
+ * y al binario único `mm`.
+ *
+ * Todos los programas conservan la forma original `./programa N P`, cuya
+ * única salida es el tiempo en microsegundos que recoge lanzador.pl. Las
+ * opciones adicionales son opcionales y pueden ir antes o después de N y P.
+ */
+
+#ifndef MM_COMUN_H
+#define MM_COMUN_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Corte por defecto de la recursión de Strassen (`--cutoff`): por debajo de
+ * unos cientos de filas las sumas cuestan más de lo que ahorra el producto
+ * que se evita */
+#define MM_STRASSEN_CORTE 512
+
+/*-----------------------------------------------------------------------------
+ * Estructura de opciones:
+ *  - N: dimensión de las matrices cuadradas.
+ *  - P: número de hilos o procesos.
+ *  - bloque: 0 → kernel clásico; >0 → kernel por bloques con ese tamaño.
+ *  - kernel: variante del micro-kernel (MM_KERNEL_*, ver mmMicro.h);
+ *            MM_KERNEL_NINGUNO si no se pidió `-k`.
+ *  - reparto: (Pthreads) política de reparto de filas (MM_REPARTO_*).
+ *  - trozo: filas por trozo en el reparto dinámico/guiado, o lado de la
+ *           tesela con robo de trabajo (0 → automático).
+ *  - repeticiones: (Pthreads) multiplicaciones seguidas sobre el mismo pool
+ *                  (0 → una, con la salida original de una columna).
+ *  - afinidad: política de fijación de hilos (MM_AFIN_*, ver mmAfinidad.h).
+ *  - replicaB: 1 → una copia de B por nodo NUMA (requiere `-a`).
+ *  - informe: 1 → muestra en stderr información adicional de la ejecución.
+ *  - privada: (solo Fork) matrices en memoria privada en lugar de compartida.
+ *  - semilla: semilla del generador de A y B (`--seed`, ver mmAleatorio.h).
+ *  - verifica: 1 → comprueba C = A·B al terminar (`--verify`, mmVerifica.c).
+ *  - formatoTiempo: salida de tiempos por fase (`--timing`, MM_TIEMPO_*).
+ *  - contadores: 1 → contadores de hardware por trabajador (`--counters`).
+ *  - paginas: páginas de las matrices (`--pages`, MM_PAGINAS_*, mmMemoria.h).
+ *  - precarga: 1 → toca todas las páginas al reservar (`--prefault`).
+ *  - motores: (mm) lista de motores de `--engine`; NULL si no se indicó.
+ *  - M, K: filas de A y dimensión común del producto general C (M×N) =
+ *          A (M×K) · B (K×N) (`--shape MxK`); 0 → N (caso cuadrado).
+ *  - relleno: elementos extra al final de cada fila de A, B y C (`--pad`),
+ *             es decir, lda = K + relleno, ldb = ldc = N + relleno.
+ *  - tipo: tipo de elemento (`--type`, MM_TIPO_*, ver mmTipo.h; el primero
+ *          de la lista); MM_TIPO_NINGUNO → double con los kernels de siempre.
+ *  - tipos: (mm) lista de tipos de `--type`; NULL si no se indicó.
+ *  - listaN, listaP: N y P tal como se escribieron; el binario único `mm`
+ *                    acepta listas separadas por comas (N y P son el primer
+ *                    valor de cada una).
+ *  - corte: (Strassen) lado máximo de los bloques base (`--cutoff`);
+ *           0 → MM_STRASSEN_CORTE.
+ *  - lote: productos N×N independientes por multiplicación (`--batch`,
+ *          ver mmLote.h); 0 → un solo producto, repartido por filas.
+ *  - archivos: rutas de A, B y C (`--files`, ver mmArchivo.h); NULL si las
+ *              matrices están en memoria.
+ *  - presupuesto: MiB de buffers del producto fuera de memoria (`--budget`,
+ *                 ver mmExterno.h); 0 → los archivos se multiplican enteros.
+ *  - tuberia: 1 → micro-kernel con el empaquetado de B en tubería y doble
+ *             buffer (`--pipeline`, ver mmMicro.h); implica `-k auto` si no
+ *             se eligió variante.
+ *  - densidad: fracción de no ceros de A (`--density`, ver mmDispersa.h);
+ *              0 → A densa con el generador de siempre.
+ *  - perfilDensidad: reparto de los no ceros por filas (MM_DENSIDAD_*).
+ *---------------------------------------------------------------------------*/
+struct opciones {
+	int N;
+	int P;
+	int bloque;
+	int kernel;
+	int reparto;
+	int trozo;
+	int repeticiones;
+	int afinidad;
+	int replicaB;
+	int informe;
+	int privada;
+	uint64_t semilla;
+	int verifica;
+	int formatoTiempo;
+	int contadores;
+	int paginas;
+	int precarga;
+	const char *motores;
+	int M;
+	int K;
+	int relleno;
+	int tipo;
+	const char *tipos;
+	const char *listaN;
+	const char *listaP;
+	int corte;
+	int lote;
+	const char *archivos[3];
+	int presupuesto;
+	int tuberia;
+	double densidad;
+	int perfilDensidad;
+};
+
+void leerOpciones(int argc, char *argv[], const char *uso, struct opciones *op);
+
+int kernelComun(const struct opciones *op);
+int franjaFilas(const struct opciones *op);
+void multiRango(const struct opciones *op, const double *mA, const double *mB, int bTrans,
+                double *mC, int D, int filaI, int filaF);
+void multiTeselaComun(const struct opciones *op, const double *mA, const double *mB, int bTrans,
+                      double *mC, int D, int filaI, int filaF, int colI, int colF);
+size_t elemsTrabajoComun(const struct opciones *op, int cols);
+void multiTeselaComunEn(const struct opciones *op, const double *mA, const double *mB, int bTrans,
+                        double *mC, int D, int filaI, int filaF, int colI, int colF, double *trabajo);
+
+#endif
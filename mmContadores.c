@@ -0,0 +1,300 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * Descripción general:
+ * ---------------------------------------------------------------
+ * Contadores de hardware con `perf_event_open` (opción `--counters`).
+ *
+ * Con solo el tiempo no se distingue si el kernel clásico está limitado por
+ * los fallos de cache (recorre B por columnas) o por la capacidad de cálculo.
+ * Cada trabajador abre, al empezar su parte, un grupo de eventos sobre su
+ * propio hilo (pid = 0, cualquier CPU, solo modo usuario):
+ *  - ciclos (líder) e instrucciones → IPC.
+ *  - fallos de lectura de L1D, fallos de LLC y fallos de lectura de dTLB →
+ *    fallos por FMA (el producto D×D hace D³ multiplicaciones-suma).
+ * El grupo se activa y desactiva con un solo ioctl, de modo que todos los
+ * eventos cubren el mismo intervalo. Si el núcleo multiplexa los contadores,
+ * las cuentas se escalan por tiempo habilitado / tiempo en ejecución.
+ *
+ * Degradación: si el líder no se puede abrir (EACCES con
+ * perf_event_paranoid alto, ENOENT/EOPNOTSUPP en máquinas virtuales) el
+ * trabajador simplemente no cuenta; si falla solo un evento secundario, esa
+ * columna se informa como "-". El programa nunca termina por esta causa.
+ *
+ * Salida:
+ *  - `columnasContadores()`: GFLOP/s, IPC y fallos L1D/LLC/dTLB por FMA, a
+ *    continuación de las columnas de tiempo en la salida estándar.
+ *  - `informeContadores()`: totales por trabajador en stderr (con `-v`).
+ *
+ * ---------------------------------------------------------------
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "mmContadores.h"
+
+static const char *nombresCont[MM_CONTADORES] = {
+	"ciclos", "instrucciones", "fallos_l1d", "fallos_llc", "fallos_dtlb"
+};
+
+/*-----------------------------------------------------------------------------
+ * configuraEvento — Tipo y configuración de perf para cada MM_CONT_*.
+ *---------------------------------------------------------------------------*/
+static void configuraEvento(int ev, __u32 *tipo, __u64 *config) {
+	__u64 lecturaFallo = (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+	                        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+	switch (ev) {
+		case MM_CONT_CICLOS:
+			*tipo = PERF_TYPE_HARDWARE;
+			*config = PERF_COUNT_HW_CPU_CYCLES;
+			break;
+		case MM_CONT_INSTRUCCIONES:
+			*tipo = PERF_TYPE_HARDWARE;
+			*config = PERF_COUNT_HW_INSTRUCTIONS;
+			break;
+		case MM_CONT_FALLOS_L1D:
+			*tipo = PERF_TYPE_HW_CACHE;
+			*config = PERF_COUNT_HW_CACHE_L1D | lecturaFallo;
+			break;
+		case MM_CONT_FALLOS_LLC:
+			*tipo = PERF_TYPE_HARDWARE;
+			*config = PERF_COUNT_HW_CACHE_MISSES;
+			break;
+		default:
+			*tipo = PERF_TYPE_HW_CACHE;
+			*config = PERF_COUNT_HW_CACHE_DTLB | lecturaFallo;
+			break;
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * abreEvento — `perf_event_open` sobre el hilo actual.
+ *
+ * Parámetros:
+ *  - ev: evento MM_CONT_*.
+ *  - lider: descriptor del líder del grupo (-1 para abrir el líder).
+ *---------------------------------------------------------------------------*/
+static int abreEvento(int ev, int lider) {
+	struct perf_event_attr attr;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	configuraEvento(ev, &attr.type, &attr.config);
+	attr.disabled = (lider == -1);
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID |
+	                   PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+	return (int) syscall(SYS_perf_event_open, &attr, 0, -1, lider, 0);
+}
+
+/*-----------------------------------------------------------------------------
+ * iniContadores — Reserva las lecturas de `nH` trabajadores.
+ *
+ * Descripción:
+ *  Igual que las marcas de mmTiempo.c, las lecturas van en una región
+ *  anónima compartida para que los hijos de la versión Fork puedan
+ *  escribirlas. Retorna -1 si la reserva falla.
+ *---------------------------------------------------------------------------*/
+int iniContadores(struct contadores *c, int nH) {
+	void *region = mmap(NULL, (size_t) nH * sizeof(struct lecturaCont), PROT_READ | PROT_WRITE,
+	                    MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+	memset(c, 0, sizeof(*c));
+	if (region == MAP_FAILED)
+		return -1;
+
+	c->nH = nH;
+	c->trab = (struct lecturaCont *) region;
+	for (int i = 0; i < nH; i++)
+		for (int e = 0; e < MM_CONTADORES; e++)
+			c->trab[i].fd[e] = -1;
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * inicioContadores — Abre el grupo del trabajador `idH` y empieza a contar.
+ *
+ * Descripción:
+ *  Sin `iniContadores()` previo (c->trab == NULL) no hace nada, de modo que
+ *  los kernels pueden llamarla siempre.
+ *---------------------------------------------------------------------------*/
+void inicioContadores(struct contadores *c, int idH) {
+	if (c == NULL || c->trab == NULL)
+		return;
+
+	struct lecturaCont *l = &c->trab[idH];
+	int lider = abreEvento(MM_CONT_CICLOS, -1);
+
+	if (lider < 0) {
+		l->error = errno;
+		return;
+	}
+	l->fd[MM_CONT_CICLOS] = lider;
+	for (int e = 1; e < MM_CONTADORES; e++)
+		l->fd[e] = abreEvento(e, lider);
+
+	ioctl(lider, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(lider, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+/*-----------------------------------------------------------------------------
+ * finContadores — Detiene el grupo, acumula las cuentas y cierra los
+ * descriptores del trabajador `idH`.
+ *
+ * Descripción:
+ *  La lectura con PERF_FORMAT_GROUP | PERF_FORMAT_ID devuelve, tras el
+ *  número de eventos y los tiempos habilitado/en ejecución, un par
+ *  (valor, id) por evento abierto; el id se compara con el de cada
+ *  descriptor (PERF_EVENT_IOC_ID) para asignar los valores.
+ *---------------------------------------------------------------------------*/
+void finContadores(struct contadores *c, int idH) {
+	if (c == NULL || c->trab == NULL)
+		return;
+
+	struct lecturaCont *l = &c->trab[idH];
+	int lider = l->fd[MM_CONT_CICLOS];
+	uint64_t buf[3 + 2 * MM_CONTADORES];
+
+	if (lider < 0)
+		return;
+
+	ioctl(lider, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+	if (read(lider, buf, sizeof(buf)) > 0) {
+		uint64_t nr = buf[0], habilitado = buf[1], ejecutando = buf[2];
+		double escala = (ejecutando > 0) ? (double) habilitado / (double) ejecutando : 0.0;
+
+		for (int e = 0; e < MM_CONTADORES; e++) {
+			uint64_t id;
+
+			if (l->fd[e] < 0 || ioctl(l->fd[e], PERF_EVENT_IOC_ID, &id) != 0)
+				continue;
+			for (uint64_t k = 0; k < nr && k < MM_CONTADORES; k++)
+				if (buf[4 + 2 * k] == id) {
+					l->valor[e] += (uint64_t) ((double) buf[3 + 2 * k] * escala);
+					l->valido[e] = (ejecutando > 0);
+				}
+		}
+	}
+
+	for (int e = 0; e < MM_CONTADORES; e++) {
+		if (l->fd[e] >= 0)
+			close(l->fd[e]);
+		l->fd[e] = -1;
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * totalEvento — Suma un evento sobre los trabajadores; retorna 0 si ningún
+ * trabajador lo pudo contar.
+ *---------------------------------------------------------------------------*/
+static int totalEvento(const struct contadores *c, int ev, double *total) {
+	int alguno = 0;
+
+	*total = 0.0;
+	for (int i = 0; i < c->nH; i++)
+		if (c->trab[i].valido[ev]) {
+			*total += (double) c->trab[i].valor[ev];
+			alguno = 1;
+		}
+	return alguno;
+}
+
+/*-----------------------------------------------------------------------------
+ * columnasContadores — Escribe las columnas de rendimiento.
+ *
+ * Parámetros:
+ *  - c: contadores.
+ *  - flops: operaciones de punto flotante medidas (2·N³ por multiplicación).
+ *  - tiempoUs: tiempo de esas multiplicaciones en µs.
+ *  - f: flujo de salida (stdout, a continuación del tiempo).
+ *
+ * Descripción:
+ *  Columnas: GFLOP/s, IPC, fallos L1D/FMA, fallos LLC/FMA, fallos dTLB/FMA.
+ *  Las que dependen de un evento no disponible se escriben como "-".
+ *---------------------------------------------------------------------------*/
+void columnasContadores(const struct contadores *c, double flops, double tiempoUs, FILE *f) {
+	double fma = flops / 2.0, ciclos, instr, v;
+
+	fprintf(f, "%9.3f ", (tiempoUs > 0.0) ? flops / tiempoUs * 1e-3 : 0.0);
+
+	if (totalEvento(c, MM_CONT_CICLOS, &ciclos) && totalEvento(c, MM_CONT_INSTRUCCIONES, &instr) && ciclos > 0.0)
+		fprintf(f, "%6.3f ", instr / ciclos);
+	else
+		fprintf(f, "%6s ", "-");
+
+	for (int e = MM_CONT_FALLOS_L1D; e <= MM_CONT_FALLOS_DTLB; e++) {
+		if (totalEvento(c, e, &v) && fma > 0.0)
+			fprintf(f, "%9.6f ", v / fma);
+		else
+			fprintf(f, "%9s ", "-");
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * informeContadores — Informe de los contadores en `f` (stderr).
+ *
+ * Parámetros:
+ *  - c: contadores.
+ *  - detalle: 1 para mostrar las cuentas por trabajador (`-v`).
+ *  - f: flujo de salida.
+ *
+ * Descripción:
+ *  Si ningún trabajador pudo abrir los eventos se indica siempre, en una
+ *  línea, el motivo y el valor de /proc/sys/kernel/perf_event_paranoid, para
+ *  que las columnas "-" no queden sin explicación. Las cuentas por
+ *  trabajador solo se muestran con `detalle`.
+ *---------------------------------------------------------------------------*/
+void informeContadores(const struct contadores *c, int detalle, FILE *f) {
+	double ciclos;
+	int error = 0;
+
+	if (!totalEvento(c, MM_CONT_CICLOS, &ciclos)) {
+		FILE *p = fopen("/proc/sys/kernel/perf_event_paranoid", "r");
+		int paranoid = -99;
+
+		for (int i = 0; i < c->nH && error == 0; i++)
+			error = c->trab[i].error;
+		if (p != NULL) {
+			if (fscanf(p, "%d", &paranoid) != 1) paranoid = -99;
+			fclose(p);
+		}
+		fprintf(f, "Contadores no disponibles: %s (perf_event_paranoid = %d)\n",
+		        error ? strerror(error) : "sin lecturas", paranoid);
+		return;
+	}
+	if (!detalle)
+		return;
+
+	fprintf(f, "Hilo");
+	for (int e = 0; e < MM_CONTADORES; e++)
+		fprintf(f, " %14s", nombresCont[e]);
+	fprintf(f, "\n");
+	for (int i = 0; i < c->nH; i++) {
+		fprintf(f, "%4d", i);
+		for (int e = 0; e < MM_CONTADORES; e++) {
+			if (c->trab[i].valido[e])
+				fprintf(f, " %14llu", (unsigned long long) c->trab[i].valor[e]);
+			else
+				fprintf(f, " %14s", "-");
+		}
+		fprintf(f, "\n");
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * liberaContadores — Libera las lecturas.
+ *---------------------------------------------------------------------------*/
+void liberaContadores(struct contadores *c) {
+	if (c->trab != NULL)
+		munmap(c->trab, (size_t) c->nH * sizeof(struct lecturaCont));
+	c->trab = NULL;
+}
@@ -0,0 +1,60 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * mmContadores.h — Contadores de hardware por trabajador con
+ * `perf_event_open` (opción `--counters`).
+ *
+ * Cada hilo o proceso hijo abre un grupo de eventos (ciclos, instrucciones,
+ * fallos de L1D, de LLC y de dTLB) alrededor de su parte del producto. Si el
+ * sistema no permite abrir eventos (perf_event_paranoid, contenedores,
+ * máquinas virtuales) los programas siguen funcionando y solo informan
+ * GFLOP/s.
+ */
+
+#ifndef MM_CONTADORES_H
+#define MM_CONTADORES_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/* Eventos del grupo; el primero es el líder */
+#define MM_CONT_CICLOS         0
+#define MM_CONT_INSTRUCCIONES  1
+#define MM_CONT_FALLOS_L1D     2
+#define MM_CONT_FALLOS_LLC     3
+#define MM_CONT_FALLOS_DTLB    4
+#define MM_CONTADORES          5
+
+/*-----------------------------------------------------------------------------
+ * Lectura de un trabajador (una línea de cache cada uno):
+ *  - fd: descriptores abiertos durante la llamada en curso (-1 si el evento
+ *        no está disponible).
+ *  - valor: cuentas acumuladas (escaladas si hubo multiplexación).
+ *  - valido: 1 si el evento se pudo contar al menos una vez.
+ *  - error: errno del último fallo al abrir el líder (0 si no hubo).
+ *---------------------------------------------------------------------------*/
+struct lecturaCont {
+	_Alignas(64) int fd[MM_CONTADORES];
+	uint64_t valor[MM_CONTADORES];
+	int valido[MM_CONTADORES];
+	int error;
+};
+
+/*-----------------------------------------------------------------------------
+ * Estado de los contadores:
+ *  - nH: número de trabajadores.
+ *  - trab: lecturas por trabajador, en memoria compartida (versión Fork).
+ *---------------------------------------------------------------------------*/
+struct contadores {
+	int nH;
+	struct lecturaCont *trab;
+};
+
+int iniContadores(struct contadores *c, int nH);
+void inicioContadores(struct contadores *c, int idH);
+void finContadores(struct contadores *c, int idH);
+void columnasContadores(const struct contadores *c, double flops, double tiempoUs, FILE *f);
+void informeContadores(const struct contadores *c, int detalle, FILE *f);
+void liberaContadores(struct contadores *c);
+
+#endif
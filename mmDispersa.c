@@ -0,0 +1,496 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * Descripción general:
+ * ---------------------------------------------------------------
+ * Producto C = A·B con A dispersa y B densa (`--density d[,perfil]`).
+ *
+ * Generador: A es la misma matriz de `iniMatrixFilas()` con cada elemento
+ * puesto a cero salvo una fracción `d` de ellos, elegida con un flujo
+ * aleatorio propio (mmAleatorio.c), así que A no depende del reparto ni
+ * del programa. Con el perfil "uniforme" todas las filas tienen densidad
+ * d; con "creciente" la densidad de la fila i es 2·d·(i + ½)/N (máximo 1),
+ * de modo que la media sigue siendo d (con d ≤ ½) pero las últimas filas
+ * tienen casi el doble de no ceros que la media y las primeras casi
+ * ninguno, como las matrices reales con filas muy desiguales.
+ *
+ * Formato: CSR (`struct matrizCSR`). La compresión desde la A densa se
+ * hace una vez por motor, fuera del tiempo de multiplicación, en la fase
+ * MM_FASE_COMPRESION de mmTiempo.c.
+ *
+ * Kernel (`multiCSR()`): para cada tesela de MM_DISPERSA_COLUMNAS columnas
+ * de C y cada fila i, la fila de la tesela se acumula en un arreglo local
+ * como combinación de las filas de B que indican los no ceros de A[i]; con
+ * el ancho constante el compilador la mantiene en registros y vectoriza,
+ * y la tesela de B se reutiliza en todas las filas del rango. Se genera
+ * para las tres variantes de `-k` con `__attribute__((target))`, como los
+ * kernels de mmLote.c. Cada no cero cuesta 2·N FLOP y lee una fila de B:
+ * la intensidad aritmética es la de un producto matriz-vector por fila de
+ * B, así que con densidades bajas el producto queda limitado por memoria.
+ *
+ * Reparto (`particionNnz()`): cortes de filas contiguas con el mismo peso
+ * nnz + filas (cada fila cuesta sus no ceros más escribir su fila de C).
+ * Con el perfil creciente el reparto por número de filas que usan
+ * mmClasicaPosix.c y los demás motores da al último trabajador casi el
+ * doble de trabajo que la media.
+ *
+ * No se implementa CSR por bloques (BCSR): el generador reparte los no
+ * ceros sin estructura de bloques y los bloques se llenarían de ceros.
+ *
+ * ---------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "mmDispersa.h"
+#include "mmMicro.h"
+#include "mmReparto.h"
+#include "mmAleatorio.h"
+#include "mmVerifica.h"
+#include "mmTiempo.h"
+#include "mmContadores.h"
+#include "mmMemoria.h"
+#include "mmMotor.h"
+
+/* Flujo del generador que decide qué elementos de A son no ceros */
+#define MM_DISPERSA_FLUJO  0xD5
+
+static const char *nombresPerfil[] = { "uniforme", "creciente" };
+
+/*-----------------------------------------------------------------------------
+ * densidadPorNombre — Interpreta el argumento de `--density` ("d[,perfil]").
+ *
+ * Descripción:
+ *  Retorna 0 y deja la densidad y el perfil (MM_DENSIDAD_*) si d está en
+ *  (0, 1] y el perfil existe; -1 en otro caso.
+ *---------------------------------------------------------------------------*/
+int densidadPorNombre(const char *texto, double *densidad, int *perfil) {
+	char *fin;
+	double d = strtod(texto, &fin);
+
+	if (fin == texto || !(d > 0.0 && d <= 1.0))
+		return -1;
+	*densidad = d;
+	*perfil = MM_DENSIDAD_UNIFORME;
+	if (*fin == '\0')
+		return 0;
+	if (*fin != ',')
+		return -1;
+	for (int p = 0; p < (int) (sizeof(nombresPerfil) / sizeof(nombresPerfil[0])); p++)
+		if (strcmp(fin + 1, nombresPerfil[p]) == 0) {
+			*perfil = p;
+			return 0;
+		}
+	return -1;
+}
+
+/*-----------------------------------------------------------------------------
+ * nombrePerfil — Nombre de un perfil de densidad (MM_DENSIDAD_*).
+ *---------------------------------------------------------------------------*/
+const char *nombrePerfil(int perfil) {
+	return nombresPerfil[perfil];
+}
+
+/*-----------------------------------------------------------------------------
+ * densidadFila — Fracción de no ceros de la fila i de una A D×D.
+ *---------------------------------------------------------------------------*/
+static double densidadFila(double densidad, int perfil, int i, int D) {
+	if (perfil == MM_DENSIDAD_UNIFORME)
+		return densidad;
+
+	double d = 2.0 * densidad * (i + 0.5) / D;
+	return (d < 1.0) ? d : 1.0;
+}
+
+/*-----------------------------------------------------------------------------
+ * iniDispersaFilas — Inicializa las filas [filaI, filaF) de A dispersa y
+ * B densa.
+ *
+ * Parámetros:
+ *  - mA, mB: matrices D×D.
+ *  - D: dimensión.
+ *  - filaI, filaF: rango de filas a llenar.
+ *  - densidad, perfil: fracción de no ceros de A y su reparto por filas.
+ *  - semilla: semilla del usuario (`--seed`).
+ *
+ * Descripción:
+ *  Como `iniMatrixFilas()`, y después A[i][k] se pone a cero si el valor
+ *  del flujo MM_DISPERSA_FLUJO en la posición i·D + k no es menor que la
+ *  densidad de la fila: los no ceros tienen el mismo valor que en la A
+ *  densa y, con densidad 1, A es idéntica a la densa.
+ *---------------------------------------------------------------------------*/
+void iniDispersaFilas(double *mA, double *mB, int D, int filaI, int filaF,
+                      double densidad, int perfil, uint64_t semilla) {
+	uint64_t flujo = semillaMatriz(semilla, MM_DISPERSA_FLUJO);
+
+	iniMatrixFilas(mA, mB, D, filaI, filaF, semilla);
+	for (int i = filaI; i < filaF; i++) {
+		double p = densidadFila(densidad, perfil, i, D);
+		double *fila = mA + (size_t) i * D;
+		uint64_t base = (uint64_t) i * D;
+
+		if (p >= 1.0)
+			continue;
+		for (int k = 0; k < D; k++)
+			if (aleatorioEn(flujo, base + k) >= p)
+				fila[k] = 0.0;
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * comprimeCSR — Comprime una matriz densa por filas a CSR.
+ *
+ * Parámetros:
+ *  - m: matriz densa de `filas`×`cols` con salto `ld`.
+ *  - a: destino; se libera con `liberaCSR()`.
+ *
+ * Descripción:
+ *  Dos pasadas: la primera cuenta los no ceros de cada fila y deja sus
+ *  posiciones en `inicio`; la segunda copia columnas y valores. Retorna 0,
+ *  o -1 si no hay memoria (con `a` vacía).
+ *---------------------------------------------------------------------------*/
+int comprimeCSR(const double *m, int filas, int cols, int ld, struct matrizCSR *a) {
+	memset(a, 0, sizeof(*a));
+	a->filas = filas;
+	a->cols = cols;
+	a->inicio = malloc(((size_t) filas + 1) * sizeof(size_t));
+	if (a->inicio == NULL)
+		return -1;
+
+	size_t nnz = 0;
+	for (int i = 0; i < filas; i++) {
+		const double *fila = m + (size_t) i * ld;
+
+		a->inicio[i] = nnz;
+		for (int k = 0; k < cols; k++)
+			nnz += (fila[k] != 0.0);
+	}
+	a->inicio[filas] = nnz;
+	a->nnz = nnz;
+
+	/* Un elemento de más para que una matriz sin no ceros no pida malloc(0) */
+	a->col = malloc((nnz + 1) * sizeof(int));
+	a->val = malloc((nnz + 1) * sizeof(double));
+	if (a->col == NULL || a->val == NULL) {
+		liberaCSR(a);
+		return -1;
+	}
+
+	size_t x = 0;
+	for (int i = 0; i < filas; i++) {
+		const double *fila = m + (size_t) i * ld;
+
+		for (int k = 0; k < cols; k++)
+			if (fila[k] != 0.0) {
+				a->col[x] = k;
+				a->val[x] = fila[k];
+				x++;
+			}
+	}
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * liberaCSR — Libera una matriz CSR y la deja vacía.
+ *---------------------------------------------------------------------------*/
+void liberaCSR(struct matrizCSR *a) {
+	free(a->inicio);
+	free(a->col);
+	free(a->val);
+	memset(a, 0, sizeof(*a));
+}
+
+/*-----------------------------------------------------------------------------
+ * pesoHasta — Peso de las filas [0, i): sus no ceros más una unidad por
+ * fila.
+ *---------------------------------------------------------------------------*/
+static size_t pesoHasta(const struct matrizCSR *a, int i) {
+	return a->inicio[i] + (size_t) i;
+}
+
+/*-----------------------------------------------------------------------------
+ * particionNnz — Reparte las filas de A en trozos contiguos de igual peso.
+ *
+ * Parámetros:
+ *  - a: matriz CSR.
+ *  - partes: número de trabajadores.
+ *  - cortes: destino de partes + 1 filas; el trabajador t calcula las filas
+ *            [cortes[t], cortes[t + 1]).
+ *
+ * Descripción:
+ *  El corte t es la primera fila en la que el peso acumulado (no ceros más
+ *  filas, ver `pesoHasta()`) alcanza t/partes del total; se busca por
+ *  bisección sobre `inicio`, que ya es la suma prefija de los no ceros.
+ *  Sin no ceros el reparto coincide con el de filas de `rangoEstatico()`
+ *  salvo por el redondeo.
+ *---------------------------------------------------------------------------*/
+void particionNnz(const struct matrizCSR *a, int partes, int *cortes) {
+	size_t total = pesoHasta(a, a->filas);
+
+	cortes[0] = 0;
+	for (int t = 1; t < partes; t++) {
+		size_t meta = (size_t) ((double) total * t / partes);
+		int lo = cortes[t - 1], hi = a->filas;
+
+		while (lo < hi) {
+			int medio = lo + (hi - lo) / 2;
+
+			if (pesoHasta(a, medio) < meta)
+				lo = medio + 1;
+			else
+				hi = medio;
+		}
+		cortes[t] = lo;
+	}
+	cortes[partes] = a->filas;
+}
+
+/*-----------------------------------------------------------------------------
+ * desequilibrioCortes — No ceros del trozo más cargado / media (1 = ideal).
+ *---------------------------------------------------------------------------*/
+static double desequilibrioCortes(const struct matrizCSR *a, int partes, const int *cortes) {
+	size_t maximo = 0;
+
+	if (a->nnz == 0)
+		return 1.0;
+	for (int t = 0; t < partes; t++) {
+		size_t n = a->inicio[cortes[t + 1]] - a->inicio[cortes[t]];
+		if (n > maximo)
+			maximo = n;
+	}
+	return (double) maximo * partes / (double) a->nnz;
+}
+
+/*-----------------------------------------------------------------------------
+ * MM_DISPERSA_VARIANTE — Define el kernel CSR `filasCSR##suf` de una
+ * variante SIMD.
+ *
+ * Descripción:
+ *  C[filaI:filaF, 0:n] = A[filaI:filaF, :]·B. Las teselas completas
+ *  acumulan cada fila en `c`, de largo constante; la última tesela, más
+ *  estrecha, acumula directamente en C.
+ *---------------------------------------------------------------------------*/
+#define MM_DISPERSA_VARIANTE(suf, ATRIB)                                                    \
+ATRIB static void filasCSR##suf(const struct matrizCSR *a, const double *restrict mB, int ldb, \
+                                double *restrict mC, int ldc, int n, int filaI, int filaF) { \
+	const size_t *inicio = a->inicio;                                                        \
+	const int *col = a->col;                                                                 \
+	const double *val = a->val;                                                              \
+	int jc = 0;                                                                              \
+                                                                                             \
+	for (; jc + MM_DISPERSA_COLUMNAS <= n; jc += MM_DISPERSA_COLUMNAS)                       \
+		for (int i = filaI; i < filaF; i++) {                                                \
+			double c[MM_DISPERSA_COLUMNAS] = { 0.0 };                                        \
+                                                                                             \
+			for (size_t x = inicio[i]; x < inicio[i + 1]; x++) {                             \
+				const double *restrict b = mB + (size_t) col[x] * ldb + jc;                  \
+				double v = val[x];                                                           \
+                                                                                             \
+				for (int j = 0; j < MM_DISPERSA_COLUMNAS; j++)                               \
+					c[j] += v * b[j];                                                        \
+			}                                                                                \
+			double *restrict fila = mC + (size_t) i * ldc + jc;                              \
+			for (int j = 0; j < MM_DISPERSA_COLUMNAS; j++)                                   \
+				fila[j] = c[j];                                                              \
+		}                                                                                    \
+                                                                                             \
+	if (jc < n)                                                                              \
+		for (int i = filaI; i < filaF; i++) {                                                \
+			double *restrict fila = mC + (size_t) i * ldc;                                   \
+                                                                                             \
+			for (int j = jc; j < n; j++)                                                     \
+				fila[j] = 0.0;                                                               \
+			for (size_t x = inicio[i]; x < inicio[i + 1]; x++) {                             \
+				const double *restrict b = mB + (size_t) col[x] * ldb;                       \
+				double v = val[x];                                                           \
+                                                                                             \
+				for (int j = jc; j < n; j++)                                                 \
+					fila[j] += v * b[j];                                                     \
+			}                                                                                \
+		}                                                                                    \
+}
+
+MM_DISPERSA_VARIANTE(Escalar, )
+MM_DISPERSA_VARIANTE(AVX2, __attribute__((target("avx2,fma"))))
+MM_DISPERSA_VARIANTE(AVX512, __attribute__((target("avx512f"))))
+
+typedef void (*kernelCSR)(const struct matrizCSR *a, const double *restrict mB, int ldb,
+                          double *restrict mC, int ldc, int n, int filaI, int filaF);
+
+/* Kernels por variante, en el orden de MM_KERNEL_* */
+static const kernelCSR kernelsCSR[] = { filasCSREscalar, filasCSRAVX2, filasCSRAVX512 };
+
+/*-----------------------------------------------------------------------------
+ * multiCSR — Calcula las filas [filaI, filaF) de C = A·B con A en CSR.
+ *
+ * Parámetros:
+ *  - kernel: variante SIMD (MM_KERNEL_*; NINGUNO → la detectada).
+ *  - a: A en CSR (a->cols filas de B).
+ *  - mB, ldb: B densa de a->cols × n con salto ldb.
+ *  - mC, ldc: C densa con salto ldc; las filas del rango se sobrescriben.
+ *  - n: columnas de B y de C.
+ *---------------------------------------------------------------------------*/
+void multiCSR(int kernel, const struct matrizCSR *a, const double *mB, int ldb,
+              double *mC, int ldc, int n, int filaI, int filaF) {
+	if (kernel == MM_KERNEL_NINGUNO)
+		kernel = kernelDetectado();
+	kernelsCSR[kernel](a, mB, ldb, mC, ldc, n, filaI, filaF);
+}
+
+/*-----------------------------------------------------------------------------
+ * informeRepartoNnz — Muestra el reparto por no ceros frente al de filas.
+ *
+ * Descripción:
+ *  Para los cortes de `particionNnz()` y para los de `rangoEstatico()`
+ *  (filas iguales) muestra los no ceros del trozo más cargado sobre la
+ *  media: el tiempo de cálculo del producto crece en esa proporción.
+ *---------------------------------------------------------------------------*/
+void informeRepartoNnz(const struct matrizCSR *a, int partes, const int *cortes, FILE *f) {
+	int *filas = malloc(((size_t) partes + 1) * sizeof(int));
+
+	if (filas == NULL)
+		return;
+	for (int t = 0; t < partes; t++)
+		rangoEstatico(a->filas, partes, t, &filas[t], &filas[t + 1]);
+
+	fprintf(f, "# CSR: %d×%d, %zu no ceros, %.1f MiB; reparto de %d trozos, máx/media de no ceros "
+	        "%.2f (por filas iguales %.2f)\n", a->filas, a->cols, a->nnz,
+	        (a->nnz * (sizeof(int) + sizeof(double)) + (a->filas + 1.0) * sizeof(size_t)) / 1048576.0,
+	        partes, desequilibrioCortes(a, partes, cortes), desequilibrioCortes(a, partes, filas));
+	free(filas);
+}
+
+/*-----------------------------------------------------------------------------
+ * cuentaNoCeros — Elementos no nulos de los `elems` primeros de `m`.
+ *---------------------------------------------------------------------------*/
+size_t cuentaNoCeros(const double *m, size_t elems) {
+	size_t nnz = 0;
+
+	for (size_t x = 0; x < elems; x++)
+		nnz += (m[x] != 0.0);
+	return nnz;
+}
+
+/*-----------------------------------------------------------------------------
+ * informeDispersa — Densidad real de A y rendimiento útil del producto.
+ *
+ * Descripción:
+ *  Con los no ceros de A (`cuentaNoCeros()`) muestra los GFLOP/s útiles
+ *  (2·nnz·N FLOP) junto con los que tendría el producto denso (2·N³) en el
+ *  mismo tiempo: un motor denso hace todo el trabajo del segundo y solo le
+ *  sirve el primero.
+ *---------------------------------------------------------------------------*/
+void informeDispersa(const struct opciones *op, size_t nnz, double tiempoUs, int reps, FILE *f) {
+	int N = op->N;
+	size_t total = (size_t) N * N;
+	double densidad = (op->densidad > 0.0) ? op->densidad : 1.0;
+	double utiles = 2.0 * (double) nnz * N, densos = 2.0 * N * (double) N * N;
+
+	fprintf(f, "# dispersa: densidad %g (%s), real %.4f, %zu no ceros; %.2f GFLOP/s útiles, "
+	        "%.2f GFLOP/s del producto denso equivalente\n", densidad, nombrePerfil(op->perfilDensidad),
+	        (double) nnz / total, nnz,
+	        tiempoUs > 0.0 ? utiles * reps / (tiempoUs * 1e3) : 0.0,
+	        tiempoUs > 0.0 ? densos * reps / (tiempoUs * 1e3) : 0.0);
+}
+
+/*-----------------------------------------------------------------------------
+ * ejecutaDispersa — Programa independiente común para `--density`.
+ *
+ * Parámetros:
+ *  - op: opciones ya leídas (con `--density`, o sin ella en el programa
+ *        del motor dispersa: A densa).
+ *  - mt: motor del programa (ver mmMotor.h).
+ *  - compartida: 1 → matrices en memoria compartida (motor Fork).
+ *  - programa: nombre para `--timing`.
+ *
+ * Descripción:
+ *  Como `ejecutaLote()` (mmLote.c): reserva A, B y C en una región, las
+ *  inicializa en serie con `iniDispersaFilas()`, ejecuta el motor (una vez
+ *  o R con `-r`) y escribe el tiempo con el formato de siempre. Con `-v`
+ *  la densidad y el rendimiento útil, con `--verify` la comprobación de C
+ *  y con `--timing` las fases. Retorna el código de salida del programa.
+ *---------------------------------------------------------------------------*/
+int ejecutaDispersa(const struct opciones *op, const struct motor *mt, int compartida, const char *programa) {
+	struct medicion tiempos;
+	struct contadores contadores;
+	int N = op->N;
+	int reps = (op->repeticiones > 0) ? op->repeticiones : 1;
+	double densidad = (op->densidad > 0.0) ? op->densidad : 1.0;
+
+	if (compruebaHuella(N, 3, stderr) != 0)
+		exit(1);
+
+	size_t eM = elemsAlineados((size_t) N * N);
+	double *region = reservaMatriz(3 * eM, op->paginas, compartida, op->precarga);
+	if (region == NULL) {
+		perror("Error al reservar memoria para las matrices");
+		exit(1);
+	}
+	double *mA = region, *mB = region + eM, *mC = region + 2 * eM;
+
+	if (iniMedicion(&tiempos, op->P) != 0) {
+		perror("Error al reservar las marcas de tiempo");
+		exit(1);
+	}
+	if (op->contadores) {
+		if (iniContadores(&contadores, op->P) != 0) {
+			perror("Error al reservar los contadores");
+			exit(1);
+		}
+		tiempos.cont = &contadores;
+	}
+
+	inicioFase(&tiempos, MM_FASE_INICIALIZACION);
+	iniDispersaFilas(mA, mB, N, 0, N, densidad, op->perfilDensidad, op->semilla);
+	memset(mC, 0, (size_t) N * N * sizeof(double));
+	finFase(&tiempos, MM_FASE_INICIALIZACION);
+
+	if (mt->iniciar(op, &tiempos) != 0) {
+		perror("Error al iniciar el motor");
+		exit(1);
+	}
+
+	double suma = 0.0, minimo = 0.0, maximo = 0.0;
+	for (int r = 0; r < reps; r++) {
+		double t = mt->multiplicar(op, mA, mB, mC);
+
+		suma += t;
+		if (r == 0 || t < minimo) minimo = t;
+		if (r == 0 || t > maximo) maximo = t;
+	}
+	mt->terminar(op);
+
+	/* Como en `mm`: los motores densos hacen los 2·N³ FLOP, pero el motor
+	 * dispersa (kernel CSR) solo los 2·nnz·N útiles; GFLOP/s y fallos por FMA
+	 * de `--counters` se refieren a lo que el motor hizo. Se compara por
+	 * nombre porque los demás programas no enlazan `motorDispersa` */
+	size_t nnz = cuentaNoCeros(mA, (size_t) N * N);
+	double flops = (strcmp(mt->nombre, "dispersa") == 0) ? 2.0 * (double) nnz * N : 2.0 * N * (double) N * N;
+
+	if (op->repeticiones > 0)
+		printf("%9.0f %9.0f %9.0f ", suma / reps, minimo, maximo);
+	else
+		printf("%9.0f ", suma);
+	if (op->contadores)
+		columnasContadores(&contadores, flops * reps, suma, stdout);
+	printf("\n");
+	fflush(stdout);
+
+	if (op->informe) {
+		informeDispersa(op, nnz, suma, reps, stderr);
+		informeMemoria("A|B|C", region, stderr);
+	}
+
+	int fallo = op->verifica ? verificaProducto(mA, mB, mC, N, op->semilla, stderr) : 0;
+
+	escribeMedicion(&tiempos, op->formatoTiempo, programa, N, stderr);
+	if (op->contadores) {
+		informeContadores(&contadores, op->informe, stderr);
+		liberaContadores(&contadores);
+	}
+	finMedicion(&tiempos);
+	liberaMatriz(region, 3 * eM, op->paginas);
+	return fallo;
+}
@@ -0,0 +1,68 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * mmDispersa.h — Producto de una A dispersa por una B densa (`--density`).
+ *
+ * A se genera densa (N×N, con ceros) con una fracción `densidad` de no
+ * ceros y se comprime a CSR (filas comprimidas) para el motor `dispersa`;
+ * los demás motores multiplican la misma A densa, así que la comparación
+ * muestra cuánto cuestan los productos por cero. El reparto de filas entre
+ * trabajadores se equilibra por no ceros, no por número de filas.
+ */
+
+#ifndef MM_DISPERSA_H
+#define MM_DISPERSA_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "mmComun.h"
+
+struct motor;
+
+/* Perfiles de densidad por fila (`--density d[,perfil]`) */
+#define MM_DENSIDAD_UNIFORME   0   /* todas las filas con densidad d          */
+#define MM_DENSIDAD_CRECIENTE  1   /* la fila i con 2·d·(i + ½)/N (máx. 1)    */
+
+/* Columnas de C por tesela del kernel CSR: cada fila de la tesela se
+ * acumula en un arreglo local de este largo, y la tesela de B (N filas de
+ * este ancho) se reutiliza en todas las filas del trabajador */
+#define MM_DISPERSA_COLUMNAS  64
+
+/*-----------------------------------------------------------------------------
+ * Matriz en formato CSR:
+ *  - filas, cols: dimensiones.
+ *  - nnz: elementos no nulos.
+ *  - inicio: filas + 1 posiciones; los no ceros de la fila i son
+ *            [inicio[i], inicio[i + 1]).
+ *  - col, val: columna y valor de cada no cero, por filas y, dentro de
+ *              cada fila, por columnas crecientes.
+ *---------------------------------------------------------------------------*/
+struct matrizCSR {
+	int filas, cols;
+	size_t nnz;
+	size_t *inicio;
+	int *col;
+	double *val;
+};
+
+int densidadPorNombre(const char *texto, double *densidad, int *perfil);
+const char *nombrePerfil(int perfil);
+
+void iniDispersaFilas(double *mA, double *mB, int D, int filaI, int filaF,
+                      double densidad, int perfil, uint64_t semilla);
+
+int comprimeCSR(const double *m, int filas, int cols, int ld, struct matrizCSR *a);
+void liberaCSR(struct matrizCSR *a);
+void particionNnz(const struct matrizCSR *a, int partes, int *cortes);
+
+void multiCSR(int kernel, const struct matrizCSR *a, const double *mB, int ldb,
+              double *mC, int ldc, int n, int filaI, int filaF);
+
+void informeRepartoNnz(const struct matrizCSR *a, int partes, const int *cortes, FILE *f);
+size_t cuentaNoCeros(const double *m, size_t elems);
+void informeDispersa(const struct opciones *op, size_t nnz, double tiempoUs, int reps, FILE *f);
+
+int ejecutaDispersa(const struct opciones *op, const struct motor *mt, int compartida, const char *programa);
+
+#endif
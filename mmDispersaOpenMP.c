@@ -0,0 +1,159 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * Descripción general:
+ * ---------------------------------------------------------------
+ * Multiplicación de una A dispersa en CSR por una B densa, paralelizada con
+ * OpenMP (`--density d[,perfil]`, ver mmDispersa.c).
+ *
+ * A se genera densa con ceros, como para los demás motores, y la primera
+ * multiplicación tras `iniciar()` la comprime a CSR fuera del tiempo de
+ * multiplicación (fase "compresion" de `--timing`); las siguientes (`-r`)
+ * reutilizan la CSR. Cada hilo calcula un trozo de filas contiguas de C con
+ * el kernel CSR de mmDispersa.c (variante de `-k`, o la detectada), y los
+ * trozos se cortan con el mismo número de no ceros (`particionNnz()`) en
+ * lugar del mismo número de filas: con filas muy desiguales (perfil
+ * "creciente") el reparto por filas de mmClasicaPosix.c deja a un hilo con
+ * casi el doble de trabajo que la media.
+ *
+ * Estructura del programa:
+ *  - `motorDispersa` (`iniciaDispersa()`, `multiplicaDispersa()`,
+ *    `terminaDispersa()`): interfaz de mmMotor.h, usada también por el
+ *    binario único `mm`.
+ *  - `main()`: `ejecutaDispersa()` de mmDispersa.c (se omite al compilar
+ *    con -DMM_BINARIO_UNICO). Sin `--density` A es densa y se multiplica
+ *    igual, en CSR.
+ *
+ * Solo admite matrices cuadradas de double: no se combina con `--shape`,
+ * `--pad`, `--type` ni `--batch`; `-a`, `-b` y `-s` no aplican.
+ *
+ * ---------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+#include "mmComun.h"
+#include "mmDispersa.h"
+#include "mmTiempo.h"
+#include "mmForma.h"
+#include "mmTipo.h"
+#include "mmMotor.h"
+
+/* A en CSR (vacía hasta la primera multiplicación) y cortes de filas de
+ * cada hilo */
+static struct matrizCSR csr;
+static int *cortes;
+static int comprimida;
+
+/* Marcas de tiempo del programa (ver mmTiempo.h) */
+static struct medicion *medida;
+
+/*-----------------------------------------------------------------------------
+ * iniciaDispersa — Prepara el motor dispersa (ver mmMotor.h).
+ *
+ * Descripción:
+ *  Configura el número de hilos y reserva los cortes del reparto. Retorna
+ *  -1 si el producto no es un solo cuadrado de double.
+ *---------------------------------------------------------------------------*/
+static int iniciaDispersa(const struct opciones *op, struct medicion *m) {
+	if (formaGeneral(op) || op->tipo != MM_TIPO_NINGUNO || op->lote > 0) {
+		fprintf(stderr, "El motor dispersa no admite --shape, --pad, --type ni --batch\n");
+		return -1;
+	}
+
+	medida = m;
+	omp_set_num_threads(op->P);
+	cortes = malloc(((size_t) op->P + 1) * sizeof(int));
+	if (cortes == NULL) {
+		perror("Error al reservar el reparto de filas");
+		return -1;
+	}
+	comprimida = 0;
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * comprime — Comprime A a CSR y calcula el reparto por no ceros.
+ *
+ * Descripción:
+ *  Se mide en la fase MM_FASE_COMPRESION; con `-v` muestra el reparto
+ *  frente al de filas iguales. Termina el programa si no hay memoria.
+ *---------------------------------------------------------------------------*/
+static void comprime(const struct opciones *op, const double *mA) {
+	inicioFase(medida, MM_FASE_COMPRESION);
+	if (comprimeCSR(mA, op->N, op->N, op->N, &csr) != 0) {
+		perror("Error al comprimir A a CSR");
+		exit(1);
+	}
+	particionNnz(&csr, op->P, cortes);
+	finFase(medida, MM_FASE_COMPRESION);
+	comprimida = 1;
+
+	if (op->informe)
+		informeRepartoNnz(&csr, op->P, cortes, stderr);
+}
+
+/*-----------------------------------------------------------------------------
+ * multiplicaDispersa — Una multiplicación C = A·B con el equipo de hilos.
+ *
+ * Descripción:
+ *  Comprime A la primera vez (fuera del tiempo devuelto) y, en una región
+ *  paralela, el hilo t calcula las filas [cortes[t], cortes[t + 1]) de C.
+ *  Retorna el tiempo de la multiplicación en µs.
+ *---------------------------------------------------------------------------*/
+static double multiplicaDispersa(const struct opciones *op, const double *mA, const double *mB, double *mC) {
+	int N = op->N;
+
+	if (!comprimida)
+		comprime(op, mA);
+
+	inicioFase(medida, MM_FASE_MULTIPLICACION);
+	#pragma omp parallel
+	{
+		int id = omp_get_thread_num();
+
+		/* Si el equipo tiene menos de P hilos, cada uno toma varios trozos */
+		inicioTrabajador(medida, id);
+		for (int t = id; t < op->P; t += omp_get_num_threads())
+			multiCSR(op->kernel, &csr, mB, N, mC, N, N, cortes[t], cortes[t + 1]);
+		finTrabajador(medida, id);
+	}
+	return finFase(medida, MM_FASE_MULTIPLICACION);
+}
+
+/*-----------------------------------------------------------------------------
+ * terminaDispersa — Libera la CSR y el reparto.
+ *---------------------------------------------------------------------------*/
+static void terminaDispersa(const struct opciones *op) {
+	liberaCSR(&csr);
+	free(cortes);
+	cortes = NULL;
+	comprimida = 0;
+	medida = NULL;
+}
+
+const struct motor motorDispersa = { "dispersa", iniciaDispersa, multiplicaDispersa, terminaDispersa, 0 };
+
+#ifndef MM_BINARIO_UNICO
+
+/*-----------------------------------------------------------------------------
+ * main — Función principal del programa.
+ *
+ * Descripción:
+ *  Valida los parámetros y las opciones (ver mmComun.c) y delega en
+ *  `ejecutaDispersa()`: reserva e inicializa A (con la densidad de
+ *  `--density`, o densa) y B, multiplica con el motor, muestra el tiempo
+ *  (µs) y, con `--verify`, comprueba C = A·B fuera del tiempo medido.
+ *---------------------------------------------------------------------------*/
+int main(int argc, char *argv[]) {
+	struct opciones op;
+	leerOpciones(argc, argv, "./mmDispersaOpenMP", &op);
+	if (op.archivos[0] != NULL) {
+		fprintf(stderr, "El motor dispersa genera A en memoria: no admite --files\n");
+		exit(1);
+	}
+	return ejecutaDispersa(&op, &motorDispersa, 0, "mmDispersaOpenMP");
+}
+
+#endif /* MM_BINARIO_UNICO */
@@ -0,0 +1,357 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * Descripción general:
+ * ---------------------------------------------------------------
+ * Producto fuera de memoria (`--files A,B,C --budget MiB`): A, B y C están
+ * en archivos proyectados (mmArchivo.c) que pueden ser mayores que la
+ * memoria, y el programa no usa más que el presupuesto en buffers.
+ *
+ * Recorrido: C se divide en franjas de h filas y la dimensión común en
+ * paneles de kb. Para la franja i,
+ *     C[i] = Σ_k A[i, k] · B[k, :]      (A[i, k] es h×kb, B[k, :] es kb×N)
+ * El motor multiplica cada par de paneles como un producto general h×kb·
+ * kb×N contiguo: el primero escribe la franja de C en memoria y los demás
+ * una suma parcial que se acumula en ella; al terminar la franja se copia
+ * a la proyección de C y se inicia su escritura al disco. Los paneles del
+ * borde se rellenan con ceros para que todos tengan la misma forma y el
+ * motor se prepare una sola vez. A se lee una vez y B una vez por franja,
+ * por eso el plan da a h todo el presupuesto que no necesitan los paneles.
+ *
+ * Solapamiento: un hilo de precarga copia el panel p+1 de los archivos a
+ * un segundo juego de buffers (doble buffer) mientras el motor multiplica
+ * el panel p. Antes de copiar un panel pide al núcleo el siguiente con
+ * MADV_WILLNEED (lectura anticipada asíncrona, sin bloquear como
+ * readahead(2)) y después descarta el ya copiado con MADV_DONTNEED, de
+ * modo que las proyecciones no acumulan memoria residente; la cache de
+ * páginas del núcleo es memoria recuperable y no cuenta en el
+ * presupuesto. El motor solo espera si la copia de un panel tarda más que
+ * su producto, y esa espera se mide aparte (`-v`).
+ *
+ * ---------------------------------------------------------------
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include "mmExterno.h"
+#include "mmArchivo.h"
+#include "mmTiempo.h"
+#include "mmMemoria.h"
+#include "mmMotor.h"
+
+/*-----------------------------------------------------------------------------
+ * Estado compartido entre el motor y el hilo de precarga:
+ *  - pl: plan del recorrido.
+ *  - mA, mB: archivos de entrada.
+ *  - cerrojo, cambio: protegen y avisan los cambios de `lleno`.
+ *  - lleno: 1 si el juego de buffers s tiene su panel listo para el motor.
+ *  - copia, leidos: µs copiando y bytes leídos (solo los escribe el hilo de
+ *                   precarga; se leen después de `pthread_join()`).
+ *---------------------------------------------------------------------------*/
+struct tuberia {
+	const struct planExterno *pl;
+	const struct matrizArchivo *mA, *mB;
+	pthread_mutex_t cerrojo;
+	pthread_cond_t cambio;
+	int lleno[2];
+	double copia;
+	double leidos;
+};
+
+/*-----------------------------------------------------------------------------
+ * planificaExterno — Elige franjas y paneles para el presupuesto.
+ *
+ * Parámetros:
+ *  - pl: plan a llenar.
+ *  - f: forma del producto.
+ *  - presupuestoMiB: memoria para los buffers (`--budget`).
+ *  - fl: destino del mensaje si el presupuesto no alcanza.
+ *
+ * Descripción:
+ *  Los buffers son 2·(h·kb + kb·N) elementos de paneles más h·N de la
+ *  franja de C y otros h·N de la suma parcial si hay más de un panel. B se
+ *  lee una vez por franja, así que conviene una h grande más que un kb
+ *  grande: kb es el mayor que deja los paneles de B en un cuarto del
+ *  presupuesto (entre MM_EXTERNO_MIN_PROF y MM_EXTERNO_PROF, o K si es
+ *  menor) y h es lo que quede; si no alcanza para MM_FORMA_MIN_FILAS filas,
+ *  kb se reduce a la mitad hasta el mínimo. Luego h y kb se igualan entre las
+ *  franjas y los paneles para que el relleno del borde sea mínimo. No
+ *  cuenta la memoria propia del motor (Bᵀ en `filas`, sumas parciales del
+ *  reparto por K). Retorna 0, o -1 si el presupuesto no alcanza.
+ *---------------------------------------------------------------------------*/
+int planificaExterno(struct planExterno *pl, const struct forma *f, int presupuestoMiB, FILE *fl) {
+	size_t W = (size_t) presupuestoMiB * 1048576 / sizeof(double);
+	size_t M = (size_t) f->M, N = (size_t) f->N, K = (size_t) f->K;
+	size_t minimo = (M < MM_FORMA_MIN_FILAS) ? M : MM_FORMA_MIN_FILAS;
+	size_t kb = W / 4 / (2 * N), h;
+
+	if (kb > MM_EXTERNO_PROF)
+		kb = MM_EXTERNO_PROF;
+	if (kb < MM_EXTERNO_MIN_PROF)
+		kb = MM_EXTERNO_MIN_PROF;
+	if (kb > K)
+		kb = K;
+
+	for (;;) {
+		size_t fijo = 2 * kb * N;
+		size_t porFila = 2 * kb + ((kb < K) ? 2 : 1) * N;
+
+		h = (W > fijo) ? (W - fijo) / porFila : 0;
+		if (h >= minimo)
+			break;
+		if (kb <= MM_EXTERNO_MIN_PROF) {
+			fprintf(fl, "--budget %d MiB no alcanza para %zu filas de A y %zu de B por panel "
+			        "(hacen falta %.0f MiB)\n", presupuestoMiB, minimo, kb,
+			        (fijo + minimo * porFila) * sizeof(double) / 1048576.0 + 1.0);
+			return -1;
+		}
+		kb = (kb / 2 > MM_EXTERNO_MIN_PROF) ? kb / 2 : MM_EXTERNO_MIN_PROF;
+	}
+	if (h > M)
+		h = M;
+
+	memset(pl, 0, sizeof(*pl));
+	pl->f = *f;
+	pl->franjas = (int) ((M + h - 1) / h);
+	pl->paneles = (int) ((K + kb - 1) / kb);
+	pl->h = (int) ((M + pl->franjas - 1) / pl->franjas);
+	pl->kb = (int) ((K + pl->paneles - 1) / pl->paneles);
+	pl->eA = elemsAlineados((size_t) pl->h * pl->kb);
+	pl->eB = elemsAlineados((size_t) pl->kb * N);
+	pl->eC = elemsAlineados((size_t) pl->h * N);
+	pl->elems = 2 * pl->eA + 2 * pl->eB + ((pl->paneles > 1) ? 2 : 1) * pl->eC;
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * iniExterno — Reserva los buffers del plan (precargados, fuera de la
+ * medición). Retorna 0, o -1 si no hay memoria.
+ *---------------------------------------------------------------------------*/
+int iniExterno(struct planExterno *pl, int compartida, int paginas) {
+	pl->paginas = paginas;
+	pl->buffers = reservaMatriz(pl->elems, paginas, compartida, 1);
+	return (pl->buffers == NULL) ? -1 : 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * finExterno — Libera los buffers del plan.
+ *---------------------------------------------------------------------------*/
+void finExterno(struct planExterno *pl) {
+	if (pl->buffers != NULL)
+		liberaMatriz(pl->buffers, pl->elems, pl->paginas);
+	pl->buffers = NULL;
+}
+
+/*-----------------------------------------------------------------------------
+ * opcionesPanel — Opciones con las que el motor multiplica un panel.
+ *
+ * Descripción:
+ *  Producto general h×kb · kb×N sin relleno; si el panel es cuadrado se
+ *  deja como producto cuadrado (M = K = 0), que es la ruta original de
+ *  cada motor.
+ *---------------------------------------------------------------------------*/
+void opcionesPanel(const struct opciones *op, const struct planExterno *pl, struct opciones *sub) {
+	*sub = *op;
+	sub->N = pl->f.N;
+	sub->M = pl->h;
+	sub->K = pl->kb;
+	sub->relleno = 0;
+	sub->repeticiones = 0;
+	sub->verifica = 0;
+	sub->presupuesto = 0;
+	if (pl->h == pl->f.N && pl->kb == pl->f.N)
+		sub->M = sub->K = 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * panelDe — Posición del panel p: franja i (filas [i0, i0+filas) de A y C)
+ * y profundidad k (filas [k0, k0+prof) de B).
+ *---------------------------------------------------------------------------*/
+static void panelDe(const struct planExterno *pl, int p, int *i0, int *filas, int *k0, int *prof) {
+	int i = p / pl->paneles, k = p % pl->paneles;
+
+	*i0 = i * pl->h;
+	*filas = (*i0 + pl->h <= pl->f.M) ? pl->h : pl->f.M - *i0;
+	*k0 = k * pl->kb;
+	*prof = (*k0 + pl->kb <= pl->f.K) ? pl->kb : pl->f.K - *k0;
+}
+
+/*-----------------------------------------------------------------------------
+ * aconsejaPanel — `madvise()` sobre las páginas de A y B del panel p.
+ *---------------------------------------------------------------------------*/
+static void aconsejaPanel(const struct tuberia *tb, int p, int consejo) {
+	int i0, filas, k0, prof;
+
+	panelDe(tb->pl, p, &i0, &filas, &k0, &prof);
+	aconsejaFilas(tb->mA, (size_t) i0, (size_t) (i0 + filas), (size_t) k0, (size_t) (k0 + prof), consejo);
+	aconsejaFilas(tb->mB, (size_t) k0, (size_t) (k0 + prof), 0, (size_t) tb->pl->f.N, consejo);
+}
+
+/*-----------------------------------------------------------------------------
+ * copiaPanel — Copia A[i, k] y B[k, :] del panel p al juego de buffers s,
+ * con ceros en las filas y columnas que caen fuera de las matrices.
+ *---------------------------------------------------------------------------*/
+static void copiaPanel(struct tuberia *tb, int p, int s) {
+	const struct planExterno *pl = tb->pl;
+	double *pa = pl->buffers + s * pl->eA;
+	double *pb = pl->buffers + 2 * pl->eA + s * pl->eB;
+	int i0, filas, k0, prof, kb = pl->kb, N = pl->f.N;
+
+	panelDe(pl, p, &i0, &filas, &k0, &prof);
+
+	for (int i = 0; i < pl->h; i++) {
+		double *fila = pa + (size_t) i * kb;
+
+		if (i < filas)
+			memcpy(fila, tb->mA->datos + (size_t) (i0 + i) * tb->mA->ld + k0, prof * sizeof(double));
+		memset(fila + ((i < filas) ? prof : 0), 0, (kb - ((i < filas) ? prof : 0)) * sizeof(double));
+	}
+	for (int k = 0; k < prof; k++)
+		memcpy(pb + (size_t) k * N, tb->mB->datos + (size_t) (k0 + k) * tb->mB->ld, N * sizeof(double));
+	if (prof < kb)
+		memset(pb + (size_t) prof * N, 0, (size_t) (kb - prof) * N * sizeof(double));
+
+	tb->leidos += ((double) filas * prof + (double) prof * N) * sizeof(double);
+}
+
+/*-----------------------------------------------------------------------------
+ * precargaPaneles — Hilo de precarga: copia los paneles en orden, cada uno
+ * en el juego de buffers que el motor haya liberado.
+ *---------------------------------------------------------------------------*/
+static void *precargaPaneles(void *arg) {
+	struct tuberia *tb = (struct tuberia *) arg;
+	int total = tb->pl->franjas * tb->pl->paneles;
+
+	for (int p = 0; p < total; p++) {
+		int s = p % 2;
+
+		pthread_mutex_lock(&tb->cerrojo);
+		while (tb->lleno[s])
+			pthread_cond_wait(&tb->cambio, &tb->cerrojo);
+		pthread_mutex_unlock(&tb->cerrojo);
+
+		double t0 = ahoraUs();
+		if (p + 1 < total)
+			aconsejaPanel(tb, p + 1, MADV_WILLNEED);
+		copiaPanel(tb, p, s);
+		aconsejaPanel(tb, p, MADV_DONTNEED);
+		tb->copia += ahoraUs() - t0;
+
+		pthread_mutex_lock(&tb->cerrojo);
+		tb->lleno[s] = 1;
+		pthread_cond_broadcast(&tb->cambio);
+		pthread_mutex_unlock(&tb->cerrojo);
+	}
+	return NULL;
+}
+
+/*-----------------------------------------------------------------------------
+ * escribeFranja — Copia las `filas` filas de la franja a C desde la fila
+ * i0, inicia su escritura al disco y las descarta de la proyección.
+ *---------------------------------------------------------------------------*/
+static void escribeFranja(const struct planExterno *pl, struct matrizArchivo *mC, const double *franja,
+                          int i0, int filas) {
+	size_t N = (size_t) pl->f.N, ld = (size_t) mC->ld;
+
+	for (int i = 0; i < filas; i++)
+		memcpy(mC->datos + (i0 + i) * ld, franja + i * N, N * sizeof(double));
+	sync_file_range(mC->fd, (off_t) ((char *) (mC->datos + i0 * ld) - mC->base),
+	                (off_t) (filas * ld * sizeof(double)), SYNC_FILE_RANGE_WRITE);
+	aconsejaFilas(mC, (size_t) i0, (size_t) (i0 + filas), 0, N, MADV_DONTNEED);
+}
+
+/*-----------------------------------------------------------------------------
+ * multiplicaExterno — Calcula C = A·B recorriendo los archivos por paneles.
+ *
+ * Parámetros:
+ *  - sub: opciones de un panel (`opcionesPanel()`), con las que se preparó
+ *         el motor.
+ *  - mt: motor que multiplica cada panel.
+ *  - pl: plan con los buffers ya reservados.
+ *  - mA, mB, mC: archivos de A, B y C.
+ *  - e: estadísticas, que se acumulan.
+ *
+ * Descripción:
+ *  Lanza el hilo de precarga y multiplica los paneles en el orden en que
+ *  este los deja listos. Retorna el tiempo total en µs, que incluye leer A
+ *  y B y escribir C en la proyección (no esperar a que C llegue al disco).
+ *---------------------------------------------------------------------------*/
+double multiplicaExterno(const struct opciones *sub, const struct motor *mt, const struct planExterno *pl,
+                         const struct matrizArchivo *mA, const struct matrizArchivo *mB,
+                         struct matrizArchivo *mC, struct estadExterno *e) {
+	struct tuberia tb = { pl, mA, mB, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, {0, 0}, 0.0, 0.0 };
+	double *franja = pl->buffers + 2 * pl->eA + 2 * pl->eB;
+	double *parcial = franja + pl->eC;
+	size_t N = (size_t) pl->f.N;
+	int total = pl->franjas * pl->paneles;
+	pthread_t hilo;
+
+	double t0 = ahoraUs();
+	if (pthread_create(&hilo, NULL, precargaPaneles, &tb) != 0) {
+		perror("Error al crear el hilo de precarga");
+		exit(1);
+	}
+
+	for (int p = 0; p < total; p++) {
+		int s = p % 2, k = p % pl->paneles;
+		int i0, filas, k0, prof;
+
+		panelDe(pl, p, &i0, &filas, &k0, &prof);
+
+		double te = ahoraUs();
+		pthread_mutex_lock(&tb.cerrojo);
+		while (!tb.lleno[s])
+			pthread_cond_wait(&tb.cambio, &tb.cerrojo);
+		pthread_mutex_unlock(&tb.cerrojo);
+		e->espera += ahoraUs() - te;
+
+		e->calculo += mt->multiplicar(sub, pl->buffers + s * pl->eA, pl->buffers + 2 * pl->eA + s * pl->eB,
+		                              (k == 0) ? franja : parcial);
+
+		pthread_mutex_lock(&tb.cerrojo);
+		tb.lleno[s] = 0;
+		pthread_cond_broadcast(&tb.cambio);
+		pthread_mutex_unlock(&tb.cerrojo);
+
+		if (k > 0)
+			for (size_t x = 0; x < (size_t) filas * N; x++)
+				franja[x] += parcial[x];
+		if (k == pl->paneles - 1) {
+			escribeFranja(pl, mC, franja, i0, filas);
+			e->escritos += (double) filas * N * sizeof(double);
+		}
+	}
+
+	pthread_join(hilo, NULL);
+	double t = ahoraUs() - t0;
+
+	e->copia += tb.copia;
+	e->leidos += tb.leidos;
+	return t;
+}
+
+/*-----------------------------------------------------------------------------
+ * informeExterno — Muestra el plan, el tráfico con los archivos y cuánto
+ * de la copia quedó oculto detrás del cálculo (por multiplicación).
+ *---------------------------------------------------------------------------*/
+void informeExterno(const struct planExterno *pl, const struct estadExterno *e, int presupuestoMiB,
+                    double tiempoUs, int reps, FILE *f) {
+	double flops = flopsForma(&pl->f) * reps;
+	double oculta = (e->copia > 0.0) ? 100.0 * (e->copia - e->espera) / e->copia : 100.0;
+
+	fprintf(f, "# fuera de memoria: presupuesto %d MiB, buffers %.1f MiB; %d franjas de %d filas × %d paneles "
+	        "de profundidad %d\n", presupuestoMiB, pl->elems * sizeof(double) / 1048576.0,
+	        pl->franjas, pl->h, pl->paneles, pl->kb);
+	fprintf(f, "# archivos: %.1f MiB leídos y %.1f MiB escritos por multiplicación (B se lee %d veces); "
+	        "%.2f GB/s\n", e->leidos / reps / 1048576.0, e->escritos / reps / 1048576.0, pl->franjas,
+	        tiempoUs > 0.0 ? (e->leidos + e->escritos) / (tiempoUs * 1e3) : 0.0);
+	fprintf(f, "# motor %.0f µs (%.2f GFLOP/s), copia de paneles %.0f µs, espera del motor %.0f µs "
+	        "(%.0f%% de la copia oculta)\n", e->calculo / reps,
+	        e->calculo > 0.0 ? flops / (e->calculo * 1e3) : 0.0, e->copia / reps, e->espera / reps,
+	        oculta < 0.0 ? 0.0 : oculta);
+}
@@ -0,0 +1,80 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * mmExterno.h — Producto fuera de memoria sobre matrices en archivo
+ * (`--files A,B,C --budget MiB`).
+ *
+ * C se calcula por franjas de filas y cada franja como suma de productos
+ * de paneles A[franja, k0:k1] · B[k0:k1, :], que un hilo de precarga copia
+ * de los archivos a buffers dobles mientras el motor multiplica el panel
+ * anterior. Los buffers caben en el presupuesto de memoria pedido, sin
+ * importar el tamaño de los archivos.
+ */
+
+#ifndef MM_EXTERNO_H
+#define MM_EXTERNO_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "mmComun.h"
+#include "mmForma.h"
+
+struct motor;
+struct matrizArchivo;
+
+/* Profundidad máxima y mínima de los paneles (filas de B por panel); con
+ * presupuestos pequeños se reduce a la mitad hasta el mínimo */
+#define MM_EXTERNO_PROF      1024
+#define MM_EXTERNO_MIN_PROF  64
+
+/*-----------------------------------------------------------------------------
+ * Plan del producto fuera de memoria:
+ *  - f: forma del producto completo (la de los archivos).
+ *  - h: filas de A y de C por franja.
+ *  - kb: profundidad de los paneles (columnas de A y filas de B).
+ *  - franjas, paneles: número de franjas de C y de paneles por franja.
+ *  - eA, eB, eC: elementos (alineados) de cada buffer de panel de A, de B
+ *                y de la franja de C.
+ *  - buffers: región con los dos buffers de A, los dos de B, la franja de
+ *             C y, si hay más de un panel, la suma parcial; NULL hasta
+ *             `iniExterno()`.
+ *  - elems: elementos de `buffers`.
+ *  - paginas: páginas de la reserva (MM_PAGINAS_*).
+ *---------------------------------------------------------------------------*/
+struct planExterno {
+	struct forma f;
+	int h, kb;
+	int franjas, paneles;
+	size_t eA, eB, eC;
+	double *buffers;
+	size_t elems;
+	int paginas;
+};
+
+/*-----------------------------------------------------------------------------
+ * Estadísticas acumuladas de las multiplicaciones (µs y bytes):
+ *  - calculo: tiempo dentro del motor.
+ *  - espera: tiempo que el motor esperó a que su panel estuviera copiado.
+ *  - copia: tiempo del hilo de precarga leyendo y copiando paneles.
+ *  - leidos, escritos: bytes leídos de A y B y escritos en C.
+ *---------------------------------------------------------------------------*/
+struct estadExterno {
+	double calculo;
+	double espera;
+	double copia;
+	double leidos;
+	double escritos;
+};
+
+int planificaExterno(struct planExterno *pl, const struct forma *f, int presupuestoMiB, FILE *fl);
+int iniExterno(struct planExterno *pl, int compartida, int paginas);
+void finExterno(struct planExterno *pl);
+void opcionesPanel(const struct opciones *op, const struct planExterno *pl, struct opciones *sub);
+
+double multiplicaExterno(const struct opciones *sub, const struct motor *mt, const struct planExterno *pl,
+                         const struct matrizArchivo *mA, const struct matrizArchivo *mB,
+                         struct matrizArchivo *mC, struct estadExterno *e);
+void informeExterno(const struct planExterno *pl, const struct estadExterno *e, int presupuestoMiB,
+                    double tiempoUs, int reps, FILE *f);
+
+#endif
@@ -10,19 +10,38 @@
  * optimizado mediante el uso de la **matriz transpuesta** y paralelismo
  * con **OpenMP** (modelo de hilos compartidos).
  *
- * En esta versión, la segunda matriz (`mB`) se trata como transpuesta
- * para mejorar la **localidad de memoria** y la **eficiencia en cache**.
+ * En esta versión, la segunda matriz se usa transpuesta para mejorar la
+ * **localidad de memoria** y la **eficiencia en cache**. B se genera por
+ * filas, como en las demás versiones, y una etapa previa de transposición
+ * paralela por bloques (`transMatrix()`) construye `Bᵀ`; así el producto es
+ * correcto para cualquier B y no solo para datos aleatorios.
  * 
  * Cada hilo ejecuta un subconjunto de filas de `mA`, mientras que accede
- * secuencialmente a las filas de `mB` (equivalentes a columnas originales),
+ * secuencialmente a las filas de `Bᵀ` (equivalentes a columnas originales),
  * reduciendo así los saltos en memoria y acelerando el cálculo.
  *
+ * Salida: dos columnas, el tiempo de la multiplicación y el de la
+ * transposición (µs), medidos por separado para ver a partir de qué N la
+ * transposición compensa su costo.
+ *
  * Estructura del programa:
- *  - `iniMatrix()`: Inicializa matrices A y B con valores aleatorios.
+ *  - `iniMatrix()`: Inicializa A y B en paralelo (mmAleatorio.c, `--seed`).
  *  - `impMatrix()`: Imprime matrices en diferentes modos (normal o transpuesta).
+ *  - `transMatrix()`: Construye la transpuesta de B en paralelo.
  *  - `multiMatrixTrans()`: Realiza la multiplicación paralela optimizada.
- *  - `InicioMuestra()` / `FinMuestra()`: Miden el tiempo total de ejecución.
- *  - `main()`: Controla la ejecución, configurando OpenMP y midiendo el rendimiento.
+ *  - `multiMatrixTransPorBloques()`: Variante con los kernels comunes (`-b`, `-k`).
+ *  - `multiMatrixTransTuberia()`: Micro-kernel con el empaquetado de Bᵀ en
+ *    tubería y buffers dobles por hilo (`--pipeline`, mmMicro.c).
+ *  - `multiMatrixTransForma()`: Producto general M×K · K×N (`--shape`, mmForma.c).
+ *  - `multiMatrixLote()`: Lote de productos pequeños (`--batch`, mmLote.c),
+ *    sin transponer: cada B del lote es pequeña y se lee desde la cache.
+ *  - `colocaMatrices()` / `replicaMatriz()`: Afinidad y ubicación NUMA (`-a`).
+ *  - Tiempos por fase y por hilo con mmTiempo.c (`--timing csv|json`).
+ *  - `motorFilas` (`iniciaFilas()`, `multiplicaFilas()`, `terminaFilas()`):
+ *    configura los hilos, transpone B y multiplica; es la interfaz que usa
+ *    también el binario único `mm` (ver mmMotor.h).
+ *  - `main()`: Reserva e inicializa las matrices, ejecuta el motor y muestra
+ *    ambos tiempos (se omite al compilar con -DMM_BINARIO_UNICO).
  *
  * ---------------------------------------------------------------
  */
@@ -30,37 +49,362 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
-#include <sys/time.h>
 #include <omp.h>
+#include "mmComun.h"
+#include "mmBloques.h"
+#include "mmMicro.h"
+#include "mmAfinidad.h"
+#include "mmAleatorio.h"
+#include "mmVerifica.h"
+#include "mmTiempo.h"
+#include "mmMemoria.h"
+#include "mmForma.h"
+#include "mmTipo.h"
+#include "mmLote.h"
+#include "mmDispersa.h"
+#include "mmArchivo.h"
+#include "mmMotor.h"
+
+/* Plan de afinidad y réplicas de Bᵀ para `-a` (ver mmAfinidad.h) */
+static struct afinidad colocacion;
+static int replicada;   /* 1 → las réplicas de Bᵀ ya están creadas */
+
+/* Tiempos por fase y por hilo de la ejecución en curso (ver mmTiempo.h); los
+ * entrega `iniciaFilas()` */
+static struct medicion *medida;
 
-struct timeval inicio, fin;
+/* Transpuesta de B y su número de elementos, reservada por `iniciaFilas()` */
+static double *matrixBt;
+static size_t elemsBt;
+
+/* Reparto del producto general (`--shape`, ver mmForma.h) */
+static struct particion plan;
 
 /*-----------------------------------------------------------------------------
- * InicioMuestra — Inicia el cronómetro de medición de rendimiento.
+ * transMatrix — Construye en paralelo la transpuesta de B.
+ *
+ * Parámetros:
+ *  - mB: matriz B de `filas` × `cols` (por filas), con salto `ldb`.
+ *  - mBt: destino de Bᵀ (`cols` × `filas`), con salto `ldbt`.
  *
  * Descripción:
- *  Registra la marca de tiempo inicial utilizando `gettimeofday()`.
+ *  Cada hilo transpone franjas de MM_BLOQUE_TRANS filas de B con
+ *  `transFormaBloques()` (mmBloques.c), que recorre bloques que caben en L1.
+ *  En el caso cuadrado filas = cols = ldb = ldbt = N.
  *---------------------------------------------------------------------------*/
-void InicioMuestra() {
-	gettimeofday(&inicio, (void *)0);
+static void transMatrix(const double *mB, int ldb, double *mBt, int ldbt, int filas, int cols) {
+	#pragma omp parallel for schedule(static)
+	for (int ii = 0; ii < filas; ii += MM_BLOQUE_TRANS) {
+		int iF = (ii + MM_BLOQUE_TRANS < filas) ? ii + MM_BLOQUE_TRANS : filas;
+		transFormaBloques(mB, ldb, mBt, ldbt, cols, ii, iF, MM_BLOQUE_TRANS);
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * transMatrixTipo — Como `transMatrix()` para matrices D×D de otro tipo de
+ * elemento (`--type`, ver `transTipo()` en mmTipo.c).
+ *---------------------------------------------------------------------------*/
+static void transMatrixTipo(int tipo, const double *mB, double *mBt, int D) {
+	#pragma omp parallel for schedule(static)
+	for (int ii = 0; ii < D; ii += MM_BLOQUE_TRANS) {
+		int iF = (ii + MM_BLOQUE_TRANS < D) ? ii + MM_BLOQUE_TRANS : D;
+		transTipo(tipo, mB, mBt, D, ii, iF);
+	}
 }
 
 /*-----------------------------------------------------------------------------
- * FinMuestra — Finaliza la medición y muestra el tiempo total.
+ * multiMatrixTrans — Multiplicación optimizada usando la matriz transpuesta.
+ *
+ * Parámetros:
+ *  - mA: puntero a la matriz A.
+ *  - mB: puntero a la transpuesta de B (construida por `transMatrix()`).
+ *  - mC: puntero a la matriz resultado C.
+ *  - D:  dimensión de las matrices.
  *
  * Descripción:
- *  Calcula el tiempo transcurrido en microsegundos entre `InicioMuestra()` y
- *  el momento actual, luego imprime el resultado en pantalla.
+ *  Cada hilo OpenMP calcula un subconjunto de filas de `mC`. 
+ *  La diferencia frente a la versión clásica es que `mB` se recorre por filas
+ *  (en lugar de columnas), mejorando la localidad espacial en la memoria.
+ *
+ * Directivas OpenMP:
+ *  - `#pragma omp parallel` crea el grupo de hilos.
+ *  - `#pragma omp for` divide el bucle principal de filas `i` entre los hilos.
+ *  - `Suma`, `pA` y `pB` son locales al bucle y por tanto privadas de cada
+ *    hilo (declaradas fuera de la región paralela eran compartidas).
  *---------------------------------------------------------------------------*/
-void FinMuestra() {
-	gettimeofday(&fin, (void *)0);
-	fin.tv_usec -= inicio.tv_usec;
-	fin.tv_sec  -= inicio.tv_sec;
-	double tiempo = (double)(fin.tv_sec * 1000000 + fin.tv_usec); 
-	printf("%9.0f \n", tiempo);
+static void multiMatrixTrans(const double *mA, const double *mB, double *mC, int D) {
+	#pragma omp parallel
+	{
+		const double *mBl = matrizLocal(&colocacion, mB);
+
+		inicioTrabajador(medida, omp_get_thread_num());
+		#pragma omp for nowait
+		for (int i = 0; i < D; i++) {
+			for (int j = 0; j < D; j++) {
+				const double *pA = mA + (size_t) i * D;
+				const double *pB = mBl + (size_t) j * D;
+				double Suma = 0.0;
+
+				for (int k = 0; k < D; k++, pA++, pB++) {
+					Suma += *pA * *pB;
+				}
+				mC[(size_t) i * D + j] = Suma;
+			}
+		}
+		finTrabajador(medida, omp_get_thread_num());
+	}
 }
 
+/*-----------------------------------------------------------------------------
+ * multiMatrixTransPorBloques — Versión de `multiMatrixTrans()` con los kernels comunes.
+ *
+ * Parámetros:
+ *  - op: opciones del programa (`-b` kernel por bloques, `-k` micro-kernel).
+ *  - mA, mB, mC, D: igual que en `multiMatrixTrans()`.
+ *
+ * Descripción:
+ *  Reparte entre los hilos franjas de filas de C del tamaño del bloque del
+ *  kernel elegido; cada franja se calcula con `multiTeselaComunEn()` de
+ *  mmComun.c, con los buffers de empaquetado que cada hilo reserva una vez.
+ *---------------------------------------------------------------------------*/
+static void multiMatrixTransPorBloques(const struct opciones *op, const double *mA, const double *mB,
+                                       double *mC, int D) {
+	int tam = franjaFilas(op);
+
+	#pragma omp parallel
+	{
+		const double *mBl = matrizLocal(&colocacion, mB);
+		size_t elems = elemsTrabajoComun(op, D);
+		double *trabajo = (elems > 0) ? aligned_alloc(64, sizeof(double) * elems) : NULL;
+
+		if (elems > 0 && trabajo == NULL) {
+			perror("Error al reservar los buffers de empaquetado");
+			exit(1);
+		}
+
+		inicioTrabajador(medida, omp_get_thread_num());
+		#pragma omp for schedule(static) nowait
+		for (int ii = 0; ii < D; ii += tam) {
+			int iF = (ii + tam < D) ? ii + tam : D;
+			multiTeselaComunEn(op, mA, mBl, 1, mC, D, ii, iF, 0, D, trabajo);
+		}
+		finTrabajador(medida, omp_get_thread_num());
+		free(trabajo);
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * multiMatrixTransTuberia — `multiMatrixTransPorBloques()` con el
+ * micro-kernel en tubería (`--pipeline`).
+ *
+ * Descripción:
+ *  Mismas franjas y mismo reparto estático; cada hilo reserva al entrar en
+ *  la región paralela su bloque de A y sus dos paneles de Bᵀ
+ *  (`elemsTuberia()` de D columnas) y los reutiliza en todas sus franjas,
+ *  empaquetando el panel siguiente mientras multiplica el actual.
+ *---------------------------------------------------------------------------*/
+static void multiMatrixTransTuberia(const struct opciones *op, const double *mA, const double *mB,
+                                    double *mC, int D) {
+	int tam = franjaFilas(op);
+
+	#pragma omp parallel
+	{
+		const double *mBl = matrizLocal(&colocacion, mB);
+		double *trabajo = aligned_alloc(64, sizeof(double) * elemsTuberia(D));
+
+		if (trabajo == NULL) {
+			perror("Error al reservar los buffers de la tubería");
+			exit(1);
+		}
+
+		inicioTrabajador(medida, omp_get_thread_num());
+		#pragma omp for schedule(static) nowait
+		for (int ii = 0; ii < D; ii += tam) {
+			int iF = (ii + tam < D) ? ii + tam : D;
+			multiFormaTuberiaEn(mA, D, mBl, D, 1, mC, D, D, ii, iF, 0, D, op->kernel, trabajo);
+		}
+		finTrabajador(medida, omp_get_thread_num());
+		free(trabajo);
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * multiMatrixTransForma — Producto general C (M×N) = A (M×K) · B (K×N) con
+ * Bᵀ (N×K, salto K).
+ *
+ * Descripción:
+ *  Como `multiMatrixForma()` de la versión clásica: el hilo t calcula el
+ *  trozo t de `plan` (ver mmForma.c) y, si el plan divide K, los hilos suman
+ *  después las parciales a C.
+ *---------------------------------------------------------------------------*/
+static void multiMatrixTransForma(const struct opciones *op, const double *mA, const double *mBt, double *mC) {
+	#pragma omp parallel
+	{
+		const double *mBl = matrizLocal(&colocacion, mBt);
+
+		inicioTrabajador(medida, omp_get_thread_num());
+		#pragma omp for schedule(static)
+		for (int t = 0; t < plan.trozos; t++)
+			calculaTrozo(op, &plan, mA, mBl, plan.f.K, 1, mC, t);
+		#pragma omp for schedule(static) nowait
+		for (int r = 0; r < plan.franjas; r++)
+			reduceFranja(&plan, mC, r);
+		finTrabajador(medida, omp_get_thread_num());
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * multiMatrixLote — Lote de productos pequeños e independientes.
+ *
+ * Descripción:
+ *  Como en mmClasicaOpenMP.c, pero con el reparto estático de filas de
+ *  este programa aplicado a los productos: bloques contiguos de productos
+ *  por hilo. No hay transposición; el kernel directo de mmLote.c recorre
+ *  B por filas.
+ *---------------------------------------------------------------------------*/
+static void multiMatrixLote(const struct opciones *op, const double *mA, const double *mB, double *mC) {
+	size_t paso = (size_t) op->N * op->N;
+
+	#pragma omp parallel
+	{
+		struct trabajoLote t;
+
+		inicioTrabajador(medida, omp_get_thread_num());
+		iniTrabajoLote(&t, op);
+		#pragma omp for schedule(static) nowait
+		for (int b = 0; b < op->lote; b++)
+			multiLote(&t, mA, mB, mC, paso, b, b + 1);
+		finTrabajoLote(&t);
+		finTrabajador(medida, omp_get_thread_num());
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * replicaMatriz — Crea una réplica de Bᵀ en cada nodo NUMA (`-a <pol>,replica`).
+ *
+ * Descripción:
+ *  El primer hilo de cada nodo copia los `elems` elementos de la matriz a la
+ *  réplica de su nodo; los kernels obtienen luego la copia local con
+ *  `matrizLocal()`.
+ *---------------------------------------------------------------------------*/
+static void replicaMatriz(const double *m, size_t elems) {
+	if (reservaReplicas(&colocacion, m, elems) != 0) {
+		perror("Error al reservar las réplicas");
+		exit(1);
+	}
+
+	#pragma omp parallel
+	copiaReplica(&colocacion, omp_get_thread_num());
+}
+
+/*-----------------------------------------------------------------------------
+ * iniciaFilas — Prepara el motor OpenMP por filas (ver mmMotor.h).
+ *
+ * Descripción:
+ *  Reserva Bᵀ (con las páginas de `--pages`; N×K sin relleno con
+ *  `--shape`; ninguna con `--batch`), configura el número de hilos y, con `-a`, arma el plan de
+ *  afinidad y fija cada hilo del equipo a su CPU. Con `--shape` planifica
+ *  además el reparto de la forma. Retorna -1 si alguna reserva falla.
+ *---------------------------------------------------------------------------*/
+static int iniciaFilas(const struct opciones *op, struct medicion *m) {
+	medida = m;
+	replicada = 0;
+	elemsBt = (size_t) op->N * op->N;
+
+	if (formaGeneral(op)) {
+		struct forma f;
+
+		formaDe(op, &f);
+		elemsBt = (size_t) f.N * f.K;
+		if (iniParticion(&plan, &f, op->P, 0, op->paginas) != 0)
+			return -1;
+	}
+
+	if (op->lote == 0) {
+		matrixBt = reservaMatriz(elemsBt, op->paginas, 0, op->precarga);
+		if (matrixBt == NULL)
+			return -1;
+	}
+
+	omp_set_num_threads(op->P);
+
+	if (op->afinidad != MM_AFIN_NINGUNA) {
+		if (iniAfinidad(&colocacion, op->afinidad, op->P) != 0)
+			return -1;
+
+		#pragma omp parallel
+		fijaHiloActual(&colocacion, omp_get_thread_num());
+	}
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * multiplicaFilas — Transpone B y calcula C = A·B con el equipo de hilos.
+ *
+ * Descripción:
+ *  La transposición se mide como fase aparte (MM_FASE_TRANSPOSICION) y se
+ *  repite en cada llamada, porque B puede cambiar entre llamadas. En la
+ *  primera con `-a <pol>,replica` se replica Bᵀ (fuera de ambos tiempos).
+ *  Con `--batch` no hay transposición. Retorna solo el tiempo de la
+ *  multiplicación, en µs.
+ *---------------------------------------------------------------------------*/
+static double multiplicaFilas(const struct opciones *op, const double *mA, const double *mB, double *mC) {
+	int general = formaGeneral(op);
+
+	if (op->lote > 0) {
+		inicioFase(medida, MM_FASE_MULTIPLICACION);
+		multiMatrixLote(op, mA, mB, mC);
+		return finFase(medida, MM_FASE_MULTIPLICACION);
+	}
+
+	inicioFase(medida, MM_FASE_TRANSPOSICION);
+	if (general)
+		transMatrix(mB, plan.f.ldb, matrixBt, plan.f.K, plan.f.K, plan.f.N);
+	else if (op->tipo != MM_TIPO_NINGUNO)
+		transMatrixTipo(op->tipo, mB, matrixBt, op->N);
+	else
+		transMatrix(mB, op->N, matrixBt, op->N, op->N, op->N);
+	finFase(medida, MM_FASE_TRANSPOSICION);
+
+	if (op->afinidad != MM_AFIN_NINGUNA && op->replicaB && !replicada) {
+		replicaMatriz(matrixBt, elemsBt);
+		replicada = 1;
+	}
+
+	inicioFase(medida, MM_FASE_MULTIPLICACION);
+	if (general)
+		multiMatrixTransForma(op, mA, matrixBt, mC);
+	else if (op->tuberia)
+		multiMatrixTransTuberia(op, mA, matrixBt, mC, op->N);
+	else if (kernelComun(op))
+		multiMatrixTransPorBloques(op, mA, matrixBt, mC, op->N);
+	else
+		multiMatrixTrans(mA, matrixBt, mC, op->N);
+	return finFase(medida, MM_FASE_MULTIPLICACION);
+}
+
+/*-----------------------------------------------------------------------------
+ * terminaFilas — Suelta los hilos fijados y libera Bᵀ, el plan de afinidad y
+ * el de la forma.
+ *---------------------------------------------------------------------------*/
+static void terminaFilas(const struct opciones *op) {
+	finParticion(&plan);
+	if (op->afinidad != MM_AFIN_NINGUNA) {
+		#pragma omp parallel
+		sueltaHiloActual();
+
+		finAfinidad(&colocacion);
+		memset(&colocacion, 0, sizeof(colocacion));
+	}
+	liberaMatriz(matrixBt, elemsBt, op->paginas);
+	matrixBt = NULL;
+	medida = NULL;
+}
+
+const struct motor motorFilas = { "filas", iniciaFilas, multiplicaFilas, terminaFilas, 1 };
+
+#ifndef MM_BINARIO_UNICO
+
 /*-----------------------------------------------------------------------------
  * impMatrix — Imprime una matriz (normal o transpuesta) si el tamaño es pequeño.
  *
@@ -75,7 +419,7 @@ void FinMuestra() {
  *  Muestra la matriz en formato flotante (2 decimales), útil para depuración
  *  y verificación visual de resultados en casos pequeños (D < 6).
  *---------------------------------------------------------------------------*/
-void impMatrix(double *matrix, int D, int t) {
+static void impMatrix(double *matrix, int D, int t) {
 	int aux = 0;
 	if (D < 6)
 		switch (t) {
@@ -106,61 +450,67 @@ void impMatrix(double *matrix, int D, int t) {
  * iniMatrix — Inicializa matrices A y B con valores aleatorios.
  *
  * Parámetros:
+ *  - op: opciones del programa (semilla y franja de filas).
  *  - m1: puntero a la matriz A.
  *  - m2: puntero a la matriz B.
- *  - D:  tamaño (dimensión) de las matrices cuadradas.
+ *  - D:  dimensión de las matrices cuadradas.
  *
  * Descripción:
- *  Asigna valores pseudoaleatorios en punto flotante:
+ *  Los hilos llenan franjas de filas en paralelo con el generador por
+ *  contador de mmAleatorio.c (semilla `--seed`):
  *   - A: valores entre 1.0 y 5.0
  *   - B: valores entre 5.0 y 9.0
+ *  Se usa el mismo reparto `schedule(static)` que la multiplicación, de modo
+ *  que el primer toque deja cada franja en el nodo del hilo que la usará.
  *---------------------------------------------------------------------------*/
-void iniMatrix(double *m1, double *m2, int D) {
-	for (int i = 0; i < D * D; i++, m1++, m2++) {
-		*m1 = (double)rand() / RAND_MAX * (5.0 - 1.0);	
-		*m2 = (double)rand() / RAND_MAX * (9.0 - 5.0);		
+static void iniMatrix(const struct opciones *op, double *m1, double *m2, int D) {
+	int tam = franjaFilas(op);
+
+	#pragma omp parallel for schedule(static)
+	for (int ii = 0; ii < D; ii += tam) {
+		int iF = (ii + tam < D) ? ii + tam : D;
+		iniMatrixFilas(m1, m2, D, ii, iF, op->semilla);
 	}
 }
 
 /*-----------------------------------------------------------------------------
- * multiMatrixTrans — Multiplicación optimizada usando la matriz transpuesta.
+ * colocaMatrices — Ubica A y C por primer toque.
  *
  * Parámetros:
- *  - mA: puntero a la matriz A.
- *  - mB: puntero a la matriz B (interpretada como transpuesta).
- *  - mC: puntero a la matriz resultado C.
- *  - D:  dimensión de las matrices.
+ *  - op: opciones del programa (define la franja de filas de cada hilo).
+ *  - mA, mC: matrices aún sin inicializar.
+ *  - D: dimensión de las matrices.
  *
  * Descripción:
- *  Cada hilo OpenMP calcula un subconjunto de filas de `mC`. 
- *  La diferencia frente a la versión clásica es que `mB` se recorre por filas
- *  (en lugar de columnas), mejorando la localidad espacial en la memoria.
- *
- * Directivas OpenMP:
- *  - `#pragma omp parallel` crea el grupo de hilos.
- *  - `#pragma omp for` divide el bucle principal de filas `i` entre los hilos.
+ *  Con los hilos ya fijados por `iniciaFilas()`, cada uno escribe primero
+ *  las franjas de A y C que le asignará la multiplicación con
+ *  `schedule(static)`, para que esas páginas queden en su nodo NUMA.
+ *  `iniMatrix()` llena luego esas mismas franjas desde los mismos hilos.
  *---------------------------------------------------------------------------*/
-void multiMatrixTrans(double *mA, double *mB, double *mC, int D) {
-	double Suma, *pA, *pB;
-
-	#pragma omp parallel
-	{
-		#pragma omp for
-		for (int i = 0; i < D; i++) {
-			for (int j = 0; j < D; j++) {
-				pA = mA + i * D;	
-				pB = mB + j * D;	
-				Suma = 0.0;
+static void colocaMatrices(const struct opciones *op, double *mA, double *mC, int D) {
+	int tam = franjaFilas(op);
 
-				for (int k = 0; k < D; k++, pA++, pB++) {
-					Suma += *pA * *pB;
-				}
-				mC[i * D + j] = Suma;
-			}
-		}
+	#pragma omp parallel for schedule(static)
+	for (int ii = 0; ii < D; ii += tam) {
+		int iF = (ii + tam < D) ? ii + tam : D;
+		tocaFilas(mA, D, ii, iF);
+		tocaFilas(mC, D, ii, iF);
 	}
 }
 
+/*-----------------------------------------------------------------------------
+ * traficoTuberia — Tráfico con memoria de `multiMatrixTransTuberia()`: la
+ * suma de `traficoMicro()` sobre las franjas.
+ *---------------------------------------------------------------------------*/
+static double traficoTuberia(const struct opciones *op, int D) {
+	int tam = franjaFilas(op);
+	double bytes = 0.0;
+
+	for (int ii = 0; ii < D; ii += tam)
+		bytes += traficoMicro((ii + tam < D) ? tam : D - ii, D, D);
+	return bytes;
+}
+
 /*-----------------------------------------------------------------------------
  * main — Función principal del programa.
  *
@@ -169,45 +519,121 @@ void multiMatrixTrans(double *mA, double *mB, double *mC, int D) {
  *  - argv: arreglo de argumentos (argv[1]=tamaño, argv[2]=hilos).
  *
  * Descripción:
- *  1. Valida los argumentos de entrada.
+ *  1. Valida los argumentos de entrada y las opciones (ver mmComun.c); con
+ *     `--shape` o `--pad` el producto general lo ejecuta `ejecutaForma()`
+ *     (mmForma.c) con este motor, con `--type` `ejecutaTipo()` (mmTipo.c),
+ *     con `--files` `ejecutaArchivo()` (mmArchivo.c) y con `--density`
+ *     `ejecutaDispersa()` (mmDispersa.c).
  *  2. Reserva memoria dinámica para matrices A, B y C.
- *  3. Inicializa matrices con valores aleatorios.
- *  4. Configura el número de hilos con `omp_set_num_threads()`.
- *  5. Ejecuta la multiplicación optimizada y mide el tiempo total.
- *  6. Imprime resultados si la matriz es pequeña.
+ *  3. Prepara el motor (`iniciaFilas()`): número de hilos y, con `-a`,
+ *     fijación de hilos; luego ubica A y C por primer toque.
+ *  4. Inicializa matrices con valores aleatorios.
+ *  5. Ejecuta el motor: transpone B (con `-a <pol>,replica`, Bᵀ se replica
+ *     en cada nodo) y multiplica, midiendo ambas fases por separado.
+ *  6. Muestra ambos tiempos e imprime resultados si la matriz es pequeña;
+ *     con `--verify` comprueba C = A·B fuera del tiempo medido.
  *  7. Libera la memoria asignada.
  *---------------------------------------------------------------------------*/
 int main(int argc, char *argv[]) {
-	if (argc < 3) {
-		printf("\nUso: ./mmFilasOpenMP <TamañoMatriz> <NumHilos>\n\n");
-		exit(0);
+	struct opciones op;
+	leerOpciones(argc, argv, "./mmFilasOpenMP", &op);
+	if (op.archivos[0] != NULL)
+		return ejecutaArchivo(&op, &motorFilas, 0, "mmFilasOpenMP");
+	if (formaGeneral(&op))
+		return ejecutaForma(&op, &motorFilas, 0, "mmFilasOpenMP");
+	if (op.tipo != MM_TIPO_NINGUNO)
+		return ejecutaTipo(&op, &motorFilas, 0, "mmFilasOpenMP");
+	if (op.lote > 0)
+		return ejecutaLote(&op, &motorFilas, 0, "mmFilasOpenMP");
+	if (op.densidad > 0.0)
+		return ejecutaDispersa(&op, &motorFilas, 0, "mmFilasOpenMP");
+
+	int N = op.N;
+	int TH = op.P;
+
+	/* A, B, C y la transpuesta de B */
+	if (compruebaHuella(N, 4, stderr) != 0)
+		exit(1);
+
+	/* Con -a la ubicación de A y C la hace el primer toque de cada hilo */
+	int precarga = op.precarga && op.afinidad == MM_AFIN_NINGUNA;
+	double *matrixA = reservaMatriz((size_t) N * N, op.paginas, 0, precarga);
+	double *matrixB = reservaMatriz((size_t) N * N, op.paginas, 0, op.precarga);
+	double *matrixC = reservaMatriz((size_t) N * N, op.paginas, 0, precarga);
+	if (matrixA == NULL || matrixB == NULL || matrixC == NULL) {
+		perror("Error al reservar memoria para las matrices");
+		exit(1);
 	}
 
-	int N = atoi(argv[1]);
-	int TH = atoi(argv[2]);
+	struct medicion tiempos;
+	struct contadores contadores;
 
-	double *matrixA = (double *)calloc(N * N, sizeof(double));
-	double *matrixB = (double *)calloc(N * N, sizeof(double));
-	double *matrixC = (double *)calloc(N * N, sizeof(double));
+	if (iniMedicion(&tiempos, TH) != 0) {
+		perror("Error al reservar las marcas de tiempo");
+		exit(1);
+	}
+
+	if (op.contadores) {
+		if (iniContadores(&contadores, TH) != 0) {
+			perror("Error al reservar los contadores");
+			exit(1);
+		}
+		tiempos.cont = &contadores;
+	}
 
-	srand(time(NULL));
-	omp_set_num_threads(TH);
+	if (motorFilas.iniciar(&op, &tiempos) != 0) {
+		perror("Error al preparar la transpuesta o la afinidad de hilos");
+		exit(1);
+	}
+	if (op.afinidad != MM_AFIN_NINGUNA)
+		colocaMatrices(&op, matrixA, matrixC, N);
 
-	iniMatrix(matrixA, matrixB, N);
+	inicioFase(&tiempos, MM_FASE_INICIALIZACION);
+	iniMatrix(&op, matrixA, matrixB, N);
+	finFase(&tiempos, MM_FASE_INICIALIZACION);
 
 	impMatrix(matrixA, N, 0);  // matriz normal
-	impMatrix(matrixB, N, 1);  // matriz transpuesta
+	impMatrix(matrixB, N, 0);  // matriz normal
+
+	double tMult = motorFilas.multiplicar(&op, matrixA, matrixB, matrixC);
+	double tTrans = tiempos.fase[MM_FASE_TRANSPOSICION].total;
 
-	InicioMuestra();
-	multiMatrixTrans(matrixA, matrixB, matrixC, N);
-	FinMuestra();
+	impMatrix(matrixBt, N, 1); // Bᵀ impresa por columnas coincide con B
+
+	if (op.afinidad != MM_AFIN_NINGUNA)
+		informeAfinidad(&colocacion, stderr);
+
+	printf("%9.0f %9.0f ", tMult, tTrans);
+	if (op.contadores)
+		columnasContadores(&contadores, 2.0 * N * N * N, tMult, stdout);
+	printf("\n");
 
 	impMatrix(matrixC, N, 0);
+	if (op.informe) {
+		informeMemoria("A", matrixA, stderr);
+		informeMemoria("B", matrixB, stderr);
+		informeMemoria("C", matrixC, stderr);
+		informeHuella(N, 4, tMult, 1, stderr);
+		if (op.tuberia)
+			informeAncho("tubería", traficoTuberia(&op, N), tMult, 1, TH, stderr);
+	}
+
+	int fallo = op.verifica ? verificaProducto(matrixA, matrixB, matrixC, N, op.semilla, stderr) : 0;
+
+	motorFilas.terminar(&op);
+	escribeMedicion(&tiempos, op.formatoTiempo, "mmFilasOpenMP", N, stderr);
+	if (op.contadores) {
+		informeContadores(&contadores, op.informe, stderr);
+		liberaContadores(&contadores);
+	}
+	finMedicion(&tiempos);
 
 	/* Liberación de memoria */
-	free(matrixA);
-	free(matrixB);
-	free(matrixC);
+	liberaMatriz(matrixA, (size_t) N * N, op.paginas);
+	liberaMatriz(matrixB, (size_t) N * N, op.paginas);
+	liberaMatriz(matrixC, (size_t) N * N, op.paginas);
 	
-	return 0;
+	return fallo;
 }
+
+#endif /* MM_BINARIO_UNICO */
@@ -0,0 +1,479 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * Descripción general:
+ * ---------------------------------------------------------------
+ * Producto general C (M×N) = A (M×K) · B (K×N) con saltos de fila propios
+ * (opciones `--shape MxK` y `--pad e`).
+ *
+ * Los programas originales solo multiplican matrices cuadradas y reparten
+ * filas de C, lo que para formas reales deja hilos sin trabajo: con M = 32
+ * y 8 hilos, o con un producto "panel" de M y N pequeñas y K grande, la
+ * mayoría de los hilos no recibe ninguna fila. El plan (`planifica()`)
+ * divide por orden de preferencia:
+ *  1. Filas de C (pm): cada trozo escribe una franja distinta de C y no
+ *     hay que combinar nada; se usa mientras haya al menos
+ *     MM_FORMA_MIN_FILAS filas por división.
+ *  2. Columnas de C (pn): cuando M no alcanza para todos los trabajadores;
+ *     los trozos leen columnas distintas de B y tampoco se combinan.
+ *  3. Dimensión común K (pk): cuando M y N son pequeñas y K grande. Cada
+ *     trozo calcula una suma parcial de su rango de k; la del primer rango
+ *     se escribe en C y las demás en matrices auxiliares que se suman a C
+ *     en una segunda etapa (`reduceFranja()`), repartida entre todos.
+ * Entre los repartos posibles se elige el que ocupa más trabajadores y, a
+ * igualdad, el que divide más las filas (lo más barato).
+ *
+ * Cada trozo se calcula con el kernel pedido (`-k`, `-b` o el clásico)
+ * sobre punteros desplazados: el rango [kI, kF) de K es la submatriz
+ * A[:, kI:kF] (mA + kI, salto lda) por B[kI:kF, :] (mB + kI·ldb, salto ldb).
+ *
+ * `ejecutaForma()` es el `main()` común de la ruta general para los cuatro
+ * programas: reserva A, B y C en una región, las inicializa (en serie, con
+ * el mismo generador por contador), ejecuta el motor y escribe el tiempo.
+ *
+ * ---------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#include "mmForma.h"
+#include "mmBloques.h"
+#include "mmMicro.h"
+#include "mmReparto.h"
+#include "mmAleatorio.h"
+#include "mmVerifica.h"
+#include "mmTiempo.h"
+#include "mmMemoria.h"
+#include "mmMotor.h"
+
+/*-----------------------------------------------------------------------------
+ * formaGeneral — 1 si se pidió el producto general (`--shape` o `--pad`).
+ *---------------------------------------------------------------------------*/
+int formaGeneral(const struct opciones *op) {
+	return op->M > 0 || op->K > 0 || op->relleno > 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * formaDe — Forma del producto para las opciones (y el N) en curso.
+ *
+ * Descripción:
+ *  Sin `--shape` M = K = N; los saltos son la fila más el relleno de
+ *  `--pad`. Un salto que no cabe en `int` se deja en -1 para que
+ *  `compruebaForma()` lo rechace.
+ *---------------------------------------------------------------------------*/
+void formaDe(const struct opciones *op, struct forma *f) {
+	long long lda, ldn;
+
+	f->N = op->N;
+	f->M = (op->M > 0) ? op->M : op->N;
+	f->K = (op->K > 0) ? op->K : op->N;
+
+	lda = (long long) f->K + op->relleno;
+	ldn = (long long) f->N + op->relleno;
+	f->lda = (lda <= INT_MAX) ? (int) lda : -1;
+	f->ldb = f->ldc = (ldn <= INT_MAX) ? (int) ldn : -1;
+}
+
+/*-----------------------------------------------------------------------------
+ * flopsForma — Operaciones de punto flotante de una multiplicación (2·M·N·K).
+ *---------------------------------------------------------------------------*/
+double flopsForma(const struct forma *f) {
+	return 2.0 * f->M * (double) f->N * f->K;
+}
+
+/*-----------------------------------------------------------------------------
+ * divisiones — Cuántas partes de al menos `minimo` caben en `total`, sin
+ * pasar de `maximo` ni bajar de 1.
+ *---------------------------------------------------------------------------*/
+static int divisiones(int total, int minimo, int maximo) {
+	int d = total / minimo;
+
+	if (d > maximo) d = maximo;
+	return (d < 1) ? 1 : d;
+}
+
+/*-----------------------------------------------------------------------------
+ * planifica — Elige las divisiones pm × pn × pk de la forma para P
+ * trabajadores (ver descripción del archivo). No reserva memoria.
+ *---------------------------------------------------------------------------*/
+void planifica(struct particion *pt, const struct forma *f, int P) {
+	int maxM = divisiones(f->M, MM_FORMA_MIN_FILAS, P);
+
+	memset(pt, 0, sizeof(*pt));
+	pt->f = *f;
+
+	for (int pm = maxM; pm >= 1; pm--) {
+		int pn = divisiones(f->N, MM_FORMA_MIN_COLS, P / pm);
+		int pk = divisiones(f->K, MM_FORMA_MIN_PROF, P / (pm * pn));
+
+		if (pm * pn * pk > pt->trozos) {
+			pt->pm = pm;
+			pt->pn = pn;
+			pt->pk = pk;
+			pt->trozos = pm * pn * pk;
+		}
+	}
+	pt->franjas = (pt->pk > 1) ? P : 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * iniParticion — Planifica la forma y reserva las sumas parciales.
+ *
+ * Parámetros:
+ *  - pt: plan a llenar.
+ *  - f: forma del producto.
+ *  - P: número de trabajadores.
+ *  - compartida: 1 → sumas parciales en memoria compartida (motor Fork).
+ *  - paginas: páginas de la reserva (`--pages`).
+ *
+ * Descripción:
+ *  Las matrices parciales solo existen si el plan divide K; se precargan
+ *  al reservarlas para que sus fallos de página no caigan en el tiempo de
+ *  la multiplicación. Retorna -1 si la reserva falla.
+ *---------------------------------------------------------------------------*/
+int iniParticion(struct particion *pt, const struct forma *f, int P, int compartida, int paginas) {
+	planifica(pt, f, P);
+	pt->paginas = paginas;
+
+	if (pt->pk > 1) {
+		pt->elemsParcial = elemsAlineados((size_t) f->M * f->N);
+		pt->parcial = reservaMatriz(pt->elemsParcial * (size_t) (pt->pk - 1), paginas, compartida, 1);
+		if (pt->parcial == NULL)
+			return -1;
+	}
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * finParticion — Libera las sumas parciales (si las hay).
+ *---------------------------------------------------------------------------*/
+void finParticion(struct particion *pt) {
+	if (pt->parcial != NULL)
+		liberaMatriz(pt->parcial, pt->elemsParcial * (size_t) (pt->pk - 1), pt->paginas);
+	memset(pt, 0, sizeof(*pt));
+}
+
+/*-----------------------------------------------------------------------------
+ * informeParticion — Escribe en `fl` la forma y el plan elegido.
+ *---------------------------------------------------------------------------*/
+void informeParticion(const struct particion *pt, FILE *fl) {
+	const struct forma *f = &pt->f;
+
+	fprintf(fl, "# forma: C %d×%d = A %d×%d · B %d×%d (lda %d, ldb %d, ldc %d)\n",
+	        f->M, f->N, f->M, f->K, f->K, f->N, f->lda, f->ldb, f->ldc);
+	fprintf(fl, "# reparto: %d trozos = %d (filas) × %d (columnas) × %d (K)%s\n",
+	        pt->trozos, pt->pm, pt->pn, pt->pk, pt->pk > 1 ? " con reducción de sumas parciales" : "");
+}
+
+/*-----------------------------------------------------------------------------
+ * rangoAlineado — Rango `idx` de `partes` sobre [0, total) en múltiplos de
+ * `unidad` (el último rango absorbe el resto).
+ *---------------------------------------------------------------------------*/
+static void rangoAlineado(int total, int partes, int idx, int unidad, int *ini, int *fin) {
+	int grupos = (total + unidad - 1) / unidad;
+
+	rangoEstatico(grupos, partes, idx, ini, fin);
+	*ini *= unidad;
+	*fin = (*fin * (long) unidad < total) ? *fin * unidad : total;
+	if (*ini > total)
+		*ini = total;
+}
+
+/*-----------------------------------------------------------------------------
+ * multiFormaClasica — Kernel clásico i-j-k para una región de C: cada
+ * C[i][j] es el producto punto de la fila i de A y la columna j de B (o la
+ * fila j de Bᵀ si `bTrans` = 1).
+ *---------------------------------------------------------------------------*/
+static void multiFormaClasica(const double *mA, int lda, const double *mB, int ldb, int bTrans,
+                              double *mC, int ldc, int K, int filaI, int filaF, int colI, int colF) {
+	size_t paso = bTrans ? 1 : (size_t) ldb;
+
+	for (int i = filaI; i < filaF; i++) {
+		const double *pA = mA + (size_t) i * lda;
+
+		for (int j = colI; j < colF; j++) {
+			const double *pB = bTrans ? mB + (size_t) j * ldb : mB + j;
+			double Suma = 0.0;
+
+			for (int k = 0; k < K; k++, pB += paso)
+				Suma += pA[k] * *pB;
+			mC[(size_t) i * ldc + j] = Suma;
+		}
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * multiFormaComun — Calcula la región [filaI, filaF) × [colI, colF) de C
+ * del producto general con el kernel pedido.
+ *
+ * Parámetros:
+ *  - op: opciones del programa (`--pipeline` tiene prioridad sobre `-k`
+ *        y `-k` sobre `-b`; sin ninguna, el kernel clásico).
+ *  - mA, lda: A y su salto de fila.
+ *  - mB, ldb: B (o Bᵀ si `bTrans` = 1) y su salto de fila.
+ *  - mC, ldc: C y su salto de fila.
+ *  - K: dimensión común.
+ *---------------------------------------------------------------------------*/
+void multiFormaComun(const struct opciones *op, const double *mA, int lda, const double *mB, int ldb,
+                     int bTrans, double *mC, int ldc, int K, int filaI, int filaF, int colI, int colF) {
+	if (op->tuberia)
+		multiFormaTuberia(mA, lda, mB, ldb, bTrans, mC, ldc, K, filaI, filaF, colI, colF, op->kernel);
+	else if (op->kernel != MM_KERNEL_NINGUNO)
+		multiFormaMicro(mA, lda, mB, ldb, bTrans, mC, ldc, K, filaI, filaF, colI, colF, op->kernel);
+	else if (op->bloque > 0 && bTrans)
+		multiFormaBloquesTrans(mA, lda, mB, ldb, mC, ldc, K, filaI, filaF, colI, colF, op->bloque);
+	else if (op->bloque > 0)
+		multiFormaBloques(mA, lda, mB, ldb, mC, ldc, K, filaI, filaF, colI, colF, op->bloque);
+	else
+		multiFormaClasica(mA, lda, mB, ldb, bTrans, mC, ldc, K, filaI, filaF, colI, colF);
+}
+
+/*-----------------------------------------------------------------------------
+ * calculaTrozo — Calcula el trozo `t` del plan.
+ *
+ * Parámetros:
+ *  - op: opciones (kernel).
+ *  - pt: plan de `iniParticion()`.
+ *  - mA, mC: matrices A y C (saltos de pt->f).
+ *  - mB, ldb, bTrans: B con su salto, o Bᵀ (N×K) si `bTrans` = 1.
+ *  - t: trozo (0 .. pt->trozos-1); con t fuera de rango no hace nada, así
+ *       que cada trabajador puede llamarla con su propio identificador.
+ *
+ * Descripción:
+ *  El trozo t corresponde a la división (t / (pn·pk), (t / pk) % pn,
+ *  t % pk) de (M, N, K). Las filas se dividen en múltiplos de MM_MR y las
+ *  columnas en múltiplos de 16 para no partir micro-bloques.
+ *---------------------------------------------------------------------------*/
+void calculaTrozo(const struct opciones *op, const struct particion *pt, const double *mA,
+                  const double *mB, int ldb, int bTrans, double *mC, int t) {
+	const struct forma *f = &pt->f;
+	int filaI, filaF, colI, colF, kI, kF;
+
+	if (t < 0 || t >= pt->trozos)
+		return;
+
+	int ik = t % pt->pk;
+	int in = (t / pt->pk) % pt->pn;
+	int im = t / (pt->pk * pt->pn);
+
+	rangoAlineado(f->M, pt->pm, im, MM_MR, &filaI, &filaF);
+	rangoAlineado(f->N, pt->pn, in, 16, &colI, &colF);
+	rangoEstatico(f->K, pt->pk, ik, &kI, &kF);
+
+	double *dest = mC;
+	int ldc = f->ldc;
+
+	if (ik > 0) {
+		dest = pt->parcial + (size_t) (ik - 1) * pt->elemsParcial;
+		ldc = f->N;
+	}
+
+	const double *pB = bTrans ? mB + kI : mB + (size_t) kI * ldb;
+
+	multiFormaComun(op, mA + kI, f->lda, pB, ldb, bTrans, dest, ldc, kF - kI, filaI, filaF, colI, colF);
+}
+
+/*-----------------------------------------------------------------------------
+ * reduceFranja — Suma a C las sumas parciales de la franja `r` (0 ..
+ * pt->franjas-1) de sus M·N elementos.
+ *
+ * Descripción:
+ *  Las franjas son rangos contiguos y balanceados de elementos de C, así
+ *  que la reducción reparte el trabajo aunque M sea menor que el número de
+ *  trabajadores.
+ *---------------------------------------------------------------------------*/
+void reduceFranja(const struct particion *pt, double *mC, int r) {
+	size_t N = (size_t) pt->f.N, total = (size_t) pt->f.M * N;
+
+	if (r < 0 || r >= pt->franjas)
+		return;
+
+	size_t ini = total * (size_t) r / (size_t) pt->franjas;
+	size_t fin = total * (size_t) (r + 1) / (size_t) pt->franjas;
+
+	for (size_t p = ini; p < fin; ) {
+		size_t i = p / N, j = p % N;
+		size_t n = (N - j < fin - p) ? N - j : fin - p;
+		double *restrict c = mC + i * (size_t) pt->f.ldc + j;
+
+		for (int s = 0; s < pt->pk - 1; s++) {
+			const double *restrict q = pt->parcial + (size_t) s * pt->elemsParcial + i * N + j;
+
+			for (size_t x = 0; x < n; x++)
+				c[x] += q[x];
+		}
+		p += n;
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * iniForma — Inicializa A y B de la forma con el generador por contador
+ * (`--seed`) y pone C a cero, incluido el relleno de cada fila.
+ *---------------------------------------------------------------------------*/
+void iniForma(const struct forma *f, double *mA, double *mB, double *mC, uint64_t semilla) {
+	int filas = (f->M > f->K) ? f->M : f->K;
+
+	iniFormaFilas(mA, mB, f->M, f->N, f->K, f->lda, f->ldb, 0, filas, semilla);
+	memset(mC, 0, (size_t) f->M * f->ldc * sizeof(double));
+}
+
+/*-----------------------------------------------------------------------------
+ * huellaForma — Bytes de A, B y C (con relleno y alineadas como en
+ * `ejecutaForma()`), o SIZE_MAX si no caben en size_t.
+ *---------------------------------------------------------------------------*/
+size_t huellaForma(const struct forma *f) {
+	size_t limite = SIZE_MAX / 4 / sizeof(double);
+	size_t eA = (size_t) f->M * (size_t) f->lda;
+	size_t eB = (size_t) f->K * (size_t) f->ldb;
+	size_t eC = (size_t) f->M * (size_t) f->ldc;
+
+	if (f->lda <= 0 || f->ldb <= 0 || eA > limite || eB > limite || eC > limite)
+		return SIZE_MAX;
+	return (elemsAlineados(eA) + elemsAlineados(eB) + elemsAlineados(eC)) * sizeof(double);
+}
+
+/*-----------------------------------------------------------------------------
+ * compruebaForma — Valida que A, B y C de la forma quepan en memoria
+ * (como `compruebaHuella()` para el caso cuadrado). Retorna 0 o -1.
+ *---------------------------------------------------------------------------*/
+int compruebaForma(const struct forma *f, FILE *fl) {
+	size_t bytes = huellaForma(f);
+
+	if (bytes == SIZE_MAX) {
+		fprintf(fl, "M=%d N=%d K=%d: las matrices no caben en el espacio de direcciones\n",
+		        f->M, f->N, f->K);
+		return -1;
+	}
+	if (!cabeEnMemoria(bytes)) {
+		fprintf(fl, "M=%d N=%d K=%d: las matrices ocupan %.1f GiB y el equipo tiene %.1f GiB de memoria\n",
+		        f->M, f->N, f->K, bytes / 1073741824.0, memoriaFisica() / 1073741824.0);
+		return -1;
+	}
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * informeForma — Huella, tráfico mínimo y rendimiento del producto general.
+ *
+ * Descripción:
+ *  Cada multiplicación lee A y B y escribe C al menos una vez:
+ *  8·(M·K + K·N + M·N) bytes. La intensidad aritmética 2·M·N·K / esos bytes
+ *  cae mucho en formas delgadas (M o N pequeñas), que por eso quedan
+ *  limitadas por memoria aunque K sea grande.
+ *---------------------------------------------------------------------------*/
+void informeForma(const struct forma *f, double tiempoUs, int reps, FILE *fl) {
+	double minimo = sizeof(double) * ((double) f->M * f->K + (double) f->K * f->N + (double) f->M * f->N);
+	double flops = flopsForma(f);
+
+	fprintf(fl, "# huella: %.1f MiB; tráfico mínimo %.1f MiB por multiplicación\n",
+	        huellaForma(f) / 1048576.0, minimo / 1048576.0);
+	fprintf(fl, "# ancho de banda efectivo mínimo: %.2f GB/s; %.2f GFLOP/s; intensidad aritmética %.1f FLOP/byte\n",
+	        tiempoUs > 0.0 ? minimo * reps / (tiempoUs * 1e3) : 0.0,
+	        tiempoUs > 0.0 ? flops * reps / (tiempoUs * 1e3) : 0.0, flops / minimo);
+}
+
+/*-----------------------------------------------------------------------------
+ * ejecutaForma — Programa independiente común para el producto general.
+ *
+ * Parámetros:
+ *  - op: opciones ya leídas (con `--shape` o `--pad`).
+ *  - mt: motor del programa (ver mmMotor.h).
+ *  - compartida: 1 → A, B y C en memoria compartida (motor Fork).
+ *  - programa: nombre para `--timing`.
+ *
+ * Descripción:
+ *  1. Valida la huella y reserva A, B y C en una sola región.
+ *  2. Inicializa A y B (fase de inicialización) y pone C a cero.
+ *  3. Inicia el motor, ejecuta una multiplicación (o R con `-r`) y lo
+ *     termina.
+ *  4. Escribe el tiempo: una columna, o media, mínimo y máximo con `-r`;
+ *     si el motor transpone B, además la transposición media.
+ *  5. Con `-v` el plan, la huella y el rendimiento; con `--verify` la
+ *     comprobación; con `--timing` las fases y los trabajadores.
+ *  Retorna el código de salida del programa (1 si la verificación falla).
+ *---------------------------------------------------------------------------*/
+int ejecutaForma(const struct opciones *op, const struct motor *mt, int compartida, const char *programa) {
+	struct forma f;
+	struct medicion tiempos;
+	struct contadores contadores;
+	int reps = (op->repeticiones > 0) ? op->repeticiones : 1;
+
+	formaDe(op, &f);
+	if (compruebaForma(&f, stderr) != 0)
+		exit(1);
+
+	size_t eA = elemsAlineados((size_t) f.M * f.lda), eB = elemsAlineados((size_t) f.K * f.ldb);
+	size_t elems = eA + eB + elemsAlineados((size_t) f.M * f.ldc);
+	double *region = reservaMatriz(elems, op->paginas, compartida, op->precarga);
+	if (region == NULL) {
+		perror("Error al reservar memoria para las matrices");
+		exit(1);
+	}
+	double *mA = region, *mB = region + eA, *mC = region + eA + eB;
+
+	if (iniMedicion(&tiempos, op->P) != 0) {
+		perror("Error al reservar las marcas de tiempo");
+		exit(1);
+	}
+	if (op->contadores) {
+		if (iniContadores(&contadores, op->P) != 0) {
+			perror("Error al reservar los contadores");
+			exit(1);
+		}
+		tiempos.cont = &contadores;
+	}
+
+	inicioFase(&tiempos, MM_FASE_INICIALIZACION);
+	iniForma(&f, mA, mB, mC, op->semilla);
+	finFase(&tiempos, MM_FASE_INICIALIZACION);
+
+	if (mt->iniciar(op, &tiempos) != 0) {
+		perror("Error al iniciar el motor");
+		exit(1);
+	}
+
+	double suma = 0.0, minimo = 0.0, maximo = 0.0;
+	for (int r = 0; r < reps; r++) {
+		double t = mt->multiplicar(op, mA, mB, mC);
+
+		suma += t;
+		if (r == 0 || t < minimo) minimo = t;
+		if (r == 0 || t > maximo) maximo = t;
+	}
+	mt->terminar(op);
+
+	const struct fase *trans = &tiempos.fase[MM_FASE_TRANSPOSICION];
+	if (op->repeticiones > 0)
+		printf("%9.0f %9.0f %9.0f ", suma / reps, minimo, maximo);
+	else
+		printf("%9.0f ", suma);
+	if (trans->veces > 0)
+		printf("%9.0f ", trans->total / trans->veces);
+	if (op->contadores)
+		columnasContadores(&contadores, flopsForma(&f) * reps, suma, stdout);
+	printf("\n");
+	fflush(stdout);
+
+	if (op->informe) {
+		struct particion plan;
+
+		planifica(&plan, &f, op->P);
+		informeParticion(&plan, stderr);
+		informeForma(&f, suma, reps, stderr);
+		informeMemoria("A|B|C", region, stderr);
+	}
+
+	int fallo = op->verifica ? verificaForma(&f, mA, mB, mC, op->semilla, stderr) : 0;
+
+	escribeMedicion(&tiempos, op->formatoTiempo, programa, f.N, stderr);
+	if (op->contadores) {
+		informeContadores(&contadores, op->informe, stderr);
+		liberaContadores(&contadores);
+	}
+	finMedicion(&tiempos);
+	liberaMatriz(region, elems, op->paginas);
+	return fallo;
+}
@@ -0,0 +1,86 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * mmForma.h — Producto general C (M×N) = A (M×K) · B (K×N) con saltos de
+ * fila (leading dimension) propios (`--shape MxK`, `--pad e`).
+ *
+ * Los motores reparten el producto general con un plan (`struct
+ * particion`) que se adapta a la forma: divide las filas de C si hay
+ * suficientes para todos los trabajadores; si M es pequeña divide también
+ * las columnas, y si además N es pequeña divide la dimensión común K, con
+ * sumas parciales que se reducen al final. Aquí están también la
+ * inicialización, la huella y el programa independiente común de la ruta
+ * general (`ejecutaForma()`).
+ */
+
+#ifndef MM_FORMA_H
+#define MM_FORMA_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "mmComun.h"
+
+struct motor;
+
+/* Granularidad mínima de cada división del plan: filas de C (4 micro-bloques
+ * MR), columnas de C (4 tiras NR de AVX-512) y profundidad (un panel KC) */
+#define MM_FORMA_MIN_FILAS  16
+#define MM_FORMA_MIN_COLS   64
+#define MM_FORMA_MIN_PROF   256
+
+/*-----------------------------------------------------------------------------
+ * Forma del producto:
+ *  - M, N, K: C es M×N, A es M×K y B es K×N.
+ *  - lda, ldb, ldc: salto entre filas consecutivas de A, B y C, en
+ *                   elementos (≥ K, N y N).
+ *---------------------------------------------------------------------------*/
+struct forma {
+	int M, N, K;
+	int lda, ldb, ldc;
+};
+
+/*-----------------------------------------------------------------------------
+ * Plan de reparto del producto general:
+ *  - f: forma del producto.
+ *  - pm, pn, pk: divisiones de M (filas), N (columnas) y K (profundidad).
+ *  - trozos: pm·pn·pk; el trabajador t calcula el trozo t (si t < trozos).
+ *  - franjas: franjas de C de la reducción (0 si pk = 1).
+ *  - parcial: pk-1 matrices M×N (salto N) con las sumas parciales de los
+ *             trozos con k > 0; el trozo k = 0 escribe directamente en C.
+ *  - elemsParcial: elementos (alineados) de cada matriz parcial.
+ *  - paginas: páginas de la reserva de `parcial` (MM_PAGINAS_*).
+ *---------------------------------------------------------------------------*/
+struct particion {
+	struct forma f;
+	int pm, pn, pk;
+	int trozos;
+	int franjas;
+	double *parcial;
+	size_t elemsParcial;
+	int paginas;
+};
+
+int formaGeneral(const struct opciones *op);
+void formaDe(const struct opciones *op, struct forma *f);
+double flopsForma(const struct forma *f);
+
+void planifica(struct particion *pt, const struct forma *f, int P);
+int iniParticion(struct particion *pt, const struct forma *f, int P, int compartida, int paginas);
+void finParticion(struct particion *pt);
+void informeParticion(const struct particion *pt, FILE *fl);
+
+void multiFormaComun(const struct opciones *op, const double *mA, int lda, const double *mB, int ldb,
+                     int bTrans, double *mC, int ldc, int K, int filaI, int filaF, int colI, int colF);
+void calculaTrozo(const struct opciones *op, const struct particion *pt, const double *mA,
+                  const double *mB, int ldb, int bTrans, double *mC, int t);
+void reduceFranja(const struct particion *pt, double *mC, int r);
+
+void iniForma(const struct forma *f, double *mA, double *mB, double *mC, uint64_t semilla);
+size_t huellaForma(const struct forma *f);
+int compruebaForma(const struct forma *f, FILE *fl);
+void informeForma(const struct forma *f, double tiempoUs, int reps, FILE *fl);
+
+int ejecutaForma(const struct opciones *op, const struct motor *mt, int compartida, const char *programa);
+
+#endif
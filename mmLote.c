@@ -0,0 +1,374 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * Descripción general:
+ * ---------------------------------------------------------------
+ * Multiplicación por lotes de matrices pequeñas (`--batch B`).
+ *
+ * Con N = 100 o 200 crear los procesos de Fork, despertar el pool de
+ * Pthreads o abrir la región paralela de OpenMP cuesta más que el producto,
+ * y repartir las filas de una matriz tan pequeña deja a cada trabajador
+ * unas pocas filas. Cuando hay muchos productos independientes conviene lo
+ * contrario: cada trabajador calcula productos completos y los motores
+ * reparten el lote (estático en Fork y en `filas`, con la política de `-s`
+ * en Pthreads y en OpenMP clásica), con una sola creación de trabajadores
+ * para todo el lote.
+ *
+ * Disposición: el lote está contiguo, A[b] empieza en mA + b·paso (lo mismo
+ * B y C) y cada matriz es N×N por filas; en la línea de comandos
+ * paso = N·N. `multiLotePunteros()` acepta en cambio matrices dispersas
+ * dadas por arreglos de punteros.
+ *
+ * Kernels por producto:
+ *  - N = 2, 3, 4, 6, 8, 12, 16 o 24: producto directo i-k-j sin empaquetar,
+ *    con la fila de C acumulada en un arreglo local. `MM_LOTE_FIJO` genera
+ *    una copia con N constante: el compilador desenrolla los bucles y
+ *    vectoriza j con el ancho justo, sin bucles de resto. Cada kernel se
+ *    genera para las tres variantes de `-k` (escalar, AVX2+FMA y AVX-512)
+ *    con `__attribute__((target))`, como los micro-kernels de mmMicro.c.
+ *  - Cualquier otro N: micro-kernel empaquetado de mmMicro.c (o el kernel
+ *    por bloques con `-b`), con los buffers de empaquetado reservados una
+ *    sola vez por trabajador y no en cada producto. Medido en un núcleo
+ *    AVX-512: el mismo bucle directo con N variable no llega a la mitad del
+ *    micro-kernel desde N ≈ 10, y los de N fijo lo superan solo hasta
+ *    N = 24 (de 1,5 a 10 GFLOP/s frente a 0,2 a 7 con N de 2 a 24); desde
+ *    N = 32 gana el micro-kernel.
+ *
+ * ---------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "mmLote.h"
+#include "mmMicro.h"
+#include "mmBloques.h"
+#include "mmAleatorio.h"
+#include "mmVerifica.h"
+#include "mmTiempo.h"
+#include "mmContadores.h"
+#include "mmMemoria.h"
+#include "mmMotor.h"
+
+/*-----------------------------------------------------------------------------
+ * MM_LOTE_FIJO — Define el kernel directo `nombre` para N = `n` constante.
+ *
+ * Descripción:
+ *  C = A·B con A, B y C de n×n contiguas. Para cada fila i, la fila de C
+ *  se acumula en `c` (en registros) como combinación de las filas de B, y
+ *  se escribe una sola vez. El parámetro N se ignora; existe para que
+ *  todos los kernels directos tengan el mismo tipo.
+ *---------------------------------------------------------------------------*/
+#define MM_LOTE_FIJO(nombre, n, ATRIB)                                                      \
+ATRIB static void nombre(const double *restrict mA, const double *restrict mB,              \
+                         double *restrict mC, int N) {                                      \
+	(void) N;                                                                                \
+	for (int i = 0; i < (n); i++) {                                                          \
+		double c[(n)] = { 0.0 };                                                             \
+                                                                                             \
+		for (int k = 0; k < (n); k++) {                                                      \
+			double a = mA[i * (n) + k];                                                      \
+                                                                                             \
+			for (int j = 0; j < (n); j++)                                                    \
+				c[j] += a * mB[k * (n) + j];                                                 \
+		}                                                                                    \
+		for (int j = 0; j < (n); j++)                                                        \
+			mC[i * (n) + j] = c[j];                                                          \
+	}                                                                                        \
+}
+
+/*-----------------------------------------------------------------------------
+ * MM_LOTE_VARIANTE — Genera los kernels directos de una variante SIMD y la
+ * tabla `directos##suf` indexada por N, con NULL donde no hay kernel.
+ *---------------------------------------------------------------------------*/
+#define MM_LOTE_VARIANTE(suf, ATRIB)                                                        \
+MM_LOTE_FIJO(fijo2##suf, 2, ATRIB)                                                          \
+MM_LOTE_FIJO(fijo3##suf, 3, ATRIB)                                                          \
+MM_LOTE_FIJO(fijo4##suf, 4, ATRIB)                                                          \
+MM_LOTE_FIJO(fijo6##suf, 6, ATRIB)                                                          \
+MM_LOTE_FIJO(fijo8##suf, 8, ATRIB)                                                          \
+MM_LOTE_FIJO(fijo12##suf, 12, ATRIB)                                                        \
+MM_LOTE_FIJO(fijo16##suf, 16, ATRIB)                                                        \
+MM_LOTE_FIJO(fijo24##suf, 24, ATRIB)                                                        \
+                                                                                             \
+static const kernelDirecto directos##suf[MM_LOTE_DIRECTO + 1] = {                           \
+	[2] = fijo2##suf, [3] = fijo3##suf, [4] = fijo4##suf, [6] = fijo6##suf,                  \
+	[8] = fijo8##suf, [12] = fijo12##suf, [16] = fijo16##suf, [24] = fijo24##suf             \
+};
+
+MM_LOTE_VARIANTE(Escalar, )
+MM_LOTE_VARIANTE(AVX2, __attribute__((target("avx2,fma"))))
+MM_LOTE_VARIANTE(AVX512, __attribute__((target("avx512f"))))
+
+/* Tablas por variante, en el orden de MM_KERNEL_* */
+static const kernelDirecto *const tablas[] = { directosEscalar, directosAVX2, directosAVX512 };
+
+/*-----------------------------------------------------------------------------
+ * varianteLote — Variante SIMD de los kernels del lote: la de `-k` o, sin
+ * `-k`, la mejor que soporta el CPU (el lote nunca usa el kernel clásico).
+ *---------------------------------------------------------------------------*/
+static int varianteLote(const struct opciones *op) {
+	return (op->kernel != MM_KERNEL_NINGUNO) ? op->kernel : kernelDetectado();
+}
+
+/*-----------------------------------------------------------------------------
+ * trozoLote — Productos por trozo del reparto dinámico o guiado del lote.
+ *
+ * Descripción:
+ *  El trozo de `-s <tipo>,n` si se indicó; si no, los productos que suman
+ *  unas MM_LOTE_TRABAJO multiplicaciones-suma (al menos uno).
+ *---------------------------------------------------------------------------*/
+int trozoLote(const struct opciones *op) {
+	double nnn = (double) op->N * op->N * op->N;
+
+	if (op->trozo > 0)
+		return op->trozo;
+	return (nnn >= MM_LOTE_TRABAJO) ? 1 : (int) (MM_LOTE_TRABAJO / nnn);
+}
+
+/*-----------------------------------------------------------------------------
+ * iniTrabajoLote — Prepara el trabajo de un trabajador sobre el lote.
+ *
+ * Descripción:
+ *  Elige el kernel directo si hay uno para N y, si no (sin `-b`), reserva
+ *  los buffers de empaquetado del micro-kernel. Cada trabajador (hijo,
+ *  hilo) tiene el suyo. Si la reserva falla el programa termina.
+ *---------------------------------------------------------------------------*/
+void iniTrabajoLote(struct trabajoLote *t, const struct opciones *op) {
+	memset(t, 0, sizeof(*t));
+	t->N = op->N;
+	t->kernel = varianteLote(op);
+	t->bloque = op->bloque;
+
+	if (t->N <= MM_LOTE_DIRECTO)
+		t->directo = tablas[t->kernel][t->N];
+	if (t->directo == NULL && (op->kernel != MM_KERNEL_NINGUNO || t->bloque == 0)) {
+		t->bloque = 0;
+		t->trabajo = aligned_alloc(MM_ALINEACION, sizeof(double) * elemsEmpaquetado(t->N));
+		if (t->trabajo == NULL) {
+			perror("Error al reservar los buffers de empaquetado del lote");
+			exit(1);
+		}
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * finTrabajoLote — Libera los buffers de `iniTrabajoLote()`.
+ *---------------------------------------------------------------------------*/
+void finTrabajoLote(struct trabajoLote *t) {
+	free(t->trabajo);
+	t->trabajo = NULL;
+}
+
+/*-----------------------------------------------------------------------------
+ * multiUno — C = A·B para un producto N×N del lote.
+ *---------------------------------------------------------------------------*/
+static void multiUno(const struct trabajoLote *t, const double *mA, const double *mB, double *mC) {
+	int N = t->N;
+
+	if (t->directo != NULL)
+		t->directo(mA, mB, mC, N);
+	else if (t->bloque > 0)
+		multiFormaBloques(mA, N, mB, N, mC, N, N, 0, N, 0, N, t->bloque);
+	else
+		multiFormaMicroEn(mA, N, mB, N, 0, mC, N, N, 0, N, 0, N, t->kernel, t->trabajo);
+}
+
+/*-----------------------------------------------------------------------------
+ * multiLote — Calcula los productos [ini, fin) de un lote contiguo.
+ *
+ * Parámetros:
+ *  - t: trabajo del trabajador (`iniTrabajoLote()`).
+ *  - mA, mB, mC: primera matriz de cada operando del lote.
+ *  - paso: elementos entre el inicio de una matriz y el de la siguiente
+ *          (≥ N·N; N·N si el lote está compacto).
+ *  - ini, fin: rango de productos a calcular.
+ *---------------------------------------------------------------------------*/
+void multiLote(const struct trabajoLote *t, const double *mA, const double *mB, double *mC,
+               size_t paso, int ini, int fin) {
+	for (int b = ini; b < fin; b++)
+		multiUno(t, mA + (size_t) b * paso, mB + (size_t) b * paso, mC + (size_t) b * paso);
+}
+
+/*-----------------------------------------------------------------------------
+ * multiLotePunteros — Como `multiLote()`, con la matriz b de cada operando
+ * en mA[b], mB[b] y mC[b] (cada una N×N contigua, en cualquier lugar).
+ *---------------------------------------------------------------------------*/
+void multiLotePunteros(const struct trabajoLote *t, const double *const *mA, const double *const *mB,
+                       double *const *mC, int ini, int fin) {
+	for (int b = ini; b < fin; b++)
+		multiUno(t, mA[b], mB[b], mC[b]);
+}
+
+/*-----------------------------------------------------------------------------
+ * iniLote — Inicializa los productos [ini, fin) de A y B (lote compacto).
+ *
+ * Descripción:
+ *  Cada elemento recibe el valor de su posición en el lote con la serie de
+ *  A o de B de `iniMatrixFilas()`; el primer producto coincide con las
+ *  matrices N×N de los programas sin `--batch` y la misma semilla.
+ *---------------------------------------------------------------------------*/
+void iniLote(double *mA, double *mB, int N, int ini, int fin, uint64_t semilla) {
+	size_t nn = (size_t) N * N;
+
+	llenaAleatorio(mA, ini * nn, fin * nn, semillaMatriz(semilla, 0xA), MM_A_MIN, MM_A_MAX);
+	llenaAleatorio(mB, ini * nn, fin * nn, semillaMatriz(semilla, 0xB), MM_B_MIN, MM_B_MAX);
+}
+
+/*-----------------------------------------------------------------------------
+ * elemsLote — Elementos (alineados) de un operando del lote compacto;
+ * SIZE_MAX si no caben tres en el espacio de direcciones.
+ *---------------------------------------------------------------------------*/
+size_t elemsLote(int N, int lote) {
+	size_t limite = SIZE_MAX / 4 / sizeof(double);
+	size_t nn = (size_t) N * N;
+
+	if (nn > limite / (size_t) lote)
+		return SIZE_MAX;
+	return elemsAlineados(nn * lote);
+}
+
+/*-----------------------------------------------------------------------------
+ * compruebaLote — Valida que A, B y C del lote quepan en memoria.
+ *
+ * Descripción:
+ *  Como `compruebaHuella()` (mmMemoria.c) para los 3·B matrices N×N.
+ *  Retorna 0 si caben y -1 (con el motivo en `f`) si no.
+ *---------------------------------------------------------------------------*/
+int compruebaLote(int N, int lote, FILE *f) {
+	size_t elems = elemsLote(N, lote);
+
+	if (elems == SIZE_MAX) {
+		fprintf(f, "N=%d: un lote de %d productos no cabe en el espacio de direcciones\n", N, lote);
+		return -1;
+	}
+	if (!cabeEnMemoria(3 * elems * sizeof(double))) {
+		fprintf(f, "N=%d: el lote de %d productos ocupa %.1f GiB y el equipo tiene %.1f GiB de memoria\n",
+		        N, lote, 3.0 * elems * sizeof(double) / 1073741824.0, memoriaFisica() / 1073741824.0);
+		return -1;
+	}
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * informeLote — Kernel, rendimiento y tráfico mínimo del lote.
+ *
+ * Descripción:
+ *  Cada ejecución del lote lee todas las A y B y escribe todas las C al
+ *  menos una vez; la intensidad aritmética es la de un solo producto
+ *  (N/12 FLOP/byte), así que con N pequeño el lote queda limitado por
+ *  memoria en cuanto no cabe en cache.
+ *---------------------------------------------------------------------------*/
+void informeLote(const struct opciones *op, double tiempoUs, int reps, FILE *f) {
+	int N = op->N, lote = op->lote;
+	int kernel = varianteLote(op);
+	double productos = (double) lote * reps;
+	double minimo = 3.0 * N * N * sizeof(double) * lote;
+	double flops = 2.0 * N * (double) N * N * lote;
+
+	if (N <= MM_LOTE_DIRECTO && tablas[kernel][N] != NULL)
+		fprintf(f, "# lote: %d productos de %d×%d, kernel directo de N fijo (%s)\n", lote, N, N,
+		        nombreKernel(kernel));
+	else if (op->kernel == MM_KERNEL_NINGUNO && op->bloque > 0)
+		fprintf(f, "# lote: %d productos de %d×%d, kernel por bloques de %d\n", lote, N, N, op->bloque);
+	else
+		fprintf(f, "# lote: %d productos de %d×%d, micro-kernel %s\n", lote, N, N, nombreKernel(kernel));
+	fprintf(f, "# huella %.1f MiB; %.2f GFLOP/s, %.0f productos/s; ancho de banda efectivo mínimo %.2f GB/s; intensidad aritmética %.1f FLOP/byte\n",
+	        3.0 * elemsLote(N, lote) * sizeof(double) / 1048576.0,
+	        tiempoUs > 0.0 ? flops * reps / (tiempoUs * 1e3) : 0.0,
+	        tiempoUs > 0.0 ? productos / (tiempoUs * 1e-6) : 0.0,
+	        tiempoUs > 0.0 ? minimo * reps / (tiempoUs * 1e3) : 0.0, flops / minimo);
+}
+
+/*-----------------------------------------------------------------------------
+ * ejecutaLote — Programa independiente común para `--batch`.
+ *
+ * Parámetros:
+ *  - op: opciones ya leídas (con `--batch`).
+ *  - mt: motor del programa (ver mmMotor.h).
+ *  - compartida: 1 → el lote en memoria compartida (motor Fork).
+ *  - programa: nombre para `--timing`.
+ *
+ * Descripción:
+ *  Como `ejecutaTipo()` (mmTipo.c): valida el lote, reserva A, B y C en
+ *  una región, las inicializa en serie, ejecuta el motor (una vez o R con
+ *  `-r`) y escribe el tiempo del lote completo con el formato de siempre.
+ *  Con `-v` el kernel y el rendimiento del lote, con `--verify` la
+ *  comprobación de cada producto y con `--timing` las fases. Retorna el
+ *  código de salida del programa (1 si la verificación falla).
+ *---------------------------------------------------------------------------*/
+int ejecutaLote(const struct opciones *op, const struct motor *mt, int compartida, const char *programa) {
+	struct medicion tiempos;
+	struct contadores contadores;
+	int N = op->N, lote = op->lote;
+	int reps = (op->repeticiones > 0) ? op->repeticiones : 1;
+
+	if (compruebaLote(N, lote, stderr) != 0)
+		exit(1);
+
+	size_t eL = elemsLote(N, lote);
+	double *region = reservaMatriz(3 * eL, op->paginas, compartida, op->precarga);
+	if (region == NULL) {
+		perror("Error al reservar memoria para el lote");
+		exit(1);
+	}
+	double *mA = region, *mB = region + eL, *mC = region + 2 * eL;
+
+	if (iniMedicion(&tiempos, op->P) != 0) {
+		perror("Error al reservar las marcas de tiempo");
+		exit(1);
+	}
+	if (op->contadores) {
+		if (iniContadores(&contadores, op->P) != 0) {
+			perror("Error al reservar los contadores");
+			exit(1);
+		}
+		tiempos.cont = &contadores;
+	}
+
+	inicioFase(&tiempos, MM_FASE_INICIALIZACION);
+	iniLote(mA, mB, N, 0, lote, op->semilla);
+	memset(mC, 0, eL * sizeof(double));
+	finFase(&tiempos, MM_FASE_INICIALIZACION);
+
+	if (mt->iniciar(op, &tiempos) != 0) {
+		perror("Error al iniciar el motor");
+		exit(1);
+	}
+
+	double suma = 0.0, minimo = 0.0, maximo = 0.0;
+	for (int r = 0; r < reps; r++) {
+		double t = mt->multiplicar(op, mA, mB, mC);
+
+		suma += t;
+		if (r == 0 || t < minimo) minimo = t;
+		if (r == 0 || t > maximo) maximo = t;
+	}
+	mt->terminar(op);
+
+	if (op->repeticiones > 0)
+		printf("%9.0f %9.0f %9.0f ", suma / reps, minimo, maximo);
+	else
+		printf("%9.0f ", suma);
+	if (op->contadores)
+		columnasContadores(&contadores, 2.0 * N * (double) N * N * lote * reps, suma, stdout);
+	printf("\n");
+	fflush(stdout);
+
+	if (op->informe) {
+		informeLote(op, suma, reps, stderr);
+		informeMemoria("A|B|C", region, stderr);
+	}
+
+	int fallo = op->verifica ? verificaLote(mA, mB, mC, N, lote, (size_t) N * N, op->semilla, stderr) : 0;
+
+	escribeMedicion(&tiempos, op->formatoTiempo, programa, N, stderr);
+	if (op->contadores) {
+		informeContadores(&contadores, op->informe, stderr);
+		liberaContadores(&contadores);
+	}
+	finMedicion(&tiempos);
+	liberaMatriz(region, 3 * eL, op->paginas);
+	return fallo;
+}
@@ -0,0 +1,70 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * mmLote.h — Lotes de productos pequeños e independientes (`--batch B`):
+ * C[b] = A[b]·B[b] para b = 0 .. B-1, todas las matrices N×N.
+ *
+ * Las matrices de un lote pueden estar contiguas con un salto fijo entre
+ * una y la siguiente (`multiLote()`) o dispersas y dadas por arreglos de
+ * punteros (`multiLotePunteros()`). Los motores reparten los productos del
+ * lote entre sus trabajadores en lugar de repartir las filas de cada
+ * producto, y los N pequeños más comunes tienen un kernel directo
+ * especializado.
+ */
+
+#ifndef MM_LOTE_H
+#define MM_LOTE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "mmComun.h"
+
+struct motor;
+
+/* Mayor N con kernel directo (sin empaquetar) especializado; los N sin
+ * kernel propio usan el micro-kernel de mmMicro.c o el de bloques (`-b`) */
+#define MM_LOTE_DIRECTO  24
+
+/* Multiplicaciones-suma por trozo del reparto dinámico del lote: los
+ * trozos de productos muy pequeños agrupan muchos para amortizar el
+ * reparto */
+#define MM_LOTE_TRABAJO  (1 << 16)
+
+typedef void (*kernelDirecto)(const double *restrict mA, const double *restrict mB,
+                              double *restrict mC, int N);
+
+/*-----------------------------------------------------------------------------
+ * Trabajo de un trabajador sobre el lote:
+ *  - N: dimensión de cada producto.
+ *  - directo: kernel directo especializado para N; NULL si no hay.
+ *  - kernel: variante SIMD (MM_KERNEL_*): la de `-k` o la detectada.
+ *  - bloque: bloque de `-b` para los N sin kernel directo (0 → micro-kernel).
+ *  - trabajo: buffers de empaquetado del micro-kernel, propios del
+ *             trabajador y reutilizados en todo el lote (NULL si no se usan).
+ *---------------------------------------------------------------------------*/
+struct trabajoLote {
+	int N;
+	kernelDirecto directo;
+	int kernel;
+	int bloque;
+	double *trabajo;
+};
+
+int trozoLote(const struct opciones *op);
+
+void iniTrabajoLote(struct trabajoLote *t, const struct opciones *op);
+void finTrabajoLote(struct trabajoLote *t);
+void multiLote(const struct trabajoLote *t, const double *mA, const double *mB, double *mC,
+               size_t paso, int ini, int fin);
+void multiLotePunteros(const struct trabajoLote *t, const double *const *mA, const double *const *mB,
+                       double *const *mC, int ini, int fin);
+
+void iniLote(double *mA, double *mB, int N, int ini, int fin, uint64_t semilla);
+size_t elemsLote(int N, int lote);
+int compruebaLote(int N, int lote, FILE *f);
+void informeLote(const struct opciones *op, double tiempoUs, int reps, FILE *f);
+
+int ejecutaLote(const struct opciones *op, const struct motor *mt, int compartida, const char *programa);
+
+#endif
@@ -0,0 +1,401 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * Descripción general:
+ * ---------------------------------------------------------------
+ * Reserva de matrices alineadas con páginas normales o grandes.
+ *
+ * Las versiones originales reservaban A, B y C con `calloc`: sin alineación
+ * garantizada para SIMD, con páginas de 4 KiB y con el llenado a cero
+ * diferido al primer toque, que para C ocurre dentro de la región medida.
+ * Con N=2400 cada matriz ocupa ~46 MB (más de 11 000 páginas de 4 KiB) y el
+ * recorrido por columnas de B en los kernels clásicos cambia de página en
+ * cada elemento, muy por encima de lo que cubre la dTLB.
+ *
+ * Este módulo reserva cada matriz con `mmap`:
+ *  - normal:  páginas de 4 KiB; alineación a página.
+ *  - thp:     región alineada a 2 MiB y `madvise(MADV_HUGEPAGE)`, para que
+ *             el núcleo la cubra con páginas grandes transparentes (requiere
+ *             /sys/kernel/mm/transparent_hugepage/enabled en madvise o
+ *             always; en memoria compartida, shmem_enabled).
+ *  - hugetlb: `MAP_HUGETLB`, páginas de 2 MiB reservadas por el
+ *             administrador (vm.nr_hugepages). Si no hay suficientes se avisa
+ *             en stderr y se usa thp.
+ * Con precarga (`--prefault`) se escribe una vez cada página al reservar,
+ * fuera de toda medición, de modo que ningún fallo de página cae dentro de
+ * la multiplicación.
+ *
+ * Pico de ancho de banda (`anchoStream()`): la tríada de STREAM
+ * (a = b + s·c) con P hilos sobre arreglos mucho mayores que la L3 da la
+ * referencia contra la que `informeAncho()` compara el tráfico de los
+ * kernels (`--pipeline -v`).
+ *
+ * Índices y tamaños: con N > 46 340, N·N ya no cabe en un `int`. Todas las
+ * posiciones se calculan como `(size_t) i * D + j` y las reservas en
+ * `size_t`; `compruebaHuella()` rechaza antes de reservar un N cuyas
+ * matrices no quepan en `size_t` o superen la memoria física del equipo.
+ *
+ * ---------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include "mmMemoria.h"
+#include "mmTiempo.h"
+
+/*-----------------------------------------------------------------------------
+ * paginasPorNombre — Traduce el argumento de `--pages` a MM_PAGINAS_*.
+ *
+ * Retorna -1 si el nombre no corresponde a ningún tipo.
+ *---------------------------------------------------------------------------*/
+int paginasPorNombre(const char *nombre) {
+	if (strcmp(nombre, "normal") == 0)  return MM_PAGINAS_NORMAL;
+	if (strcmp(nombre, "thp") == 0)     return MM_PAGINAS_THP;
+	if (strcmp(nombre, "hugetlb") == 0) return MM_PAGINAS_HUGETLB;
+	return -1;
+}
+
+/*-----------------------------------------------------------------------------
+ * nombrePaginas — Nombre de un tipo de páginas (para los informes).
+ *---------------------------------------------------------------------------*/
+const char *nombrePaginas(int paginas) {
+	switch (paginas) {
+		case MM_PAGINAS_THP:     return "thp";
+		case MM_PAGINAS_HUGETLB: return "hugetlb";
+		default:                 return "normal";
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * bytesReserva — Longitud real de la región de una matriz de `elems`
+ * doubles: múltiplo de 2 MiB con páginas grandes y de la página base en
+ * otro caso. `liberaMatriz()` la recalcula igual.
+ *---------------------------------------------------------------------------*/
+static size_t bytesReserva(size_t elems, int paginas) {
+	size_t unidad = (paginas == MM_PAGINAS_NORMAL) ? (size_t) sysconf(_SC_PAGESIZE) : MM_PAGINA_GRANDE;
+	size_t bytes = elems * sizeof(double);
+
+	if (bytes == 0)
+		bytes = 1;
+	return (bytes + unidad - 1) / unidad * unidad;
+}
+
+/*-----------------------------------------------------------------------------
+ * reservaAlineada — mmap de `bytes` con el inicio alineado a 2 MiB.
+ *
+ * Descripción:
+ *  Se reservan 2 MiB de más y se devuelven al sistema el trozo anterior al
+ *  primer límite de 2 MiB y el sobrante final; así toda la región puede
+ *  cubrirse con páginas grandes transparentes.
+ *---------------------------------------------------------------------------*/
+static void *reservaAlineada(size_t bytes, int visibilidad) {
+	size_t extra = bytes + MM_PAGINA_GRANDE;
+	char *base = mmap(NULL, extra, PROT_READ | PROT_WRITE, visibilidad | MAP_ANONYMOUS, -1, 0);
+
+	if (base == MAP_FAILED)
+		return MAP_FAILED;
+
+	uintptr_t dir = ((uintptr_t) base + MM_PAGINA_GRANDE - 1) & ~(uintptr_t) (MM_PAGINA_GRANDE - 1);
+	char *inicio = (char *) dir;
+	size_t antes = (size_t) (inicio - base);
+	size_t despues = extra - antes - bytes;
+
+	if (antes > 0)
+		munmap(base, antes);
+	if (despues > 0)
+		munmap(inicio + bytes, despues);
+	return inicio;
+}
+
+/*-----------------------------------------------------------------------------
+ * reservaMatriz — Reserva una matriz de `elems` doubles inicializada a cero.
+ *
+ * Parámetros:
+ *  - elems: número de elementos (N·N, o 3·N·N para una región A|B|C).
+ *  - paginas: MM_PAGINAS_*.
+ *  - compartida: 1 → MAP_SHARED (la ven los hijos de `fork()`); 0 → privada.
+ *  - precarga: 1 → escribe cada página ahora, fuera del tiempo medido.
+ *
+ * Descripción:
+ *  El resultado está alineado al menos a MM_ALINEACION bytes (a 2 MiB con
+ *  páginas grandes) y se libera con `liberaMatriz()`. Retorna NULL si la
+ *  reserva falla.
+ *---------------------------------------------------------------------------*/
+double *reservaMatriz(size_t elems, int paginas, int compartida, int precarga) {
+	int visibilidad = compartida ? MAP_SHARED : MAP_PRIVATE;
+	size_t bytes = bytesReserva(elems, paginas);
+	void *m = MAP_FAILED;
+
+	if (paginas == MM_PAGINAS_HUGETLB) {
+		m = mmap(NULL, bytes, PROT_READ | PROT_WRITE, visibilidad | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (m == MAP_FAILED) {
+			static int avisado = 0;
+			if (!avisado++)
+				fprintf(stderr, "# MAP_HUGETLB no disponible (vm.nr_hugepages); se usa thp\n");
+			paginas = MM_PAGINAS_THP;
+		}
+	}
+
+	if (m == MAP_FAILED && paginas == MM_PAGINAS_THP) {
+		m = reservaAlineada(bytes, visibilidad);
+		if (m != MAP_FAILED)
+			madvise(m, bytes, MADV_HUGEPAGE);
+	}
+
+	if (m == MAP_FAILED && paginas == MM_PAGINAS_NORMAL)
+		m = mmap(NULL, bytes, PROT_READ | PROT_WRITE, visibilidad | MAP_ANONYMOUS, -1, 0);
+
+	if (m == MAP_FAILED)
+		return NULL;
+
+	if (precarga) {
+		size_t paso = (size_t) sysconf(_SC_PAGESIZE);
+		for (size_t b = 0; b < bytes; b += paso)
+			((volatile char *) m)[b] = 0;
+	}
+	return (double *) m;
+}
+
+/*-----------------------------------------------------------------------------
+ * liberaMatriz — Libera una matriz obtenida con `reservaMatriz()` con los
+ * mismos `elems` y `paginas`.
+ *---------------------------------------------------------------------------*/
+void liberaMatriz(double *m, size_t elems, int paginas) {
+	if (m != NULL)
+		munmap(m, bytesReserva(elems, paginas));
+}
+
+/*-----------------------------------------------------------------------------
+ * informeMemoria — Muestra cómo quedó respaldada la matriz `m`.
+ *
+ * Descripción:
+ *  Busca en /proc/self/smaps la región que contiene `m` y escribe en `f` su
+ *  tamaño, la memoria residente, la parte en páginas grandes (transparentes
+ *  o hugetlb) y el tamaño de página del núcleo. Así se comprueba si
+ *  `--pages thp` surtió efecto (p. ej. shmem_enabled=never con Fork).
+ *---------------------------------------------------------------------------*/
+void informeMemoria(const char *nombre, const double *m, FILE *f) {
+	FILE *smaps = fopen("/proc/self/smaps", "r");
+	char linea[256];
+	unsigned long dir = (unsigned long) m, ini, fin;
+	int dentro = 0;
+	long tam = 0, rss = 0, grandes = 0, pagina = 0, valor;
+
+	if (smaps == NULL)
+		return;
+
+	while (fgets(linea, sizeof(linea), smaps) != NULL) {
+		/* Las cabeceras de región son "inicio-fin permisos ..." en hexadecimal */
+		if (sscanf(linea, "%lx-%lx ", &ini, &fin) == 2) {
+			if (dentro)
+				break;
+			dentro = (dir >= ini && dir < fin);
+			continue;
+		}
+		if (!dentro)
+			continue;
+		if (sscanf(linea, "Size: %ld", &valor) == 1)                 tam = valor;
+		else if (sscanf(linea, "Rss: %ld", &valor) == 1)             rss = valor;
+		else if (sscanf(linea, "AnonHugePages: %ld", &valor) == 1)   grandes += valor;
+		else if (sscanf(linea, "ShmemPmdMapped: %ld", &valor) == 1)  grandes += valor;
+		else if (sscanf(linea, "Private_Hugetlb: %ld", &valor) == 1) grandes += valor;
+		else if (sscanf(linea, "Shared_Hugetlb: %ld", &valor) == 1)  grandes += valor;
+		else if (sscanf(linea, "KernelPageSize: %ld", &valor) == 1)  pagina = valor;
+	}
+	fclose(smaps);
+
+	fprintf(f, "# memoria %s: %ld kB, residente %ld kB, en páginas grandes %ld kB, página %ld kB\n",
+	        nombre, tam, rss, grandes, pagina);
+}
+
+/*-----------------------------------------------------------------------------
+ * memoriaFisica — Bytes de memoria física del equipo (0 si no se conocen).
+ *---------------------------------------------------------------------------*/
+double memoriaFisica(void) {
+	long paginas = sysconf(_SC_PHYS_PAGES), tamPagina = sysconf(_SC_PAGESIZE);
+
+	return (paginas > 0 && tamPagina > 0) ? (double) paginas * tamPagina : 0.0;
+}
+
+/*-----------------------------------------------------------------------------
+ * cabeEnMemoria — 1 si `bytes` no supera la memoria física (o no se conoce).
+ *---------------------------------------------------------------------------*/
+int cabeEnMemoria(size_t bytes) {
+	double fisica = memoriaFisica();
+
+	return fisica == 0.0 || (double) bytes <= fisica;
+}
+
+/*-----------------------------------------------------------------------------
+ * huellaMatrices — Bytes que ocupan `matrices` matrices N×N de doubles
+ * (cada una redondeada a MM_ALINEACION), o SIZE_MAX si no caben en size_t.
+ *---------------------------------------------------------------------------*/
+size_t huellaMatrices(int N, int matrices) {
+	size_t n = (size_t) N;
+
+	if (N <= 0 || matrices <= 0 || n > SIZE_MAX / n / sizeof(double) / (size_t) (matrices + 1))
+		return SIZE_MAX;
+	return (size_t) matrices * elemsAlineados(n * n) * sizeof(double);
+}
+
+/*-----------------------------------------------------------------------------
+ * compruebaHuella — Valida que `matrices` matrices N×N quepan en memoria.
+ *
+ * Descripción:
+ *  Retorna 0 si la huella es representable y no supera la memoria física
+ *  (`sysconf(_SC_PHYS_PAGES)`); en otro caso escribe el motivo en `f` y
+ *  retorna -1. Evita que un N demasiado grande termine en un fallo de
+ *  `mmap` poco claro o, con overcommit, en el OOM killer a mitad de la
+ *  inicialización.
+ *---------------------------------------------------------------------------*/
+int compruebaHuella(int N, int matrices, FILE *f) {
+	size_t bytes = huellaMatrices(N, matrices);
+
+	if (bytes == SIZE_MAX) {
+		fprintf(f, "N=%d: %d matrices de %d×%d no caben en el espacio de direcciones\n",
+		        N, matrices, N, N);
+		return -1;
+	}
+	if (!cabeEnMemoria(bytes)) {
+		fprintf(f, "N=%d: %d matrices ocupan %.1f GiB y el equipo tiene %.1f GiB de memoria\n",
+		        N, matrices, bytes / 1073741824.0, memoriaFisica() / 1073741824.0);
+		return -1;
+	}
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * informeHuella — Huella de memoria y ancho de banda efectivo.
+ *
+ * Parámetros:
+ *  - N, matrices: dimensión y número de matrices N×N del programa.
+ *  - tiempoUs: tiempo total de las `reps` multiplicaciones.
+ *
+ * Descripción:
+ *  Escribe la huella de las matrices y el ancho de banda efectivo mínimo:
+ *  cada multiplicación debe leer A y B y escribir C al menos una vez
+ *  (3·N²·8 bytes), así que bytes / tiempo es una cota inferior del tráfico
+ *  real con memoria; la intensidad aritmética 2N³ / (24N²) = N/12 FLOP/byte
+ *  indica cuán lejos está el producto de estar limitado por memoria.
+ *---------------------------------------------------------------------------*/
+void informeHuella(int N, int matrices, double tiempoUs, int reps, FILE *f) {
+	double huella = (double) huellaMatrices(N, matrices);
+	double minimo = 3.0 * N * (double) N * sizeof(double) * reps;
+
+	fprintf(f, "# huella: %d matrices de %d×%d = %.1f MiB; tráfico mínimo %.1f MiB por multiplicación\n",
+	        matrices, N, N, huella / 1048576.0, minimo / reps / 1048576.0);
+	fprintf(f, "# ancho de banda efectivo mínimo: %.2f GB/s; intensidad aritmética %.1f FLOP/byte\n",
+	        tiempoUs > 0.0 ? minimo / (tiempoUs * 1e3) : 0.0, N / 12.0);
+}
+
+/* Elementos de cada arreglo de la tríada: 64 MiB, muy por encima de la L3 */
+#define MM_STREAM_ELEMS  (8UL * 1024 * 1024)
+#define MM_STREAM_REPS   5
+
+/*-----------------------------------------------------------------------------
+ * Trozo de la tríada de un hilo: [inicio, fin) de los tres arreglos.
+ *---------------------------------------------------------------------------*/
+struct trozoStream {
+	double *a, *b, *c;
+	size_t inicio, fin;
+	int primera;
+};
+
+static void *triadaStream(void *arg) {
+	struct trozoStream *t = arg;
+
+	/* La primera pasada es el primer toque: cada hilo ubica su trozo */
+	if (t->primera)
+		for (size_t i = t->inicio; i < t->fin; i++) {
+			t->b[i] = 1.0;
+			t->c[i] = 2.0;
+		}
+	for (size_t i = t->inicio; i < t->fin; i++)
+		t->a[i] = t->b[i] + 3.0 * t->c[i];
+	return NULL;
+}
+
+/*-----------------------------------------------------------------------------
+ * anchoStream — Pico de ancho de banda de memoria con `P` hilos, en GB/s.
+ *
+ * Descripción:
+ *  Tríada de STREAM sobre tres arreglos de MM_STREAM_ELEMS doubles
+ *  repartidos en P trozos contiguos, uno por hilo POSIX (independiente del
+ *  modelo de hilos del programa). La primera pasada toca las páginas y no
+ *  se mide; de las MM_STREAM_REPS siguientes se toma la mejor, contando
+ *  3·8 bytes por elemento como STREAM (sin la lectura por escritura de a).
+ *  El resultado se guarda para no repetir la medición. Retorna 0 si no se
+ *  pudo medir.
+ *---------------------------------------------------------------------------*/
+double anchoStream(int P) {
+	static double pico;
+	static int hilosPico;
+
+	if (P < 1)
+		P = 1;
+	if (hilosPico == P)
+		return pico;
+
+	size_t n = MM_STREAM_ELEMS;
+	double *a = reservaMatriz(n, MM_PAGINAS_NORMAL, 0, 0);
+	double *b = reservaMatriz(n, MM_PAGINAS_NORMAL, 0, 0);
+	double *c = reservaMatriz(n, MM_PAGINAS_NORMAL, 0, 0);
+	struct trozoStream *trozos = calloc(P, sizeof(*trozos));
+	pthread_t *hilos = calloc(P, sizeof(*hilos));
+	double mejor = 0.0;
+
+	if (a != NULL && b != NULL && c != NULL && trozos != NULL && hilos != NULL) {
+		for (int r = 0; r <= MM_STREAM_REPS; r++) {
+			double t0 = ahoraUs();
+			int lanzados = 0;
+
+			for (int t = 0; t < P; t++) {
+				trozos[t] = (struct trozoStream) { a, b, c, n * t / P, n * (t + 1) / P, r == 0 };
+				if (pthread_create(&hilos[t], NULL, triadaStream, &trozos[t]) != 0)
+					break;
+				lanzados++;
+			}
+			for (int t = 0; t < lanzados; t++)
+				pthread_join(hilos[t], NULL);
+
+			double t1 = ahoraUs();
+			if (lanzados < P)
+				break;
+			if (r > 0 && t1 > t0 && 3.0 * sizeof(double) * n / ((t1 - t0) * 1e3) > mejor)
+				mejor = 3.0 * sizeof(double) * n / ((t1 - t0) * 1e3);
+		}
+	}
+
+	free(hilos);
+	free(trozos);
+	liberaMatriz(c, n, MM_PAGINAS_NORMAL);
+	liberaMatriz(b, n, MM_PAGINAS_NORMAL);
+	liberaMatriz(a, n, MM_PAGINAS_NORMAL);
+	pico = mejor;
+	hilosPico = P;
+	return pico;
+}
+
+/*-----------------------------------------------------------------------------
+ * informeAncho — Ancho de banda que logra un kernel frente al pico STREAM.
+ *
+ * Parámetros:
+ *  - etiqueta: kernel al que corresponde el tráfico.
+ *  - bytes: tráfico con memoria de una multiplicación según el modelo del
+ *           kernel (p. ej. `traficoMicro()`).
+ *  - tiempoUs, reps: tiempo total de las `reps` multiplicaciones.
+ *  - P: hilos con los que se mide el pico (`anchoStream()`).
+ *---------------------------------------------------------------------------*/
+void informeAncho(const char *etiqueta, double bytes, double tiempoUs, int reps, int P, FILE *f) {
+	double logrado = tiempoUs > 0.0 ? bytes * reps / (tiempoUs * 1e3) : 0.0;
+	double pico = anchoStream(P);
+
+	fprintf(f, "# ancho de banda (%s): tráfico %.1f MiB por multiplicación, %.2f GB/s; "
+	        "pico STREAM triad (%d hilos) %.2f GB/s → %.0f %%\n",
+	        etiqueta, bytes / 1048576.0, logrado, P, pico, pico > 0.0 ? 100.0 * logrado / pico : 0.0);
+}
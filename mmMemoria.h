@@ -0,0 +1,55 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * mmMemoria.h — Reserva de matrices alineadas, con páginas normales o
+ * grandes y precarga opcional (`--pages`, `--prefault`).
+ *
+ * Todas las matrices se obtienen con `mmap`, de modo que quedan alineadas
+ * al menos a página (y por tanto a los 64 bytes de una línea de cache y de
+ * un registro AVX-512). Con páginas grandes el inicio se alinea a 2 MiB.
+ * También valida que las matrices de un N dado quepan en memoria e informa
+ * su huella y el ancho de banda efectivo de la multiplicación, y mide el
+ * pico de ancho de banda del equipo (tríada de STREAM) como referencia.
+ */
+
+#ifndef MM_MEMORIA_H
+#define MM_MEMORIA_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+/* Tipo de páginas de las matrices (`--pages`) */
+#define MM_PAGINAS_NORMAL   0   /* páginas de 4 KiB (como calloc)            */
+#define MM_PAGINAS_THP      1   /* páginas grandes transparentes (madvise)   */
+#define MM_PAGINAS_HUGETLB  2   /* páginas grandes explícitas (MAP_HUGETLB)  */
+
+/* Alineación garantizada de toda matriz y tamaño de página grande */
+#define MM_ALINEACION       64
+#define MM_PAGINA_GRANDE    (2UL * 1024 * 1024)
+
+/*-----------------------------------------------------------------------------
+ * elemsAlineados — Redondea `elems` doubles a un múltiplo de MM_ALINEACION
+ * bytes; al ubicar varias matrices en una sola región, cada una empieza así
+ * en una línea de cache propia.
+ *---------------------------------------------------------------------------*/
+static inline size_t elemsAlineados(size_t elems) {
+	size_t paso = MM_ALINEACION / sizeof(double);
+	return (elems + paso - 1) / paso * paso;
+}
+
+int paginasPorNombre(const char *nombre);
+const char *nombrePaginas(int paginas);
+
+double *reservaMatriz(size_t elems, int paginas, int compartida, int precarga);
+void liberaMatriz(double *m, size_t elems, int paginas);
+void informeMemoria(const char *nombre, const double *m, FILE *f);
+
+double memoriaFisica(void);
+int cabeEnMemoria(size_t bytes);
+size_t huellaMatrices(int N, int matrices);
+int compruebaHuella(int N, int matrices, FILE *f);
+void informeHuella(int N, int matrices, double tiempoUs, int reps, FILE *f);
+double anchoStream(int P);
+void informeAncho(const char *etiqueta, double bytes, double tiempoUs, int reps, int P, FILE *f);
+
+#endif
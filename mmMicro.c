@@ -0,0 +1,566 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * Descripción general:
+ * ---------------------------------------------------------------
+ * Kernel de multiplicación con empaquetado y micro-kernel en registros, en
+ * el estilo de GotoBLAS/BLIS.
+ *
+ * En las versiones clásicas el bucle interno `Suma += *pA * *pB` mantiene un
+ * solo acumulador escalar y recorre B con salto D, por lo que el compilador
+ * no puede vectorizarlo. Aquí:
+ *  1. Un panel KC×NC de B se copia a un buffer contiguo en tiras de NR
+ *     columnas (`empacaB()`).
+ *  2. Un bloque MC×KC de A se copia en tiras de MR filas (`empacaA()`).
+ *  3. El micro-kernel recorre k y mantiene un bloque MR×NR de C en
+ *     registros, actualizándolo con FMA: MR·NR/ancho_SIMD acumuladores.
+ *
+ * Modo en tubería (`--pipeline`, `multiFormaTuberiaEn()`): en el bucle
+ * original cada panel de B se empaqueta entero antes de multiplicarlo, y
+ * mientras se empaqueta (lecturas de memoria con poco cálculo) las unidades
+ * FMA esperan; mientras se multiplica, el bus de memoria queda ocioso. Con
+ * dos buffers de B, las tiras del panel siguiente se empaquetan
+ * intercaladas con los micro-bloques del actual, y las líneas de cada tira
+ * se piden con prefetch software una tira antes de copiarla, de modo que
+ * el tráfico de B se solapa con el cálculo.
+ *
+ * Variantes del micro-kernel (MR = 4 en todas):
+ *  - escalar: 4×4, en C portable.
+ *  - AVX2+FMA: 4×8 (8 registros ymm de acumulación).
+ *  - AVX-512: 4×16 (8 registros zmm de acumulación).
+ *
+ * Las variantes vectoriales se compilan con `__attribute__((target))`, de
+ * modo que el ejecutable se construye con las mismas CFLAGS y solo usa esas
+ * instrucciones si `kernelDetectado()` confirma que el CPU las soporta.
+ *
+ * ---------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <immintrin.h>
+#include "mmMicro.h"
+
+/* Ancho (NR) de cada variante del micro-kernel */
+static const int anchoNR[] = { 4, 8, 16 };
+static const char *nombres[] = { "escalar", "avx2", "avx512" };
+
+/*-----------------------------------------------------------------------------
+ * kernelDetectado — Mejor variante soportada por el CPU (vía cpuid).
+ *---------------------------------------------------------------------------*/
+int kernelDetectado(void) {
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+		return MM_KERNEL_AVX512;
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+		return MM_KERNEL_AVX2;
+	return MM_KERNEL_ESCALAR;
+}
+
+/*-----------------------------------------------------------------------------
+ * kernelPorNombre — Traduce el argumento de `-k` a una variante.
+ *
+ * Descripción:
+ *  Acepta "escalar", "avx2", "avx512" o "auto" (la detectada). Si la variante
+ *  pedida no está soportada por el CPU, o el nombre no existe, retorna
+ *  MM_KERNEL_NINGUNO.
+ *---------------------------------------------------------------------------*/
+int kernelPorNombre(const char *nombre) {
+	int mejor = kernelDetectado();
+
+	if (strcmp(nombre, "auto") == 0)
+		return mejor;
+
+	for (int k = MM_KERNEL_ESCALAR; k <= MM_KERNEL_AVX512; k++)
+		if (strcmp(nombre, nombres[k]) == 0)
+			return (k <= mejor) ? k : MM_KERNEL_NINGUNO;
+
+	return MM_KERNEL_NINGUNO;
+}
+
+/*-----------------------------------------------------------------------------
+ * nombreKernel — Nombre legible de una variante.
+ *---------------------------------------------------------------------------*/
+const char *nombreKernel(int kernel) {
+	return (kernel >= MM_KERNEL_ESCALAR && kernel <= MM_KERNEL_AVX512) ? nombres[kernel] : "ninguno";
+}
+
+/*-----------------------------------------------------------------------------
+ * Micro-kernels.
+ *
+ * Parámetros comunes:
+ *  - kc: profundidad del panel.
+ *  - pA: tira empaquetada de A (kc × MR, columna a columna).
+ *  - pB: tira empaquetada de B (kc × NR, fila a fila).
+ *  - C: esquina superior izquierda del bloque MR×NR de C; ldc: su salto.
+ *  - acumula: 0 → C = A·B, 1 → C += A·B.
+ *
+ * Siempre calculan un bloque completo MR×NR; los bordes los resuelve
+ * `microBorde()` con un bloque temporal.
+ *---------------------------------------------------------------------------*/
+static void microEscalar(int kc, const double *restrict pA, const double *restrict pB,
+                         double *restrict C, int ldc, int acumula) {
+	double c[MM_MR][4] = {{0}};
+
+	for (int k = 0; k < kc; k++, pA += MM_MR, pB += 4)
+		for (int r = 0; r < MM_MR; r++)
+			for (int j = 0; j < 4; j++)
+				c[r][j] += pA[r] * pB[j];
+
+	for (int r = 0; r < MM_MR; r++)
+		for (int j = 0; j < 4; j++)
+			C[r * ldc + j] = acumula ? C[r * ldc + j] + c[r][j] : c[r][j];
+}
+
+__attribute__((target("avx2,fma")))
+static void microAVX2(int kc, const double *restrict pA, const double *restrict pB,
+                      double *restrict C, int ldc, int acumula) {
+	__m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+	__m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+	__m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+	__m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+
+	for (int k = 0; k < kc; k++, pA += MM_MR, pB += 8) {
+		__m256d b0 = _mm256_loadu_pd(pB);
+		__m256d b1 = _mm256_loadu_pd(pB + 4);
+		__m256d a;
+
+		a = _mm256_broadcast_sd(pA + 0);
+		c00 = _mm256_fmadd_pd(a, b0, c00); c01 = _mm256_fmadd_pd(a, b1, c01);
+		a = _mm256_broadcast_sd(pA + 1);
+		c10 = _mm256_fmadd_pd(a, b0, c10); c11 = _mm256_fmadd_pd(a, b1, c11);
+		a = _mm256_broadcast_sd(pA + 2);
+		c20 = _mm256_fmadd_pd(a, b0, c20); c21 = _mm256_fmadd_pd(a, b1, c21);
+		a = _mm256_broadcast_sd(pA + 3);
+		c30 = _mm256_fmadd_pd(a, b0, c30); c31 = _mm256_fmadd_pd(a, b1, c31);
+	}
+
+	if (acumula) {
+		c00 = _mm256_add_pd(c00, _mm256_loadu_pd(C + 0 * ldc)); c01 = _mm256_add_pd(c01, _mm256_loadu_pd(C + 0 * ldc + 4));
+		c10 = _mm256_add_pd(c10, _mm256_loadu_pd(C + 1 * ldc)); c11 = _mm256_add_pd(c11, _mm256_loadu_pd(C + 1 * ldc + 4));
+		c20 = _mm256_add_pd(c20, _mm256_loadu_pd(C + 2 * ldc)); c21 = _mm256_add_pd(c21, _mm256_loadu_pd(C + 2 * ldc + 4));
+		c30 = _mm256_add_pd(c30, _mm256_loadu_pd(C + 3 * ldc)); c31 = _mm256_add_pd(c31, _mm256_loadu_pd(C + 3 * ldc + 4));
+	}
+	_mm256_storeu_pd(C + 0 * ldc, c00); _mm256_storeu_pd(C + 0 * ldc + 4, c01);
+	_mm256_storeu_pd(C + 1 * ldc, c10); _mm256_storeu_pd(C + 1 * ldc + 4, c11);
+	_mm256_storeu_pd(C + 2 * ldc, c20); _mm256_storeu_pd(C + 2 * ldc + 4, c21);
+	_mm256_storeu_pd(C + 3 * ldc, c30); _mm256_storeu_pd(C + 3 * ldc + 4, c31);
+}
+
+__attribute__((target("avx512f")))
+static void microAVX512(int kc, const double *restrict pA, const double *restrict pB,
+                        double *restrict C, int ldc, int acumula) {
+	__m512d c00 = _mm512_setzero_pd(), c01 = _mm512_setzero_pd();
+	__m512d c10 = _mm512_setzero_pd(), c11 = _mm512_setzero_pd();
+	__m512d c20 = _mm512_setzero_pd(), c21 = _mm512_setzero_pd();
+	__m512d c30 = _mm512_setzero_pd(), c31 = _mm512_setzero_pd();
+
+	for (int k = 0; k < kc; k++, pA += MM_MR, pB += 16) {
+		__m512d b0 = _mm512_loadu_pd(pB);
+		__m512d b1 = _mm512_loadu_pd(pB + 8);
+		__m512d a;
+
+		a = _mm512_set1_pd(pA[0]);
+		c00 = _mm512_fmadd_pd(a, b0, c00); c01 = _mm512_fmadd_pd(a, b1, c01);
+		a = _mm512_set1_pd(pA[1]);
+		c10 = _mm512_fmadd_pd(a, b0, c10); c11 = _mm512_fmadd_pd(a, b1, c11);
+		a = _mm512_set1_pd(pA[2]);
+		c20 = _mm512_fmadd_pd(a, b0, c20); c21 = _mm512_fmadd_pd(a, b1, c21);
+		a = _mm512_set1_pd(pA[3]);
+		c30 = _mm512_fmadd_pd(a, b0, c30); c31 = _mm512_fmadd_pd(a, b1, c31);
+	}
+
+	if (acumula) {
+		c00 = _mm512_add_pd(c00, _mm512_loadu_pd(C + 0 * ldc)); c01 = _mm512_add_pd(c01, _mm512_loadu_pd(C + 0 * ldc + 8));
+		c10 = _mm512_add_pd(c10, _mm512_loadu_pd(C + 1 * ldc)); c11 = _mm512_add_pd(c11, _mm512_loadu_pd(C + 1 * ldc + 8));
+		c20 = _mm512_add_pd(c20, _mm512_loadu_pd(C + 2 * ldc)); c21 = _mm512_add_pd(c21, _mm512_loadu_pd(C + 2 * ldc + 8));
+		c30 = _mm512_add_pd(c30, _mm512_loadu_pd(C + 3 * ldc)); c31 = _mm512_add_pd(c31, _mm512_loadu_pd(C + 3 * ldc + 8));
+	}
+	_mm512_storeu_pd(C + 0 * ldc, c00); _mm512_storeu_pd(C + 0 * ldc + 8, c01);
+	_mm512_storeu_pd(C + 1 * ldc, c10); _mm512_storeu_pd(C + 1 * ldc + 8, c11);
+	_mm512_storeu_pd(C + 2 * ldc, c20); _mm512_storeu_pd(C + 2 * ldc + 8, c21);
+	_mm512_storeu_pd(C + 3 * ldc, c30); _mm512_storeu_pd(C + 3 * ldc + 8, c31);
+}
+
+typedef void (*microKernel)(int, const double *, const double *, double *, int, int);
+static const microKernel micros[] = { microEscalar, microAVX2, microAVX512 };
+
+/*-----------------------------------------------------------------------------
+ * microBorde — Micro-bloque incompleto (m < MR o n < NR) en el borde de C.
+ *
+ * Descripción:
+ *  El micro-kernel escribe en un bloque temporal MR×NR y solo las m×n
+ *  posiciones válidas se copian (o suman) a C.
+ *---------------------------------------------------------------------------*/
+static void microBorde(microKernel micro, int nr, int kc, const double *pA, const double *pB,
+                       double *C, int ldc, int m, int n, int acumula) {
+	double tmp[MM_MR * 16];
+
+	micro(kc, pA, pB, tmp, nr, 0);
+	for (int r = 0; r < m; r++)
+		for (int j = 0; j < n; j++)
+			C[r * ldc + j] = acumula ? C[r * ldc + j] + tmp[r * nr + j] : tmp[r * nr + j];
+}
+
+/*-----------------------------------------------------------------------------
+ * empacaA — Copia un bloque mc×kc de A en tiras de MR filas.
+ *
+ * Descripción:
+ *  Dentro de cada tira los elementos quedan en orden k-mayor (para cada k,
+ *  las MR filas consecutivas), que es el orden en que los lee el
+ *  micro-kernel. Las filas que faltan en la última tira se rellenan con 0.
+ *---------------------------------------------------------------------------*/
+static void empacaA(const double *A, int lda, int mc, int kc, double *buf) {
+	for (int ir = 0; ir < mc; ir += MM_MR) {
+		int m = (mc - ir < MM_MR) ? mc - ir : MM_MR;
+
+		for (int k = 0; k < kc; k++)
+			for (int r = 0; r < MM_MR; r++)
+				*buf++ = (r < m) ? A[(size_t) (ir + r) * lda + k] : 0.0;
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * empacaB — Copia un panel kc×nc de B en tiras de `nr` columnas.
+ *
+ * Parámetros:
+ *  - B: esquina del panel; si `bTrans` = 1, B se recibe transpuesta y el
+ *       elemento (k, j) está en B[j·ldb + k].
+ *
+ * Descripción:
+ *  Igual que en `empacaA()`, la última tira se completa con ceros. Gracias
+ *  al empaquetado el micro-kernel lee siempre B de forma contigua, sin
+ *  importar si el programa guarda B o su transpuesta. `empacaTiraB()` copia
+ *  una sola tira (la de la columna `jr`), para poder intercalar el
+ *  empaquetado con el cálculo (`multiFormaTuberiaEn()`).
+ *---------------------------------------------------------------------------*/
+static void empacaTiraB(const double *B, int ldb, int bTrans, int kc, int nc, int nr, int jr, double *buf) {
+	int n = (nc - jr < nr) ? nc - jr : nr;
+
+	buf += (size_t) jr * kc;
+	for (int k = 0; k < kc; k++)
+		for (int j = 0; j < nr; j++) {
+			if (j >= n)
+				*buf++ = 0.0;
+			else if (bTrans)
+				*buf++ = B[(size_t) (jr + j) * ldb + k];
+			else
+				*buf++ = B[(size_t) k * ldb + jr + j];
+		}
+}
+
+static void empacaB(const double *B, int ldb, int bTrans, int kc, int nc, int nr, double *buf) {
+	for (int jr = 0; jr < nc; jr += nr)
+		empacaTiraB(B, ldb, bTrans, kc, nc, nr, jr, buf);
+}
+
+/*-----------------------------------------------------------------------------
+ * precargaTiraB — Prefetch software de las líneas de B que leerá
+ * `empacaTiraB()` para la tira que empieza en la columna `jr`.
+ *
+ * Descripción:
+ *  Sin transponer, la tira son `kc` trozos de fila de NR elementos (una o
+ *  dos líneas de cache cada uno); transpuesta, NR filas de Bᵀ de `kc`
+ *  elementos contiguos. Con localidad 0 (prefetchnta) las líneas llegan a
+ *  L1 sin desplazar de L2 el bloque empaquetado de A.
+ *---------------------------------------------------------------------------*/
+static void precargaTiraB(const double *B, int ldb, int bTrans, int kc, int nc, int nr, int jr) {
+	int n = (nc - jr < nr) ? nc - jr : nr;
+
+	if (bTrans) {
+		for (int j = 0; j < n; j++)
+			for (int k = 0; k < kc; k += 8)
+				__builtin_prefetch(B + (size_t) (jr + j) * ldb + k, 0, 0);
+	} else {
+		for (int k = 0; k < kc; k++)
+			for (int j = 0; j < n; j += 8)
+				__builtin_prefetch(B + (size_t) k * ldb + jr + j, 0, 0);
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * elemsEmpaquetado — doubles de los buffers de empaquetado (A y B) que
+ * necesita `multiFormaMicroEn()` para una región de `cols` columnas de C,
+ * con el mayor NR de las variantes.
+ *---------------------------------------------------------------------------*/
+size_t elemsEmpaquetado(int cols) {
+	int nr = anchoNR[MM_KERNEL_AVX512];
+	int nc = (cols < MM_NC) ? cols : MM_NC;
+
+	return (size_t) MM_MC * MM_KC + (size_t) MM_KC * ((nc + nr - 1) / nr * nr);
+}
+
+/*-----------------------------------------------------------------------------
+ * multiFormaMicro — C = A·B en una región de C con micro-kernel, para
+ * dimensiones y saltos de fila generales.
+ *
+ * Parámetros:
+ *  - mA: matriz A (filas de C) × K por filas, con salto `lda`.
+ *  - mB: matriz B K × (columnas de C) por filas, o su transpuesta si
+ *        `bTrans` = 1; salto `ldb` en ambos casos.
+ *  - mC: matriz resultado con salto `ldc`; solo se escribe la región
+ *        [filaI, filaF) × [colI, colF).
+ *  - K: dimensión común (columnas de A, filas de B).
+ *  - kernel: variante del micro-kernel (MM_KERNEL_*).
+ *
+ * Descripción:
+ *  Bucle de cinco niveles de GotoBLAS: jc (NC columnas) → pc (KC de
+ *  profundidad, empaca B) → ic (MC filas, empaca A) → jr (NR) → ir (MR).
+ *  Los buffers de empaquetado son propios de cada llamada, por lo que la
+ *  función puede invocarse desde varios hilos o procesos a la vez; quien la
+ *  llama muchas veces debe usar `multiFormaMicroEn()` con buffers propios.
+ *  Termina el programa si no hay memoria para los buffers.
+ *---------------------------------------------------------------------------*/
+void multiFormaMicro(const double *mA, int lda, const double *mB, int ldb, int bTrans,
+                     double *mC, int ldc, int K, int filaI, int filaF, int colI, int colF, int kernel) {
+	if (filaF <= filaI || colF <= colI)
+		return;
+
+	double *trabajo = aligned_alloc(64, sizeof(double) * elemsEmpaquetado(colF - colI));
+	if (trabajo == NULL) {
+		perror("Error al reservar los buffers de empaquetado");
+		exit(1);
+	}
+
+	multiFormaMicroEn(mA, lda, mB, ldb, bTrans, mC, ldc, K, filaI, filaF, colI, colF, kernel, trabajo);
+	free(trabajo);
+}
+
+/*-----------------------------------------------------------------------------
+ * multiFormaMicroEn — `multiFormaMicro()` con los buffers de empaquetado
+ * del llamador.
+ *
+ * Parámetros:
+ *  - trabajo: al menos `elemsEmpaquetado(colF - colI)` doubles alineados a
+ *             64 bytes, de uso exclusivo durante la llamada.
+ *
+ * Descripción:
+ *  Para quien llama al kernel muchas veces sobre bloques pequeños (la
+ *  recursión de Strassen) y no quiere reservar memoria en cada llamada.
+ *---------------------------------------------------------------------------*/
+void multiFormaMicroEn(const double *mA, int lda, const double *mB, int ldb, int bTrans,
+                       double *mC, int ldc, int K, int filaI, int filaF, int colI, int colF, int kernel,
+                       double *trabajo) {
+	if (filaF <= filaI || colF <= colI)
+		return;
+	if (kernel < MM_KERNEL_ESCALAR || kernel > MM_KERNEL_AVX512)
+		kernel = MM_KERNEL_ESCALAR;
+
+	microKernel micro = micros[kernel];
+	int nr = anchoNR[kernel];
+	double *bufA = trabajo;
+	double *bufB = trabajo + (size_t) MM_MC * MM_KC;
+
+	for (int jc = colI; jc < colF; jc += MM_NC) {
+		int nc = (colF - jc < MM_NC) ? colF - jc : MM_NC;
+
+		for (int pc = 0; pc < K; pc += MM_KC) {
+			int kc = (K - pc < MM_KC) ? K - pc : MM_KC;
+			int acumula = (pc > 0);
+			const double *panelB = bTrans ? mB + (size_t) jc * ldb + pc : mB + (size_t) pc * ldb + jc;
+
+			empacaB(panelB, ldb, bTrans, kc, nc, nr, bufB);
+
+			for (int ic = filaI; ic < filaF; ic += MM_MC) {
+				int mc = (filaF - ic < MM_MC) ? filaF - ic : MM_MC;
+
+				empacaA(mA + (size_t) ic * lda + pc, lda, mc, kc, bufA);
+
+				for (int jr = 0; jr < nc; jr += nr) {
+					int n = (nc - jr < nr) ? nc - jr : nr;
+
+					for (int ir = 0; ir < mc; ir += MM_MR) {
+						int m = (mc - ir < MM_MR) ? mc - ir : MM_MR;
+						const double *pA = bufA + (size_t) ir * kc;
+						const double *pB = bufB + (size_t) jr * kc;
+						double *C = mC + (size_t) (ic + ir) * ldc + jc + jr;
+
+						if (m == MM_MR && n == nr)
+							micro(kc, pA, pB, C, ldc, acumula);
+						else
+							microBorde(micro, nr, kc, pA, pB, C, ldc, m, n, acumula);
+					}
+				}
+			}
+		}
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * Panel de B del recorrido jc → pc: columnas [jc, jc+nc) de C y
+ * profundidad [pc, pc+kc).
+ *---------------------------------------------------------------------------*/
+struct panelB {
+	int jc, nc, pc, kc;
+};
+
+/*-----------------------------------------------------------------------------
+ * siguientePanel — Panel que sigue a `p` en el orden de los bucles jc → pc.
+ * Retorna 0 si `p` es el último.
+ *---------------------------------------------------------------------------*/
+static int siguientePanel(const struct panelB *p, int K, int colF, struct panelB *sig) {
+	*sig = *p;
+	sig->pc += MM_KC;
+	if (sig->pc >= K) {
+		sig->pc = 0;
+		sig->jc += MM_NC;
+		if (sig->jc >= colF)
+			return 0;
+	}
+	sig->nc = (colF - sig->jc < MM_NC) ? colF - sig->jc : MM_NC;
+	sig->kc = (K - sig->pc < MM_KC) ? K - sig->pc : MM_KC;
+	return 1;
+}
+
+/*-----------------------------------------------------------------------------
+ * elemsTuberia — doubles de los buffers de `multiFormaTuberiaEn()` para una
+ * región de `cols` columnas de C: el bloque de A y dos paneles de B.
+ *---------------------------------------------------------------------------*/
+size_t elemsTuberia(int cols) {
+	return elemsEmpaquetado(cols) + (elemsEmpaquetado(cols) - (size_t) MM_MC * MM_KC);
+}
+
+/*-----------------------------------------------------------------------------
+ * multiFormaTuberia — `multiFormaTuberiaEn()` con buffers propios de la
+ * llamada, como `multiFormaMicro()` (y como ella, termina el programa si no
+ * hay memoria).
+ *---------------------------------------------------------------------------*/
+void multiFormaTuberia(const double *mA, int lda, const double *mB, int ldb, int bTrans,
+                       double *mC, int ldc, int K, int filaI, int filaF, int colI, int colF, int kernel) {
+	if (filaF <= filaI || colF <= colI)
+		return;
+
+	double *trabajo = aligned_alloc(64, sizeof(double) * elemsTuberia(colF - colI));
+	if (trabajo == NULL) {
+		perror("Error al reservar los buffers de la tubería");
+		exit(1);
+	}
+
+	multiFormaTuberiaEn(mA, lda, mB, ldb, bTrans, mC, ldc, K, filaI, filaF, colI, colF, kernel, trabajo);
+	free(trabajo);
+}
+
+/*-----------------------------------------------------------------------------
+ * multiFormaTuberiaEn — `multiFormaMicroEn()` con el empaquetado de B en
+ * tubería.
+ *
+ * Parámetros:
+ *  - los de `multiFormaMicroEn()`; `trabajo` debe tener al menos
+ *    `elemsTuberia(colF - colI)` doubles alineados a 64 bytes.
+ *
+ * Descripción:
+ *  Solo el primer panel de B se empaqueta antes de empezar. Mientras se
+ *  multiplica el panel p (buffer s), después de cada tira jr de cada bloque
+ *  ic se empaquetan en el buffer 1-s las tiras del panel p+1 que tocan para
+ *  avanzar al mismo ritmo (tiras_siguiente · pasos_hechos / pasos), y se
+ *  pide con prefetch la tira que viene después. Al terminar el panel p el
+ *  siguiente ya está completo y los buffers se intercambian. El orden de
+ *  las sumas es el de `multiFormaMicroEn()`, así que C es idéntica.
+ *---------------------------------------------------------------------------*/
+void multiFormaTuberiaEn(const double *mA, int lda, const double *mB, int ldb, int bTrans,
+                         double *mC, int ldc, int K, int filaI, int filaF, int colI, int colF, int kernel,
+                         double *trabajo) {
+	if (filaF <= filaI || colF <= colI)
+		return;
+	if (kernel < MM_KERNEL_ESCALAR || kernel > MM_KERNEL_AVX512)
+		kernel = MM_KERNEL_ESCALAR;
+
+	microKernel micro = micros[kernel];
+	int nr = anchoNR[kernel];
+	size_t eB = elemsEmpaquetado(colF - colI) - (size_t) MM_MC * MM_KC;
+	double *bufA = trabajo;
+	double *bufB[2] = { trabajo + (size_t) MM_MC * MM_KC, trabajo + (size_t) MM_MC * MM_KC + eB };
+	int bloquesIc = (filaF - filaI + MM_MC - 1) / MM_MC;
+	struct panelB act = { colI, 0, 0, 0 }, sig;
+	int s = 0, hay = 1;
+
+	act.nc = (colF - colI < MM_NC) ? colF - colI : MM_NC;
+	act.kc = (K < MM_KC) ? K : MM_KC;
+
+#define MM_ORIGEN_B(p) (bTrans ? mB + (size_t) (p).jc * ldb + (p).pc : mB + (size_t) (p).pc * ldb + (p).jc)
+
+	empacaB(MM_ORIGEN_B(act), ldb, bTrans, act.kc, act.nc, nr, bufB[0]);
+
+	while (hay) {
+		int haySig = siguientePanel(&act, K, colF, &sig);
+		const double *origenSig = haySig ? MM_ORIGEN_B(sig) : NULL;
+		int tirasSig = haySig ? (sig.nc + nr - 1) / nr : 0;
+		int pasos = bloquesIc * ((act.nc + nr - 1) / nr), paso = 0, empacadas = 0;
+		int acumula = (act.pc > 0);
+
+		if (haySig)
+			precargaTiraB(origenSig, ldb, bTrans, sig.kc, sig.nc, nr, 0);
+
+		for (int ic = filaI; ic < filaF; ic += MM_MC) {
+			int mc = (filaF - ic < MM_MC) ? filaF - ic : MM_MC;
+
+			empacaA(mA + (size_t) ic * lda + act.pc, lda, mc, act.kc, bufA);
+
+			for (int jr = 0; jr < act.nc; jr += nr) {
+				int n = (act.nc - jr < nr) ? act.nc - jr : nr;
+
+				for (int ir = 0; ir < mc; ir += MM_MR) {
+					int m = (mc - ir < MM_MR) ? mc - ir : MM_MR;
+					const double *pA = bufA + (size_t) ir * act.kc;
+					const double *pB = bufB[s] + (size_t) jr * act.kc;
+					double *C = mC + (size_t) (ic + ir) * ldc + act.jc + jr;
+
+					if (m == MM_MR && n == nr)
+						micro(act.kc, pA, pB, C, ldc, acumula);
+					else
+						microBorde(micro, nr, act.kc, pA, pB, C, ldc, m, n, acumula);
+				}
+
+				/* Etapa de precarga: tiras del panel siguiente */
+				int objetivo = (int) (((long) tirasSig * ++paso + pasos - 1) / pasos);
+				for (; empacadas < objetivo; empacadas++) {
+					if (empacadas + 1 < tirasSig)
+						precargaTiraB(origenSig, ldb, bTrans, sig.kc, sig.nc, nr, (empacadas + 1) * nr);
+					empacaTiraB(origenSig, ldb, bTrans, sig.kc, sig.nc, nr, empacadas * nr, bufB[1 - s]);
+				}
+			}
+		}
+
+		act = sig;
+		s = 1 - s;
+		hay = haySig;
+	}
+#undef MM_ORIGEN_B
+}
+
+/*-----------------------------------------------------------------------------
+ * traficoMicro — Bytes que mueve entre la memoria y la cache el kernel
+ * empaquetado en una región m×n de C con profundidad K.
+ *
+ * Descripción:
+ *  Modelo del recorrido jc → pc → ic, suponiendo que los buffers
+ *  empaquetados caben en cache: B se lee una vez (K·n), A una vez por cada
+ *  bloque de NC columnas, y C se escribe en el primer panel de K y se lee y
+ *  escribe en cada uno de los demás.
+ *---------------------------------------------------------------------------*/
+double traficoMicro(int m, int n, int K) {
+	double bloquesNc = (n + MM_NC - 1) / MM_NC, panelesKc = (K + MM_KC - 1) / MM_KC;
+
+	return sizeof(double) * ((double) K * n + (double) m * K * bloquesNc
+	                         + (double) m * n * (2.0 * panelesKc - 1.0));
+}
+
+/*-----------------------------------------------------------------------------
+ * multiMatrixMicro — C = A·B en una región de C con micro-kernel.
+ *
+ * Parámetros:
+ *  - mA: matriz A D×D (por filas).
+ *  - mB: matriz B (por filas) o su transpuesta si `bTrans` = 1.
+ *  - mC: matriz resultado; solo se escribe la región
+ *        [filaI, filaF) × [colI, colF).
+ *  - D: dimensión de las matrices.
+ *  - kernel: variante del micro-kernel (MM_KERNEL_*).
+ *
+ * Descripción:
+ *  Caso cuadrado de `multiFormaMicro()`.
+ *---------------------------------------------------------------------------*/
+void multiMatrixMicro(const double *mA, const double *mB, int bTrans, double *mC, int D,
+                      int filaI, int filaF, int colI, int colF, int kernel) {
+	multiFormaMicro(mA, D, mB, D, bTrans, mC, D, D, filaI, filaF, colI, colF, kernel);
+}
@@ -0,0 +1,50 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * mmMicro.h — Multiplicación estilo GotoBLAS/BLIS: empaquetado de paneles de
+ * A y B y un micro-kernel que calcula un bloque MR×NR de C en registros.
+ *
+ * Hay tres variantes del micro-kernel (escalar, AVX2+FMA y AVX-512). La
+ * variante se elige al iniciar según `cpuid` o se fuerza con `-k`. El modo
+ * en tubería (`--pipeline`) empaqueta el panel siguiente de B con doble
+ * buffer mientras multiplica el actual.
+ */
+
+#ifndef MM_MICRO_H
+#define MM_MICRO_H
+
+#include <stddef.h>
+
+/* Variantes del micro-kernel */
+#define MM_KERNEL_NINGUNO  -1
+#define MM_KERNEL_ESCALAR   0
+#define MM_KERNEL_AVX2      1
+#define MM_KERNEL_AVX512    2
+
+/* Tamaños de bloque del macro-kernel (en elementos) */
+#define MM_MR   4       /* filas del micro-bloque de C             */
+#define MM_MC   96      /* filas de A empaquetadas (cabe en L2)    */
+#define MM_KC   256     /* profundidad del panel (cabe en L1)      */
+#define MM_NC   2048    /* columnas de B empaquetadas (cabe en L3) */
+
+int kernelDetectado(void);
+int kernelPorNombre(const char *nombre);
+const char *nombreKernel(int kernel);
+
+void multiMatrixMicro(const double *mA, const double *mB, int bTrans, double *mC, int D,
+                      int filaI, int filaF, int colI, int colF, int kernel);
+void multiFormaMicro(const double *mA, int lda, const double *mB, int ldb, int bTrans,
+                     double *mC, int ldc, int K, int filaI, int filaF, int colI, int colF, int kernel);
+size_t elemsEmpaquetado(int cols);
+void multiFormaMicroEn(const double *mA, int lda, const double *mB, int ldb, int bTrans,
+                       double *mC, int ldc, int K, int filaI, int filaF, int colI, int colF, int kernel,
+                       double *trabajo);
+size_t elemsTuberia(int cols);
+void multiFormaTuberia(const double *mA, int lda, const double *mB, int ldb, int bTrans,
+                       double *mC, int ldc, int K, int filaI, int filaF, int colI, int colF, int kernel);
+void multiFormaTuberiaEn(const double *mA, int lda, const double *mB, int ldb, int bTrans,
+                         double *mC, int ldc, int K, int filaI, int filaF, int colI, int colF, int kernel,
+                         double *trabajo);
+double traficoMicro(int m, int n, int K);
+
+#endif
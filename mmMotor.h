@@ -0,0 +1,52 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * mmMotor.h — Interfaz común de las versiones ("motores") para el binario
+ * único `mm`.
+ *
+ * Cada programa (mmClasicaFork.c, mmClasicaPosix.c, mmClasicaOpenMP.c,
+ * mmFilasOpenMP.c, mmStrassenOpenMP.c, mmSummaProcesos.c y
+ * mmDispersaOpenMP.c) exporta un `struct motor` y usa esas mismas funciones
+ * en su propio `main()`. Al compilar con -DMM_BINARIO_UNICO se omiten los
+ * `main()` y mm.c enlaza los motores en un solo ejecutable, que selecciona
+ * con `--engine` y recorre N × P × motor sobre las mismas matrices de
+ * entrada.
+ */
+
+#ifndef MM_MOTOR_H
+#define MM_MOTOR_H
+
+#include "mmComun.h"
+#include "mmTiempo.h"
+
+/*-----------------------------------------------------------------------------
+ * Motor de multiplicación:
+ *  - nombre: nombre para `--engine` (fork, posix, openmp, filas, strassen,
+ *            summa, dispersa).
+ *  - iniciar: prepara el motor para op->N y op->P (hilos, pool, afinidad) y
+ *             guarda `m` para las marcas de tiempo. Retorna 0 si todo va bien.
+ *  - multiplicar: calcula C = A·B con A, B y C ya reservadas e inicializadas
+ *                 (C en memoria compartida para el motor Fork) y retorna el
+ *                 tiempo de la multiplicación en µs.
+ *  - terminar: libera lo creado por `iniciar()` y `multiplicar()`.
+ *  - general: 1 si admite el producto general, los tipos y los lotes
+ *             (`--shape`, `--pad`, `--type`, `--batch`); con "todos" se
+ *             omiten los que no.
+ *---------------------------------------------------------------------------*/
+struct motor {
+	const char *nombre;
+	int (*iniciar)(const struct opciones *op, struct medicion *m);
+	double (*multiplicar)(const struct opciones *op, const double *mA, const double *mB, double *mC);
+	void (*terminar)(const struct opciones *op);
+	int general;
+};
+
+extern const struct motor motorFork;
+extern const struct motor motorPosix;
+extern const struct motor motorOpenMP;
+extern const struct motor motorFilas;
+extern const struct motor motorStrassen;
+extern const struct motor motorSumma;
+extern const struct motor motorDispersa;
+
+#endif
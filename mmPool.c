@@ -0,0 +1,137 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * Descripción general:
+ * ---------------------------------------------------------------
+ * Grupo persistente de hilos para la versión Pthreads.
+ *
+ * La versión original crea y une `n_threads` hilos (y reserva una estructura
+ * de parámetros por hilo) en cada multiplicación, dentro del intervalo
+ * medido; para N=100 o N=200 ese costo domina el tiempo. Aquí los hilos se
+ * crean una vez y esperan en una barrera:
+ *
+ *   principal:  tarea = f ── barrera(inicio) ── f(0) ── barrera(fin)
+ *   hilo i:          ... ── barrera(inicio) ── f(i) ── barrera(fin) ── ...
+ *
+ * La barrera de inicio publica `tarea`/`arg` a todos los hilos y la de fin
+ * garantiza que al retornar `ejecutaPool()` todos los resultados son
+ * visibles para el hilo principal. Los hilos no llegan a las barreras
+ * hasta que `iniPool()` los ha creado todos: si falla la creación de uno,
+ * los ya creados salen sin quedar bloqueados en una barrera incompleta.
+ *
+ * ---------------------------------------------------------------
+ */
+
+#include <stdlib.h>
+#include "mmPool.h"
+
+struct argHilo {
+	struct pool *pl;
+	int idH;
+};
+
+/*-----------------------------------------------------------------------------
+ * cicloHilo — Bucle de cada trabajador del pool (idH ≥ 1).
+ *---------------------------------------------------------------------------*/
+static void *cicloHilo(void *variables) {
+	struct argHilo datos = *(struct argHilo *) variables;
+	struct pool *pl = datos.pl;
+
+	free(variables);
+
+	/* Espera a que iniPool() termine de crear los hilos */
+	pthread_mutex_lock(&pl->arranque);
+	pthread_mutex_unlock(&pl->arranque);
+	if (pl->terminar)
+		return NULL;
+
+	for (;;) {
+		pthread_barrier_wait(&pl->inicio);
+		if (pl->terminar)
+			break;
+		pl->tarea(datos.idH, pl->arg);
+		pthread_barrier_wait(&pl->fin);
+	}
+	return NULL;
+}
+
+/*-----------------------------------------------------------------------------
+ * iniPool — Crea los nH-1 hilos del pool.
+ *
+ * Retorna 0 si todo fue bien y -1 si no se pudieron crear los hilos; en ese
+ * caso los hilos ya creados terminan y se unen, y el pool queda liberado.
+ *---------------------------------------------------------------------------*/
+int iniPool(struct pool *pl, int nH) {
+	pl->nH = (nH > 0) ? nH : 1;
+	pl->terminar = 0;
+	pl->tarea = NULL;
+	pl->arg = NULL;
+	pl->hilos = malloc(sizeof(pthread_t) * pl->nH);
+	if (pl->hilos == NULL)
+		return -1;
+
+	pthread_barrier_init(&pl->inicio, NULL, pl->nH);
+	pthread_barrier_init(&pl->fin, NULL, pl->nH);
+	pthread_mutex_init(&pl->arranque, NULL);
+	pthread_mutex_lock(&pl->arranque);
+
+	int creados = 1;
+	for (; creados < pl->nH; creados++) {
+		struct argHilo *datos = malloc(sizeof(struct argHilo));
+		if (datos == NULL)
+			break;
+		datos->pl = pl;
+		datos->idH = creados;
+		if (pthread_create(&pl->hilos[creados], NULL, cicloHilo, datos) != 0) {
+			free(datos);
+			break;
+		}
+	}
+
+	/* Si faltó alguno, los creados salen en cuanto se libera `arranque`,
+	 * sin tocar las barreras */
+	pl->terminar = (creados < pl->nH);
+	pthread_mutex_unlock(&pl->arranque);
+	if (!pl->terminar)
+		return 0;
+
+	for (int j = 1; j < creados; j++)
+		pthread_join(pl->hilos[j], NULL);
+	pthread_barrier_destroy(&pl->inicio);
+	pthread_barrier_destroy(&pl->fin);
+	pthread_mutex_destroy(&pl->arranque);
+	free(pl->hilos);
+	pl->hilos = NULL;
+	return -1;
+}
+
+/*-----------------------------------------------------------------------------
+ * ejecutaPool — Ejecuta `tarea(idH, arg)` en todos los trabajadores.
+ *
+ * Descripción:
+ *  El hilo que llama ejecuta la parte del trabajador 0 y retorna cuando
+ *  todos han terminado. No reserva memoria ni crea hilos.
+ *---------------------------------------------------------------------------*/
+void ejecutaPool(struct pool *pl, tareaPool tarea, void *arg) {
+	pl->tarea = tarea;
+	pl->arg = arg;
+	pthread_barrier_wait(&pl->inicio);
+	tarea(0, arg);
+	pthread_barrier_wait(&pl->fin);
+}
+
+/*-----------------------------------------------------------------------------
+ * finPool — Despierta a los hilos para que terminen y los une.
+ *---------------------------------------------------------------------------*/
+void finPool(struct pool *pl) {
+	pl->terminar = 1;
+	pthread_barrier_wait(&pl->inicio);
+
+	for (int j = 1; j < pl->nH; j++)
+		pthread_join(pl->hilos[j], NULL);
+
+	pthread_barrier_destroy(&pl->inicio);
+	pthread_barrier_destroy(&pl->fin);
+	pthread_mutex_destroy(&pl->arranque);
+	free(pl->hilos);
+}
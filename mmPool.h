@@ -0,0 +1,42 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * mmPool.h — Grupo persistente de hilos POSIX (thread pool).
+ *
+ * Los hilos se crean una sola vez con `iniPool()` y ejecutan cualquier
+ * número de tareas con `ejecutaPool()`, sin crear hilos ni reservar memoria
+ * en cada llamada. El hilo que llama participa como trabajador 0.
+ */
+
+#ifndef MM_POOL_H
+#define MM_POOL_H
+
+#include <pthread.h>
+
+typedef void (*tareaPool)(int idH, void *arg);
+
+/*-----------------------------------------------------------------------------
+ * Estructura del pool:
+ *  - nH: número total de trabajadores (incluido el hilo que llama).
+ *  - hilos: identificadores de los nH-1 hilos creados.
+ *  - inicio, fin: barreras de arranque y terminación de cada tarea.
+ *  - arranque: lo retiene `iniPool()` mientras crea los hilos; ningún hilo
+ *              llega a las barreras antes de que existan todos.
+ *  - tarea, arg: tarea en curso y su argumento.
+ *  - terminar: 1 cuando los hilos deben salir (`finPool()`).
+ *---------------------------------------------------------------------------*/
+struct pool {
+	int nH;
+	pthread_t *hilos;
+	pthread_barrier_t inicio, fin;
+	pthread_mutex_t arranque;
+	tareaPool tarea;
+	void *arg;
+	int terminar;
+};
+
+int iniPool(struct pool *pl, int nH);
+void ejecutaPool(struct pool *pl, tareaPool tarea, void *arg);
+void finPool(struct pool *pl);
+
+#endif
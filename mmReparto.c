@@ -0,0 +1,125 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * Descripción general:
+ * ---------------------------------------------------------------
+ * Capa de reparto de trabajo para la versión con hilos POSIX.
+ *
+ * El reparto original `filaI = (D / nH) * idH`, `filaF = (D / nH) * (idH + 1)`
+ * pierde las últimas `D % nH` filas cuando N no es divisible por el número de
+ * hilos: el tiempo medido corresponde a un producto incompleto. Este módulo
+ * garantiza que cada fila se asigne exactamente una vez con cualquiera de las
+ * tres políticas.
+ *
+ * Uso desde cada hilo:
+ *
+ *     int turno = 0, ini, fin;
+ *     while (siguienteRango(&rep, idH, &turno, &ini, &fin))
+ *         ... calcular filas [ini, fin) ...
+ *
+ * ---------------------------------------------------------------
+ */
+
+#include <string.h>
+#include "mmReparto.h"
+
+static const char *nombres[] = { "estatico", "dinamico", "guiado", "robo" };
+
+/*-----------------------------------------------------------------------------
+ * repartoPorNombre — Traduce el argumento de `-s` a una política.
+ *
+ * Retorna -1 si el nombre no corresponde a ninguna política.
+ *---------------------------------------------------------------------------*/
+int repartoPorNombre(const char *nombre) {
+	for (int t = MM_REPARTO_ESTATICO; t <= MM_REPARTO_ROBO; t++)
+		if (strcmp(nombre, nombres[t]) == 0)
+			return t;
+	return -1;
+}
+
+/*-----------------------------------------------------------------------------
+ * nombreReparto — Nombre legible de una política.
+ *---------------------------------------------------------------------------*/
+const char *nombreReparto(int tipo) {
+	return (tipo >= MM_REPARTO_ESTATICO && tipo <= MM_REPARTO_ROBO) ? nombres[tipo] : "?";
+}
+
+/*-----------------------------------------------------------------------------
+ * iniReparto — Prepara el reparto de `total` filas entre `nH` hilos.
+ *
+ * Debe llamarse antes de crear los hilos (o de cada nueva multiplicación).
+ * El trozo se limita a `total`: un trozo mayor no cambia el reparto.
+ *---------------------------------------------------------------------------*/
+void iniReparto(struct reparto *r, int tipo, int total, int nH, int trozo) {
+	r->tipo  = tipo;
+	r->total = total;
+	r->nH    = (nH > 0) ? nH : 1;
+	r->trozo = (trozo > 0) ? trozo : 1;
+	if (r->trozo > total && total > 0)
+		r->trozo = total;
+	atomic_store(&r->siguiente, 0);
+}
+
+/*-----------------------------------------------------------------------------
+ * rangoEstatico — Rango contiguo balanceado del hilo `idH`.
+ *
+ * Descripción:
+ *  Los primeros `total % nH` hilos reciben una fila más que el resto, de modo
+ *  que los rangos cubren [0, total) sin huecos y difieren en a lo sumo 1.
+ *---------------------------------------------------------------------------*/
+void rangoEstatico(int total, int nH, int idH, int *ini, int *fin) {
+	int base  = total / nH;
+	int extra = total % nH;
+
+	*ini = idH * base + (idH < extra ? idH : extra);
+	*fin = *ini + base + (idH < extra ? 1 : 0);
+}
+
+/*-----------------------------------------------------------------------------
+ * siguienteRango — Entrega al hilo `idH` su siguiente rango de filas.
+ *
+ * Parámetros:
+ *  - r: reparto compartido.
+ *  - idH: identificador del hilo (0 .. nH-1).
+ *  - turno: estado privado del hilo; debe valer 0 en la primera llamada.
+ *  - ini, fin: rango asignado [ini, fin).
+ *
+ * Retorna 1 si se asignó un rango y 0 cuando ya no queda trabajo.
+ *
+ * Descripción:
+ *  - estatico: un único rango por hilo (`rangoEstatico()`).
+ *  - dinamico: reserva `trozo` filas (o las que queden).
+ *  - guiado: reserva max(trozo, restantes / (2·nH)) filas, de modo que los
+ *    trozos decrecen hacia el final y los últimos hilos en terminar esperan
+ *    poco.
+ *  Ambas reservan con un ciclo compare-and-swap que no avanza `siguiente`
+ *  más allá de `total`, así que el contador no se desborda aunque los hilos
+ *  sigan pidiendo trabajo al terminar.
+ *---------------------------------------------------------------------------*/
+int siguienteRango(struct reparto *r, int idH, int *turno, int *ini, int *fin) {
+	int actual, tam;
+
+	switch (r->tipo) {
+		case MM_REPARTO_DINAMICO:
+		case MM_REPARTO_GUIADO:
+			actual = atomic_load(&r->siguiente);
+			do {
+				if (actual >= r->total)
+					return 0;
+				tam = r->trozo;
+				if (r->tipo == MM_REPARTO_GUIADO && (r->total - actual) / (2 * r->nH) > tam)
+					tam = (r->total - actual) / (2 * r->nH);
+				if (tam > r->total - actual)
+					tam = r->total - actual;
+			} while (!atomic_compare_exchange_weak(&r->siguiente, &actual, actual + tam));
+			*ini = actual;
+			*fin = actual + tam;
+			return 1;
+
+		default:
+			if ((*turno)++ > 0)
+				return 0;
+			rangoEstatico(r->total, r->nH, idH, ini, fin);
+			return *fin > *ini;
+	}
+}
@@ -0,0 +1,47 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * mmReparto.h — Reparto de filas de C entre hilos (versión Pthreads).
+ *
+ * Tres políticas, elegidas en tiempo de ejecución con `-s`:
+ *  - estatico: un rango contiguo por hilo, balanceado (difieren en ≤ 1 fila).
+ *  - dinamico: cola de trozos de tamaño fijo tomados con un contador atómico.
+ *  - guiado:   como dinámico, pero el trozo es proporcional a lo que falta.
+ *  - robo:     teselas 2-D con robo de trabajo; lo implementa mmRobo.c y no
+ *              pasa por `siguienteRango()`.
+ */
+
+#ifndef MM_REPARTO_H
+#define MM_REPARTO_H
+
+#include <stdatomic.h>
+
+#define MM_REPARTO_ESTATICO  0
+#define MM_REPARTO_DINAMICO  1
+#define MM_REPARTO_GUIADO    2
+#define MM_REPARTO_ROBO      3
+
+/*-----------------------------------------------------------------------------
+ * Estructura de reparto (compartida por todos los hilos):
+ *  - tipo: política MM_REPARTO_*.
+ *  - total: número de filas a repartir.
+ *  - nH: número de hilos.
+ *  - trozo: tamaño (mínimo, en guiado) de cada trozo de filas.
+ *  - siguiente: primera fila aún no asignada (dinámico y guiado).
+ *---------------------------------------------------------------------------*/
+struct reparto {
+	int tipo;
+	int total;
+	int nH;
+	int trozo;
+	atomic_int siguiente;
+};
+
+int repartoPorNombre(const char *nombre);
+const char *nombreReparto(int tipo);
+
+void iniReparto(struct reparto *r, int tipo, int total, int nH, int trozo);
+void rangoEstatico(int total, int nH, int idH, int *ini, int *fin);
+int siguienteRango(struct reparto *r, int idH, int *turno, int *ini, int *fin);
+
+#endif
@@ -0,0 +1,217 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * Descripción general:
+ * ---------------------------------------------------------------
+ * Planificador con robo de trabajo sobre teselas 2-D de la matriz C.
+ *
+ * Con un bloque contiguo de filas por hilo, un hilo retrasado (núcleo
+ * ocupado o compartido por SMT) fija el tiempo total, lo que se ve como
+ * varianza alta entre las 30 repeticiones de los CSV. Aquí C se divide en
+ * teselas de tam×tam, numeradas por filas, y cada hilo recibe un rango
+ * contiguo balanceado como cola inicial (conserva la localidad del reparto
+ * estático). Quien termina roba teselas de otros hilos elegidos al azar.
+ *
+ * Colas: como todas las teselas se conocen al inicio, cada cola es solo un
+ * par de índices atómicos [tope, fondo). El dueño extrae del fondo y los
+ * ladrones del tope con el protocolo de Chase-Lev (sin inserciones); la
+ * única carrera, por la última tesela, se resuelve con compare-and-swap
+ * sobre `tope`.
+ *
+ * ---------------------------------------------------------------
+ */
+
+#include <stdlib.h>
+#include <time.h>
+#include "mmRobo.h"
+#include "mmReparto.h"
+
+/*-----------------------------------------------------------------------------
+ * ahoraNs — Reloj monotónico en nanosegundos.
+ *---------------------------------------------------------------------------*/
+static long long ahoraNs(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/*-----------------------------------------------------------------------------
+ * iniRobo — Reserva las colas y estadísticas para `nH` hilos.
+ *
+ * Retorna 0 si todo fue bien y -1 si falla la reserva de memoria. Una
+ * tesela mayor que D se recorta a D (una sola tesela).
+ *---------------------------------------------------------------------------*/
+int iniRobo(struct robo *rb, int D, int nH, int tam) {
+	rb->D = D;
+	rb->tam = (tam > 0) ? tam : 1;
+	if (rb->tam > D && D > 0)
+		rb->tam = D;
+	rb->nH = (nH > 0) ? nH : 1;
+	rb->teselasCol = (D + rb->tam - 1) / rb->tam;
+	rb->total = rb->teselasCol * rb->teselasCol;
+	rb->colas = aligned_alloc(64, sizeof(struct colaRobo) * rb->nH);
+	rb->estad = aligned_alloc(64, sizeof(struct estadRobo) * rb->nH);
+	if (rb->colas == NULL || rb->estad == NULL)
+		return -1;
+
+	reiniciaRobo(rb);
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * reiniciaRobo — Reparte de nuevo todas las teselas y limpia estadísticas.
+ *
+ * Descripción:
+ *  Debe llamarse antes de cada multiplicación, cuando ningún hilo está
+ *  trabajando. No reserva memoria.
+ *---------------------------------------------------------------------------*/
+void reiniciaRobo(struct robo *rb) {
+	for (int h = 0; h < rb->nH; h++) {
+		int ini, fin;
+
+		rangoEstatico(rb->total, rb->nH, h, &ini, &fin);
+		atomic_store(&rb->colas[h].tope, ini);
+		atomic_store(&rb->colas[h].fondo, fin);
+
+		rb->estad[h].teselas = rb->estad[h].robos = rb->estad[h].fallidos = 0;
+		rb->estad[h].busqueda = rb->estad[h].final = 0;
+	}
+	rb->inicio = ahoraNs();
+}
+
+/*-----------------------------------------------------------------------------
+ * extraePropia — El dueño toma una tesela del fondo de su cola.
+ *
+ * Retorna el identificador de la tesela o -1 si la cola está vacía.
+ *---------------------------------------------------------------------------*/
+static int extraePropia(struct colaRobo *q) {
+	int b = atomic_load(&q->fondo) - 1;
+	atomic_store(&q->fondo, b);
+	int t = atomic_load(&q->tope);
+
+	if (t > b) {
+		atomic_store(&q->fondo, b + 1);
+		return -1;
+	}
+	if (t == b) {
+		/* última tesela: compite con los ladrones */
+		int gana = atomic_compare_exchange_strong(&q->tope, &t, t + 1);
+		atomic_store(&q->fondo, b + 1);
+		return gana ? b : -1;
+	}
+	return b;
+}
+
+/*-----------------------------------------------------------------------------
+ * roba — Un ladrón intenta tomar la tesela del tope de la cola `q`.
+ *
+ * Retorna el identificador de la tesela, -1 si la cola está vacía o -2 si
+ * otro hilo ganó la carrera (vale la pena reintentar).
+ *---------------------------------------------------------------------------*/
+static int roba(struct colaRobo *q) {
+	int t = atomic_load(&q->tope);
+	int b = atomic_load(&q->fondo);
+
+	if (t >= b)
+		return -1;
+	return atomic_compare_exchange_strong(&q->tope, &t, t + 1) ? t : -2;
+}
+
+/*-----------------------------------------------------------------------------
+ * siguienteTesela — Entrega al hilo `idH` la siguiente tesela a calcular.
+ *
+ * Parámetros:
+ *  - rb: planificador compartido.
+ *  - idH: identificador del hilo.
+ *  - semilla: estado privado del generador para elegir víctimas.
+ *  - filaI, filaF, colI, colF: región de C de la tesela.
+ *
+ * Retorna 1 si hay tesela y 0 cuando no queda trabajo en ninguna cola.
+ *
+ * Descripción:
+ *  Primero se vacía la cola propia. Luego se recorren las demás colas
+ *  empezando por una víctima aleatoria; si una vuelta completa no encuentra
+ *  teselas, el trabajo terminó (no se generan teselas nuevas durante la
+ *  multiplicación).
+ *---------------------------------------------------------------------------*/
+int siguienteTesela(struct robo *rb, int idH, unsigned *semilla,
+                    int *filaI, int *filaF, int *colI, int *colF) {
+	struct estadRobo *e = &rb->estad[idH];
+	int id = extraePropia(&rb->colas[idH]);
+
+	if (id < 0 && rb->nH > 1) {
+		long long t0 = ahoraNs();
+		int vacias = 0;
+
+		*semilla = *semilla * 1103515245u + 12345u;
+		int victima = (int) ((*semilla >> 16) % (unsigned) rb->nH);
+
+		while (id < 0 && vacias < rb->nH) {
+			if (victima == idH) {
+				vacias++;
+			} else {
+				id = roba(&rb->colas[victima]);
+				if (id == -2) {
+					e->fallidos++;
+					continue;           /* carrera perdida: reintentar */
+				}
+				if (id < 0) {
+					e->fallidos++;
+					vacias++;
+				} else {
+					e->robos++;
+				}
+			}
+			victima = (victima + 1) % rb->nH;
+		}
+		e->busqueda += ahoraNs() - t0;
+	}
+
+	if (id < 0) {
+		e->final = ahoraNs();
+		return 0;
+	}
+
+	int tf = id / rb->teselasCol, tc = id % rb->teselasCol;
+	*filaI = tf * rb->tam;
+	*filaF = *filaI + ((rb->tam < rb->D - *filaI) ? rb->tam : rb->D - *filaI);
+	*colI = tc * rb->tam;
+	*colF = *colI + ((rb->tam < rb->D - *colI) ? rb->tam : rb->D - *colI);
+	e->teselas++;
+	return 1;
+}
+
+/*-----------------------------------------------------------------------------
+ * informeRobo — Muestra las estadísticas por hilo de la última ejecución.
+ *
+ * Descripción:
+ *  El tiempo ocioso de un hilo es el que pasó buscando víctimas más el que
+ *  esperó desde que se quedó sin trabajo hasta que terminó el último hilo.
+ *  Si el robo elimina la cola de rezagados, el ocio máximo es pequeño
+ *  comparado con el tiempo total.
+ *---------------------------------------------------------------------------*/
+void informeRobo(const struct robo *rb, FILE *f) {
+	long long ultimo = rb->inicio;
+
+	for (int h = 0; h < rb->nH; h++)
+		if (rb->estad[h].final > ultimo)
+			ultimo = rb->estad[h].final;
+
+	fprintf(f, "# robo: %d teselas de %dx%d, total %.0f us\n",
+	        rb->total, rb->tam, rb->tam, (ultimo - rb->inicio) / 1e3);
+	fprintf(f, "# hilo teselas robos fallidos ocio(us)\n");
+	for (int h = 0; h < rb->nH; h++) {
+		const struct estadRobo *e = &rb->estad[h];
+		double ocio = (e->busqueda + (ultimo - e->final)) / 1e3;
+
+		fprintf(f, "%d %ld %ld %ld %.1f\n", h, e->teselas, e->robos, e->fallidos, ocio);
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * finRobo — Libera las colas y estadísticas.
+ *---------------------------------------------------------------------------*/
+void finRobo(struct robo *rb) {
+	free(rb->colas);
+	free(rb->estad);
+}
@@ -0,0 +1,69 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * mmRobo.h — Planificador de teselas 2-D de C con robo de trabajo
+ * (work stealing) para la versión Pthreads.
+ *
+ * Cada hilo es dueño de una cola doble (deque) con un rango contiguo de
+ * teselas. Consume su cola por un extremo y, cuando se vacía, roba teselas
+ * del extremo opuesto de las colas de otros hilos.
+ */
+
+#ifndef MM_ROBO_H
+#define MM_ROBO_H
+
+#include <stdio.h>
+#include <stdatomic.h>
+
+/*-----------------------------------------------------------------------------
+ * Cola de teselas de un hilo.
+ *  Contiene los identificadores de tesela [tope, fondo). El dueño toma del
+ *  fondo y los ladrones del tope. Se alinea a 64 bytes para que las colas de
+ *  hilos distintos no compartan línea de cache.
+ *---------------------------------------------------------------------------*/
+struct colaRobo {
+	_Alignas(64) atomic_int tope;
+	atomic_int fondo;
+};
+
+/*-----------------------------------------------------------------------------
+ * Estadísticas por hilo.
+ *  - teselas: teselas calculadas (propias y robadas).
+ *  - robos: robos con éxito.
+ *  - fallidos: intentos de robo sobre colas vacías o perdidos por carrera.
+ *  - busqueda: ns dedicados a buscar víctimas.
+ *  - final: instante (ns, CLOCK_MONOTONIC) en que el hilo se quedó sin trabajo.
+ *---------------------------------------------------------------------------*/
+struct estadRobo {
+	_Alignas(64) long teselas;
+	long robos;
+	long fallidos;
+	long long busqueda;
+	long long final;
+};
+
+/*-----------------------------------------------------------------------------
+ * Planificador:
+ *  - D, tam: dimensión de C y lado de la tesela.
+ *  - teselasCol, total: teselas por fila de teselas y en total.
+ *  - nH: número de hilos.
+ *  - colas, estad: un elemento por hilo.
+ *  - inicio: instante (ns) en que se reinició el planificador.
+ *---------------------------------------------------------------------------*/
+struct robo {
+	int D, tam;
+	int teselasCol, total;
+	int nH;
+	struct colaRobo *colas;
+	struct estadRobo *estad;
+	long long inicio;
+};
+
+int iniRobo(struct robo *rb, int D, int nH, int tam);
+void reiniciaRobo(struct robo *rb);
+int siguienteTesela(struct robo *rb, int idH, unsigned *semilla,
+                    int *filaI, int *filaF, int *colI, int *colF);
+void informeRobo(const struct robo *rb, FILE *f);
+void finRobo(struct robo *rb);
+
+#endif
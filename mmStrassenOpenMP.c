@@ -0,0 +1,553 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * Descripción general:
+ * ---------------------------------------------------------------
+ * Multiplicación rápida de matrices con la variante de Winograd del
+ * algoritmo de Strassen (7 productos y 15 sumas por nivel, O(n^2.81)),
+ * paralelizada con tareas de OpenMP.
+ *
+ * La matriz se divide recursivamente en cuadrantes hasta que el lado queda
+ * por debajo del corte (`--cutoff`, MM_STRASSEN_CORTE por defecto); los
+ * bloques base se multiplican con el mejor kernel por teselas del repo (el
+ * micro-kernel empaquetado de mmMicro.c, o el de bloques con `-b`). Si N
+ * no es base·2^niveles, A, B y C se copian rellenadas con ceros al lado
+ * siguiente de esa forma (a lo sumo 2^niveles - 1 filas y columnas más).
+ *
+ * Paralelismo: en los primeros niveles (los necesarios para que 7^niveles
+ * cubra los P hilos, hasta 3) los siete productos son tareas
+ * independientes, con sus propios temporales; por debajo la recursión es
+ * secuencial dentro de cada tarea y usa el orden de Winograd con solo dos
+ * temporales por nivel.
+ *
+ * Toda la memoria de trabajo (temporales de cada nivel, buffers de
+ * empaquetado de cada hilo y copias rellenadas) es una sola arena que
+ * `iniciaStrassen()` reserva y precarga una vez; la recursión no llama a
+ * malloc. El error numérico es mayor que el del producto clásico (crece
+ * con el número de niveles); `--verify` lo informa.
+ *
+ * Estructura del programa:
+ *  - `planificaStrassen()`: niveles, bloque base, relleno, niveles con
+ *    tareas y tamaño de la arena.
+ *  - `producto()`: recursión (`nivelTareas()`, `nivelSecuencial()`,
+ *    `casoBase()`).
+ *  - `motorStrassen` (`iniciaStrassen()`, `multiplicaStrassen()`,
+ *    `terminaStrassen()`): interfaz de mmMotor.h, usada también por el
+ *    binario único `mm`.
+ *  - `main()`: igual que en mmClasicaOpenMP.c (se omite al compilar con
+ *    -DMM_BINARIO_UNICO).
+ *
+ * Solo admite matrices cuadradas de double: no se combina con `--shape`,
+ * `--pad` ni `--type`; `-a` y `-s` no aplican.
+ *
+ * ---------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include "mmComun.h"
+#include "mmBloques.h"
+#include "mmMicro.h"
+#include "mmAleatorio.h"
+#include "mmVerifica.h"
+#include "mmTiempo.h"
+#include "mmMemoria.h"
+#include "mmForma.h"
+#include "mmTipo.h"
+#include "mmArchivo.h"
+#include "mmDispersa.h"
+#include "mmMotor.h"
+
+/* Máximo de niveles con tareas: 7³ = 343 productos independientes */
+#define MM_STRASSEN_NIVELES_TAREAS 3
+
+/* Plan de la recursión para un N, un corte y un número de hilos */
+struct planStrassen {
+	int N;
+	int corte;
+	int niveles;          /* niveles de recursión (0 → solo el kernel base) */
+	int nivelesTareas;    /* primeros niveles con los productos en tareas   */
+	int base;             /* lado de los bloques del caso base              */
+	int lado;             /* base·2^niveles ≥ N (lado de la matriz rellenada) */
+	int kernel;           /* micro-kernel del caso base, o NINGUNO (bloques) */
+	int bloque;           /* tamaño de bloque del caso base sin micro-kernel */
+	int paginas;
+	double *arena;        /* temporales, empaquetado y copias rellenadas    */
+	size_t elems;         /* doubles de la arena                            */
+	size_t elemsTrabajo;  /* doubles de empaquetado por hilo                */
+	double *trabajo;      /* empaquetado del hilo t: trabajo + t·elemsTrabajo */
+	double *pA, *pB, *pC; /* copias rellenadas (NULL si lado = N)           */
+};
+
+static struct planStrassen plan;
+
+/* Tiempos por fase y por hilo de la ejecución en curso (ver mmTiempo.h); los
+ * entrega `iniciaStrassen()` */
+static struct medicion *medida;
+
+/*-----------------------------------------------------------------------------
+ * suma, resta — Z = X + Y y Z = X − Y sobre bloques n×n con saltos propios.
+ *---------------------------------------------------------------------------*/
+static void suma(const double *X, int ldx, const double *Y, int ldy, double *Z, int ldz, int n) {
+	for (int i = 0; i < n; i++) {
+		const double *x = X + (size_t) i * ldx, *y = Y + (size_t) i * ldy;
+		double *z = Z + (size_t) i * ldz;
+
+		for (int j = 0; j < n; j++)
+			z[j] = x[j] + y[j];
+	}
+}
+
+static void resta(const double *X, int ldx, const double *Y, int ldy, double *Z, int ldz, int n) {
+	for (int i = 0; i < n; i++) {
+		const double *x = X + (size_t) i * ldx, *y = Y + (size_t) i * ldy;
+		double *z = Z + (size_t) i * ldz;
+
+		for (int j = 0; j < n; j++)
+			z[j] = x[j] - y[j];
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * espacioNivel — Doubles de arena que necesita la recursión desde `nivel`
+ * para un bloque de lado n.
+ *
+ * Descripción:
+ *  Un nivel con tareas guarda los ocho operandos S1..S4, T1..T4 y los tres
+ *  productos que no caben en C (P1, P6, P7), y da a cada uno de sus siete
+ *  hijos un espacio propio porque se ejecutan a la vez. Un nivel
+ *  secuencial usa dos temporales y un solo espacio para sus hijos, que se
+ *  ejecutan uno tras otro.
+ *---------------------------------------------------------------------------*/
+static size_t espacioNivel(int n, int nivel) {
+	if (nivel == plan.niveles)
+		return 0;
+
+	int h = n / 2;
+	size_t t = elemsAlineados((size_t) h * h);
+
+	if (nivel < plan.nivelesTareas)
+		return 11 * t + 7 * espacioNivel(h, nivel + 1);
+	return 2 * t + espacioNivel(h, nivel + 1);
+}
+
+/*-----------------------------------------------------------------------------
+ * planificaStrassen — Calcula el plan de la recursión y el tamaño de la arena.
+ *
+ * Descripción:
+ *  `niveles` es el menor L tal que ceil(N / 2^L) ≤ corte; el bloque base
+ *  es ese cociente y el lado rellenado base·2^L, de modo que el relleno es
+ *  menor que 2^L. Los niveles con tareas son los necesarios para tener al
+ *  menos P productos independientes (7^t ≥ P), sin pasar de
+ *  MM_STRASSEN_NIVELES_TAREAS ni de `niveles`.
+ *---------------------------------------------------------------------------*/
+static void planificaStrassen(const struct opciones *op) {
+	memset(&plan, 0, sizeof(plan));
+	plan.N = op->N;
+	plan.corte = (op->corte > 0) ? op->corte : MM_STRASSEN_CORTE;
+	plan.paginas = op->paginas;
+
+	plan.base = op->N;
+	while (plan.base > plan.corte) {
+		plan.niveles++;
+		plan.base = (int) (((long) op->N + (1L << plan.niveles) - 1) >> plan.niveles);
+	}
+	plan.lado = plan.base << plan.niveles;
+
+	for (int productos = 1; productos < op->P && plan.nivelesTareas < plan.niveles &&
+	     plan.nivelesTareas < MM_STRASSEN_NIVELES_TAREAS; productos *= 7)
+		plan.nivelesTareas++;
+
+	/* Como en mmComun.c, `-k` tiene prioridad sobre `-b`; sin ninguno de
+	 * los dos se usa la mejor variante del micro-kernel */
+	plan.bloque = op->bloque;
+	if (op->kernel != MM_KERNEL_NINGUNO)
+		plan.kernel = op->kernel;
+	else
+		plan.kernel = (op->bloque > 0) ? MM_KERNEL_NINGUNO : kernelDetectado();
+
+	plan.elemsTrabajo = (plan.kernel != MM_KERNEL_NINGUNO) ? elemsAlineados(elemsEmpaquetado(plan.base)) : 0;
+	plan.elems = espacioNivel(plan.lado, 0) + (size_t) op->P * plan.elemsTrabajo;
+	if (plan.lado != plan.N)
+		plan.elems += 3 * elemsAlineados((size_t) plan.lado * plan.lado);
+}
+
+/*-----------------------------------------------------------------------------
+ * casoBase — C = A·B para bloques n×n con el kernel por teselas, en las
+ * filas [filaI, filaF).
+ *
+ * Descripción:
+ *  El micro-kernel empaqueta en el buffer del hilo que ejecuta la llamada;
+ *  las tareas de OpenMP son ligadas (tied) y el kernel no tiene puntos de
+ *  planificación, así que el buffer no se comparte mientras se usa.
+ *---------------------------------------------------------------------------*/
+static void casoBase(const double *A, int lda, const double *B, int ldb, double *C, int ldc,
+                     int n, int filaI, int filaF) {
+	if (plan.kernel == MM_KERNEL_NINGUNO)
+		multiFormaBloques(A, lda, B, ldb, C, ldc, n, filaI, filaF, 0, n, plan.bloque);
+	else
+		multiFormaMicroEn(A, lda, B, ldb, 0, C, ldc, n, filaI, filaF, 0, n, plan.kernel,
+		                  plan.trabajo + (size_t) omp_get_thread_num() * plan.elemsTrabajo);
+}
+
+static void producto(const double *A, int lda, const double *B, int ldb, double *C, int ldc,
+                     int n, int nivel, double *espacio);
+
+/*-----------------------------------------------------------------------------
+ * nivelSecuencial — Un nivel de Winograd con dos temporales X e Y de h×h.
+ *
+ * Descripción:
+ *  Orden de Boyer, Dumas, Pernet y Zhou: los productos P3..P7 se escriben
+ *  directamente en los cuadrantes de C y P1 en X, de modo que solo hacen
+ *  falta dos temporales; los hijos reutilizan uno tras otro el mismo
+ *  espacio de la arena.
+ *---------------------------------------------------------------------------*/
+static void nivelSecuencial(const double *A, int lda, const double *B, int ldb, double *C, int ldc,
+                            int n, int nivel, double *espacio) {
+	int h = n / 2;
+	size_t t = elemsAlineados((size_t) h * h);
+	const double *A11 = A, *A12 = A + h, *A21 = A + (size_t) h * lda, *A22 = A21 + h;
+	const double *B11 = B, *B12 = B + h, *B21 = B + (size_t) h * ldb, *B22 = B21 + h;
+	double *C11 = C, *C12 = C + h, *C21 = C + (size_t) h * ldc, *C22 = C21 + h;
+	double *X = espacio, *Y = espacio + t, *hijo = espacio + 2 * t;
+
+	resta(A11, lda, A21, lda, X, h, h);                     /* X = S3 = A11 − A21 */
+	resta(B22, ldb, B12, ldb, Y, h, h);                     /* Y = T3 = B22 − B12 */
+	producto(X, h, Y, h, C21, ldc, h, nivel + 1, hijo);     /* C21 = P7 = S3·T3   */
+	suma(A21, lda, A22, lda, X, h, h);                      /* X = S1 = A21 + A22 */
+	resta(B12, ldb, B11, ldb, Y, h, h);                     /* Y = T1 = B12 − B11 */
+	producto(X, h, Y, h, C22, ldc, h, nivel + 1, hijo);     /* C22 = P5 = S1·T1   */
+	resta(X, h, A11, lda, X, h, h);                         /* X = S2 = S1 − A11  */
+	resta(B22, ldb, Y, h, Y, h, h);                         /* Y = T2 = B22 − T1  */
+	producto(X, h, Y, h, C12, ldc, h, nivel + 1, hijo);     /* C12 = P6 = S2·T2   */
+	resta(A12, lda, X, h, X, h, h);                         /* X = S4 = A12 − S2  */
+	producto(X, h, B22, ldb, C11, ldc, h, nivel + 1, hijo); /* C11 = P3 = S4·B22  */
+	producto(A11, lda, B11, ldb, X, h, h, nivel + 1, hijo); /* X = P1 = A11·B11   */
+	suma(X, h, C12, ldc, C12, ldc, h);                      /* C12 = U2 = P1 + P6 */
+	suma(C12, ldc, C21, ldc, C21, ldc, h);                  /* C21 = U3 = U2 + P7 */
+	suma(C12, ldc, C22, ldc, C12, ldc, h);                  /* C12 = U4 = U2 + P5 */
+	suma(C21, ldc, C22, ldc, C22, ldc, h);                  /* C22 = U7 = U3 + P5 */
+	suma(C12, ldc, C11, ldc, C12, ldc, h);                  /* C12 = U5 = U4 + P3 */
+	resta(Y, h, B21, ldb, Y, h, h);                         /* Y = T4 = T2 − B21  */
+	producto(A22, lda, Y, h, C11, ldc, h, nivel + 1, hijo); /* C11 = P4 = A22·T4  */
+	resta(C21, ldc, C11, ldc, C21, ldc, h);                 /* C21 = U6 = U3 − P4 */
+	producto(A12, lda, B21, ldb, C11, ldc, h, nivel + 1, hijo); /* C11 = P2 = A12·B21 */
+	suma(X, h, C11, ldc, C11, ldc, h);                      /* C11 = U1 = P1 + P2 */
+}
+
+/*-----------------------------------------------------------------------------
+ * nivelTareas — Un nivel de Winograd con los siete productos en tareas.
+ *
+ * Descripción:
+ *  1. Cuatro tareas calculan los operandos (S1, S2, S4 y T1, T2, T4 van en
+ *     cadena dentro de la misma tarea).
+ *  2. Siete tareas calculan los productos, cada una con su espacio de la
+ *     arena; P2..P5 van a los cuadrantes de C y P1, P6, P7 a temporales.
+ *  3. Una `taskloop` por filas combina los productos en C en una pasada.
+ *---------------------------------------------------------------------------*/
+static void nivelTareas(const double *A, int lda, const double *B, int ldb, double *C, int ldc,
+                        int n, int nivel, double *espacio) {
+	int h = n / 2;
+	size_t t = elemsAlineados((size_t) h * h);
+	size_t e = espacioNivel(h, nivel + 1);
+	const double *A11 = A, *A12 = A + h, *A21 = A + (size_t) h * lda, *A22 = A21 + h;
+	const double *B11 = B, *B12 = B + h, *B21 = B + (size_t) h * ldb, *B22 = B21 + h;
+	double *C11 = C, *C12 = C + h, *C21 = C + (size_t) h * ldc, *C22 = C21 + h;
+	double *S1 = espacio, *S2 = S1 + t, *S3 = S2 + t, *S4 = S3 + t;
+	double *T1 = S4 + t, *T2 = T1 + t, *T3 = T2 + t, *T4 = T3 + t;
+	double *P1 = T4 + t, *P6 = P1 + t, *P7 = P6 + t;
+	double *hijo = P7 + t;
+
+	#pragma omp task
+	{
+		suma(A21, lda, A22, lda, S1, h, h);
+		resta(S1, h, A11, lda, S2, h, h);
+		resta(A12, lda, S2, h, S4, h, h);
+	}
+	#pragma omp task
+	resta(A11, lda, A21, lda, S3, h, h);
+	#pragma omp task
+	{
+		resta(B12, ldb, B11, ldb, T1, h, h);
+		resta(B22, ldb, T1, h, T2, h, h);
+		resta(T2, h, B21, ldb, T4, h, h);
+	}
+	#pragma omp task
+	resta(B22, ldb, B12, ldb, T3, h, h);
+	#pragma omp taskwait
+
+	#pragma omp task
+	producto(A11, lda, B11, ldb, P1, h, h, nivel + 1, hijo);
+	#pragma omp task
+	producto(A12, lda, B21, ldb, C11, ldc, h, nivel + 1, hijo + e);
+	#pragma omp task
+	producto(S4, h, B22, ldb, C12, ldc, h, nivel + 1, hijo + 2 * e);
+	#pragma omp task
+	producto(A22, lda, T4, h, C21, ldc, h, nivel + 1, hijo + 3 * e);
+	#pragma omp task
+	producto(S1, h, T1, h, C22, ldc, h, nivel + 1, hijo + 4 * e);
+	#pragma omp task
+	producto(S2, h, T2, h, P6, h, h, nivel + 1, hijo + 5 * e);
+	#pragma omp task
+	producto(S3, h, T3, h, P7, h, h, nivel + 1, hijo + 6 * e);
+	#pragma omp taskwait
+
+	#pragma omp taskloop
+	for (int i = 0; i < h; i++) {
+		const double *p1 = P1 + (size_t) i * h, *p6 = P6 + (size_t) i * h, *p7 = P7 + (size_t) i * h;
+		double *c11 = C11 + (size_t) i * ldc, *c12 = C12 + (size_t) i * ldc;
+		double *c21 = C21 + (size_t) i * ldc, *c22 = C22 + (size_t) i * ldc;
+
+		for (int j = 0; j < h; j++) {
+			double u2 = p1[j] + p6[j];
+			double u3 = u2 + p7[j];
+			double p5 = c22[j];
+
+			c11[j] = p1[j] + c11[j];           /* U1 = P1 + P2      */
+			c12[j] = u2 + p5 + c12[j];         /* U5 = U2 + P5 + P3 */
+			c21[j] = u3 - c21[j];              /* U6 = U3 − P4      */
+			c22[j] = u3 + p5;                  /* U7 = U3 + P5      */
+		}
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * producto — C = A·B para bloques n×n desde el nivel `nivel` de la
+ * recursión, con la arena a partir de `espacio`.
+ *---------------------------------------------------------------------------*/
+static void producto(const double *A, int lda, const double *B, int ldb, double *C, int ldc,
+                     int n, int nivel, double *espacio) {
+	if (nivel == plan.niveles)
+		casoBase(A, lda, B, ldb, C, ldc, n, 0, n);
+	else if (nivel < plan.nivelesTareas)
+		nivelTareas(A, lda, B, ldb, C, ldc, n, nivel, espacio);
+	else
+		nivelSecuencial(A, lda, B, ldb, C, ldc, n, nivel, espacio);
+}
+
+/*-----------------------------------------------------------------------------
+ * informePlan — Muestra el plan de la recursión en stderr (`-v`).
+ *---------------------------------------------------------------------------*/
+static void informePlan(FILE *f) {
+	fprintf(f, "Strassen-Winograd: N=%d, corte %d → %d niveles, bloques base %d×%d (%s)",
+	        plan.N, plan.corte, plan.niveles, plan.base, plan.base,
+	        plan.kernel == MM_KERNEL_NINGUNO ? "bloques" : nombreKernel(plan.kernel));
+	if (plan.lado != plan.N)
+		fprintf(f, ", relleno a %d", plan.lado);
+	int productos = 1;
+	for (int t = 0; t < plan.nivelesTareas; t++)
+		productos *= 7;
+	fprintf(f, "\n  tareas en %d niveles (%d productos independientes), arena %.1f MiB\n",
+	        plan.nivelesTareas, productos, plan.elems * sizeof(double) / (1024.0 * 1024.0));
+}
+
+/*-----------------------------------------------------------------------------
+ * iniciaStrassen — Prepara el motor Strassen (ver mmMotor.h).
+ *
+ * Descripción:
+ *  Configura el número de hilos, planifica la recursión para op->N y
+ *  reserva y precarga la arena (con las páginas de `--pages`), fuera del
+ *  tiempo medido. Retorna -1 si el producto no es un solo cuadrado de
+ *  double o si la arena no cabe en memoria.
+ *---------------------------------------------------------------------------*/
+static int iniciaStrassen(const struct opciones *op, struct medicion *m) {
+	if (formaGeneral(op) || op->tipo != MM_TIPO_NINGUNO || op->lote > 0) {
+		fprintf(stderr, "El motor strassen no admite --shape, --pad, --type ni --batch\n");
+		return -1;
+	}
+
+	medida = m;
+	omp_set_num_threads(op->P);
+	planificaStrassen(op);
+
+	if (!cabeEnMemoria(plan.elems * sizeof(double))) {
+		fprintf(stderr, "La arena de Strassen (%.1f MiB) no cabe en memoria\n",
+		        plan.elems * sizeof(double) / (1024.0 * 1024.0));
+		return -1;
+	}
+	plan.arena = reservaMatriz(plan.elems, plan.paginas, 0, 1);
+	if (plan.arena == NULL) {
+		perror("Error al reservar la arena de Strassen");
+		return -1;
+	}
+
+	double *resto = plan.arena + espacioNivel(plan.lado, 0);
+	plan.trabajo = resto;
+	resto += (size_t) op->P * plan.elemsTrabajo;
+	if (plan.lado != plan.N) {
+		size_t elemsLado = elemsAlineados((size_t) plan.lado * plan.lado);
+
+		plan.pA = resto;
+		plan.pB = resto + elemsLado;
+		plan.pC = resto + 2 * elemsLado;
+	}
+
+	if (op->informe)
+		informePlan(stderr);
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * multiplicaStrassen — Una multiplicación C = A·B con el equipo de hilos.
+ *
+ * Descripción:
+ *  En una sola región paralela: con relleno, los hilos copian A y B a sus
+ *  copias rellenadas (el borde queda en cero desde la reserva); un hilo
+ *  lanza la recursión y los demás ejecutan sus tareas; al final se copia C
+ *  de vuelta. Sin niveles de recursión (N ≤ corte) los hilos se reparten
+ *  franjas de MM_MC filas del kernel base. Retorna el tiempo de la
+ *  multiplicación en µs (incluidas las copias).
+ *---------------------------------------------------------------------------*/
+static double multiplicaStrassen(const struct opciones *op, const double *mA, const double *mB, double *mC) {
+	int N = plan.N, lado = plan.lado;
+	int relleno = (lado != N);
+	const double *A = relleno ? plan.pA : mA;
+	const double *B = relleno ? plan.pB : mB;
+	double *C = relleno ? plan.pC : mC;
+
+	inicioFase(medida, MM_FASE_MULTIPLICACION);
+	#pragma omp parallel
+	{
+		inicioTrabajador(medida, omp_get_thread_num());
+		if (relleno) {
+			#pragma omp for schedule(static)
+			for (int i = 0; i < N; i++) {
+				memcpy(plan.pA + (size_t) i * lado, mA + (size_t) i * N, (size_t) N * sizeof(double));
+				memcpy(plan.pB + (size_t) i * lado, mB + (size_t) i * N, (size_t) N * sizeof(double));
+			}
+		}
+
+		if (plan.niveles == 0) {
+			#pragma omp for schedule(static)
+			for (int ii = 0; ii < N; ii += MM_MC)
+				casoBase(A, lado, B, lado, C, lado, N, ii, (ii + MM_MC < N) ? ii + MM_MC : N);
+		} else {
+			#pragma omp single
+			producto(A, lado, B, lado, C, lado, lado, 0, plan.arena);
+		}
+
+		if (relleno) {
+			#pragma omp for schedule(static)
+			for (int i = 0; i < N; i++)
+				memcpy(mC + (size_t) i * N, plan.pC + (size_t) i * lado, (size_t) N * sizeof(double));
+		}
+		finTrabajador(medida, omp_get_thread_num());
+	}
+	return finFase(medida, MM_FASE_MULTIPLICACION);
+}
+
+/*-----------------------------------------------------------------------------
+ * terminaStrassen — Libera la arena.
+ *---------------------------------------------------------------------------*/
+static void terminaStrassen(const struct opciones *op) {
+	if (plan.arena != NULL)
+		liberaMatriz(plan.arena, plan.elems, plan.paginas);
+	memset(&plan, 0, sizeof(plan));
+	medida = NULL;
+}
+
+const struct motor motorStrassen = { "strassen", iniciaStrassen, multiplicaStrassen, terminaStrassen, 0 };
+
+#ifndef MM_BINARIO_UNICO
+
+/*-----------------------------------------------------------------------------
+ * iniMatrix — Inicializa A y B con el generador de mmAleatorio.c (como en
+ * mmClasicaOpenMP.c, por franjas de filas en paralelo).
+ *---------------------------------------------------------------------------*/
+static void iniMatrix(const struct opciones *op, double *m1, double *m2, int D) {
+	#pragma omp parallel for schedule(static)
+	for (int ii = 0; ii < D; ii += MM_MC) {
+		int iF = (ii + MM_MC < D) ? ii + MM_MC : D;
+		iniMatrixFilas(m1, m2, D, ii, iF, op->semilla);
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * main — Función principal del programa.
+ *
+ * Descripción:
+ *  1. Valida los parámetros y las opciones (ver mmComun.c); con `--files`
+ *     multiplica las matrices de los archivos con `ejecutaArchivo()`
+ *     (mmArchivo.c), sin `--budget`, y con `--density` una A dispersa con
+ *     `ejecutaDispersa()` (mmDispersa.c).
+ *  2. Reserva A, B y C y prepara el motor (`iniciaStrassen()`: hilos,
+ *     plan y arena).
+ *  3. Inicializa A y B, multiplica y muestra el tiempo (µs).
+ *  4. Con `--verify`, comprueba C = A·B fuera del tiempo medido e informa
+ *     el error numérico.
+ *---------------------------------------------------------------------------*/
+int main(int argc, char *argv[]) {
+	struct opciones op;
+	leerOpciones(argc, argv, "./mmStrassenOpenMP", &op);
+	if (op.archivos[0] != NULL)
+		return ejecutaArchivo(&op, &motorStrassen, 0, "mmStrassenOpenMP");
+	if (op.densidad > 0.0)
+		return ejecutaDispersa(&op, &motorStrassen, 0, "mmStrassenOpenMP");
+
+	int N = op.N;
+	int TH = op.P;
+
+	if (compruebaHuella(N, 3, stderr) != 0)
+		exit(1);
+
+	double *matrixA = reservaMatriz((size_t) N * N, op.paginas, 0, op.precarga);
+	double *matrixB = reservaMatriz((size_t) N * N, op.paginas, 0, op.precarga);
+	double *matrixC = reservaMatriz((size_t) N * N, op.paginas, 0, op.precarga);
+	if (matrixA == NULL || matrixB == NULL || matrixC == NULL) {
+		perror("Error al reservar memoria para las matrices");
+		exit(1);
+	}
+
+	struct medicion tiempos;
+	struct contadores contadores;
+
+	if (iniMedicion(&tiempos, TH) != 0) {
+		perror("Error al reservar las marcas de tiempo");
+		exit(1);
+	}
+
+	if (op.contadores) {
+		if (iniContadores(&contadores, TH) != 0) {
+			perror("Error al reservar los contadores");
+			exit(1);
+		}
+		tiempos.cont = &contadores;
+	}
+
+	if (motorStrassen.iniciar(&op, &tiempos) != 0)
+		exit(1);
+
+	inicioFase(&tiempos, MM_FASE_INICIALIZACION);
+	iniMatrix(&op, matrixA, matrixB, N);
+	finFase(&tiempos, MM_FASE_INICIALIZACION);
+
+	double tMult = motorStrassen.multiplicar(&op, matrixA, matrixB, matrixC);
+
+	printf("%9.0f ", tMult);
+	if (op.contadores)
+		columnasContadores(&contadores, 2.0 * N * N * N, tMult, stdout);
+	printf("\n");
+
+	if (op.informe)
+		informeHuella(N, 3, tMult, 1, stderr);
+
+	int fallo = op.verifica ? verificaProducto(matrixA, matrixB, matrixC, N, op.semilla, stderr) : 0;
+
+	motorStrassen.terminar(&op);
+	escribeMedicion(&tiempos, op.formatoTiempo, "mmStrassenOpenMP", N, stderr);
+	if (op.contadores) {
+		informeContadores(&contadores, op.informe, stderr);
+		liberaContadores(&contadores);
+	}
+	finMedicion(&tiempos);
+
+	liberaMatriz(matrixA, (size_t) N * N, op.paginas);
+	liberaMatriz(matrixB, (size_t) N * N, op.paginas);
+	liberaMatriz(matrixC, (size_t) N * N, op.paginas);
+
+	return fallo;
+}
+
+#endif /* MM_BINARIO_UNICO */
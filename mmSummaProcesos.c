@@ -0,0 +1,619 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * Descripción general:
+ * ---------------------------------------------------------------
+ * Multiplicación distribuida con el algoritmo SUMMA (Scalable Universal
+ * Matrix Multiplication Algorithm) sobre una malla de P procesos que solo
+ * se comunican por mensajes.
+ *
+ * mmClasicaFork.c reparte filas entre procesos que heredan con `fork()`
+ * copias de A y B completas, algo que no existe entre nodos distintos. Aquí
+ * cada proceso (i, j) de una malla pr×pc guarda solo su bloque de A, de B y
+ * de C (descomposición 2-D por bloques) y recibe de los demás los paneles
+ * que le faltan:
+ *
+ *   para cada panel k de la dimensión común:
+ *     - el dueño de A[i, k] lo difunde a su fila de la malla;
+ *     - el dueño de B[k, j] lo difunde a su columna;
+ *     - cada proceso suma C[i, j] += A[i, k] · B[k, j] con el kernel pedido.
+ *
+ * Los mensajes viajan por sockets de dominio Unix (`socketpair()`), uno por
+ * par de procesos que comparten fila o columna, de modo que el algoritmo se
+ * prueba en un solo equipo con el mismo patrón de comunicación que tendría
+ * entre nodos. La malla es la más cuadrada posible (√P×√P si P es un
+ * cuadrado perfecto; 1×P si P es primo), y los paneles son los tramos entre
+ * los cortes de ambas particiones de K, así que cualquier N ≥ pc admite
+ * cualquier P.
+ *
+ * Cada proceso mide los bytes y mensajes enviados y recibidos y el tiempo
+ * dentro de las llamadas de comunicación (incluida la espera al dueño del
+ * panel), separado del tiempo de cálculo; con `-v` se comparan con el
+ * volumen que predice el algoritmo, 8·N²·((pc - 1) + (pr - 1)) bytes por
+ * multiplicación. La carga inicial de los bloques desde A y B y la
+ * escritura de C (en memoria compartida, como en el motor Fork) hacen las
+ * veces de la distribución y la recolección, y no cuentan como mensajes.
+ *
+ * Estructura del programa:
+ *  - `planificaMalla()`: forma de la malla y cortes de filas y columnas.
+ *  - `abreCanales()` / `cierraCanales()`: sockets entre procesos de la
+ *    misma fila o columna.
+ *  - `enviaPanel()` / `recibePanel()`: mensajes completos con su contabilidad.
+ *  - `procesoSumma()`: carga, bucle de paneles y escritura del bloque de C.
+ *  - `motorSumma` (`iniciaSumma()`, `multiplicaSumma()`, `terminaSumma()`):
+ *    interfaz de mmMotor.h, usada también por el binario único `mm`.
+ *  - `main()`: igual que en mmClasicaFork.c, con C en memoria compartida
+ *    (se omite al compilar con -DMM_BINARIO_UNICO).
+ *
+ * Solo admite matrices cuadradas de double: no se combina con `--shape`,
+ * `--pad`, `--type` ni `--batch`; `-a` y `-s` no aplican.
+ *
+ * ---------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include "mmComun.h"
+#include "mmReparto.h"
+#include "mmAleatorio.h"
+#include "mmVerifica.h"
+#include "mmTiempo.h"
+#include "mmMemoria.h"
+#include "mmForma.h"
+#include "mmTipo.h"
+#include "mmArchivo.h"
+#include "mmDispersa.h"
+#include "mmMotor.h"
+
+/*-----------------------------------------------------------------------------
+ * Contabilidad de un proceso, acumulada en todas las multiplicaciones (en
+ * memoria compartida para que el padre la lea):
+ *  - enviados, recibidos: bytes de paneles.
+ *  - mensajes: paneles enviados.
+ *  - comunicacion: µs dentro de `enviaPanel()` y `recibePanel()`.
+ *  - calculo: µs del kernel y de la suma de los productos parciales.
+ *  - carga: µs copiando los bloques de A y B y escribiendo el de C.
+ *---------------------------------------------------------------------------*/
+struct estadSumma {
+	double enviados, recibidos;
+	double mensajes;
+	double comunicacion;
+	double calculo;
+	double carga;
+};
+
+/*-----------------------------------------------------------------------------
+ * Malla de procesos:
+ *  - N: dimensión de las matrices.
+ *  - pr, pc: filas y columnas de la malla (P = pr·pc, pr ≤ pc).
+ *  - cortesF: pr + 1 cortes de las filas de A y C y de las filas de B.
+ *  - cortesC: pc + 1 cortes de las columnas de B y C y de las columnas de A.
+ *  - paneles: tramos de K entre los cortes de ambas particiones.
+ *  - canal: P·P descriptores; canal[p·P + r] es el extremo del proceso p
+ *           hacia r (-1 si no comparten fila ni columna).
+ *  - estad: P contabilidades en memoria compartida.
+ *  - multiplicaciones: llamadas a `multiplicaSumma()` desde `iniciaSumma()`.
+ *---------------------------------------------------------------------------*/
+struct mallaSumma {
+	int N;
+	int pr, pc;
+	int *cortesF, *cortesC;
+	int paneles;
+	int *canal;
+	struct estadSumma *estad;
+	int multiplicaciones;
+};
+
+/* Tiempos por fase y por proceso de la ejecución en curso (ver mmTiempo.h);
+ * los entrega `iniciaSumma()` */
+static struct medicion *medida;
+
+static struct mallaSumma malla;
+
+/*-----------------------------------------------------------------------------
+ * finPanel — Fin del panel de K que empieza en `k0`: el primer corte de
+ * cualquiera de las dos particiones después de `k0`.
+ *
+ * Descripción:
+ *  `bf` y `bc` son los bloques de filas y de columnas que contienen `k0`
+ *  (los dueños del panel de B y de A); se avanzan en el mismo recorrido,
+ *  así que deben empezar en 0 con `k0` = 0.
+ *---------------------------------------------------------------------------*/
+static int finPanel(int k0, int *bf, int *bc) {
+	while (malla.cortesF[*bf + 1] <= k0) (*bf)++;
+	while (malla.cortesC[*bc + 1] <= k0) (*bc)++;
+	return (malla.cortesF[*bf + 1] < malla.cortesC[*bc + 1]) ? malla.cortesF[*bf + 1] : malla.cortesC[*bc + 1];
+}
+
+/*-----------------------------------------------------------------------------
+ * planificaMalla — Elige la malla pr×pc y los cortes de los bloques.
+ *
+ * Descripción:
+ *  pr es el mayor divisor de P que no pasa de √P, así que la malla es la
+ *  más cuadrada posible y el volumen de comunicación, proporcional a
+ *  (pr - 1) + (pc - 1), el menor. Las filas se reparten en pr bloques y las
+ *  columnas en pc con `rangoEstatico()`; los paneles son los tramos de
+ *  `finPanel()`. Retorna -1 si falta memoria.
+ *---------------------------------------------------------------------------*/
+static int planificaMalla(int N, int P) {
+	malla.N = N;
+	malla.pr = 1;
+	for (int d = 1; (long) d * d <= P; d++)
+		if (P % d == 0)
+			malla.pr = d;
+	malla.pc = P / malla.pr;
+
+	malla.cortesF = malloc((size_t) (malla.pr + 1) * sizeof(int));
+	malla.cortesC = malloc((size_t) (malla.pc + 1) * sizeof(int));
+	if (malla.cortesF == NULL || malla.cortesC == NULL)
+		return -1;
+
+	int ini, fin;
+	for (int b = 0; b < malla.pr; b++) {
+		rangoEstatico(N, malla.pr, b, &ini, &fin);
+		malla.cortesF[b] = ini;
+	}
+	malla.cortesF[malla.pr] = N;
+	for (int b = 0; b < malla.pc; b++) {
+		rangoEstatico(N, malla.pc, b, &ini, &fin);
+		malla.cortesC[b] = ini;
+	}
+	malla.cortesC[malla.pc] = N;
+
+	malla.paneles = 0;
+	for (int k0 = 0, bf = 0, bc = 0; k0 < N; malla.paneles++)
+		k0 = finPanel(k0, &bf, &bc);
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * abreCanales — Crea un socket de dominio Unix por cada par de procesos que
+ * comparten fila o columna de la malla.
+ *
+ * Descripción:
+ *  Los sockets se crean en el padre y los procesos los heredan con
+ *  `fork()` en cada multiplicación; son flujos (SOCK_STREAM), así que un
+ *  panel llega completo y en orden aunque el núcleo lo parta. Retorna -1
+ *  si falla alguno (p. ej. por el límite de descriptores con P grande).
+ *---------------------------------------------------------------------------*/
+static int abreCanales(int P) {
+	malla.canal = malloc((size_t) P * P * sizeof(int));
+	if (malla.canal == NULL)
+		return -1;
+	for (int i = 0; i < P * P; i++)
+		malla.canal[i] = -1;
+
+	for (int p = 0; p < P; p++)
+		for (int r = p + 1; r < P; r++) {
+			int sv[2];
+
+			if (p / malla.pc != r / malla.pc && p % malla.pc != r % malla.pc)
+				continue;
+			if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) {
+				perror("Error al crear los sockets de la malla");
+				return -1;
+			}
+			malla.canal[p * P + r] = sv[0];
+			malla.canal[r * P + p] = sv[1];
+		}
+	return 0;
+}
+
+static void cierraCanales(int P) {
+	if (malla.canal == NULL)
+		return;
+	for (int i = 0; i < P * P; i++)
+		if (malla.canal[i] >= 0)
+			close(malla.canal[i]);
+	free(malla.canal);
+	malla.canal = NULL;
+}
+
+/*-----------------------------------------------------------------------------
+ * enviaPanel / recibePanel — Un panel de `elems` doubles contiguos por el
+ * socket `fd`.
+ *
+ * Descripción:
+ *  Repiten `send()`/`recv()` hasta mover todos los bytes (un panel de
+ *  varios MiB no cabe en el buffer del socket) y suman los bytes y el
+ *  tiempo a la contabilidad del proceso. Retornan -1 si el otro extremo
+ *  falla o se cerró.
+ *---------------------------------------------------------------------------*/
+static int enviaPanel(int fd, const double *panel, size_t elems, struct estadSumma *e) {
+	const char *p = (const char *) panel;
+	size_t resto = elems * sizeof(double);
+	double t0 = ahoraUs();
+
+	while (resto > 0) {
+		ssize_t n = send(fd, p, resto, MSG_NOSIGNAL);
+
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return -1;
+		p += n;
+		resto -= (size_t) n;
+	}
+	e->enviados += (double) elems * sizeof(double);
+	e->mensajes += 1.0;
+	e->comunicacion += ahoraUs() - t0;
+	return 0;
+}
+
+static int recibePanel(int fd, double *panel, size_t elems, struct estadSumma *e) {
+	char *p = (char *) panel;
+	size_t resto = elems * sizeof(double);
+	double t0 = ahoraUs();
+
+	while (resto > 0) {
+		ssize_t n = recv(fd, p, resto, MSG_WAITALL);
+
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return -1;
+		p += n;
+		resto -= (size_t) n;
+	}
+	e->recibidos += (double) elems * sizeof(double);
+	e->comunicacion += ahoraUs() - t0;
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * procesoSumma — Trabajo del proceso `p` de la malla.
+ *
+ * Parámetros:
+ *  - op: opciones (kernel: `-k`, `-b` o el clásico).
+ *  - mA, mB: matrices de entrada (solo se lee el bloque propio).
+ *  - mC: C en memoria compartida (solo se escribe el bloque propio).
+ *  - p: índice del proceso; ocupa la fila p / pc y la columna p % pc.
+ *
+ * Descripción:
+ *  Copia a memoria propia sus bloques A[i, j] y B[i, j] y recorre los
+ *  paneles de K en orden: primero la difusión de A por la fila, luego la de
+ *  B por la columna y después el producto del panel. Todos los procesos
+ *  siguen el mismo orden de difusiones, de modo que cada envío bloqueante
+ *  encuentra a su receptor en la misma operación y no hay interbloqueo. El
+ *  primer panel escribe C[i, j] y los siguientes se calculan en un
+ *  temporal y se suman. Retorna 0, o -1 si falla la memoria o un socket.
+ *---------------------------------------------------------------------------*/
+static int procesoSumma(const struct opciones *op, const double *mA, const double *mB, double *mC, int p) {
+	int N = malla.N, P = malla.pr * malla.pc;
+	int i = p / malla.pc, j = p % malla.pc;
+	int fI = malla.cortesF[i], fF = malla.cortesF[i + 1];   /* filas de A y C; filas de B */
+	int cI = malla.cortesC[j], cF = malla.cortesC[j + 1];   /* columnas de B y C; de A    */
+	int mb = fF - fI, nb = cF - cI, ka = cF - cI, kb = fF - fI;
+	int maxPanel = (N + malla.pr - 1) / malla.pr;   /* el mayor bloque de ambas particiones */
+	struct estadSumma *e = &malla.estad[p];
+
+	/* Bloques propios, paneles recibidos, C y el producto parcial: la
+	 * memoria del "nodo" */
+	size_t eA = elemsAlineados((size_t) mb * ka), eB = elemsAlineados((size_t) kb * nb);
+	size_t ePA = elemsAlineados((size_t) mb * maxPanel), ePB = elemsAlineados((size_t) maxPanel * nb);
+	size_t eC = elemsAlineados((size_t) mb * nb);
+	size_t elems = eA + eB + ePA + ePB + 2 * eC;
+	double *region = reservaMatriz(elems, op->paginas, 0, 0);
+
+	if (region == NULL)
+		return -1;
+
+	double *locA = region, *locB = locA + eA, *panelA = locB + eB, *panelB = panelA + ePA;
+	double *locC = panelB + ePB, *parcial = locC + eC;
+
+	double t0 = ahoraUs();
+	for (int r = 0; r < mb; r++)
+		memcpy(locA + (size_t) r * ka, mA + (size_t) (fI + r) * N + cI, (size_t) ka * sizeof(double));
+	for (int r = 0; r < kb; r++)
+		memcpy(locB + (size_t) r * nb, mB + (size_t) (fI + r) * N + cI, (size_t) nb * sizeof(double));
+	e->carga += ahoraUs() - t0;
+
+	int fallo = 0, primero = 1;
+	int bf = 0, bc = 0;   /* bloque de la partición de filas y de columnas que contiene k0 */
+
+	for (int k0 = 0; k0 < N && !fallo; ) {
+		int k1 = finPanel(k0, &bf, &bc), kk = k1 - k0;
+		const double *pA = panelA, *pB = panelB;
+
+		/* Difusión de A[i, k0:k1] por la fila i: la raíz es la columna bc */
+		if (j == bc) {
+			for (int r = 0; r < mb; r++)
+				memcpy(panelA + (size_t) r * kk, locA + (size_t) r * ka + (k0 - cI),
+				       (size_t) kk * sizeof(double));
+			for (int c = 0; c < malla.pc && !fallo; c++)
+				if (c != j)
+					fallo = enviaPanel(malla.canal[p * P + i * malla.pc + c], panelA, (size_t) mb * kk, e);
+		} else
+			fallo = recibePanel(malla.canal[p * P + i * malla.pc + bc], panelA, (size_t) mb * kk, e);
+
+		/* Difusión de B[k0:k1, j] por la columna j: la raíz es la fila bf */
+		if (!fallo && i == bf) {
+			pB = locB + (size_t) (k0 - fI) * nb;
+			for (int r = 0; r < malla.pr && !fallo; r++)
+				if (r != i)
+					fallo = enviaPanel(malla.canal[p * P + r * malla.pc + j], pB, (size_t) kk * nb, e);
+		} else if (!fallo)
+			fallo = recibePanel(malla.canal[p * P + bf * malla.pc + j], panelB, (size_t) kk * nb, e);
+		if (fallo)
+			break;
+
+		t0 = ahoraUs();
+		if (primero)
+			multiFormaComun(op, pA, kk, pB, nb, 0, locC, nb, kk, 0, mb, 0, nb);
+		else {
+			multiFormaComun(op, pA, kk, pB, nb, 0, parcial, nb, kk, 0, mb, 0, nb);
+			for (size_t x = 0; x < (size_t) mb * nb; x++)
+				locC[x] += parcial[x];
+		}
+		e->calculo += ahoraUs() - t0;
+		primero = 0;
+		k0 = k1;
+	}
+
+	if (!fallo) {
+		t0 = ahoraUs();
+		for (int r = 0; r < mb; r++)
+			memcpy(mC + (size_t) (fI + r) * N + cI, locC + (size_t) r * nb, (size_t) nb * sizeof(double));
+		e->carga += ahoraUs() - t0;
+	}
+	liberaMatriz(region, elems, op->paginas);
+	return fallo;
+}
+
+/*-----------------------------------------------------------------------------
+ * volumenPrevisto — Bytes de paneles por multiplicación: cada elemento de A
+ * llega a las otras pc - 1 columnas de su fila de la malla y cada uno de B
+ * a las otras pr - 1 filas de su columna.
+ *---------------------------------------------------------------------------*/
+static double volumenPrevisto(void) {
+	return 8.0 * malla.N * (double) malla.N * ((malla.pc - 1) + (malla.pr - 1));
+}
+
+/*-----------------------------------------------------------------------------
+ * informeMalla — Muestra la malla y el volumen previsto en stderr (`-v`).
+ *---------------------------------------------------------------------------*/
+static void informeMalla(FILE *f) {
+	fprintf(f, "SUMMA: malla %d×%d de procesos, bloques de ~%d×%d, %d paneles de K; "
+	        "sockets Unix; volumen previsto %.1f MiB por multiplicación\n",
+	        malla.pr, malla.pc, (malla.N + malla.pr - 1) / malla.pr, (malla.N + malla.pc - 1) / malla.pc,
+	        malla.paneles, volumenPrevisto() / 1048576.0);
+}
+
+/*-----------------------------------------------------------------------------
+ * informeComunicacion — Resume la contabilidad de los procesos (`-v`).
+ *
+ * Descripción:
+ *  Totales de bytes y mensajes por multiplicación, y la media y el máximo
+ *  entre procesos del tiempo de comunicación y del de cálculo. El ancho de
+ *  banda efectivo divide los bytes recibidos por cada proceso entre su
+ *  tiempo de comunicación, que incluye la espera al dueño del panel.
+ *---------------------------------------------------------------------------*/
+static void informeComunicacion(FILE *f) {
+	int P = malla.pr * malla.pc, veces = malla.multiplicaciones > 0 ? malla.multiplicaciones : 1;
+	double enviados = 0.0, recibidos = 0.0, mensajes = 0.0;
+	double com = 0.0, maxCom = 0.0, calc = 0.0, maxCalc = 0.0, carga = 0.0;
+
+	for (int p = 0; p < P; p++) {
+		const struct estadSumma *e = &malla.estad[p];
+
+		enviados += e->enviados;
+		recibidos += e->recibidos;
+		mensajes += e->mensajes;
+		com += e->comunicacion;
+		calc += e->calculo;
+		carga += e->carga;
+		if (e->comunicacion > maxCom) maxCom = e->comunicacion;
+		if (e->calculo > maxCalc) maxCalc = e->calculo;
+	}
+	fprintf(f, "# comunicación SUMMA: %.1f MiB enviados y %.1f MiB recibidos en %.0f mensajes "
+	        "por multiplicación (previsto %.1f MiB)\n",
+	        enviados / veces / 1048576.0, recibidos / veces / 1048576.0, mensajes / veces,
+	        volumenPrevisto() / 1048576.0);
+	fprintf(f, "# tiempo por proceso y multiplicación: comunicación media %.0f µs (máx. %.0f), "
+	        "cálculo medio %.0f µs (máx. %.0f), carga %.0f µs; %.0f %% en comunicación, %.2f GB/s efectivos\n",
+	        com / P / veces, maxCom / veces, calc / P / veces, maxCalc / veces, carga / P / veces,
+	        com + calc > 0.0 ? 100.0 * com / (com + calc) : 0.0,
+	        com > 0.0 ? recibidos / (com * 1e3) : 0.0);
+}
+
+/*-----------------------------------------------------------------------------
+ * iniciaSumma — Prepara el motor SUMMA (ver mmMotor.h).
+ *
+ * Descripción:
+ *  Planifica la malla para op->N y op->P, crea los sockets y la
+ *  contabilidad compartida. Los procesos se crean en cada multiplicación,
+ *  como en el motor Fork. Retorna -1 si el producto no es un solo cuadrado
+ *  de double, si N es menor que las columnas de la malla o si falla alguna
+ *  reserva.
+ *---------------------------------------------------------------------------*/
+static int iniciaSumma(const struct opciones *op, struct medicion *m) {
+	if (formaGeneral(op) || op->tipo != MM_TIPO_NINGUNO || op->lote > 0) {
+		fprintf(stderr, "El motor summa no admite --shape, --pad, --type ni --batch\n");
+		return -1;
+	}
+
+	medida = m;
+	memset(&malla, 0, sizeof(malla));
+	if (planificaMalla(op->N, op->P) != 0)
+		return -1;
+	if (op->N < malla.pc) {
+		fprintf(stderr, "SUMMA: N=%d es menor que las %d columnas de la malla %d×%d\n",
+		        op->N, malla.pc, malla.pr, malla.pc);
+		return -1;
+	}
+
+	malla.estad = mmap(NULL, (size_t) op->P * sizeof(struct estadSumma), PROT_READ | PROT_WRITE,
+	                   MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (malla.estad == MAP_FAILED) {
+		malla.estad = NULL;
+		return -1;
+	}
+	if (abreCanales(op->P) != 0)
+		return -1;
+
+	if (op->informe)
+		informeMalla(stderr);
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * multiplicaSumma — Una multiplicación C = A·B con la malla de procesos.
+ *
+ * Parámetros:
+ *  - mC: debe estar en memoria compartida para que el padre reciba C.
+ *
+ * Descripción:
+ *  Crea un proceso por nodo de la malla y espera a todos; si alguno falla,
+ *  el programa termina. Retorna el tiempo desde el primer `fork()` hasta el
+ *  último `wait()`, en µs.
+ *---------------------------------------------------------------------------*/
+static double multiplicaSumma(const struct opciones *op, const double *mA, const double *mB, double *mC) {
+	int fallo = 0;
+
+	fflush(stdout);
+	fflush(stderr);
+	inicioFase(medida, MM_FASE_MULTIPLICACION);
+	for (int p = 0; p < op->P; p++) {
+		pid_t pid = fork();
+
+		if (pid == 0) {
+			inicioTrabajador(medida, p);
+			int r = procesoSumma(op, mA, mB, mC, p);
+			finTrabajador(medida, p);
+			if (r != 0)
+				fprintf(stderr, "SUMMA: el proceso %d (%d, %d) no pudo completar su bloque\n",
+				        p, p / malla.pc, p % malla.pc);
+			_exit(r != 0);
+		}
+		else if (pid < 0) {
+			perror("Error al crear el proceso con fork");
+			exit(1);
+		}
+	}
+	for (int p = 0; p < op->P; p++) {
+		int estado;
+
+		if (wait(&estado) < 0 || !WIFEXITED(estado) || WEXITSTATUS(estado) != 0)
+			fallo = 1;
+	}
+	double t = finFase(medida, MM_FASE_MULTIPLICACION);
+
+	if (fallo)
+		exit(1);
+	malla.multiplicaciones++;
+	return t;
+}
+
+/*-----------------------------------------------------------------------------
+ * terminaSumma — Con `-v` resume la comunicación; cierra los sockets y
+ * libera la malla.
+ *---------------------------------------------------------------------------*/
+static void terminaSumma(const struct opciones *op) {
+	if (op->informe && malla.estad != NULL && malla.multiplicaciones > 0)
+		informeComunicacion(stderr);
+	cierraCanales(op->P);
+	if (malla.estad != NULL)
+		munmap(malla.estad, (size_t) op->P * sizeof(struct estadSumma));
+	free(malla.cortesF);
+	free(malla.cortesC);
+	memset(&malla, 0, sizeof(malla));
+	medida = NULL;
+}
+
+const struct motor motorSumma = { "summa", iniciaSumma, multiplicaSumma, terminaSumma, 0 };
+
+#ifndef MM_BINARIO_UNICO
+
+/*-----------------------------------------------------------------------------
+ * main — Función principal del programa.
+ *
+ * Descripción:
+ *  1. Valida los parámetros y las opciones (ver mmComun.c); con `--files`
+ *     multiplica las matrices de los archivos con `ejecutaArchivo()`
+ *     (mmArchivo.c), sin `--budget`, y con `--density` una A dispersa con
+ *     `ejecutaDispersa()` (mmDispersa.c).
+ *  2. Reserva A y B (que los procesos leen de la copia heredada) y C en
+ *     memoria compartida, y las inicializa.
+ *  3. Prepara el motor (`iniciaSumma()`: malla y sockets), multiplica y
+ *     muestra el tiempo (µs).
+ *  4. Con `-v` informa la huella y la comunicación; con `--verify`
+ *     comprueba C = A·B fuera del tiempo medido.
+ *---------------------------------------------------------------------------*/
+int main(int argc, char *argv[]) {
+	struct opciones op;
+	leerOpciones(argc, argv, "./mmSummaProcesos", &op);
+	if (op.archivos[0] != NULL)
+		return ejecutaArchivo(&op, &motorSumma, 1, "mmSummaProcesos");
+	if (op.densidad > 0.0)
+		return ejecutaDispersa(&op, &motorSumma, 1, "mmSummaProcesos");
+
+	int N = op.N;
+	int num_P = op.P;
+
+	if (compruebaHuella(N, 3, stderr) != 0)
+		exit(1);
+
+	double *matrixA = reservaMatriz((size_t) N * N, op.paginas, 0, op.precarga);
+	double *matrixB = reservaMatriz((size_t) N * N, op.paginas, 0, op.precarga);
+	double *matrixC = reservaMatriz((size_t) N * N, op.paginas, 1, op.precarga);
+	if (matrixA == NULL || matrixB == NULL || matrixC == NULL) {
+		perror("Error al reservar memoria para las matrices");
+		exit(1);
+	}
+
+	struct medicion tiempos;
+	struct contadores contadores;
+
+	if (iniMedicion(&tiempos, num_P) != 0) {
+		perror("Error al reservar las marcas de tiempo");
+		exit(1);
+	}
+
+	if (op.contadores) {
+		if (iniContadores(&contadores, num_P) != 0) {
+			perror("Error al reservar los contadores");
+			exit(1);
+		}
+		tiempos.cont = &contadores;
+	}
+
+	inicioFase(&tiempos, MM_FASE_INICIALIZACION);
+	iniMatrixFilas(matrixA, matrixB, N, 0, N, op.semilla);
+	finFase(&tiempos, MM_FASE_INICIALIZACION);
+
+	if (motorSumma.iniciar(&op, &tiempos) != 0)
+		exit(1);
+	double tMult = motorSumma.multiplicar(&op, matrixA, matrixB, matrixC);
+
+	printf("%9.0f ", tMult);
+	if (op.contadores)
+		columnasContadores(&contadores, 2.0 * N * N * N, tMult, stdout);
+	printf("\n");
+
+	if (op.informe)
+		informeHuella(N, 3, tMult, 1, stderr);
+	motorSumma.terminar(&op);
+
+	int fallo = op.verifica ? verificaProducto(matrixA, matrixB, matrixC, N, op.semilla, stderr) : 0;
+
+	escribeMedicion(&tiempos, op.formatoTiempo, "mmSummaProcesos", N, stderr);
+	if (op.contadores) {
+		informeContadores(&contadores, op.informe, stderr);
+		liberaContadores(&contadores);
+	}
+	finMedicion(&tiempos);
+
+	liberaMatriz(matrixA, (size_t) N * N, op.paginas);
+	liberaMatriz(matrixB, (size_t) N * N, op.paginas);
+	liberaMatriz(matrixC, (size_t) N * N, op.paginas);
+
+	return fallo;
+}
+
+#endif /* MM_BINARIO_UNICO */
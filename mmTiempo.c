@@ -0,0 +1,255 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * Descripción general:
+ * ---------------------------------------------------------------
+ * Instrumentación de tiempos por fase y por trabajador.
+ *
+ * Cada programa marca sus fases con `inicioFase()`/`finFase()` y cada hilo o
+ * proceso hijo marca su trabajo con `inicioTrabajador()`/`finTrabajador()`.
+ * A partir de ambas se derivan, para la última multiplicación:
+ *  - lanzamiento: desde que el programa lanza el trabajo hasta que empieza
+ *    el primer trabajador (fork, despertar del pool o región paralela).
+ *  - cálculo: desde el primer inicio hasta el último fin de trabajador.
+ *  - sincronización: desde el último fin hasta que el programa recupera el
+ *    control (wait, barrera final o fin de la región paralela).
+ *  - desequilibrio: tiempo ocupado máximo / medio − 1 (0 = perfecto).
+ *
+ * Los tiempos se leen con `clock_gettime(CLOCK_MONOTONIC)` (resolución de
+ * nanosegundos, sin saltos por ajustes del reloj) y, en x86, también se
+ * acumulan ciclos del TSC por trabajador.
+ *
+ * Salida (`--timing`, en stderr):
+ *  - csv: una fila por fase, valor derivado y trabajador, con las columnas
+ *         registro,nombre,inicio_us,fin_us,duracion_us,ciclos
+ *         (inicio/fin son de la última ejecución; duracion_us de una fase o
+ *         de un trabajador suma todas las ejecuciones, p. ej. con `-r`).
+ *  - json: un objeto con "fases", "derivadas" y "trabajadores".
+ *
+ * ---------------------------------------------------------------
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/mman.h>
+#include "mmTiempo.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+static const char *nombresFase[MM_FASES] = {
+	"inicializacion", "arranque", "transposicion", "multiplicacion", "compresion"
+};
+
+/*-----------------------------------------------------------------------------
+ * ahoraUs — Instante actual en microsegundos (CLOCK_MONOTONIC).
+ *---------------------------------------------------------------------------*/
+double ahoraUs(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double) ts.tv_sec * 1e6 + (double) ts.tv_nsec * 1e-3;
+}
+
+/*-----------------------------------------------------------------------------
+ * ciclosTsc — Lectura del contador de ciclos (0 fuera de x86).
+ *---------------------------------------------------------------------------*/
+uint64_t ciclosTsc(void) {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+/*-----------------------------------------------------------------------------
+ * formatoTiempoPorNombre — Traduce "csv" o "json" a MM_TIEMPO_*.
+ *
+ * Descripción:
+ *  Retorna -1 si el nombre no corresponde a ningún formato.
+ *---------------------------------------------------------------------------*/
+int formatoTiempoPorNombre(const char *nombre) {
+	if (strcmp(nombre, "csv") == 0)
+		return MM_TIEMPO_CSV;
+	if (strcmp(nombre, "json") == 0)
+		return MM_TIEMPO_JSON;
+	return -1;
+}
+
+/*-----------------------------------------------------------------------------
+ * iniMedicion — Prepara la medición para `nH` trabajadores.
+ *
+ * Descripción:
+ *  Las marcas de los trabajadores se ubican en una región anónima compartida
+ *  (`mmap` MAP_SHARED), de modo que sirven igual para hilos que para los
+ *  procesos hijos de la versión Fork. Retorna -1 si la reserva falla.
+ *---------------------------------------------------------------------------*/
+int iniMedicion(struct medicion *m, int nH) {
+	void *region = mmap(NULL, (size_t) nH * sizeof(struct trabajador), PROT_READ | PROT_WRITE,
+	                    MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+	memset(m, 0, sizeof(*m));
+	if (region == MAP_FAILED)
+		return -1;
+
+	m->nH = nH;
+	m->trab = (struct trabajador *) region;
+	for (int i = 0; i < nH; i++)
+		m->trab[i].inicio = -1.0;
+	m->t0 = ahoraUs();
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * inicioFase / finFase — Delimitan una ejecución de la fase indicada.
+ *
+ * Descripción:
+ *  `finFase()` acumula la duración y la retorna en µs, de modo que sustituye
+ *  directamente a `FinMuestra()` en los programas.
+ *---------------------------------------------------------------------------*/
+void inicioFase(struct medicion *m, int fase) {
+	m->fase[fase].inicio = ahoraUs() - m->t0;
+}
+
+double finFase(struct medicion *m, int fase) {
+	struct fase *f = &m->fase[fase];
+
+	f->fin = ahoraUs() - m->t0;
+	f->total += f->fin - f->inicio;
+	f->veces++;
+	return f->fin - f->inicio;
+}
+
+/*-----------------------------------------------------------------------------
+ * inicioTrabajador / finTrabajador — Delimitan la parte de un trabajador.
+ *
+ * Descripción:
+ *  Cada trabajador escribe solo su propia entrada, así que no hace falta
+ *  sincronización. Con `--counters` los contadores de hardware se abren
+ *  antes de la marca inicial y se cierran después de la final, para que su
+ *  costo no cuente en el intervalo del trabajador.
+ *---------------------------------------------------------------------------*/
+void inicioTrabajador(struct medicion *m, int idH) {
+	struct trabajador *t = &m->trab[idH];
+
+	inicioContadores(m->cont, idH);
+	t->inicio = ahoraUs() - m->t0;
+	t->tsc = ciclosTsc();
+}
+
+void finTrabajador(struct medicion *m, int idH) {
+	struct trabajador *t = &m->trab[idH];
+
+	t->ciclos += ciclosTsc() - t->tsc;
+	t->fin = ahoraUs() - m->t0;
+	t->ocupado += t->fin - t->inicio;
+	finContadores(m->cont, idH);
+}
+
+/*-----------------------------------------------------------------------------
+ * derivadas — Lanzamiento, cálculo, sincronización y desequilibrio de la
+ * última multiplicación (ver descripción del archivo).
+ *---------------------------------------------------------------------------*/
+static void derivadas(const struct medicion *m, double valor[4]) {
+	const struct fase *f = &m->fase[MM_FASE_MULTIPLICACION];
+	double primero = 0.0, ultimo = 0.0, maximo = 0.0, suma = 0.0;
+	int n = 0;
+
+	for (int i = 0; i < m->nH; i++) {
+		const struct trabajador *t = &m->trab[i];
+
+		if (t->inicio < 0.0)
+			continue;
+		if (n == 0 || t->inicio < primero) primero = t->inicio;
+		if (n == 0 || t->fin > ultimo)     ultimo = t->fin;
+		if (t->ocupado > maximo)           maximo = t->ocupado;
+		suma += t->ocupado;
+		n++;
+	}
+
+	if (n == 0 || f->veces == 0) {
+		memset(valor, 0, 4 * sizeof(double));
+		return;
+	}
+	valor[0] = primero - f->inicio;
+	valor[1] = ultimo - primero;
+	valor[2] = f->fin - ultimo;
+	valor[3] = (suma > 0.0) ? maximo / (suma / n) - 1.0 : 0.0;
+}
+
+static const char *nombresDerivada[4] = {
+	"lanzamiento", "calculo", "sincronizacion", "desequilibrio"
+};
+
+/*-----------------------------------------------------------------------------
+ * escribeMedicion — Escribe las marcas en CSV o JSON.
+ *
+ * Parámetros:
+ *  - m: medición.
+ *  - formato: MM_TIEMPO_CSV o MM_TIEMPO_JSON (MM_TIEMPO_NINGUNO no escribe).
+ *  - programa, N: identifican la ejecución en la salida JSON.
+ *  - f: flujo de salida (stderr en los programas).
+ *
+ * Descripción:
+ *  Solo se incluyen las fases que el programa ejecutó. Los tiempos van en µs
+ *  con tres decimales (resolución de nanosegundos).
+ *---------------------------------------------------------------------------*/
+void escribeMedicion(const struct medicion *m, int formato, const char *programa, int N, FILE *f) {
+	double valor[4];
+
+	derivadas(m, valor);
+
+	if (formato == MM_TIEMPO_CSV) {
+		fprintf(f, "registro,nombre,inicio_us,fin_us,duracion_us,ciclos\n");
+		for (int i = 0; i < MM_FASES; i++)
+			if (m->fase[i].veces > 0)
+				fprintf(f, "fase,%s,%.3f,%.3f,%.3f,\n", nombresFase[i],
+				        m->fase[i].inicio, m->fase[i].fin, m->fase[i].total);
+		for (int i = 0; i < 4; i++)
+			fprintf(f, "derivada,%s,,,%.3f,\n", nombresDerivada[i], valor[i]);
+		for (int i = 0; i < m->nH; i++) {
+			const struct trabajador *t = &m->trab[i];
+			if (t->inicio >= 0.0)
+				fprintf(f, "trabajador,%d,%.3f,%.3f,%.3f,%llu\n", i, t->inicio, t->fin,
+				        t->ocupado, (unsigned long long) t->ciclos);
+		}
+	}
+	else if (formato == MM_TIEMPO_JSON) {
+		int primero = 1;
+
+		fprintf(f, "{\"programa\": \"%s\", \"N\": %d, \"P\": %d,\n \"fases\": {", programa, N, m->nH);
+		for (int i = 0; i < MM_FASES; i++) {
+			if (m->fase[i].veces == 0)
+				continue;
+			fprintf(f, "%s\n  \"%s\": {\"inicio_us\": %.3f, \"fin_us\": %.3f, \"total_us\": %.3f, \"veces\": %d}",
+			        primero ? "" : ",", nombresFase[i], m->fase[i].inicio, m->fase[i].fin,
+			        m->fase[i].total, m->fase[i].veces);
+			primero = 0;
+		}
+		fprintf(f, "},\n \"derivadas\": {");
+		for (int i = 0; i < 4; i++)
+			fprintf(f, "%s\"%s\": %.3f", i ? ", " : "", nombresDerivada[i], valor[i]);
+		fprintf(f, "},\n \"trabajadores\": [");
+		primero = 1;
+		for (int i = 0; i < m->nH; i++) {
+			const struct trabajador *t = &m->trab[i];
+			if (t->inicio < 0.0)
+				continue;
+			fprintf(f, "%s\n  {\"id\": %d, \"inicio_us\": %.3f, \"fin_us\": %.3f, \"ocupado_us\": %.3f, \"ciclos\": %llu}",
+			        primero ? "" : ",", i, t->inicio, t->fin, t->ocupado, (unsigned long long) t->ciclos);
+			primero = 0;
+		}
+		fprintf(f, "]}\n");
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * finMedicion — Libera las marcas de los trabajadores.
+ *---------------------------------------------------------------------------*/
+void finMedicion(struct medicion *m) {
+	if (m->trab != NULL)
+		munmap(m->trab, (size_t) m->nH * sizeof(struct trabajador));
+	m->trab = NULL;
+}
@@ -0,0 +1,92 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * mmTiempo.h — Medición de tiempos por fase y por trabajador (hilo o
+ * proceso) con `clock_gettime(CLOCK_MONOTONIC)` y, en x86, el contador TSC.
+ *
+ * Reemplaza a `InicioMuestra()`/`FinMuestra()` (gettimeofday, resolución de
+ * 1 µs, una sola cifra que mezcla creación de hilos, cálculo y espera). Cada
+ * programa marca las fases que ejecuta y cada trabajador marca el inicio y
+ * el fin de su parte; con `--timing csv|json` todo se escribe en stderr.
+ */
+
+#ifndef MM_TIEMPO_H
+#define MM_TIEMPO_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "mmContadores.h"
+
+/* Fases medidas por los programas */
+#define MM_FASE_INICIALIZACION  0   /* llenado de A y B                     */
+#define MM_FASE_ARRANQUE        1   /* creación del pool de hilos (Posix)   */
+#define MM_FASE_TRANSPOSICION   2   /* construcción de Bᵀ (FilasOpenMP)     */
+#define MM_FASE_MULTIPLICACION  3   /* lanzamiento + cálculo + espera       */
+#define MM_FASE_COMPRESION      4   /* A densa → CSR (motor dispersa)       */
+#define MM_FASES                5
+
+/* Formatos de salida de `--timing` */
+#define MM_TIEMPO_NINGUNO  0
+#define MM_TIEMPO_CSV      1
+#define MM_TIEMPO_JSON     2
+
+/*-----------------------------------------------------------------------------
+ * Marca de una fase (tiempos en µs relativos a `t0`):
+ *  - inicio, fin: última vez que se ejecutó.
+ *  - total: suma de todas las ejecuciones (con `-r` hay varias).
+ *  - veces: número de ejecuciones.
+ *---------------------------------------------------------------------------*/
+struct fase {
+	double inicio;
+	double fin;
+	double total;
+	int veces;
+};
+
+/*-----------------------------------------------------------------------------
+ * Marca de un trabajador (una línea de cache cada uno para no compartirla):
+ *  - inicio, fin: intervalo de la última llamada (µs relativos a `t0`;
+ *    inicio < 0 si el trabajador no participó).
+ *  - ocupado: tiempo de cálculo acumulado en todas las llamadas.
+ *  - ciclos: ciclos TSC acumulados (0 si no hay TSC).
+ *  - tsc: lectura del TSC al comenzar la llamada en curso.
+ *---------------------------------------------------------------------------*/
+struct trabajador {
+	_Alignas(64) double inicio;
+	double fin;
+	double ocupado;
+	uint64_t ciclos;
+	uint64_t tsc;
+};
+
+/*-----------------------------------------------------------------------------
+ * Estado de la medición:
+ *  - nH: número de trabajadores.
+ *  - t0: instante de referencia (µs, CLOCK_MONOTONIC).
+ *  - fase: marcas de cada fase MM_FASE_*.
+ *  - trab: marcas por trabajador, en memoria compartida entre procesos para
+ *          que los hijos de la versión Fork también puedan escribirlas.
+ *  - cont: contadores de hardware que se leen junto con cada trabajador
+ *          (`--counters`); NULL si no se pidieron.
+ *---------------------------------------------------------------------------*/
+struct medicion {
+	int nH;
+	double t0;
+	struct fase fase[MM_FASES];
+	struct trabajador *trab;
+	struct contadores *cont;
+};
+
+double ahoraUs(void);
+uint64_t ciclosTsc(void);
+int formatoTiempoPorNombre(const char *nombre);
+
+int iniMedicion(struct medicion *m, int nH);
+void inicioFase(struct medicion *m, int fase);
+double finFase(struct medicion *m, int fase);
+void inicioTrabajador(struct medicion *m, int idH);
+void finTrabajador(struct medicion *m, int idH);
+void escribeMedicion(const struct medicion *m, int formato, const char *programa, int N, FILE *f);
+void finMedicion(struct medicion *m);
+
+#endif
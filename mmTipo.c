@@ -0,0 +1,824 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * Descripción general:
+ * ---------------------------------------------------------------
+ * Producto por tipo de elemento (`--type f64|f32|i16|i8`).
+ *
+ * Todos los kernels del taller multiplican double. Para cargas que toleran
+ * menos precisión, float duplica los elementos por registro SIMD y reduce
+ * a la mitad el tráfico con memoria, y los enteros de 8 y 16 bits lo
+ * reducen a 1/8 y 1/4 (acumulando en 32 bits para no desbordar).
+ *
+ * En lugar de cuatro copias del kernel de mmMicro.c, `MM_DEFINE_TIPO`
+ * genera para cada tipo, a partir de una sola definición:
+ *  - el empaquetado de A y B y el macro-kernel de cinco niveles de
+ *    GotoBLAS (como `multiFormaMicro()`), con los bordes resueltos igual;
+ *  - la transpuesta (para el motor `filas`), la inicialización con el
+ *    generador por contador (mmAleatorio.c) y la prueba de Freivalds.
+ *
+ * Solo los micro-kernels dependen de la familia:
+ *  - Punto flotante (double, float): `MM_MICRO_FMA` genera con vectores
+ *    de GCC la variante de 32 bytes (AVX2+FMA) y la de 64 (AVX-512) para
+ *    cada tipo; el bloque MR×NR es 4×(2 vectores): 4×8 / 4×16 en double y
+ *    4×16 / 4×32 en float.
+ *  - Enteros (int16, int8): A y B se empaquetan como pares de int16
+ *    consecutivos en k, de modo que vpmaddwd (`_mm256_madd_epi16`,
+ *    `_mm512_madd_epi16`) hace dos multiplicaciones y su suma por cada
+ *    elemento de 32 bits del acumulador. int8 se amplía a int16 al
+ *    empaquetar: comparte micro-kernel con int16 y su ventaja es el tráfico
+ *    con memoria de A y B.
+ * La variante escalar es una sola macro para los cuatro tipos.
+ *
+ * Con `--type` todos los motores usan este kernel (ver `multiTeselaComun()`
+ * en mmComun.c), también para f64, de modo que la comparación entre tipos
+ * mide solo el tipo de elemento; sin `--type` nada cambia. Los rangos de
+ * los enteros (|x| < 256 en int16, el rango completo de int8) hacen que
+ * N·|A|·|B| quepa en int32 hasta N = 32767 y 131071 respectivamente.
+ *
+ * ---------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <stdint.h>
+#include <immintrin.h>
+#include "mmTipo.h"
+#include "mmMicro.h"
+#include "mmAleatorio.h"
+#include "mmVerifica.h"
+#include "mmTiempo.h"
+#include "mmContadores.h"
+#include "mmMemoria.h"
+#include "mmMotor.h"
+
+/* Cota (exclusiva) de |x| en las matrices enteras */
+#define MM_I16_MAX  256.0
+#define MM_I8_MAX   128.0
+
+/* Mayor NR de todas las variantes (bloque temporal de los bordes) */
+#define MM_NR_MAX   32
+
+/* Lado de los bloques de la transpuesta */
+#define MM_TIPO_TRANS  32
+
+/*-----------------------------------------------------------------------------
+ * Resultado de la verificación de un tipo (como en mmVerifica.c):
+ *  - absMax, relMax: mayores errores absoluto y relativo de C·r.
+ *  - cotaMax: mayor error relativo a la tolerancia (> 1 → fallo).
+ *  - fila: componente de C·r con el peor error.
+ *---------------------------------------------------------------------------*/
+struct errorTipo {
+	double absMax;
+	double relMax;
+	double cotaMax;
+	int fila;
+};
+
+/*-----------------------------------------------------------------------------
+ * anotaError — Incorpora la diferencia `err` de la fila `fila` al resultado
+ * (`gamma` = 0 exige igualdad exacta, como en los tipos enteros).
+ *---------------------------------------------------------------------------*/
+static void anotaError(struct errorTipo *e, double err, double ref, double magnitud, double gamma, int fila) {
+	double rel = (ref != 0.0) ? err / fabs(ref) : err;
+	double cota = (err == 0.0) ? 0.0 : err / (gamma * magnitud + DBL_MIN);
+
+	if (isnan(err)) {
+		err = rel = cota = INFINITY;
+	}
+	if (err > e->absMax) e->absMax = err;
+	if (rel > e->relMax) e->relMax = rel;
+	if (cota > e->cotaMax) {
+		e->cotaMax = cota;
+		e->fila = fila;
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * Micro-kernels.
+ *
+ * Parámetros comunes (como en mmMicro.c):
+ *  - kg: grupos de k de la tira (kc / KP, con KP = 1 en punto flotante y 2
+ *        en enteros).
+ *  - pA: tira empaquetada de A (para cada grupo, las MR filas × KP).
+ *  - pB: tira empaquetada de B (para cada grupo, las NR columnas × KP).
+ *  - C: esquina del bloque MR×NR de C; ldc: su salto.
+ *  - acumula: 0 → C = A·B, 1 → C += A·B.
+ *---------------------------------------------------------------------------*/
+
+/* Micro-kernel escalar 4×4 para cualquier tipo empaquetado TP y acumulador TA */
+#define MM_MICRO_ESCALAR(nombre, TP, TA, KP)                                                   \
+static void nombre(int kg, const TP *restrict pA, const TP *restrict pB,                      \
+                   TA *restrict C, int ldc, int acumula) {                                    \
+	TA c[MM_MR][4] = {{0}};                                                                   \
+                                                                                              \
+	for (int g = 0; g < kg; g++, pA += MM_MR * (KP), pB += 4 * (KP))                          \
+		for (int r = 0; r < MM_MR; r++)                                                       \
+			for (int j = 0; j < 4; j++)                                                       \
+				for (int p = 0; p < (KP); p++)                                                \
+					c[r][j] += (TA) pA[r * (KP) + p] * (TA) pB[j * (KP) + p];                 \
+                                                                                              \
+	for (int r = 0; r < MM_MR; r++)                                                           \
+		for (int j = 0; j < 4; j++)                                                           \
+			C[r * ldc + j] = acumula ? C[r * ldc + j] + c[r][j] : c[r][j];                    \
+}
+
+/* Guarda (o suma y guarda) un vector en una posición quizá no alineada de C */
+#define MM_GUARDA_VEC(dest, v, BYTES, acumula, tmp)                                            \
+	do {                                                                                      \
+		if (acumula) {                                                                        \
+			memcpy(&tmp, dest, BYTES);                                                        \
+			v += tmp;                                                                         \
+		}                                                                                     \
+		memcpy(dest, &v, BYTES);                                                              \
+	} while (0)
+
+/* Micro-kernel de punto flotante 4×(2 vectores de BYTES bytes) con vectores
+ * de GCC; con el objetivo "avx2,fma" o "avx512f" cada `c += a * b` se
+ * compila como un FMA sobre el registro completo */
+#define MM_MICRO_FMA(nombre, TA, BYTES, OBJETIVO)                                              \
+typedef TA nombre##Vec __attribute__((vector_size(BYTES)));                                   \
+__attribute__((target(OBJETIVO)))                                                             \
+static void nombre(int kg, const TA *restrict pA, const TA *restrict pB,                      \
+                   TA *restrict C, int ldc, int acumula) {                                    \
+	const int L = (BYTES) / sizeof(TA);                                                       \
+	nombre##Vec c00 = {0}, c01 = {0}, c10 = {0}, c11 = {0};                                   \
+	nombre##Vec c20 = {0}, c21 = {0}, c30 = {0}, c31 = {0};                                   \
+	nombre##Vec b0, b1, t;                                                                    \
+                                                                                              \
+	for (int g = 0; g < kg; g++, pA += MM_MR, pB += 2 * L) {                                  \
+		memcpy(&b0, pB, BYTES);                                                               \
+		memcpy(&b1, pB + L, BYTES);                                                           \
+		c00 += pA[0] * b0; c01 += pA[0] * b1;                                                 \
+		c10 += pA[1] * b0; c11 += pA[1] * b1;                                                 \
+		c20 += pA[2] * b0; c21 += pA[2] * b1;                                                 \
+		c30 += pA[3] * b0; c31 += pA[3] * b1;                                                 \
+	}                                                                                         \
+                                                                                              \
+	MM_GUARDA_VEC(C + 0 * ldc, c00, BYTES, acumula, t);                                       \
+	MM_GUARDA_VEC(C + 0 * ldc + L, c01, BYTES, acumula, t);                                   \
+	MM_GUARDA_VEC(C + 1 * ldc, c10, BYTES, acumula, t);                                       \
+	MM_GUARDA_VEC(C + 1 * ldc + L, c11, BYTES, acumula, t);                                   \
+	MM_GUARDA_VEC(C + 2 * ldc, c20, BYTES, acumula, t);                                       \
+	MM_GUARDA_VEC(C + 2 * ldc + L, c21, BYTES, acumula, t);                                   \
+	MM_GUARDA_VEC(C + 3 * ldc, c30, BYTES, acumula, t);                                       \
+	MM_GUARDA_VEC(C + 3 * ldc + L, c31, BYTES, acumula, t);                                   \
+}
+
+MM_MICRO_ESCALAR(microF64Escalar, double, double, 1)
+MM_MICRO_FMA(microF64AVX2, double, 32, "avx2,fma")
+MM_MICRO_FMA(microF64AVX512, double, 64, "avx512f")
+
+MM_MICRO_ESCALAR(microF32Escalar, float, float, 1)
+MM_MICRO_FMA(microF32AVX2, float, 32, "avx2,fma")
+MM_MICRO_FMA(microF32AVX512, float, 64, "avx512f")
+
+MM_MICRO_ESCALAR(microEnteroEscalar, int16_t, int32_t, 2)
+
+/*-----------------------------------------------------------------------------
+ * parA — Par (A[r][k], A[r][k+1]) empaquetado, como un entero de 32 bits
+ * para difundirlo a todos los elementos del vector.
+ *---------------------------------------------------------------------------*/
+static inline int32_t parA(const int16_t *p) {
+	int32_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+__attribute__((target("avx2")))
+static void microEnteroAVX2(int kg, const int16_t *restrict pA, const int16_t *restrict pB,
+                            int32_t *restrict C, int ldc, int acumula) {
+	__m256i c00 = _mm256_setzero_si256(), c01 = _mm256_setzero_si256();
+	__m256i c10 = _mm256_setzero_si256(), c11 = _mm256_setzero_si256();
+	__m256i c20 = _mm256_setzero_si256(), c21 = _mm256_setzero_si256();
+	__m256i c30 = _mm256_setzero_si256(), c31 = _mm256_setzero_si256();
+
+	for (int g = 0; g < kg; g++, pA += 2 * MM_MR, pB += 32) {
+		__m256i b0 = _mm256_loadu_si256((const __m256i *) pB);
+		__m256i b1 = _mm256_loadu_si256((const __m256i *) (pB + 16));
+		__m256i a;
+
+		a = _mm256_set1_epi32(parA(pA + 0));
+		c00 = _mm256_add_epi32(c00, _mm256_madd_epi16(a, b0)); c01 = _mm256_add_epi32(c01, _mm256_madd_epi16(a, b1));
+		a = _mm256_set1_epi32(parA(pA + 2));
+		c10 = _mm256_add_epi32(c10, _mm256_madd_epi16(a, b0)); c11 = _mm256_add_epi32(c11, _mm256_madd_epi16(a, b1));
+		a = _mm256_set1_epi32(parA(pA + 4));
+		c20 = _mm256_add_epi32(c20, _mm256_madd_epi16(a, b0)); c21 = _mm256_add_epi32(c21, _mm256_madd_epi16(a, b1));
+		a = _mm256_set1_epi32(parA(pA + 6));
+		c30 = _mm256_add_epi32(c30, _mm256_madd_epi16(a, b0)); c31 = _mm256_add_epi32(c31, _mm256_madd_epi16(a, b1));
+	}
+
+	if (acumula) {
+		c00 = _mm256_add_epi32(c00, _mm256_loadu_si256((const __m256i *) (C + 0 * ldc)));
+		c01 = _mm256_add_epi32(c01, _mm256_loadu_si256((const __m256i *) (C + 0 * ldc + 8)));
+		c10 = _mm256_add_epi32(c10, _mm256_loadu_si256((const __m256i *) (C + 1 * ldc)));
+		c11 = _mm256_add_epi32(c11, _mm256_loadu_si256((const __m256i *) (C + 1 * ldc + 8)));
+		c20 = _mm256_add_epi32(c20, _mm256_loadu_si256((const __m256i *) (C + 2 * ldc)));
+		c21 = _mm256_add_epi32(c21, _mm256_loadu_si256((const __m256i *) (C + 2 * ldc + 8)));
+		c30 = _mm256_add_epi32(c30, _mm256_loadu_si256((const __m256i *) (C + 3 * ldc)));
+		c31 = _mm256_add_epi32(c31, _mm256_loadu_si256((const __m256i *) (C + 3 * ldc + 8)));
+	}
+	_mm256_storeu_si256((__m256i *) (C + 0 * ldc), c00); _mm256_storeu_si256((__m256i *) (C + 0 * ldc + 8), c01);
+	_mm256_storeu_si256((__m256i *) (C + 1 * ldc), c10); _mm256_storeu_si256((__m256i *) (C + 1 * ldc + 8), c11);
+	_mm256_storeu_si256((__m256i *) (C + 2 * ldc), c20); _mm256_storeu_si256((__m256i *) (C + 2 * ldc + 8), c21);
+	_mm256_storeu_si256((__m256i *) (C + 3 * ldc), c30); _mm256_storeu_si256((__m256i *) (C + 3 * ldc + 8), c31);
+}
+
+__attribute__((target("avx512bw")))
+static void microEnteroAVX512(int kg, const int16_t *restrict pA, const int16_t *restrict pB,
+                              int32_t *restrict C, int ldc, int acumula) {
+	__m512i c00 = _mm512_setzero_si512(), c01 = _mm512_setzero_si512();
+	__m512i c10 = _mm512_setzero_si512(), c11 = _mm512_setzero_si512();
+	__m512i c20 = _mm512_setzero_si512(), c21 = _mm512_setzero_si512();
+	__m512i c30 = _mm512_setzero_si512(), c31 = _mm512_setzero_si512();
+
+	for (int g = 0; g < kg; g++, pA += 2 * MM_MR, pB += 64) {
+		__m512i b0 = _mm512_loadu_si512(pB);
+		__m512i b1 = _mm512_loadu_si512(pB + 32);
+		__m512i a;
+
+		a = _mm512_set1_epi32(parA(pA + 0));
+		c00 = _mm512_add_epi32(c00, _mm512_madd_epi16(a, b0)); c01 = _mm512_add_epi32(c01, _mm512_madd_epi16(a, b1));
+		a = _mm512_set1_epi32(parA(pA + 2));
+		c10 = _mm512_add_epi32(c10, _mm512_madd_epi16(a, b0)); c11 = _mm512_add_epi32(c11, _mm512_madd_epi16(a, b1));
+		a = _mm512_set1_epi32(parA(pA + 4));
+		c20 = _mm512_add_epi32(c20, _mm512_madd_epi16(a, b0)); c21 = _mm512_add_epi32(c21, _mm512_madd_epi16(a, b1));
+		a = _mm512_set1_epi32(parA(pA + 6));
+		c30 = _mm512_add_epi32(c30, _mm512_madd_epi16(a, b0)); c31 = _mm512_add_epi32(c31, _mm512_madd_epi16(a, b1));
+	}
+
+	if (acumula) {
+		c00 = _mm512_add_epi32(c00, _mm512_loadu_si512(C + 0 * ldc)); c01 = _mm512_add_epi32(c01, _mm512_loadu_si512(C + 0 * ldc + 16));
+		c10 = _mm512_add_epi32(c10, _mm512_loadu_si512(C + 1 * ldc)); c11 = _mm512_add_epi32(c11, _mm512_loadu_si512(C + 1 * ldc + 16));
+		c20 = _mm512_add_epi32(c20, _mm512_loadu_si512(C + 2 * ldc)); c21 = _mm512_add_epi32(c21, _mm512_loadu_si512(C + 2 * ldc + 16));
+		c30 = _mm512_add_epi32(c30, _mm512_loadu_si512(C + 3 * ldc)); c31 = _mm512_add_epi32(c31, _mm512_loadu_si512(C + 3 * ldc + 16));
+	}
+	_mm512_storeu_si512(C + 0 * ldc, c00); _mm512_storeu_si512(C + 0 * ldc + 16, c01);
+	_mm512_storeu_si512(C + 1 * ldc, c10); _mm512_storeu_si512(C + 1 * ldc + 16, c11);
+	_mm512_storeu_si512(C + 2 * ldc, c20); _mm512_storeu_si512(C + 2 * ldc + 16, c21);
+	_mm512_storeu_si512(C + 3 * ldc, c30); _mm512_storeu_si512(C + 3 * ldc + 16, c31);
+}
+
+/*-----------------------------------------------------------------------------
+ * MM_DEFINE_TIPO — Genera el kernel completo de un tipo de elemento.
+ *
+ * Parámetros de la macro:
+ *  - suf: sufijo de las funciones generadas (F64, F32, I16, I8).
+ *  - T: tipo de A y B en memoria.
+ *  - TP: tipo empaquetado (el que recibe el micro-kernel).
+ *  - TA: tipo del acumulador y de C.
+ *  - KP: valores consecutivos de k por grupo empaquetado (1 o 2).
+ *  - ENTERO: 1 → valores enteros (redondeo hacia abajo al inicializar).
+ *  - TV: tipo de los productos matriz-vector de Freivalds (exacto en
+ *        enteros).
+ *  - NR2, NR5: ancho NR de las variantes AVX2 y AVX-512 (la escalar usa 4).
+ *  - esc, avx2, avx512: micro-kernels de cada variante.
+ *
+ * Genera:
+ *  - multi<suf>: C = A·B en [filaI, filaF) × [colI, colF) (ver
+ *    `multiTipo()`), con empaquetado y bordes como `multiFormaMicro()`.
+ *  - trans<suf>: filas [filaI, filaF) de B a columnas de Bᵀ.
+ *  - ini<suf>: filas [filaI, filaF) de A y B con el generador por contador.
+ *  - verifica<suf>: prueba de Freivalds (ver `verificaTipo()`).
+ *---------------------------------------------------------------------------*/
+#define MM_DEFINE_TIPO(suf, T, TP, TA, KP, ENTERO, TV, NR2, NR5, esc, avx2, avx512)            \
+typedef void (*micro##suf)(int, const TP *, const TP *, TA *, int, int);                      \
+static const micro##suf micros##suf[] = { esc, avx2, avx512 };                                \
+static const int anchos##suf[] = { 4, NR2, NR5 };                                             \
+                                                                                              \
+static void borde##suf(micro##suf micro, int nr, int kg, const TP *pA, const TP *pB,          \
+                       TA *C, int ldc, int m, int n, int acumula) {                           \
+	TA tmp[MM_MR * MM_NR_MAX];                                                                \
+                                                                                              \
+	micro(kg, pA, pB, tmp, nr, 0);                                                            \
+	for (int r = 0; r < m; r++)                                                               \
+		for (int j = 0; j < n; j++)                                                           \
+			C[r * ldc + j] = acumula ? C[r * ldc + j] + tmp[r * nr + j] : tmp[r * nr + j];    \
+}                                                                                             \
+                                                                                              \
+static void empacaA##suf(const T *A, int lda, int mc, int kc, TP *buf) {                      \
+	for (int ir = 0; ir < mc; ir += MM_MR) {                                                  \
+		int m = (mc - ir < MM_MR) ? mc - ir : MM_MR;                                          \
+                                                                                              \
+		for (int k0 = 0; k0 < kc; k0 += (KP))                                                 \
+			for (int r = 0; r < MM_MR; r++)                                                   \
+				for (int p = 0; p < (KP); p++)                                                \
+					*buf++ = (r < m && k0 + p < kc) ? (TP) A[(size_t) (ir + r) * lda + k0 + p] \
+					                                : (TP) 0;                                 \
+	}                                                                                         \
+}                                                                                             \
+                                                                                              \
+static void empacaB##suf(const T *B, int ldb, int bTrans, int kc, int nc, int nr, TP *buf) {  \
+	for (int jr = 0; jr < nc; jr += nr) {                                                     \
+		int n = (nc - jr < nr) ? nc - jr : nr;                                                \
+                                                                                              \
+		for (int k0 = 0; k0 < kc; k0 += (KP))                                                 \
+			for (int j = 0; j < nr; j++)                                                      \
+				for (int p = 0; p < (KP); p++) {                                              \
+					int k = k0 + p;                                                           \
+					if (j >= n || k >= kc)                                                    \
+						*buf++ = (TP) 0;                                                      \
+					else if (bTrans)                                                          \
+						*buf++ = (TP) B[(size_t) (jr + j) * ldb + k];                         \
+					else                                                                      \
+						*buf++ = (TP) B[(size_t) k * ldb + jr + j];                           \
+				}                                                                             \
+	}                                                                                         \
+}                                                                                             \
+                                                                                              \
+static void multi##suf(const void *vA, const void *vB, int bTrans, void *vC, int D,          \
+                       int filaI, int filaF, int colI, int colF, int kernel) {                \
+	const T *mA = vA, *mB = vB;                                                               \
+	TA *mC = vC;                                                                              \
+	micro##suf micro = micros##suf[kernel];                                                   \
+	int nr = anchos##suf[kernel];                                                             \
+	int ncMax = (colF - colI < MM_NC) ? colF - colI : MM_NC;                                  \
+	TP *bufA = aligned_alloc(64, sizeof(TP) * MM_MC * MM_KC);                                 \
+	TP *bufB = aligned_alloc(64, sizeof(TP) * MM_KC * (size_t) ((ncMax + nr - 1) / nr * nr)); \
+                                                                                              \
+	for (int jc = colI; jc < colF; jc += MM_NC) {                                             \
+		int nc = (colF - jc < MM_NC) ? colF - jc : MM_NC;                                     \
+                                                                                              \
+		for (int pc = 0; pc < D; pc += MM_KC) {                                               \
+			int kc = (D - pc < MM_KC) ? D - pc : MM_KC;                                       \
+			int kp = (kc + (KP) - 1) / (KP) * (KP);                                           \
+			int acumula = (pc > 0);                                                           \
+			const T *panelB = bTrans ? mB + (size_t) jc * D + pc : mB + (size_t) pc * D + jc; \
+                                                                                              \
+			empacaB##suf(panelB, D, bTrans, kc, nc, nr, bufB);                                \
+                                                                                              \
+			for (int ic = filaI; ic < filaF; ic += MM_MC) {                                   \
+				int mc = (filaF - ic < MM_MC) ? filaF - ic : MM_MC;                           \
+                                                                                              \
+				empacaA##suf(mA + (size_t) ic * D + pc, D, mc, kc, bufA);                     \
+                                                                                              \
+				for (int jr = 0; jr < nc; jr += nr) {                                         \
+					int n = (nc - jr < nr) ? nc - jr : nr;                                    \
+                                                                                              \
+					for (int ir = 0; ir < mc; ir += MM_MR) {                                  \
+						int m = (mc - ir < MM_MR) ? mc - ir : MM_MR;                          \
+						const TP *pA = bufA + (size_t) ir * kp;                               \
+						const TP *pB = bufB + (size_t) jr * kp;                               \
+						TA *C = mC + (size_t) (ic + ir) * D + jc + jr;                        \
+                                                                                              \
+						if (m == MM_MR && n == nr)                                            \
+							micro(kp / (KP), pA, pB, C, D, acumula);                          \
+						else                                                                  \
+							borde##suf(micro, nr, kp / (KP), pA, pB, C, D, m, n, acumula);    \
+					}                                                                         \
+				}                                                                             \
+			}                                                                                 \
+		}                                                                                     \
+	}                                                                                         \
+                                                                                              \
+	free(bufA);                                                                               \
+	free(bufB);                                                                               \
+}                                                                                             \
+                                                                                              \
+static void trans##suf(const void *vB, void *vBt, int D, int filaI, int filaF) {              \
+	const T *B = vB;                                                                          \
+	T *Bt = vBt;                                                                              \
+                                                                                              \
+	for (int jj = 0; jj < D; jj += MM_TIPO_TRANS) {                                           \
+		int jF = (jj + MM_TIPO_TRANS < D) ? jj + MM_TIPO_TRANS : D;                           \
+                                                                                              \
+		for (int i = filaI; i < filaF; i++)                                                   \
+			for (int j = jj; j < jF; j++)                                                     \
+				Bt[(size_t) j * D + i] = B[(size_t) i * D + j];                               \
+	}                                                                                         \
+}                                                                                             \
+                                                                                              \
+static void llena##suf(T *m, size_t ini, size_t fin, uint64_t semilla, double lo, double hi) { \
+	for (size_t i = ini; i < fin; i++) {                                                      \
+		double x = lo + aleatorioEn(semilla, i) * (hi - lo);                                  \
+		m[i] = (T) ((ENTERO) ? floor(x) : x);                                                 \
+	}                                                                                         \
+}                                                                                             \
+                                                                                              \
+static void ini##suf(void *vA, void *vB, int D, int filaI, int filaF, uint64_t semilla,      \
+                     const double *rango) {                                                   \
+	size_t ini = (size_t) filaI * D, fin = (size_t) filaF * D;                                \
+                                                                                              \
+	llena##suf(vA, ini, fin, semillaMatriz(semilla, 0xA), rango[0], rango[1]);                \
+	llena##suf(vB, ini, fin, semillaMatriz(semilla, 0xB), rango[2], rango[3]);                \
+}                                                                                             \
+                                                                                              \
+static int verifica##suf(const void *vA, const void *vB, const void *vC, int D,              \
+                         uint64_t semilla, double gamma, struct errorTipo *e) {               \
+	const T *A = vA, *B = vB;                                                                 \
+	const TA *C = vC;                                                                         \
+	TV *r = malloc(4 * (size_t) D * sizeof(TV));                                              \
+	double *magB = malloc(2 * (size_t) D * sizeof(double));                                   \
+	double lim = (ENTERO) ? 1024.0 : 1.0;                                                     \
+                                                                                              \
+	if (r == NULL || magB == NULL) {                                                          \
+		free(r); free(magB);                                                                  \
+		return -1;                                                                            \
+	}                                                                                         \
+	TV *Br = r + D, *ABr = Br + D, *Cr = ABr + D;                                             \
+	double *mag = magB + D;                                                                   \
+                                                                                              \
+	for (int v = 0; v < MM_FREIVALDS_VECTORES; v++) {                                         \
+		for (int j = 0; j < D; j++) {                                                         \
+			double x = -lim + aleatorioEn(semilla ^ (0xF2E1D0C0ULL + v), j) * 2.0 * lim;      \
+			r[j] = (TV) ((ENTERO) ? floor(x) : x);                                            \
+		}                                                                                     \
+		for (int i = 0; i < D; i++) {                                                         \
+			const T *fB = B + (size_t) i * D;                                                 \
+			const TA *fC = C + (size_t) i * D;                                                \
+			TV sB = 0, sC = 0;                                                                \
+			double aB = 0.0;                                                                  \
+                                                                                              \
+			for (int j = 0; j < D; j++) {                                                     \
+				sB += (TV) fB[j] * r[j];                                                      \
+				sC += (TV) fC[j] * r[j];                                                      \
+				aB += fabs((double) fB[j]) * fabs((double) r[j]);                             \
+			}                                                                                 \
+			Br[i] = sB;                                                                       \
+			Cr[i] = sC;                                                                       \
+			magB[i] = aB;                                                                     \
+		}                                                                                     \
+		for (int i = 0; i < D; i++) {                                                         \
+			const T *fA = A + (size_t) i * D;                                                 \
+			TV s = 0;                                                                         \
+			double a = 0.0;                                                                   \
+                                                                                              \
+			for (int k = 0; k < D; k++) {                                                     \
+				s += (TV) fA[k] * Br[k];                                                      \
+				a += fabs((double) fA[k]) * magB[k];                                          \
+			}                                                                                 \
+			ABr[i] = s;                                                                       \
+			mag[i] = a;                                                                       \
+		}                                                                                     \
+		for (int i = 0; i < D; i++)                                                           \
+			anotaError(e, fabs((double) (Cr[i] - ABr[i])), (double) ABr[i], mag[i], gamma, i); \
+	}                                                                                         \
+                                                                                              \
+	free(r);                                                                                  \
+	free(magB);                                                                               \
+	return 0;                                                                                 \
+}
+
+MM_DEFINE_TIPO(F64, double, double, double, 1, 0, double, 8, 16,
+               microF64Escalar, microF64AVX2, microF64AVX512)
+MM_DEFINE_TIPO(F32, float, float, float, 1, 0, double, 16, 32,
+               microF32Escalar, microF32AVX2, microF32AVX512)
+MM_DEFINE_TIPO(I16, int16_t, int16_t, int32_t, 2, 1, int64_t, 16, 32,
+               microEnteroEscalar, microEnteroAVX2, microEnteroAVX512)
+MM_DEFINE_TIPO(I8, int8_t, int16_t, int32_t, 2, 1, int64_t, 16, 32,
+               microEnteroEscalar, microEnteroAVX2, microEnteroAVX512)
+
+/*-----------------------------------------------------------------------------
+ * Descripción de cada tipo:
+ *  - nombre: nombre para `--type`.
+ *  - bytes, bytesC: tamaño de un elemento de A y B, y de C.
+ *  - rango: A en [rango[0], rango[1]) y B en [rango[2], rango[3]).
+ *  - epsilon: precisión de la acumulación (0 en enteros: resultado exacto).
+ *  - multi, trans, ini, verifica: funciones generadas por MM_DEFINE_TIPO.
+ *---------------------------------------------------------------------------*/
+struct descTipo {
+	const char *nombre;
+	size_t bytes;
+	size_t bytesC;
+	double rango[4];
+	double epsilon;
+	void (*multi)(const void *, const void *, int, void *, int, int, int, int, int, int);
+	void (*trans)(const void *, void *, int, int, int);
+	void (*ini)(void *, void *, int, int, int, uint64_t, const double *);
+	int (*verifica)(const void *, const void *, const void *, int, uint64_t, double, struct errorTipo *);
+};
+
+static const struct descTipo descriptores[] = {
+	{ "f64", sizeof(double), sizeof(double), { MM_A_MIN, MM_A_MAX, MM_B_MIN, MM_B_MAX }, DBL_EPSILON,
+	  multiF64, transF64, iniF64, verificaF64 },
+	{ "f32", sizeof(float), sizeof(float), { MM_A_MIN, MM_A_MAX, MM_B_MIN, MM_B_MAX }, FLT_EPSILON,
+	  multiF32, transF32, iniF32, verificaF32 },
+	{ "i16", sizeof(int16_t), sizeof(int32_t), { -MM_I16_MAX, MM_I16_MAX, -MM_I16_MAX, MM_I16_MAX }, 0.0,
+	  multiI16, transI16, iniI16, verificaI16 },
+	{ "i8", sizeof(int8_t), sizeof(int32_t), { -MM_I8_MAX, MM_I8_MAX, -MM_I8_MAX, MM_I8_MAX }, 0.0,
+	  multiI8, transI8, iniI8, verificaI8 },
+};
+#define MM_TIPOS ((int) (sizeof(descriptores) / sizeof(descriptores[0])))
+
+/*-----------------------------------------------------------------------------
+ * tipoPorNombre — Traduce un nombre de `--type` (f64, f32, i16, i8) a
+ * MM_TIPO_*; MM_TIPO_NINGUNO si no existe.
+ *---------------------------------------------------------------------------*/
+int tipoPorNombre(const char *nombre) {
+	for (int t = 0; t < MM_TIPOS; t++)
+		if (strcmp(nombre, descriptores[t].nombre) == 0)
+			return t;
+	return MM_TIPO_NINGUNO;
+}
+
+/*-----------------------------------------------------------------------------
+ * nombreTipo — Nombre legible de un tipo ("double" sin `--type`).
+ *---------------------------------------------------------------------------*/
+const char *nombreTipo(int tipo) {
+	return (tipo >= 0 && tipo < MM_TIPOS) ? descriptores[tipo].nombre : "double";
+}
+
+/*-----------------------------------------------------------------------------
+ * leeTipos — Interpreta la lista de `--type` ("f32" o "f64,f32,i8").
+ *
+ * Parámetros:
+ *  - texto: nombres separados por comas.
+ *  - tipos: destino, con capacidad para MM_MAX_TIPOS tipos.
+ *
+ * Retorna el número de tipos, o -1 si alguno no existe o hay demasiados.
+ *---------------------------------------------------------------------------*/
+int leeTipos(const char *texto, int *tipos) {
+	char copia[128], *nombre, *resto;
+	int n = 0;
+
+	if (snprintf(copia, sizeof(copia), "%s", texto) >= (int) sizeof(copia))
+		return -1;
+	for (nombre = strtok_r(copia, ",", &resto); nombre != NULL; nombre = strtok_r(NULL, ",", &resto)) {
+		int t = tipoPorNombre(nombre);
+
+		if (t == MM_TIPO_NINGUNO || n == MM_MAX_TIPOS)
+			return -1;
+		tipos[n++] = t;
+	}
+	return (n > 0) ? n : -1;
+}
+
+/*-----------------------------------------------------------------------------
+ * bytesTipo / bytesResultado — Bytes por elemento de A y B, y de C.
+ *---------------------------------------------------------------------------*/
+size_t bytesTipo(int tipo) {
+	return descriptores[tipo].bytes;
+}
+
+size_t bytesResultado(int tipo) {
+	return descriptores[tipo].bytesC;
+}
+
+/*-----------------------------------------------------------------------------
+ * elemsTipo — doubles (alineados, ver `elemsAlineados()`) que ocupa una
+ * matriz de `elems` elementos de `bytes` bytes; las reservas del taller se
+ * hacen en doubles.
+ *---------------------------------------------------------------------------*/
+size_t elemsTipo(size_t elems, size_t bytes) {
+	return elemsAlineados((elems * bytes + sizeof(double) - 1) / sizeof(double));
+}
+
+/*-----------------------------------------------------------------------------
+ * kernelTipo — Variante del micro-kernel para un tipo.
+ *
+ * Descripción:
+ *  Sin `-k` se usa la detectada. La variante AVX-512 de los enteros usa
+ *  vpmaddwd de 512 bits (AVX-512BW); si el CPU solo tiene AVX-512F se
+ *  usa la de AVX2.
+ *---------------------------------------------------------------------------*/
+int kernelTipo(int tipo, int kernel) {
+	if (kernel == MM_KERNEL_NINGUNO)
+		kernel = kernelDetectado();
+	if (kernel == MM_KERNEL_AVX512 && descriptores[tipo].epsilon == 0.0 && !__builtin_cpu_supports("avx512bw"))
+		kernel = MM_KERNEL_AVX2;
+	return kernel;
+}
+
+/*-----------------------------------------------------------------------------
+ * multiTipo — C = A·B en una región de C para el tipo `tipo`.
+ *
+ * Parámetros:
+ *  - mA, mB, mC: matrices D×D por filas del tipo (C de `bytesResultado()`
+ *                bytes por elemento); `mB` es Bᵀ si `bTrans` = 1.
+ *  - filaI, filaF, colI, colF: región de C a calcular.
+ *  - kernel: variante pedida con `-k` (MM_KERNEL_NINGUNO → la detectada).
+ *
+ * Descripción:
+ *  Como `multiMatrixMicro()`: los buffers de empaquetado son propios de
+ *  cada llamada, así que puede llamarse desde varios hilos o procesos.
+ *---------------------------------------------------------------------------*/
+void multiTipo(int tipo, const void *mA, const void *mB, int bTrans, void *mC, int D,
+               int filaI, int filaF, int colI, int colF, int kernel) {
+	if (filaF <= filaI || colF <= colI)
+		return;
+	descriptores[tipo].multi(mA, mB, bTrans, mC, D, filaI, filaF, colI, colF, kernelTipo(tipo, kernel));
+}
+
+/*-----------------------------------------------------------------------------
+ * transTipo — Copia las filas [filaI, filaF) de B (D×D) a las columnas
+ * correspondientes de Bᵀ.
+ *---------------------------------------------------------------------------*/
+void transTipo(int tipo, const void *mB, void *mBt, int D, int filaI, int filaF) {
+	descriptores[tipo].trans(mB, mBt, D, filaI, filaF);
+}
+
+/*-----------------------------------------------------------------------------
+ * iniTipoFilas — Inicializa las filas [filaI, filaF) de A y B del tipo.
+ *
+ * Descripción:
+ *  Como `iniMatrixFilas()`: cada elemento depende solo de la semilla y de
+ *  su posición. Los tipos de punto flotante usan los rangos de siempre
+ *  (f64 coincide bit a bit con la inicialización sin `--type`); los
+ *  enteros son uniformes en [-256, 256) (i16) o en todo int8.
+ *---------------------------------------------------------------------------*/
+void iniTipoFilas(int tipo, void *mA, void *mB, int D, int filaI, int filaF, uint64_t semilla) {
+	descriptores[tipo].ini(mA, mB, D, filaI, filaF, semilla, descriptores[tipo].rango);
+}
+
+/*-----------------------------------------------------------------------------
+ * verificaTipo — Comprueba que C = A·B para el tipo `tipo` e informa el
+ * error.
+ *
+ * Descripción:
+ *  Siempre con la prueba de Freivalds (MM_FREIVALDS_VECTORES vectores,
+ *  costo O(N²)). En punto flotante la tolerancia es la de mmVerifica.c con
+ *  la precisión del tipo (4·N·ε, ε de float en f32); en enteros los
+ *  productos se calculan en int64 con vectores enteros en [-1024, 1024) y
+ *  se exige igualdad exacta. Retorna 0 si C es correcta y 1 si no (o si
+ *  no hubo memoria para verificar).
+ *---------------------------------------------------------------------------*/
+int verificaTipo(int tipo, const void *mA, const void *mB, const void *mC, int D,
+                 uint64_t semilla, FILE *f) {
+	const struct descTipo *d = &descriptores[tipo];
+	struct errorTipo e = { 0.0, 0.0, 0.0, -1 };
+
+	if (d->verifica(mA, mB, mC, D, semilla, 4.0 * D * d->epsilon, &e) != 0) {
+		fprintf(f, "Verificación: sin memoria para la comprobación\n");
+		return 1;
+	}
+
+	int correcto = (e.cotaMax <= 1.0);
+
+	fprintf(f, "Verificación (Freivalds, %d vectores, %s): error máx. abs %.3e, rel %.3e — %s\n",
+	        MM_FREIVALDS_VECTORES, d->nombre, e.absMax, e.relMax, correcto ? "CORRECTO" : "INCORRECTO");
+	if (!correcto)
+		fprintf(f, "  peor componente: (C·r)[%d] (fila %d de C)\n", e.fila, e.fila);
+	return correcto ? 0 : 1;
+}
+
+/*-----------------------------------------------------------------------------
+ * huellaTipo — Bytes de A, B y C de N×N del tipo, o 0 si no caben en el
+ * espacio de direcciones.
+ *---------------------------------------------------------------------------*/
+static size_t huellaTipo(int tipo, int N) {
+	size_t nn = (size_t) N * N;
+
+	if (nn > SIZE_MAX / 16)
+		return 0;
+	return (2 * elemsTipo(nn, bytesTipo(tipo)) + elemsTipo(nn, bytesResultado(tipo))) * sizeof(double);
+}
+
+/*-----------------------------------------------------------------------------
+ * compruebaTipo — Valida N para el tipo: que la suma de N productos no
+ * desborde el acumulador de 32 bits de los enteros y que A, B y C quepan
+ * en memoria (como `compruebaHuella()`). Retorna 0 o -1.
+ *---------------------------------------------------------------------------*/
+int compruebaTipo(int tipo, int N, FILE *f) {
+	const struct descTipo *d = &descriptores[tipo];
+	size_t bytes = huellaTipo(tipo, N);
+
+	if (d->epsilon == 0.0) {
+		double maxA = fmax(fabs(d->rango[0]), fabs(d->rango[1]));
+		double maxB = fmax(fabs(d->rango[2]), fabs(d->rango[3]));
+
+		if ((double) N * maxA * maxB > INT32_MAX) {
+			fprintf(f, "N=%d: con --type %s la suma de N productos (hasta %.0f) desborda int32\n",
+			        N, d->nombre, (double) N * maxA * maxB);
+			return -1;
+		}
+	}
+	if (bytes == 0) {
+		fprintf(f, "N=%d: las matrices no caben en el espacio de direcciones\n", N);
+		return -1;
+	}
+	if (!cabeEnMemoria(bytes)) {
+		fprintf(f, "N=%d: las matrices %s ocupan %.1f GiB y el equipo tiene %.1f GiB de memoria\n",
+		        N, d->nombre, bytes / 1073741824.0, memoriaFisica() / 1073741824.0);
+		return -1;
+	}
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * informeTipo — Rendimiento y tráfico mínimo del producto de un tipo.
+ *
+ * Descripción:
+ *  Como `informeHuella()`, pero con los bytes del tipo: cada
+ *  multiplicación lee A y B y escribe C al menos una vez. El rendimiento
+ *  se da en GFLOP/s para punto flotante y en GOP/s (multiplicaciones y
+ *  sumas enteras) para los enteros.
+ *---------------------------------------------------------------------------*/
+void informeTipo(int tipo, int N, double tiempoUs, int reps, FILE *f) {
+	const struct descTipo *d = &descriptores[tipo];
+	double nn = (double) N * N;
+	double minimo = nn * (2.0 * d->bytes + d->bytesC);
+	double ops = 2.0 * nn * N;
+	const char *unidad = (d->epsilon > 0.0) ? "GFLOP/s" : "GOP/s";
+
+	fprintf(f, "# tipo %s: A y B de %zu bytes por elemento, C de %zu; huella %.1f MiB, tráfico mínimo %.1f MiB por multiplicación\n",
+	        d->nombre, d->bytes, d->bytesC, huellaTipo(tipo, N) / 1048576.0, minimo / 1048576.0);
+	fprintf(f, "# rendimiento: %.2f %s; ancho de banda efectivo mínimo %.2f GB/s; intensidad aritmética %.1f op/byte\n",
+	        tiempoUs > 0.0 ? ops * reps / (tiempoUs * 1e3) : 0.0, unidad,
+	        tiempoUs > 0.0 ? minimo * reps / (tiempoUs * 1e3) : 0.0, ops / minimo);
+}
+
+/*-----------------------------------------------------------------------------
+ * ejecutaTipo — Programa independiente común para `--type`.
+ *
+ * Parámetros:
+ *  - op: opciones ya leídas (con `--type`).
+ *  - mt: motor del programa (ver mmMotor.h).
+ *  - compartida: 1 → A, B y C en memoria compartida (motor Fork).
+ *  - programa: nombre para `--timing`.
+ *
+ * Descripción:
+ *  Como `ejecutaForma()` (mmForma.c): valida N para el tipo, reserva A, B
+ *  y C con su tamaño real en una región, las inicializa en serie, ejecuta
+ *  el motor (una vez o R con `-r`) y escribe el tiempo con el formato de
+ *  siempre. Con `-v` el rendimiento del tipo, con `--verify` la
+ *  comprobación y con `--timing` las fases. Retorna el código de salida
+ *  del programa (1 si la verificación falla).
+ *---------------------------------------------------------------------------*/
+int ejecutaTipo(const struct opciones *op, const struct motor *mt, int compartida, const char *programa) {
+	struct medicion tiempos;
+	struct contadores contadores;
+	int N = op->N, tipo = op->tipo;
+	int reps = (op->repeticiones > 0) ? op->repeticiones : 1;
+
+	if (strchr(op->tipos, ',') != NULL) {
+		fprintf(stderr, "Solo el binario único mm acepta una lista de tipos en --type\n");
+		exit(1);
+	}
+	if (compruebaTipo(tipo, N, stderr) != 0)
+		exit(1);
+
+	size_t nn = (size_t) N * N;
+	size_t eA = elemsTipo(nn, bytesTipo(tipo));
+	size_t elems = 2 * eA + elemsTipo(nn, bytesResultado(tipo));
+	double *region = reservaMatriz(elems, op->paginas, compartida, op->precarga);
+	if (region == NULL) {
+		perror("Error al reservar memoria para las matrices");
+		exit(1);
+	}
+	double *mA = region, *mB = region + eA, *mC = region + 2 * eA;
+
+	if (iniMedicion(&tiempos, op->P) != 0) {
+		perror("Error al reservar las marcas de tiempo");
+		exit(1);
+	}
+	if (op->contadores) {
+		if (iniContadores(&contadores, op->P) != 0) {
+			perror("Error al reservar los contadores");
+			exit(1);
+		}
+		tiempos.cont = &contadores;
+	}
+
+	inicioFase(&tiempos, MM_FASE_INICIALIZACION);
+	iniTipoFilas(tipo, mA, mB, N, 0, N, op->semilla);
+	memset(mC, 0, nn * bytesResultado(tipo));
+	finFase(&tiempos, MM_FASE_INICIALIZACION);
+
+	if (mt->iniciar(op, &tiempos) != 0) {
+		perror("Error al iniciar el motor");
+		exit(1);
+	}
+
+	double suma = 0.0, minimo = 0.0, maximo = 0.0;
+	for (int r = 0; r < reps; r++) {
+		double t = mt->multiplicar(op, mA, mB, mC);
+
+		suma += t;
+		if (r == 0 || t < minimo) minimo = t;
+		if (r == 0 || t > maximo) maximo = t;
+	}
+	mt->terminar(op);
+
+	const struct fase *trans = &tiempos.fase[MM_FASE_TRANSPOSICION];
+	if (op->repeticiones > 0)
+		printf("%9.0f %9.0f %9.0f ", suma / reps, minimo, maximo);
+	else
+		printf("%9.0f ", suma);
+	if (trans->veces > 0)
+		printf("%9.0f ", trans->total / trans->veces);
+	if (op->contadores)
+		columnasContadores(&contadores, 2.0 * N * (double) N * N * reps, suma, stdout);
+	printf("\n");
+	fflush(stdout);
+
+	if (op->informe) {
+		fprintf(stderr, "# kernel: %s\n", nombreKernel(kernelTipo(tipo, op->kernel)));
+		informeTipo(tipo, N, suma, reps, stderr);
+		informeMemoria("A|B|C", region, stderr);
+	}
+
+	int fallo = op->verifica ? verificaTipo(tipo, mA, mB, mC, N, op->semilla, stderr) : 0;
+
+	escribeMedicion(&tiempos, op->formatoTiempo, programa, N, stderr);
+	if (op->contadores) {
+		informeContadores(&contadores, op->informe, stderr);
+		liberaContadores(&contadores);
+	}
+	finMedicion(&tiempos);
+	liberaMatriz(region, elems, op->paginas);
+	return fallo;
+}
@@ -0,0 +1,55 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * mmTipo.h — Variantes del producto por tipo de elemento (`--type`): double,
+ * float y enteros de 16 y 8 bits con acumulación en 32 bits.
+ *
+ * Las cuatro variantes salen de una sola definición (una macro en
+ * mmTipo.c) que genera empaquetado, macro-kernel, transpuesta,
+ * inicialización y verificación para cada tipo; solo los micro-kernels
+ * SIMD cambian entre la familia de punto flotante (FMA) y la de enteros
+ * (pares de int16 con vpmaddwd).
+ */
+
+#ifndef MM_TIPO_H
+#define MM_TIPO_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "mmComun.h"
+
+struct motor;
+
+/* Tipos de elemento (`--type`) */
+#define MM_TIPO_NINGUNO  -1   /* double con los kernels de siempre (sin --type) */
+#define MM_TIPO_F64       0   /* double, C double                               */
+#define MM_TIPO_F32       1   /* float, C float                                 */
+#define MM_TIPO_I16       2   /* int16_t, C int32_t                             */
+#define MM_TIPO_I8        3   /* int8_t, C int32_t                              */
+
+/* Máximo de tipos en la lista de `--type` del binario único */
+#define MM_MAX_TIPOS      8
+
+int tipoPorNombre(const char *nombre);
+const char *nombreTipo(int tipo);
+int leeTipos(const char *texto, int *tipos);
+
+size_t bytesTipo(int tipo);
+size_t bytesResultado(int tipo);
+size_t elemsTipo(size_t elems, size_t bytes);
+int kernelTipo(int tipo, int kernel);
+
+void multiTipo(int tipo, const void *mA, const void *mB, int bTrans, void *mC, int D,
+               int filaI, int filaF, int colI, int colF, int kernel);
+void transTipo(int tipo, const void *mB, void *mBt, int D, int filaI, int filaF);
+void iniTipoFilas(int tipo, void *mA, void *mB, int D, int filaI, int filaF, uint64_t semilla);
+int verificaTipo(int tipo, const void *mA, const void *mB, const void *mC, int D,
+                 uint64_t semilla, FILE *f);
+
+int compruebaTipo(int tipo, int N, FILE *f);
+void informeTipo(int tipo, int N, double tiempoUs, int reps, FILE *f);
+
+int ejecutaTipo(const struct opciones *op, const struct motor *mt, int compartida, const char *programa);
+
+#endif
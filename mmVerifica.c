@@ -0,0 +1,310 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * Descripción general:
+ * ---------------------------------------------------------------
+ * Verificación del resultado de la multiplicación (opción `--verify`).
+ *
+ * Ninguna versión comprobaba su resultado: `impMatrix()` solo imprime
+ * matrices muy pequeñas, y así pasaron inadvertidos los resultados perdidos
+ * de la versión Fork y las filas que Pthreads dejaba sin calcular.
+ *
+ * Métodos:
+ *  - Exacto (N ≤ MM_VERIFICA_EXACTA, o M·N·K ≤ MM_VERIFICA_EXACTA³ en el
+ *    producto general de mmForma.h): se calcula R = A·B con el kernel por
+ *    bloques y se compara cada C[i][j] con R[i][j]. Costo O(N³).
+ *  - Freivalds (N mayor): para vectores aleatorios r se compara C·r con
+ *    A·(B·r). Si C ≠ A·B, un vector r con componentes ±1 lo detecta con
+ *    probabilidad ≥ 1/2; con MM_FREIVALDS_VECTORES vectores la probabilidad
+ *    de no detectar un error es ≤ 2^-MM_FREIVALDS_VECTORES, y en la práctica
+ *    (r con componentes continuas) es despreciable. Costo O(N²).
+ *
+ * En un lote (`--batch`, mmLote.c) cada producto se comprueba por separado
+ * con el mismo método y se informa el peor de todos.
+ *
+ * Tolerancia: distintos kernels suman en distinto orden, así que no se exige
+ * igualdad bit a bit. La cota estándar del producto punto de longitud N da
+ * |C − A·B| ≤ γ·(|A|·|B|) con γ = N·ε; se acepta un error de hasta
+ * 4·γ veces esa magnitud (|A|·|B| para el método exacto, |A|·|B|·|r| para
+ * Freivalds), lo que separa con claridad el redondeo de un error real.
+ *
+ * ---------------------------------------------------------------
+ */
+
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+#include "mmVerifica.h"
+#include "mmBloques.h"
+#include "mmAleatorio.h"
+#include "mmForma.h"
+
+/*-----------------------------------------------------------------------------
+ * Resultado de una comprobación:
+ *  - absMax: mayor |C − referencia|.
+ *  - relMax: mayor |C − referencia| / |referencia|.
+ *  - cotaMax: mayor error relativo a la tolerancia (> 1 → fallo).
+ *  - fila, col: posición del peor elemento respecto a la tolerancia.
+ *---------------------------------------------------------------------------*/
+struct errorVerif {
+	double absMax;
+	double relMax;
+	double cotaMax;
+	int fila;
+	int col;
+};
+
+/*-----------------------------------------------------------------------------
+ * acumulaError — Incorpora la diferencia entre `valor` y `ref` al resultado.
+ *
+ * Parámetros:
+ *  - e: resultado acumulado.
+ *  - valor, ref: valor calculado y de referencia.
+ *  - magnitud: |A|·|B| (o |A|·|B|·|r|) en esa posición.
+ *  - gamma: factor de tolerancia (ver descripción del archivo).
+ *  - fila, col: posición del elemento (col = -1 para un vector).
+ *---------------------------------------------------------------------------*/
+static void acumulaError(struct errorVerif *e, double valor, double ref, double magnitud,
+                         double gamma, int fila, int col) {
+	double err = isnan(valor) ? INFINITY : fabs(valor - ref);
+	double rel = (ref != 0.0) ? err / fabs(ref) : err;
+	double cota = err / (gamma * magnitud + DBL_MIN);
+
+	if (err > e->absMax) e->absMax = err;
+	if (rel > e->relMax) e->relMax = rel;
+	if (cota > e->cotaMax) {
+		e->cotaMax = cota;
+		e->fila = fila;
+		e->col = col;
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * valorAbs — Copia |m| (filas × cols con salto `ld`) a `dest` sin salto.
+ *---------------------------------------------------------------------------*/
+static void valorAbs(const double *m, int ld, int filas, int cols, double *dest) {
+	for (int i = 0; i < filas; i++)
+		for (int j = 0; j < cols; j++)
+			*dest++ = fabs(m[(size_t) i * ld + j]);
+}
+
+/*-----------------------------------------------------------------------------
+ * verificaExacta — Compara C con el producto de referencia elemento a
+ * elemento. Retorna -1 si no hay memoria para la referencia.
+ *---------------------------------------------------------------------------*/
+static int verificaExacta(const struct forma *fm, const double *mA, const double *mB, const double *mC,
+                          double gamma, struct errorVerif *e) {
+	int M = fm->M, N = fm->N, K = fm->K;
+	double *ref = malloc((size_t) M * N * sizeof(double));
+	double *absA = malloc((size_t) M * K * sizeof(double));
+	double *absB = malloc((size_t) K * N * sizeof(double));
+	double *mag = malloc((size_t) M * N * sizeof(double));
+
+	if (ref == NULL || absA == NULL || absB == NULL || mag == NULL) {
+		free(ref); free(absA); free(absB); free(mag);
+		return -1;
+	}
+
+	valorAbs(mA, fm->lda, M, K, absA);
+	valorAbs(mB, fm->ldb, K, N, absB);
+	multiFormaBloques(mA, fm->lda, mB, fm->ldb, ref, N, K, 0, M, 0, N, MM_BLOQUE_DEFECTO);
+	multiFormaBloques(absA, K, absB, N, mag, N, K, 0, M, 0, N, MM_BLOQUE_DEFECTO);
+
+	for (int i = 0; i < M; i++)
+		for (int j = 0; j < N; j++) {
+			size_t p = (size_t) i * N + j;
+			acumulaError(e, mC[(size_t) i * fm->ldc + j], ref[p], mag[p], gamma, i, j);
+		}
+
+	free(ref); free(absA); free(absB); free(mag);
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * productoVector — y = |M|·x (si `absoluto`) o y = M·x, con M filas × cols
+ * por filas y salto `ld`.
+ *---------------------------------------------------------------------------*/
+static void productoVector(const double *m, int ld, int filas, int cols, const double *x, double *y,
+                           int absoluto) {
+	for (int i = 0; i < filas; i++) {
+		const double *fila = m + (size_t) i * ld;
+		double suma = 0.0;
+
+		if (absoluto)
+			for (int k = 0; k < cols; k++)
+				suma += fabs(fila[k]) * fabs(x[k]);
+		else
+			for (int k = 0; k < cols; k++)
+				suma += fila[k] * x[k];
+		y[i] = suma;
+	}
+}
+
+/*-----------------------------------------------------------------------------
+ * verificaFreivalds — Compara C·r con A·(B·r) para varios vectores r.
+ * Retorna -1 si no hay memoria para los vectores.
+ *---------------------------------------------------------------------------*/
+static int verificaFreivalds(const struct forma *fm, const double *mA, const double *mB, const double *mC,
+                             uint64_t semilla, double gamma, struct errorVerif *e) {
+	int M = fm->M, N = fm->N, K = fm->K;
+	double *r = malloc(((size_t) N + 2 * (size_t) K + 3 * (size_t) M) * sizeof(double));
+
+	if (r == NULL)
+		return -1;
+
+	double *Br = r + N, *magB = Br + K;
+	double *ABr = magB + K, *Cr = ABr + M, *mag = Cr + M;
+
+	for (int v = 0; v < MM_FREIVALDS_VECTORES; v++) {
+		/* Componentes en [-1, 1) a partir de una semilla distinta de A y B */
+		llenaAleatorio(r, 0, N, semilla ^ (0xF2E1D0C0ULL + v), -1.0, 1.0);
+
+		productoVector(mB, fm->ldb, K, N, r, Br, 0);
+		productoVector(mA, fm->lda, M, K, Br, ABr, 0);
+		productoVector(mC, fm->ldc, M, N, r, Cr, 0);
+
+		productoVector(mB, fm->ldb, K, N, r, magB, 1);
+		productoVector(mA, fm->lda, M, K, magB, mag, 1);
+
+		for (int i = 0; i < M; i++)
+			acumulaError(e, Cr[i], ABr[i], mag[i], gamma, i, -1);
+	}
+
+	free(r);
+	return 0;
+}
+
+/*-----------------------------------------------------------------------------
+ * verificaForma — Comprueba que C = A·B para el producto general e informa
+ * el error.
+ *
+ * Parámetros:
+ *  - fm: forma del producto (dimensiones y saltos, ver mmForma.h).
+ *  - mA, mB, mC: matrices por filas (B sin transponer).
+ *  - semilla: semilla de los vectores de Freivalds (`--seed`).
+ *  - f: flujo donde se escribe el informe (stderr en los programas).
+ *
+ * Descripción:
+ *  Usa la referencia exacta si M·N·K ≤ MM_VERIFICA_EXACTA³ y Freivalds en
+ *  otro caso; la tolerancia crece con K, la longitud de cada producto
+ *  punto. Escribe una línea con el método, el error absoluto y relativo
+ *  máximos y el veredicto, y retorna 0 si C es correcta y 1 en caso
+ *  contrario (o si no hubo memoria para verificar).
+ *---------------------------------------------------------------------------*/
+int verificaForma(const struct forma *fm, const double *mA, const double *mB, const double *mC,
+                  uint64_t semilla, FILE *f) {
+	struct errorVerif e = { 0.0, 0.0, 0.0, -1, -1 };
+	double gamma = 4.0 * fm->K * DBL_EPSILON;
+	double limite = (double) MM_VERIFICA_EXACTA * MM_VERIFICA_EXACTA * MM_VERIFICA_EXACTA;
+	int exacta = ((double) fm->M * fm->N * fm->K <= limite);
+	int res;
+
+	if (exacta)
+		res = verificaExacta(fm, mA, mB, mC, gamma, &e);
+	else
+		res = verificaFreivalds(fm, mA, mB, mC, semilla, gamma, &e);
+
+	if (res != 0) {
+		fprintf(f, "Verificación: sin memoria para la comprobación\n");
+		return 1;
+	}
+
+	int correcto = (e.cotaMax <= 1.0);
+
+	if (exacta)
+		fprintf(f, "Verificación (referencia por bloques): ");
+	else
+		fprintf(f, "Verificación (Freivalds, %d vectores): ", MM_FREIVALDS_VECTORES);
+	fprintf(f, "error máx. abs %.3e, rel %.3e — %s\n", e.absMax, e.relMax,
+	        correcto ? "CORRECTO" : "INCORRECTO");
+
+	if (!correcto) {
+		if (e.col >= 0)
+			fprintf(f, "  peor elemento: C[%d][%d]\n", e.fila, e.col);
+		else
+			fprintf(f, "  peor componente: (C·r)[%d] (fila %d de C)\n", e.fila, e.fila);
+	}
+	return correcto ? 0 : 1;
+}
+
+/*-----------------------------------------------------------------------------
+ * verificaProducto — Comprueba que C = A·B e informa el error.
+ *
+ * Parámetros:
+ *  - mA, mB, mC: matrices D×D por filas (B sin transponer).
+ *  - D: dimensión.
+ *  - semilla: semilla de los vectores de Freivalds (`--seed`).
+ *  - f: flujo donde se escribe el informe (stderr en los programas).
+ *
+ * Descripción:
+ *  Caso cuadrado de `verificaForma()`: método exacto hasta
+ *  D = MM_VERIFICA_EXACTA y Freivalds para D mayor. Retorna 0 si C es
+ *  correcta y 1 en caso contrario.
+ *---------------------------------------------------------------------------*/
+int verificaProducto(const double *mA, const double *mB, const double *mC, int D,
+                     uint64_t semilla, FILE *f) {
+	struct forma fm = { D, D, D, D, D, D };
+
+	return verificaForma(&fm, mA, mB, mC, semilla, f);
+}
+
+/*-----------------------------------------------------------------------------
+ * verificaLote — Comprueba cada producto C[b] = A[b]·B[b] de un lote e
+ * informa el peor error.
+ *
+ * Parámetros:
+ *  - mA, mB, mC: primera matriz N×N de cada operando del lote.
+ *  - N, lote: dimensión y número de productos.
+ *  - paso: elementos entre matrices consecutivas del lote (ver mmLote.h).
+ *  - semilla: semilla de los vectores de Freivalds (`--seed`).
+ *  - f: flujo donde se escribe el informe.
+ *
+ * Descripción:
+ *  Aplica a cada producto el método de `verificaProducto()` (exacto hasta
+ *  N = MM_VERIFICA_EXACTA) y acumula los errores de todos; escribe una
+ *  sola línea y, si falla, el producto y el elemento peores. Retorna 0 si
+ *  todas las C son correctas y 1 en caso contrario.
+ *---------------------------------------------------------------------------*/
+int verificaLote(const double *mA, const double *mB, const double *mC, int N, int lote,
+                 size_t paso, uint64_t semilla, FILE *f) {
+	struct forma fm = { N, N, N, N, N, N };
+	struct errorVerif e = { 0.0, 0.0, 0.0, -1, -1 };
+	double gamma = 4.0 * N * DBL_EPSILON;
+	int exacta = (N <= MM_VERIFICA_EXACTA);
+	int peor = -1;
+
+	for (int b = 0; b < lote; b++) {
+		const double *pA = mA + (size_t) b * paso, *pB = mB + (size_t) b * paso;
+		const double *pC = mC + (size_t) b * paso;
+		double cota = e.cotaMax;
+		int res;
+
+		if (exacta)
+			res = verificaExacta(&fm, pA, pB, pC, gamma, &e);
+		else
+			res = verificaFreivalds(&fm, pA, pB, pC, semilla + b, gamma, &e);
+		if (res != 0) {
+			fprintf(f, "Verificación: sin memoria para la comprobación\n");
+			return 1;
+		}
+		if (e.cotaMax > cota)
+			peor = b;
+	}
+
+	int correcto = (e.cotaMax <= 1.0);
+
+	if (exacta)
+		fprintf(f, "Verificación (referencia por bloques, %d productos): ", lote);
+	else
+		fprintf(f, "Verificación (Freivalds, %d vectores, %d productos): ", MM_FREIVALDS_VECTORES, lote);
+	fprintf(f, "error máx. abs %.3e, rel %.3e — %s\n", e.absMax, e.relMax,
+	        correcto ? "CORRECTO" : "INCORRECTO");
+
+	if (!correcto) {
+		if (e.col >= 0)
+			fprintf(f, "  peor elemento: C[%d][%d] del producto %d\n", e.fila, e.col, peor);
+		else
+			fprintf(f, "  peor componente: (C·r)[%d] del producto %d\n", e.fila, peor);
+	}
+	return correcto ? 0 : 1;
+}
@@ -0,0 +1,35 @@
+/*
+ * Pontificia Universidad Javeriana — Taller de Evaluación de Rendimiento
+ *
+ * mmVerifica.h — Comprobación del producto C = A·B (`--verify`).
+ *
+ * Para N pequeño se compara C elemento a elemento con un producto de
+ * referencia (kernel por bloques); para N grande se usa la prueba
+ * probabilística de Freivalds, de costo O(N²); en un lote (`--batch`) se
+ * comprueba así cada producto. Se ejecuta fuera de la región medida, de
+ * modo que no altera los tiempos.
+ */
+
+#ifndef MM_VERIFICA_H
+#define MM_VERIFICA_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/* Hasta esta dimensión se compara contra el producto de referencia */
+#define MM_VERIFICA_EXACTA   512
+
+/* Vectores aleatorios usados en la prueba de Freivalds */
+#define MM_FREIVALDS_VECTORES  3
+
+struct forma;
+
+int verificaProducto(const double *mA, const double *mB, const double *mC, int D,
+                     uint64_t semilla, FILE *f);
+int verificaForma(const struct forma *fm, const double *mA, const double *mB, const double *mC,
+                  uint64_t semilla, FILE *f);
+int verificaLote(const double *mA, const double *mB, const double *mC, int N, int lote,
+                 size_t paso, uint64_t semilla, FILE *f);
+
+#endif